@@ -1,6 +1,8 @@
 # SPDX-License-Identifier: GPL-2.0+
 
 import builtins as _builtins
+from collections.abc import Iterator
+from contextlib import contextmanager
 from importlib import import_module
 from types import ModuleType
 
@@ -9,13 +11,19 @@ _BOOTSTRAPPED = False
 qmfloat: ModuleType
 qmint: ModuleType
 qmcmplx: ModuleType
+qmddfloat: ModuleType
+qmqqfloat: ModuleType
 qarray: ModuleType
 qcarray: ModuleType
 qiarray: ModuleType
+ddarray: ModuleType
+qqarray: ModuleType
 
 qfloat: type
 qint: type
 qcmplx: type
+ddfloat: type
+qqfloat: type
 
 
 def _bootstrap_core_modules() -> None:
@@ -33,11 +41,19 @@ def _bootstrap_core_modules() -> None:
     _qmcmplx = import_module(".qmcmplx", __name__)
     globals().update({"qmcmplx": _qmcmplx, "qcmplx": _qmcmplx.qcmplx})
 
+    _qmddfloat = import_module(".qmddfloat", __name__)
+    globals().update({"qmddfloat": _qmddfloat, "ddfloat": _qmddfloat.ddfloat})
+
+    _qmqqfloat = import_module(".qmqqfloat", __name__)
+    globals().update({"qmqqfloat": _qmqqfloat, "qqfloat": _qmqqfloat.qqfloat})
+
     globals().update(
         {
             "qarray": import_module(".qarray", __name__),
             "qcarray": import_module(".qcarray", __name__),
             "qiarray": import_module(".qiarray", __name__),
+            "ddarray": import_module(".ddarray", __name__),
+            "qqarray": import_module(".qqarray", __name__),
         }
     )
 
@@ -51,6 +67,34 @@ def _constant_exports() -> tuple[str, ...]:
     return tuple(name for name in dir(_constant) if not name.startswith("_"))
 
 
+@contextmanager
+def fast_math(enabled: bool = True) -> Iterator[None]:
+    """Select the fast qarray exp/log/sin/cos loops within a ``with`` block.
+
+    The setting is per thread and the previous value is restored on exit.
+    """
+    previous = qarray.set_fast_math(enabled)
+    try:
+        yield
+    finally:
+        qarray.set_fast_math(previous)
+
+
+def show_runtime() -> None:
+    """Print the CPU level picked for the batched qarray kernels.
+
+    The level is chosen at import from the CPU features and can be pinned
+    with the ``PYQUADP_CPU_LEVEL`` environment variable.
+    """
+    info = qarray.runtime_info()
+    env = info["env_value"] if info["env_value"] is not None else "unset"
+    print(f"CPU level:        {info['cpu_level']}")
+    print(f"Selected level:   {info['selected_level']}")
+    print(f"Available levels: {', '.join(info['available_levels'])}")
+    print(f"{info['env_var']}: {env}")
+    print(f"Fast math:        {info['fast_math']}")
+
+
 def _register_pickle_builtins() -> None:
     # Keep scalar types pickle-importable for historical compatibility.
     setattr(_builtins, "qint", qint)
@@ -62,6 +106,8 @@ _bootstrap_core_modules()
 
 from . import constant as _constant
 from .constant import *
+from . import arrow, dlpack, fortranio
+from .npyio import frombuffer, fromfile, load, save, savez, savez_compressed, tofile
 
 _CONSTANT_EXPORTS = _constant_exports()
 
@@ -69,12 +115,30 @@ __all__ = [
     "qint",
     "qfloat",
     "qcmplx",
+    "ddfloat",
+    "qqfloat",
     "qmint",
     "qmfloat",
     "qmcmplx",
+    "qmddfloat",
+    "qmqqfloat",
     "qarray",
     "qcarray",
     "qiarray",
+    "ddarray",
+    "qqarray",
+    "fast_math",
+    "show_runtime",
+    "save",
+    "load",
+    "savez",
+    "savez_compressed",
+    "frombuffer",
+    "fromfile",
+    "tofile",
+    "fortranio",
+    "dlpack",
+    "arrow",
 ]
 __all__.extend(_CONSTANT_EXPORTS)  # pyright: ignore[reportUnsupportedDunderAll]
 
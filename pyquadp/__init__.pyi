@@ -1,22 +1,63 @@
+from collections.abc import Iterator
+from contextlib import contextmanager
+
+from . import arrow as arrow
+from . import ddarray as ddarray
+from . import dlpack as dlpack
+from . import fortranio as fortranio
 from . import qarray as qarray
 from . import qcarray as qcarray
 from . import qiarray as qiarray
 from . import qmcmplx as qmcmplx
+from . import qmddfloat as qmddfloat
 from . import qmfloat as qmfloat
 from . import qmint as qmint
+from . import qmqqfloat as qmqqfloat
+from . import qqarray as qqarray
 from .constant import *
+from .npyio import frombuffer as frombuffer
+from .npyio import fromfile as fromfile
+from .npyio import load as load
+from .npyio import save as save
+from .npyio import savez as savez
+from .npyio import savez_compressed as savez_compressed
+from .npyio import tofile as tofile
 from .qmcmplx import qcmplx
+from .qmddfloat import ddfloat
 from .qmfloat import qfloat
 from .qmint import qint
+from .qmqqfloat import qqfloat
 
 __all__ = [
     "qint",
     "qfloat",
     "qcmplx",
+    "ddfloat",
+    "qqfloat",
     "qmint",
     "qmfloat",
     "qmcmplx",
+    "qmddfloat",
+    "qmqqfloat",
     "qarray",
     "qcarray",
     "qiarray",
+    "ddarray",
+    "qqarray",
+    "fast_math",
+    "show_runtime",
+    "save",
+    "load",
+    "savez",
+    "savez_compressed",
+    "frombuffer",
+    "fromfile",
+    "tofile",
+    "fortranio",
+    "dlpack",
+    "arrow",
 ]
+
+@contextmanager
+def fast_math(enabled: bool = ...) -> Iterator[None]: ...
+def show_runtime() -> None: ...
@@ -0,0 +1,40 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+"""Arrow C Data Interface producers for quad arrays.
+
+:class:`ArrowArray` wraps a 1-D quad array as an Arrow PyCapsule producer
+backed by ``qarray.to_arrow`` and friends, without needing pyarrow. Its
+elements go out as ``fixed_size_binary(16)``, or ``(32)`` for qcmplx, with
+the ``ARROW:extension:name`` ``pyquadp.qfloat``, ``pyquadp.qcmplx`` or
+``pyquadp.qint``, and the data buffer is the array's own memory. The
+modules' own ``from_arrow`` functions read the same layout back.
+"""
+
+from .dlpack import _module_of
+
+__all__ = ["ArrowArray"]
+
+
+class ArrowArray:
+    """A 1-D qarray, qcarray or qiarray array as an Arrow producer.
+
+    A strided array is copied once here, as Arrow buffers are contiguous.
+    """
+
+    def __init__(self, array):
+        module = _module_of(array, "ArrowArray")
+        if array.ndim != 1:
+            raise ValueError(f"ArrowArray needs a 1-D array, got {array.ndim} dimensions")
+        if not array.flags.c_contiguous:
+            array = module.asarray(array, order="C")
+        self.array = array
+        self._module = module
+
+    def __len__(self):
+        return len(self.array)
+
+    def __arrow_c_schema__(self):
+        return self._module.to_arrow(self.array[:0])[0]
+
+    def __arrow_c_array__(self, requested_schema=None):
+        return self._module.to_arrow(self.array, requested_schema)
@@ -0,0 +1,12 @@
+from typing import Any
+
+from numpy.typing import NDArray
+
+__all__ = ["ArrowArray"]
+
+class ArrowArray:
+    array: NDArray[Any]
+    def __init__(self, array: NDArray[Any]) -> None: ...
+    def __len__(self) -> int: ...
+    def __arrow_c_schema__(self) -> Any: ...
+    def __arrow_c_array__(self, requested_schema: Any = ...) -> tuple[Any, Any]: ...
@@ -0,0 +1,2087 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+// Double-double dtype, registered the same way as qarray in qfloatarray.c
+
+#define NPY_TARGET_VERSION NPY_2_0_API_VERSION
+#define NPY_NO_DEPRECATED_API NPY_2_0_API_VERSION
+
+#include "pyquadp.h"
+
+#include <numpy/arrayobject.h>
+#include <numpy/npy_math.h>
+#include <numpy/ufuncobject.h>
+#include <stdalign.h>
+#include <string.h>
+
+#include "ddarray.h"
+#include "ddfloat.h"
+#include "qddmath.h"
+
+static int DDArrayTypeNum = -1;
+static int QuadArrayTypeNum = -1;
+PyArray_ArrFuncs DDArrayFuncs;
+PyArray_Descr* DDArrayDescr;
+PyArray_DescrProto DDArrayDescrProto = {PyObject_HEAD_INIT(NULL)};
+
+static int DDArray_setitem(PyObject* item, qdd_t* data, void* array);
+
+// True when every operand of an inner loop is a packed run of double-doubles,
+// the plain indexed loop then lets the compiler keep both halves in vector
+// registers
+static inline bool
+DDArray_is_contiguous(const npy_intp *steps, int nargs)
+{
+  int i;
+
+  for (i = 0; i < nargs; ++i) {
+    if (steps[i] != (npy_intp)sizeof(qdd_t)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void
+DDArray_ufunc_add(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  if (DDArray_is_contiguous(steps, 3)) {
+    const qdd_t *a = (const qdd_t *)in1;
+    const qdd_t *b = (const qdd_t *)in2;
+    qdd_t *r = (qdd_t *)out;
+
+    for (i = 0; i < n; ++i) {
+      r[i] = qdd_ieee_add(a[i], b[i]);
+    }
+    return;
+  }
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_add(*(qdd_t *)in1, *(qdd_t *)in2);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_subtract(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  if (DDArray_is_contiguous(steps, 3)) {
+    const qdd_t *a = (const qdd_t *)in1;
+    const qdd_t *b = (const qdd_t *)in2;
+    qdd_t *r = (qdd_t *)out;
+
+    for (i = 0; i < n; ++i) {
+      r[i] = qdd_ieee_sub(a[i], b[i]);
+    }
+    return;
+  }
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_sub(*(qdd_t *)in1, *(qdd_t *)in2);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_multiply(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  if (DDArray_is_contiguous(steps, 3)) {
+    const qdd_t *a = (const qdd_t *)in1;
+    const qdd_t *b = (const qdd_t *)in2;
+    qdd_t *r = (qdd_t *)out;
+
+    for (i = 0; i < n; ++i) {
+      r[i] = qdd_ieee_mul(a[i], b[i]);
+    }
+    return;
+  }
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_mul(*(qdd_t *)in1, *(qdd_t *)in2);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_divide(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  if (DDArray_is_contiguous(steps, 3)) {
+    const qdd_t *a = (const qdd_t *)in1;
+    const qdd_t *b = (const qdd_t *)in2;
+    qdd_t *r = (qdd_t *)out;
+
+    for (i = 0; i < n; ++i) {
+      r[i] = qdd_ieee_div(a[i], b[i]);
+    }
+    return;
+  }
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_div(*(qdd_t *)in1, *(qdd_t *)in2);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_add_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_add(*(qdd_t *)indd, qdd_from_double(*(npy_float64 *)ind));
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_add_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_add(qdd_from_double(*(npy_float64 *)ind), *(qdd_t *)indd);
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_subtract_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_sub(*(qdd_t *)indd, qdd_from_double(*(npy_float64 *)ind));
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_subtract_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_sub(qdd_from_double(*(npy_float64 *)ind), *(qdd_t *)indd);
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_multiply_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_mul(*(qdd_t *)indd, qdd_from_double(*(npy_float64 *)ind));
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_multiply_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_mul(qdd_from_double(*(npy_float64 *)ind), *(qdd_t *)indd);
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_divide_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_div(*(qdd_t *)indd, qdd_from_double(*(npy_float64 *)ind));
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_divide_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qdd_t *)out = qdd_ieee_div(qdd_from_double(*(npy_float64 *)ind), *(qdd_t *)indd);
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_add_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(__float128 *)out = qdd_to_quad(*(qdd_t *)indd) + *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_add_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(__float128 *)out = *(__float128 *)inq + qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_subtract_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(__float128 *)out = qdd_to_quad(*(qdd_t *)indd) - *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_subtract_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(__float128 *)out = *(__float128 *)inq - qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_multiply_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(__float128 *)out = qdd_to_quad(*(qdd_t *)indd) * *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_multiply_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(__float128 *)out = *(__float128 *)inq * qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_divide_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(__float128 *)out = qdd_to_quad(*(qdd_t *)indd) / *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_divide_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(__float128 *)out = *(__float128 *)inq / qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_negative(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t v = *(qdd_t *)in;
+    *(qdd_t *)out = qdd_neg(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+DDArray_ufunc_positive(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t v = *(qdd_t *)in;
+    *(qdd_t *)out = v;
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+DDArray_ufunc_absolute(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t v = *(qdd_t *)in;
+    *(qdd_t *)out = v.hi < 0 ? qdd_neg(v) : v;
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+DDArray_ufunc_square(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t v = *(qdd_t *)in;
+    *(qdd_t *)out = qdd_ieee_mul(v, v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+DDArray_ufunc_sqrt(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t v = *(qdd_t *)in;
+    *(qdd_t *)out = qdd_ieee_sqrt(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+DDArray_ufunc_exp(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t v = *(qdd_t *)in;
+    *(qdd_t *)out = qdd_exp(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+DDArray_ufunc_log(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t v = *(qdd_t *)in;
+    *(qdd_t *)out = qdd_log(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+DDArray_ufunc_sin(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t v = *(qdd_t *)in;
+    *(qdd_t *)out = qdd_sin(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+DDArray_ufunc_cos(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t v = *(qdd_t *)in;
+    *(qdd_t *)out = qdd_cos(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+DDArray_ufunc_equal(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)in1;
+    qdd_t b = *(qdd_t *)in2;
+    *(npy_bool *)out = a.hi == b.hi && a.lo == b.lo;
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_not_equal(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)in1;
+    qdd_t b = *(qdd_t *)in2;
+    *(npy_bool *)out = !(a.hi == b.hi && a.lo == b.lo);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)in1;
+    qdd_t b = *(qdd_t *)in2;
+    *(npy_bool *)out = a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less_equal(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)in1;
+    qdd_t b = *(qdd_t *)in2;
+    *(npy_bool *)out = a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)in1;
+    qdd_t b = *(qdd_t *)in2;
+    *(npy_bool *)out = a.hi > b.hi || (a.hi == b.hi && a.lo > b.lo);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater_equal(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)in1;
+    qdd_t b = *(qdd_t *)in2;
+    *(npy_bool *)out = a.hi > b.hi || (a.hi == b.hi && a.lo >= b.lo);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_equal_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)indd;
+    qdd_t b = qdd_from_double(*(npy_float64 *)ind);
+    *(npy_bool *)out = a.hi == b.hi && a.lo == b.lo;
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_equal_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = qdd_from_double(*(npy_float64 *)ind);
+    qdd_t b = *(qdd_t *)indd;
+    *(npy_bool *)out = a.hi == b.hi && a.lo == b.lo;
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_not_equal_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)indd;
+    qdd_t b = qdd_from_double(*(npy_float64 *)ind);
+    *(npy_bool *)out = !(a.hi == b.hi && a.lo == b.lo);
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_not_equal_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = qdd_from_double(*(npy_float64 *)ind);
+    qdd_t b = *(qdd_t *)indd;
+    *(npy_bool *)out = !(a.hi == b.hi && a.lo == b.lo);
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)indd;
+    qdd_t b = qdd_from_double(*(npy_float64 *)ind);
+    *(npy_bool *)out = a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = qdd_from_double(*(npy_float64 *)ind);
+    qdd_t b = *(qdd_t *)indd;
+    *(npy_bool *)out = a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less_equal_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)indd;
+    qdd_t b = qdd_from_double(*(npy_float64 *)ind);
+    *(npy_bool *)out = a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo);
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less_equal_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = qdd_from_double(*(npy_float64 *)ind);
+    qdd_t b = *(qdd_t *)indd;
+    *(npy_bool *)out = a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo);
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)indd;
+    qdd_t b = qdd_from_double(*(npy_float64 *)ind);
+    *(npy_bool *)out = a.hi > b.hi || (a.hi == b.hi && a.lo > b.lo);
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = qdd_from_double(*(npy_float64 *)ind);
+    qdd_t b = *(qdd_t *)indd;
+    *(npy_bool *)out = a.hi > b.hi || (a.hi == b.hi && a.lo > b.lo);
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater_equal_dd_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = *(qdd_t *)indd;
+    qdd_t b = qdd_from_double(*(npy_float64 *)ind);
+    *(npy_bool *)out = a.hi > b.hi || (a.hi == b.hi && a.lo >= b.lo);
+    indd += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater_equal_d_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qdd_t a = qdd_from_double(*(npy_float64 *)ind);
+    qdd_t b = *(qdd_t *)indd;
+    *(npy_bool *)out = a.hi > b.hi || (a.hi == b.hi && a.lo >= b.lo);
+    ind += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_equal_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = qdd_to_quad(*(qdd_t *)indd) == *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_equal_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = *(__float128 *)inq == qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_not_equal_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = qdd_to_quad(*(qdd_t *)indd) != *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_not_equal_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = *(__float128 *)inq != qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = qdd_to_quad(*(qdd_t *)indd) < *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = *(__float128 *)inq < qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less_equal_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = qdd_to_quad(*(qdd_t *)indd) <= *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_less_equal_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = *(__float128 *)inq <= qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = qdd_to_quad(*(qdd_t *)indd) > *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = *(__float128 *)inq > qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater_equal_dd_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *indd = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = qdd_to_quad(*(qdd_t *)indd) >= *(__float128 *)inq;
+    indd += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+DDArray_ufunc_greater_equal_q_dd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *indd = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(npy_bool *)out = *(__float128 *)inq >= qdd_to_quad(*(qdd_t *)indd);
+    inq += steps[0];
+    indd += steps[1];
+    out += steps[2];
+  }
+}
+
+static int
+DDArray_register_ufunc_types(const char *name, PyUFuncGenericFunction loop, int *types)
+{
+  PyObject *numpy_mod;
+  PyObject *ufunc;
+
+  numpy_mod = PyImport_ImportModule("numpy");
+  if (numpy_mod == NULL) {
+    return -1;
+  }
+  ufunc = PyObject_GetAttrString(numpy_mod, name);
+  Py_DECREF(numpy_mod);
+  if (ufunc == NULL) {
+    return -1;
+  }
+
+  if (PyUFunc_RegisterLoopForType((PyUFuncObject *)ufunc, DDArrayTypeNum, loop, types, NULL) < 0) {
+    Py_DECREF(ufunc);
+    return -1;
+  }
+
+  Py_DECREF(ufunc);
+  return 0;
+}
+
+static int
+DDArray_register_ufunc_binary_types(const char *name, PyUFuncGenericFunction loop, int in0, int in1, int out)
+{
+  int types[3];
+
+  types[0] = in0;
+  types[1] = in1;
+  types[2] = out;
+  return DDArray_register_ufunc_types(name, loop, types);
+}
+
+static int
+DDArray_register_ufunc_binary(const char *name, PyUFuncGenericFunction loop)
+{
+  return DDArray_register_ufunc_binary_types(name, loop, DDArrayTypeNum, DDArrayTypeNum, DDArrayTypeNum);
+}
+
+static int
+DDArray_register_ufunc_unary(const char *name, PyUFuncGenericFunction loop)
+{
+  int types[2];
+
+  types[0] = DDArrayTypeNum;
+  types[1] = DDArrayTypeNum;
+  return DDArray_register_ufunc_types(name, loop, types);
+}
+
+typedef struct {
+  const char *name;
+  PyUFuncGenericFunction dd;
+  PyUFuncGenericFunction dd_q;
+  PyUFuncGenericFunction q_dd;
+  PyUFuncGenericFunction dd_d;
+  PyUFuncGenericFunction d_dd;
+} DDArray_binary_loops;
+
+static const DDArray_binary_loops DDArrayBinaryLoops[] = {
+  {"add", DDArray_ufunc_add, DDArray_ufunc_add_dd_q, DDArray_ufunc_add_q_dd, DDArray_ufunc_add_dd_d, DDArray_ufunc_add_d_dd},
+  {"subtract", DDArray_ufunc_subtract, DDArray_ufunc_subtract_dd_q, DDArray_ufunc_subtract_q_dd, DDArray_ufunc_subtract_dd_d, DDArray_ufunc_subtract_d_dd},
+  {"multiply", DDArray_ufunc_multiply, DDArray_ufunc_multiply_dd_q, DDArray_ufunc_multiply_q_dd, DDArray_ufunc_multiply_dd_d, DDArray_ufunc_multiply_d_dd},
+  {"divide", DDArray_ufunc_divide, DDArray_ufunc_divide_dd_q, DDArray_ufunc_divide_q_dd, DDArray_ufunc_divide_dd_d, DDArray_ufunc_divide_d_dd},
+};
+
+static const struct {
+  const char *name;
+  PyUFuncGenericFunction loop;
+} DDArrayUnaryLoops[] = {
+  {"negative", DDArray_ufunc_negative},
+  {"positive", DDArray_ufunc_positive},
+  {"absolute", DDArray_ufunc_absolute},
+  {"square", DDArray_ufunc_square},
+  {"sqrt", DDArray_ufunc_sqrt},
+  {"exp", DDArray_ufunc_exp},
+  {"log", DDArray_ufunc_log},
+  {"sin", DDArray_ufunc_sin},
+  {"cos", DDArray_ufunc_cos},
+};
+
+static const struct {
+  const char *name;
+  PyUFuncGenericFunction dd;
+  PyUFuncGenericFunction dd_q;
+  PyUFuncGenericFunction q_dd;
+  PyUFuncGenericFunction dd_d;
+  PyUFuncGenericFunction d_dd;
+} DDArrayCompareLoops[] = {
+  {"equal", DDArray_ufunc_equal, DDArray_ufunc_equal_dd_q, DDArray_ufunc_equal_q_dd, DDArray_ufunc_equal_dd_d, DDArray_ufunc_equal_d_dd},
+  {"not_equal", DDArray_ufunc_not_equal, DDArray_ufunc_not_equal_dd_q, DDArray_ufunc_not_equal_q_dd, DDArray_ufunc_not_equal_dd_d, DDArray_ufunc_not_equal_d_dd},
+  {"less", DDArray_ufunc_less, DDArray_ufunc_less_dd_q, DDArray_ufunc_less_q_dd, DDArray_ufunc_less_dd_d, DDArray_ufunc_less_d_dd},
+  {"less_equal", DDArray_ufunc_less_equal, DDArray_ufunc_less_equal_dd_q, DDArray_ufunc_less_equal_q_dd, DDArray_ufunc_less_equal_dd_d, DDArray_ufunc_less_equal_d_dd},
+  {"greater", DDArray_ufunc_greater, DDArray_ufunc_greater_dd_q, DDArray_ufunc_greater_q_dd, DDArray_ufunc_greater_dd_d, DDArray_ufunc_greater_d_dd},
+  {"greater_equal", DDArray_ufunc_greater_equal, DDArray_ufunc_greater_equal_dd_q, DDArray_ufunc_greater_equal_q_dd, DDArray_ufunc_greater_equal_dd_d, DDArray_ufunc_greater_equal_d_dd},
+};
+
+static int
+DDArray_register_ufuncs(void)
+{
+  size_t i;
+
+  // NumPy tries the loops of a user dtype in registration order and
+  // qarray -> float64 counts as a safe cast, so the qarray loops must come
+  // before the float64 ones or mixed ddarray/qarray calls would be done in
+  // double precision
+  for (i = 0; i < sizeof(DDArrayBinaryLoops) / sizeof(DDArrayBinaryLoops[0]); ++i) {
+    const DDArray_binary_loops *loops = &DDArrayBinaryLoops[i];
+
+    if (DDArray_register_ufunc_binary(loops->name, loops->dd) < 0) {
+      return -1;
+    }
+    if (DDArray_register_ufunc_binary_types(loops->name, loops->dd_q, DDArrayTypeNum, QuadArrayTypeNum, QuadArrayTypeNum) < 0) {
+      return -1;
+    }
+    if (DDArray_register_ufunc_binary_types(loops->name, loops->q_dd, QuadArrayTypeNum, DDArrayTypeNum, QuadArrayTypeNum) < 0) {
+      return -1;
+    }
+    if (DDArray_register_ufunc_binary_types(loops->name, loops->dd_d, DDArrayTypeNum, NPY_DOUBLE, DDArrayTypeNum) < 0) {
+      return -1;
+    }
+    if (DDArray_register_ufunc_binary_types(loops->name, loops->d_dd, NPY_DOUBLE, DDArrayTypeNum, DDArrayTypeNum) < 0) {
+      return -1;
+    }
+  }
+
+  for (i = 0; i < sizeof(DDArrayUnaryLoops) / sizeof(DDArrayUnaryLoops[0]); ++i) {
+    if (DDArray_register_ufunc_unary(DDArrayUnaryLoops[i].name, DDArrayUnaryLoops[i].loop) < 0) {
+      return -1;
+    }
+  }
+
+  // Normalised pairs compare on hi and then lo, and NaN compares false as
+  // in float64. There is no safe cast to float64 for NumPy to fall back on,
+  // so Python and NumPy numbers need their own loops, ordered after the
+  // qarray ones as in arithmetic.
+  for (i = 0; i < sizeof(DDArrayCompareLoops) / sizeof(DDArrayCompareLoops[0]); ++i) {
+    const char *name = DDArrayCompareLoops[i].name;
+
+    if (DDArray_register_ufunc_binary_types(name, DDArrayCompareLoops[i].dd, DDArrayTypeNum, DDArrayTypeNum, NPY_BOOL) < 0) {
+      return -1;
+    }
+    if (DDArray_register_ufunc_binary_types(name, DDArrayCompareLoops[i].dd_q, DDArrayTypeNum, QuadArrayTypeNum, NPY_BOOL) < 0) {
+      return -1;
+    }
+    if (DDArray_register_ufunc_binary_types(name, DDArrayCompareLoops[i].q_dd, QuadArrayTypeNum, DDArrayTypeNum, NPY_BOOL) < 0) {
+      return -1;
+    }
+    if (DDArray_register_ufunc_binary_types(name, DDArrayCompareLoops[i].dd_d, DDArrayTypeNum, NPY_DOUBLE, NPY_BOOL) < 0) {
+      return -1;
+    }
+    if (DDArray_register_ufunc_binary_types(name, DDArrayCompareLoops[i].d_dd, NPY_DOUBLE, DDArrayTypeNum, NPY_BOOL) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void
+DDArray_cast_to_float64(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  qdd_t *src = (qdd_t *)from;
+  npy_float64 *dst = (npy_float64 *)to;
+
+  // hi is already hi + lo rounded to a double
+  for (i = 0; i < n; ++i) {
+    dst[i] = src[i].hi;
+  }
+}
+
+static void
+DDArray_cast_to_float32(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  qdd_t *src = (qdd_t *)from;
+  npy_float32 *dst = (npy_float32 *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = (npy_float32)src[i].hi;
+  }
+}
+
+static void
+DDArray_cast_to_qarray(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  qdd_t *src = (qdd_t *)from;
+  __float128 *dst = (__float128 *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = qdd_to_quad(src[i]);
+  }
+}
+
+static void
+DDArray_cast_from_float64(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  npy_float64 *src = (npy_float64 *)from;
+  qdd_t *dst = (qdd_t *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = qdd_from_double(src[i]);
+  }
+}
+
+static void
+DDArray_cast_from_float32(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  npy_float32 *src = (npy_float32 *)from;
+  qdd_t *dst = (qdd_t *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = qdd_from_double((double)src[i]);
+  }
+}
+
+static void
+DDArray_cast_from_qarray(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  __float128 *src = (__float128 *)from;
+  qdd_t *dst = (qdd_t *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = qdd_from_quad_rn(src[i]);
+  }
+}
+
+static int
+DDArray_register_cast_from(int from_type_num, PyArray_VectorUnaryFunc *cast, bool safe)
+{
+  PyArray_Descr *from_descr;
+
+  from_descr = PyArray_DescrFromType(from_type_num);
+  if (from_descr == NULL) {
+    return -1;
+  }
+  if (PyArray_RegisterCastFunc(from_descr, DDArrayTypeNum, cast) < 0) {
+    Py_DECREF(from_descr);
+    return -1;
+  }
+  if (safe && PyArray_RegisterCanCast(from_descr, DDArrayTypeNum, NPY_NOSCALAR) < 0) {
+    Py_DECREF(from_descr);
+    return -1;
+  }
+  Py_DECREF(from_descr);
+  return 0;
+}
+
+static int
+DDArray_register_casts(PyArray_Descr *dd_descr)
+{
+  if (PyArray_RegisterCastFunc(dd_descr, NPY_DOUBLE, DDArray_cast_to_float64) < 0) {
+    return -1;
+  }
+  if (PyArray_RegisterCastFunc(dd_descr, NPY_FLOAT, DDArray_cast_to_float32) < 0) {
+    return -1;
+  }
+  if (PyArray_RegisterCastFunc(dd_descr, QuadArrayTypeNum, DDArray_cast_to_qarray) < 0) {
+    return -1;
+  }
+  // Only ddarray -> qarray is safe, narrowing to float64/float32 drops the
+  // low part and must be asked for
+  if (PyArray_RegisterCanCast(dd_descr, QuadArrayTypeNum, NPY_NOSCALAR) < 0) {
+    return -1;
+  }
+
+  if (DDArray_register_cast_from(NPY_DOUBLE, DDArray_cast_from_float64, true) < 0) {
+    return -1;
+  }
+  if (DDArray_register_cast_from(NPY_FLOAT, DDArray_cast_from_float32, true) < 0) {
+    return -1;
+  }
+  // qarray -> ddarray loses precision and range, so it is only done on request
+  if (DDArray_register_cast_from(QuadArrayTypeNum, DDArray_cast_from_qarray, false) < 0) {
+    return -1;
+  }
+
+  return 0;
+}
+
+static PyArrayObject *
+DDArray_new_empty(int nd, npy_intp *dims)
+{
+  PyArray_Descr *descr;
+
+  if (DDArrayDescr == NULL) {
+    PyErr_SetString(PyExc_RuntimeError, "ddarray dtype not initialized");
+    return NULL;
+  }
+
+  descr = DDArrayDescr;
+  Py_INCREF(descr);
+  return (PyArrayObject *)PyArray_SimpleNewFromDescr(nd, dims, descr);
+}
+
+static int
+ddarray_parse_shape(PyObject *shape_obj, int *nd_out, npy_intp **dims_out)
+{
+  PyObject *seq;
+  Py_ssize_t nd;
+  npy_intp i;
+  npy_intp *dims;
+
+  if (PyLong_Check(shape_obj)) {
+    Py_ssize_t n = PyLong_AsSsize_t(shape_obj);
+    if (n < 0 && PyErr_Occurred()) {
+      return -1;
+    }
+    if (n < 0) {
+      PyErr_SetString(PyExc_ValueError, "size must be non-negative");
+      return -1;
+    }
+
+    dims = PyMem_Malloc(sizeof(npy_intp));
+    if (dims == NULL) {
+      PyErr_NoMemory();
+      return -1;
+    }
+    dims[0] = (npy_intp)n;
+    *nd_out = 1;
+    *dims_out = dims;
+    return 0;
+  }
+
+  seq = PySequence_Fast(shape_obj, "shape must be an int or a sequence of ints");
+  if (seq == NULL) {
+    return -1;
+  }
+
+  nd = PySequence_Size(seq);
+  if (nd < 0) {
+    Py_DECREF(seq);
+    return -1;
+  }
+  if (nd == 0) {
+    Py_DECREF(seq);
+    *nd_out = 0;
+    *dims_out = NULL;
+    return 0;
+  }
+
+  dims = PyMem_Malloc((size_t)nd * sizeof(npy_intp));
+  if (dims == NULL) {
+    Py_DECREF(seq);
+    PyErr_NoMemory();
+    return -1;
+  }
+
+  for (i = 0; i < (npy_intp)nd; ++i) {
+    PyObject *item = PySequence_GetItem(seq, i);
+    if (item == NULL) {
+      Py_DECREF(seq);
+      PyMem_Free(dims);
+      return -1;
+    }
+    Py_ssize_t n = PyLong_AsSsize_t(item);
+    Py_DECREF(item);
+    if (n < 0 && PyErr_Occurred()) {
+      Py_DECREF(seq);
+      PyMem_Free(dims);
+      return -1;
+    }
+    if (n < 0) {
+      Py_DECREF(seq);
+      PyMem_Free(dims);
+      PyErr_SetString(PyExc_ValueError, "size must be non-negative");
+      return -1;
+    }
+    dims[i] = (npy_intp)n;
+  }
+
+  Py_DECREF(seq);
+  *nd_out = (int)nd;
+  *dims_out = dims;
+
+  return 0;
+}
+
+static PyObject *
+ddarray_from_object(PyObject *obj, int copy)
+{
+  int requirements;
+  PyArray_Descr *descr;
+
+  requirements = NPY_ARRAY_ENSUREARRAY | NPY_ARRAY_FORCECAST;
+  if (copy) {
+    requirements |= NPY_ARRAY_ENSURECOPY;
+  }
+
+  descr = DDArrayDescr;
+  Py_INCREF(descr);
+  return PyArray_FromAny(obj, descr, 0, NPY_MAXDIMS, requirements, NULL);
+}
+
+static PyObject *
+ddarray_full_value(PyObject *shape_obj, qdd_t fill)
+{
+  int nd;
+  npy_intp i;
+  npy_intp size;
+  npy_intp *dims = NULL;
+  PyArrayObject *arr;
+  qdd_t *data;
+
+  if (ddarray_parse_shape(shape_obj, &nd, &dims) < 0) {
+    return NULL;
+  }
+
+  arr = DDArray_new_empty(nd, dims);
+  PyMem_Free(dims);
+  if (arr == NULL) {
+    return NULL;
+  }
+
+  size = PyArray_SIZE(arr);
+  data = (qdd_t *)PyArray_DATA(arr);
+  for (i = 0; i < size; ++i) {
+    data[i] = fill;
+  }
+  return (PyObject *)arr;
+}
+
+static PyObject *
+ddarray_zeros(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *shape_obj;
+
+  if (!PyArg_ParseTuple(args, "O", &shape_obj)) {
+    return NULL;
+  }
+  return ddarray_full_value(shape_obj, qdd_from_double(0.0));
+}
+
+static PyObject *
+ddarray_ones(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *shape_obj;
+
+  if (!PyArg_ParseTuple(args, "O", &shape_obj)) {
+    return NULL;
+  }
+  return ddarray_full_value(shape_obj, qdd_from_double(1.0));
+}
+
+static PyObject *
+ddarray_full(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *shape_obj;
+  PyObject *fill_obj;
+  qdd_t fill;
+
+  if (!PyArg_ParseTuple(args, "OO", &shape_obj, &fill_obj)) {
+    return NULL;
+  }
+  if (DDArray_setitem(fill_obj, &fill, NULL) < 0) {
+    return NULL;
+  }
+  return ddarray_full_value(shape_obj, fill);
+}
+
+static PyObject *
+ddarray_empty(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *shape_obj;
+  int nd;
+  npy_intp *dims = NULL;
+  PyArrayObject *arr;
+
+  if (!PyArg_ParseTuple(args, "O", &shape_obj)) {
+    return NULL;
+  }
+  if (ddarray_parse_shape(shape_obj, &nd, &dims) < 0) {
+    return NULL;
+  }
+
+  arr = DDArray_new_empty(nd, dims);
+  PyMem_Free(dims);
+  return (PyObject *)arr;
+}
+
+static PyObject *
+ddarray_from_list(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+  PyObject *seq;
+  Py_ssize_t i;
+  Py_ssize_t n;
+  npy_intp dims[1];
+  PyArrayObject *arr;
+  qdd_t *data;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+
+  seq = PySequence_Fast(obj, "from_list requires a sequence");
+  if (seq == NULL) {
+    return NULL;
+  }
+
+  n = PySequence_Size(seq);
+  if (n < 0) {
+    Py_DECREF(seq);
+    return NULL;
+  }
+  dims[0] = (npy_intp)n;
+  arr = DDArray_new_empty(1, dims);
+  if (arr == NULL) {
+    Py_DECREF(seq);
+    return NULL;
+  }
+
+  data = (qdd_t *)PyArray_DATA(arr);
+  for (i = 0; i < n; ++i) {
+    PyObject *item = PySequence_GetItem(seq, i);
+    if (item == NULL) {
+      Py_DECREF(arr);
+      Py_DECREF(seq);
+      return NULL;
+    }
+    if (DDArray_setitem(item, &data[i], arr) < 0) {
+      Py_DECREF(item);
+      Py_DECREF(arr);
+      Py_DECREF(seq);
+      return NULL;
+    }
+    Py_DECREF(item);
+  }
+
+  Py_DECREF(seq);
+  return (PyObject *)arr;
+}
+
+static PyObject *
+ddarray_from_array(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+
+  return ddarray_from_object(obj, 1);
+}
+
+static PyObject *
+ddarray_asarray(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {"values", "copy", NULL};
+  PyObject *obj;
+  int copy = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|p", kwlist, &obj, &copy)) {
+    return NULL;
+  }
+
+  return ddarray_from_object(obj, copy);
+}
+
+static PyObject *
+ddarray_empty_like(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+  PyArrayObject *input;
+  PyArrayObject *arr;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+
+  input = (PyArrayObject *)PyArray_FROM_O(obj);
+  if (input == NULL) {
+    return NULL;
+  }
+
+  arr = DDArray_new_empty(PyArray_NDIM(input), PyArray_DIMS(input));
+  Py_DECREF(input);
+  return (PyObject *)arr;
+}
+
+static PyObject *
+ddarray_full_like_value(PyObject *obj, qdd_t fill)
+{
+  PyArrayObject *input;
+  PyArrayObject *arr;
+  qdd_t *data;
+  npy_intp i;
+  npy_intp n;
+
+  input = (PyArrayObject *)PyArray_FROM_O(obj);
+  if (input == NULL) {
+    return NULL;
+  }
+
+  arr = DDArray_new_empty(PyArray_NDIM(input), PyArray_DIMS(input));
+  Py_DECREF(input);
+  if (arr == NULL) {
+    return NULL;
+  }
+
+  data = (qdd_t *)PyArray_DATA(arr);
+  n = PyArray_SIZE(arr);
+  for (i = 0; i < n; ++i) {
+    data[i] = fill;
+  }
+
+  return (PyObject *)arr;
+}
+
+static PyObject *
+ddarray_zeros_like(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+  return ddarray_full_like_value(obj, qdd_from_double(0.0));
+}
+
+static PyObject *
+ddarray_ones_like(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+  return ddarray_full_like_value(obj, qdd_from_double(1.0));
+}
+
+static PyObject *
+ddarray_full_like(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+  PyObject *value;
+  qdd_t fill;
+
+  if (!PyArg_ParseTuple(args, "OO", &obj, &value)) {
+    return NULL;
+  }
+  if (DDArray_setitem(value, &fill, NULL) < 0) {
+    return NULL;
+  }
+  return ddarray_full_like_value(obj, fill);
+}
+
+static PyMethodDef DDArrayMethods[] = {
+  {"empty", ddarray_empty, METH_VARARGS, "Create an uninitialized ddarray."},
+  {"full", ddarray_full, METH_VARARGS, "Create a ddarray filled with a value."},
+  {"zeros", ddarray_zeros, METH_VARARGS, "Create a ddarray of zeros."},
+  {"ones", ddarray_ones, METH_VARARGS, "Create a ddarray of ones."},
+  {"from_list", ddarray_from_list, METH_VARARGS, "Create a ddarray from a Python sequence."},
+  {"from_array", ddarray_from_array, METH_VARARGS, "Create a ddarray from an array-like object."},
+  {"asarray", (PyCFunction)ddarray_asarray, METH_VARARGS | METH_KEYWORDS, "Create a ddarray from an array-like object, copying only if needed."},
+  {"empty_like", ddarray_empty_like, METH_VARARGS, "Create an empty ddarray with the same shape as input."},
+  {"zeros_like", ddarray_zeros_like, METH_VARARGS, "Create a zero-filled ddarray with the same shape as input."},
+  {"ones_like", ddarray_ones_like, METH_VARARGS, "Create a one-filled ddarray with the same shape as input."},
+  {"full_like", ddarray_full_like, METH_VARARGS, "Create a ddarray filled with a value and the same shape as input."},
+  {NULL, NULL, 0, NULL},
+};
+
+static PyModuleDef DDArrayModule = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "ddarray",
+    .m_doc = "Double-double precision module for arrays.",
+    .m_methods = DDArrayMethods,
+    .m_size = -1,
+};
+
+
+// Normalised pairs order on hi first and then on lo
+static inline bool
+DDArray_lt(qdd_t a, qdd_t b)
+{
+  return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+static npy_bool
+DDArray_nonzero(qdd_t *ip, void *NPY_UNUSED(arr))
+{
+  // lo is zero whenever hi is, this also keeps -0.0 falsy
+  return ip->hi != 0;
+}
+
+static void
+DDArray_copyswap(qdd_t *dst, qdd_t *src, int swap, void *NPY_UNUSED(arr))
+{
+  if (src == NULL) {
+    src = dst;
+  }
+  if (src != dst) {
+    memcpy(dst, src, sizeof(qdd_t));
+  }
+
+  // Byte swap each double in place, hi stays first
+  if (swap != 0) {
+    qdd_double_bits bits;
+
+    bits.f = dst->hi;
+    bits.u = __builtin_bswap64(bits.u);
+    dst->hi = bits.f;
+    bits.f = dst->lo;
+    bits.u = __builtin_bswap64(bits.u);
+    dst->lo = bits.f;
+  }
+}
+
+static void
+DDArray_copyswapn(void *dst, npy_intp dstride, void *src,
+                  npy_intp sstride, npy_intp n, int swap, void *arr)
+{
+  npy_intp i;
+  char *dstptr = dst;
+  char *srcptr = src;
+
+  if (src == NULL) {
+    if (swap == 0) {
+      return;
+    }
+    srcptr = dstptr;
+    sstride = dstride;
+  }
+
+  for (i = 0; i < n; i++) {
+    DDArray_copyswap((qdd_t *)dstptr, (qdd_t *)srcptr, swap, arr);
+    dstptr += dstride;
+    srcptr += sstride;
+  }
+}
+
+static int DDArray_setitem(PyObject* item, qdd_t* data, void* array){
+  qdd_t tmp;
+
+  if (!PyObject_to_DDObject(item, &tmp)) {
+    if (!PyErr_Occurred()) {
+      PyErr_SetString(PyExc_TypeError, "Failed to setitem in DDArray");
+    }
+    return -1;
+  }
+  // data may be unaligned, or in a non-native byte order array
+  DDArray_copyswap(&tmp, NULL, array != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)array), NULL);
+  memcpy(data, &tmp, sizeof(tmp));
+  return 0;
+}
+
+static PyObject *
+DDArray_getitem(qdd_t* data, void* arr)
+{
+  qdd_t tmp;
+
+  memcpy(&tmp, data, sizeof(tmp));
+  DDArray_copyswap(&tmp, NULL, arr != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)arr), NULL);
+  return DDObject_to_PyObject(tmp);
+}
+
+static int
+DDArray_compare(qdd_t *pa, qdd_t *pb, PyArrayObject *NPY_UNUSED(ap))
+{
+  npy_bool anan, bnan;
+
+  anan = isnan(pa->hi);
+  bnan = isnan(pb->hi);
+
+  if (anan) {
+    return bnan ? 0 : -1;
+  }
+  if (bnan) {
+    return 1;
+  }
+  if (DDArray_lt(*pa, *pb)) {
+    return -1;
+  }
+  if (DDArray_lt(*pb, *pa)) {
+    return 1;
+  }
+  return 0;
+}
+
+static int
+DDArray_argmax(qdd_t *ip, npy_intp n, npy_intp *max_ind, PyArrayObject *NPY_UNUSED(aip))
+{
+  npy_intp i;
+  qdd_t mp = *ip;
+
+  *max_ind = 0;
+
+  if (isnan(mp.hi)) {
+    // nan encountered; it's maximal
+    return 0;
+  }
+
+  for (i = 1; i < n; i++) {
+    ip++;
+    if (isnan(ip->hi)) {
+      // nan encountered, it's maximal
+      *max_ind = i;
+      break;
+    }
+    if (DDArray_lt(mp, *ip)) {
+      mp = *ip;
+      *max_ind = i;
+    }
+  }
+  return 0;
+}
+
+static int
+DDArray_argmin(qdd_t *ip, npy_intp n, npy_intp *min_ind, PyArrayObject *NPY_UNUSED(aip))
+{
+  npy_intp i;
+  qdd_t mp = *ip;
+
+  *min_ind = 0;
+
+  if (isnan(mp.hi)) {
+    // nan encountered; it's minimal
+    return 0;
+  }
+
+  for (i = 1; i < n; i++) {
+    ip++;
+    if (isnan(ip->hi)) {
+      // nan encountered, it's minimal
+      *min_ind = i;
+      break;
+    }
+    if (DDArray_lt(*ip, mp)) {
+      mp = *ip;
+      *min_ind = i;
+    }
+  }
+  return 0;
+}
+
+static void
+DDArray_fillwithscalar(qdd_t *buffer, npy_intp length, qdd_t *value, void *NPY_UNUSED(ignored))
+{
+  npy_intp i;
+  qdd_t val = *value;
+
+  for (i = 0; i < length; ++i) {
+    buffer[i] = val;
+  }
+}
+
+PyMODINIT_FUNC
+PyInit_ddarray(void)
+{
+
+    PyObject *m;
+    PyObject *qarray_mod;
+    PyObject *qarray_type_num_obj;
+    int ddarrayNum;
+
+    m = PyModule_Create(&DDArrayModule);
+    if (m == NULL)
+        return NULL;
+
+    if (import_qmddfloat() < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    qarray_mod = PyImport_ImportModule("pyquadp.qarray");
+    if (qarray_mod == NULL) {
+      Py_DECREF(m);
+      return NULL;
+    }
+    qarray_type_num_obj = PyObject_GetAttrString(qarray_mod, "dtype_num");
+    Py_DECREF(qarray_mod);
+    if (qarray_type_num_obj == NULL) {
+      Py_DECREF(m);
+      return NULL;
+    }
+    QuadArrayTypeNum = (int)PyLong_AsLong(qarray_type_num_obj);
+    Py_DECREF(qarray_type_num_obj);
+    if (QuadArrayTypeNum < 0 && PyErr_Occurred()) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    // Initialize numpy
+    import_array();
+    if (PyErr_Occurred()) {
+      Py_DECREF(m);
+        return NULL;
+    }
+    import_umath();
+    if (PyErr_Occurred()) {
+      Py_DECREF(m);
+        return NULL;
+    }
+
+    PyArray_InitArrFuncs(&DDArrayFuncs);
+    DDArrayFuncs.nonzero = (PyArray_NonzeroFunc*) DDArray_nonzero;
+    DDArrayFuncs.copyswap = (PyArray_CopySwapFunc*) DDArray_copyswap;
+    DDArrayFuncs.copyswapn = (PyArray_CopySwapNFunc*) DDArray_copyswapn;
+    DDArrayFuncs.setitem = (PyArray_SetItemFunc*) DDArray_setitem;
+    DDArrayFuncs.getitem = (PyArray_GetItemFunc*) DDArray_getitem;
+    DDArrayFuncs.compare = (PyArray_CompareFunc*) DDArray_compare;
+    DDArrayFuncs.argmax = (PyArray_ArgFunc*) DDArray_argmax;
+    DDArrayFuncs.argmin = (PyArray_ArgFunc*) DDArray_argmin;
+    DDArrayFuncs.fillwithscalar = (PyArray_FillWithScalarFunc*) DDArray_fillwithscalar;
+
+
+    DDArrayDescrProto = (PyArray_DescrProto){
+      .typeobj = &DDType,
+      .kind = 'V',
+      .type = 'd',
+      .byteorder = '=',
+      .flags = NPY_NEEDS_PYAPI | NPY_USE_GETITEM | NPY_USE_SETITEM,
+      .type_num = 0, // assigned at registration
+      .elsize = sizeof(qdd_t),
+      .alignment = alignof(qdd_t),
+      .f = &DDArrayFuncs,
+      .subarray = NULL,
+      .fields = NULL,
+      .names = NULL,
+      .metadata = NULL,
+      .c_metadata = NULL,
+    };
+
+    Py_SET_TYPE(&DDArrayDescrProto, &PyArrayDescr_Type);
+
+    Py_INCREF(&DDType);
+    ddarrayNum = PyArray_RegisterDataType(&DDArrayDescrProto);
+
+    if (ddarrayNum < 0) {
+      Py_DECREF(m);
+        return NULL;
+    }
+    DDArrayTypeNum = ddarrayNum;
+    DDArrayDescr = PyArray_DescrFromType(ddarrayNum);
+    if (DDArrayDescr == NULL) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    if (DDArray_register_casts(DDArrayDescr) < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    if (DDArray_register_ufuncs() < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    if (PyModule_AddObjectRef(m, "ddarray", (PyObject *)&DDType) < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+    if (PyModule_AddIntConstant(m, "dtype_num", ddarrayNum) < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+    if (PyModule_AddObjectRef(m, "dtype", (PyObject *)DDArrayDescr) < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    return m;
+}
@@ -0,0 +1,27 @@
+from collections.abc import Sequence
+from typing import Any, TypeAlias
+
+import numpy as np
+from numpy.typing import ArrayLike, NDArray
+
+from .qmddfloat import ddfloat
+from .qmfloat import qfloat
+
+DDFloatLike: TypeAlias = ddfloat | qfloat | float | int | str
+ShapeLike: TypeAlias = int | tuple[int, ...]
+
+ddarray: Any
+dtype: np.dtype[Any]
+dtype_num: int
+
+def empty(shape: ShapeLike) -> NDArray[Any]: ...
+def full(shape: ShapeLike, value: DDFloatLike) -> NDArray[Any]: ...
+def zeros(shape: ShapeLike) -> NDArray[Any]: ...
+def ones(shape: ShapeLike) -> NDArray[Any]: ...
+def from_list(values: Sequence[DDFloatLike]) -> NDArray[Any]: ...
+def from_array(values: ArrayLike) -> NDArray[Any]: ...
+def asarray(values: ArrayLike, *, copy: bool = ...) -> NDArray[Any]: ...
+def empty_like(values: ArrayLike) -> NDArray[Any]: ...
+def zeros_like(values: ArrayLike) -> NDArray[Any]: ...
+def ones_like(values: ArrayLike) -> NDArray[Any]: ...
+def full_like(values: ArrayLike, value: DDFloatLike) -> NDArray[Any]: ...
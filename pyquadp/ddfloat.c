@@ -0,0 +1,665 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#define DDFLOAT_MODULE
+#include "ddfloat.h"
+#include "qddmath.h"
+#include "qfloat.h"
+
+static PyTypeObject *DDType = NULL;
+
+
+static PyObject *
+DDObject_repr(DDObject * obj)
+{
+    char buf[DD_BUF];
+
+    int n = quadmath_snprintf (buf, sizeof buf, "%.32Qe", qdd_to_quad(obj->value));
+    if ((size_t) n < sizeof buf)
+        return PyUnicode_FromFormat("ddfloat('%s')",
+                                buf);
+    else
+        return PyUnicode_FromFormat("%s","Bad double-double");
+
+}
+
+
+static PyObject *
+DDObject_str(DDObject * obj)
+{
+    char buf[DD_BUF];
+
+    int n = quadmath_snprintf (buf, sizeof buf, "%.32Qe", qdd_to_quad(obj->value));
+    if ((size_t) n < sizeof buf)
+        return PyUnicode_FromFormat("%s",buf);
+    else
+        return PyUnicode_FromFormat("%s","Bad double-double");
+}
+
+
+static PyObject *
+DDObject_conversion_failed(void){
+    // Conversions that fail on an unsupported type leave no error set
+    if (PyErr_Occurred()) {
+        return NULL;
+    }
+    Py_RETURN_NOTIMPLEMENTED;
+}
+
+
+static PyObject *
+DDObject_to_qfloat_object(PyObject * obj){
+    QuadObject q;
+    qdd_t value;
+
+    if (!DDObject_Check(obj)) {
+        Py_INCREF(obj);
+        return obj;
+    }
+
+    value = ((DDObject *) obj)->value;
+    q.value = qdd_to_quad(value);
+    return QuadObject_to_PyObject(q);
+}
+
+
+static PyObject *
+DDObject_promote_op2(const int op, PyObject * o1, PyObject * o2){
+    // Mixing with a qfloat gives a qfloat, like float with qfloat
+    PyObject *q1, *q2, *result;
+
+    q1 = DDObject_to_qfloat_object(o1);
+    if (q1 == NULL) {
+        return NULL;
+    }
+    q2 = DDObject_to_qfloat_object(o2);
+    if (q2 == NULL) {
+        Py_DECREF(q1);
+        return NULL;
+    }
+
+    switch(op){
+        case OP_add:
+            result = PyNumber_Add(q1, q2);
+            break;
+        case OP_sub:
+            result = PyNumber_Subtract(q1, q2);
+            break;
+        case OP_mult:
+            result = PyNumber_Multiply(q1, q2);
+            break;
+        case OP_true_divide:
+            result = PyNumber_TrueDivide(q1, q2);
+            break;
+        default:
+            result = Py_NewRef(Py_NotImplemented);
+    }
+
+    Py_DECREF(q1);
+    Py_DECREF(q2);
+    return result;
+}
+
+
+static PyObject *
+DDObject_binary_op1(const int op, PyObject * o1){
+
+    qdd_t d1, result;
+
+    if(!PyObject_to_DDObject(o1, &d1)){
+        return DDObject_conversion_failed();
+    }
+
+    switch(op){
+        case OP_negative:
+            result = qdd_neg(d1);
+            break;
+        case OP_positive:
+            result = d1;
+            break;
+        case OP_absolute:
+            result = d1.hi < 0 ? qdd_neg(d1) : d1;
+            break;
+        default:
+            Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    return DDObject_to_PyObject(result);
+}
+
+
+static PyObject *
+DDObject_binary_op2(const int op, PyObject * o1, PyObject * o2 ){
+
+    qdd_t d1, d2, result;
+
+    if(QuadObject_Check(o1) || QuadObject_Check(o2)){
+        return DDObject_promote_op2(op, o1, o2);
+    }
+
+    if(!PyObject_to_DDObject(o1, &d1)){
+        return DDObject_conversion_failed();
+    }
+
+    if(!PyObject_to_DDObject(o2, &d2)){
+        return DDObject_conversion_failed();
+    }
+
+    switch(op){
+        case OP_add:
+            result = qdd_ieee_add(d1, d2);
+            break;
+        case OP_sub:
+            result = qdd_ieee_sub(d1, d2);
+            break;
+        case OP_mult:
+            result = qdd_ieee_mul(d1, d2);
+            break;
+        case OP_true_divide:
+            result = qdd_ieee_div(d1, d2);
+            break;
+        default:
+            Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    return DDObject_to_PyObject(result);
+}
+
+
+static PyObject *
+DDObject_add(PyObject * o1, PyObject * o2 ){
+    return DDObject_binary_op2(OP_add, o1, o2);
+}
+
+static PyObject *
+DDObject_subtract(PyObject * o1, PyObject * o2 ){
+    return DDObject_binary_op2(OP_sub, o1, o2);
+}
+
+static PyObject *
+DDObject_mult(PyObject * o1, PyObject * o2 ){
+    return DDObject_binary_op2(OP_mult, o1, o2);
+}
+
+static PyObject *
+DDObject_true_divide(PyObject * o1, PyObject * o2 ){
+    return DDObject_binary_op2(OP_true_divide, o1, o2);
+}
+
+static PyObject *
+DDObject_neg(PyObject * o1){
+    return DDObject_binary_op1(OP_negative, o1);
+}
+
+static PyObject *
+DDObject_pos(PyObject * o1){
+    return DDObject_binary_op1(OP_positive, o1);
+}
+
+static PyObject *
+DDObject_abs(PyObject * o1){
+    return DDObject_binary_op1(OP_absolute, o1);
+}
+
+static int DDObject_bool(PyObject * o1){
+    return ((DDObject *) o1)->value.hi != 0;
+}
+
+static PyObject *
+DDObject_int(PyObject * o1){
+    qdd_t d = ((DDObject *) o1)->value;
+    PyObject *hi, *lo, *result;
+    double frac;
+
+    // A non-integral hi has no integer within lo of it, otherwise round lo
+    // towards zero relative to the sign of the whole value
+    if (!isfinite(d.hi) || trunc(d.hi) != d.hi) {
+        return PyLong_FromDouble(d.hi);
+    }
+    frac = d.hi > 0 ? floor(d.lo) : ceil(d.lo);
+
+    hi = PyLong_FromDouble(d.hi);
+    if (hi == NULL) {
+        return NULL;
+    }
+    lo = PyLong_FromDouble(frac);
+    if (lo == NULL) {
+        Py_DECREF(hi);
+        return NULL;
+    }
+    result = PyNumber_Add(hi, lo);
+    Py_DECREF(hi);
+    Py_DECREF(lo);
+    return result;
+}
+
+static PyObject *
+DDObject_float(PyObject * o1){
+    return PyFloat_FromDouble(((DDObject *) o1)->value.hi);
+}
+
+
+static PyObject *
+DDType_RichCompare(PyObject * o1, PyObject * o2, int opid){
+    qdd_t d1, d2;
+    int lt, eq;
+    bool res;
+
+    if(QuadObject_Check(o1) || QuadObject_Check(o2)){
+        PyObject *q1, *q2, *ret;
+
+        q1 = DDObject_to_qfloat_object(o1);
+        if (q1 == NULL) {
+            return NULL;
+        }
+        q2 = DDObject_to_qfloat_object(o2);
+        if (q2 == NULL) {
+            Py_DECREF(q1);
+            return NULL;
+        }
+        ret = PyObject_RichCompare(q1, q2, opid);
+        Py_DECREF(q1);
+        Py_DECREF(q2);
+        return ret;
+    }
+
+    if(!PyObject_to_DDObject(o1, &d1)){
+        return DDObject_conversion_failed();
+    }
+
+    if(!PyObject_to_DDObject(o2, &d2)){
+        return DDObject_conversion_failed();
+    }
+
+    if (isnan(d1.hi) || isnan(d2.hi)) {
+        if (opid == Py_NE) {
+            Py_RETURN_TRUE;
+        }
+        Py_RETURN_FALSE;
+    }
+
+    // Normalised pairs order on hi first and then on lo
+    lt = d1.hi < d2.hi || (d1.hi == d2.hi && d1.lo < d2.lo);
+    eq = d1.hi == d2.hi && d1.lo == d2.lo;
+
+    switch (opid){
+        case Py_EQ:
+            res = eq;
+            break;
+        case Py_NE:
+            res = !eq;
+            break;
+        case Py_LE:
+            res = lt || eq;
+            break;
+        case Py_LT:
+            res = lt;
+            break;
+        case Py_GT:
+            res = !lt && !eq;
+            break;
+        case Py_GE:
+            res = !lt;
+            break;
+        default:
+            PyErr_SetString(PyExc_AttributeError, "Unknown comparison function.");
+            return NULL;
+    }
+
+    return PyBool_FromLong(res);
+}
+
+
+static PyObject * DDObject_to_bytes(DDObject * self, PyObject * args){
+    return PyBytes_FromStringAndSize(self->bytes, sizeof(qdd_t));
+}
+
+
+static PyObject * DDObject_from_bytes(PyTypeObject *type, PyObject * arg){
+    // Gets the type object not an instance in type
+    // As its METH_O we dont need to unpack arg
+    qdd_t res;
+
+    if(!PyBytes_Check(arg)){
+        PyErr_SetString(PyExc_TypeError, "Expected a bytes object");
+        return NULL;
+    }
+
+    if(PyBytes_Size(arg) == sizeof(res)){
+        memcpy(&res, PyBytes_AsString(arg), sizeof(res));
+    } else{
+        PyErr_SetString(PyExc_ValueError, "Byte array wrong size for a double-double");
+        return NULL;
+    }
+
+    return DDObject_to_PyObject(res);
+}
+
+
+static PyObject * DDObject_to_qfloat(DDObject * self, PyObject *Py_UNUSED(ignored)){
+    return DDObject_to_qfloat_object((PyObject *) self);
+}
+
+
+//Pickling
+static PyObject *DDObject_unpickle = NULL;
+
+// Module level _from_bytes, so a pickle names it once and then holds only the
+// raw bytes of each ddfloat
+static PyObject *
+DDObject__from_bytes(PyObject *module, PyObject *arg) {
+    (void)module;
+    return DDObject_from_bytes(DDType, arg);
+}
+
+static PyObject *
+DDObject___reduce__(DDObject *self, PyObject *Py_UNUSED(ignored)) {
+    PyObject *bytes_obj = DDObject_to_bytes(self, NULL);
+
+    if (bytes_obj == NULL) {
+        return NULL;
+    }
+    return Py_BuildValue("O(N)", DDObject_unpickle, bytes_obj);
+}
+
+
+static Py_hash_t DDObject_hash(DDObject *self){
+    // Values that are exactly a double hash like that float, so that
+    // ddfloat(1.5) == 1.5 keeps hash(ddfloat(1.5)) == hash(1.5)
+    PyObject *obj;
+    Py_hash_t h;
+
+    if (self->value.lo == 0) {
+        obj = PyFloat_FromDouble(self->value.hi);
+    } else {
+        obj = Py_BuildValue("(dd)", self->value.hi, self->value.lo);
+    }
+    if (obj == NULL) {
+        return -1;
+    }
+
+    h = PyObject_Hash(obj);
+    Py_DECREF(obj);
+    return h;
+}
+
+
+static PyObject* DDObject_get_hi(PyObject * self, void * y){
+    return PyFloat_FromDouble(((DDObject *) self)->value.hi);
+}
+
+static PyObject* DDObject_get_lo(PyObject * self, void * y){
+    return PyFloat_FromDouble(((DDObject *) self)->value.lo);
+}
+
+
+static PyMethodDef DD_methods[] = {
+    {"to_bytes", (PyCFunction) DDObject_to_bytes, METH_NOARGS, "to_bytes"},
+    {"from_bytes", (PyCFunction) DDObject_from_bytes, METH_CLASS|METH_O, "from_bytes"},
+    {"to_qfloat", (PyCFunction) DDObject_to_qfloat, METH_NOARGS, "Convert to a qfloat, rounding to quad precision."},
+    {"__reduce__", (PyCFunction) DDObject___reduce__, METH_NOARGS, "Pickle a ddfloat as its raw bytes" },
+    {NULL}  /* Sentinel */
+};
+
+// Properties
+static PyGetSetDef DD_cgetset[] = {
+    {"hi", DDObject_get_hi, NULL, "Leading double" },
+    {"lo", DDObject_get_lo, NULL, "Trailing double" },
+    {NULL}  /* Sentinel */
+};
+
+static int
+DD_init(DDObject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject * obj;
+    PyObject * lo_obj = NULL;
+    qdd_t lo;
+    (void)kwds;
+
+    if (!PyArg_ParseTuple(args, "O|O:", &obj, &lo_obj)){
+        return -1;
+    }
+
+    if(!PyObject_to_DDObject(obj, &self->value)){
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError, "Can not convert value to double-double precision.");
+        }
+        return -1;
+    }
+
+    if (lo_obj != NULL) {
+        // ddfloat(hi, lo) builds the (renormalised) sum hi + lo
+        if(!PyObject_to_DDObject(lo_obj, &lo)){
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_TypeError, "Can not convert value to double-double precision.");
+            }
+            return -1;
+        }
+        self->value = qdd_ieee_add(self->value, lo);
+    }
+
+    return 0;
+}
+
+
+static PyType_Slot DDType_slots[] = {
+    {Py_tp_doc, (void *)PyDoc_STR("A single double-double precision variable")},
+    {Py_tp_new, (void *)PyType_GenericNew},
+    {Py_tp_repr, (void *)DDObject_repr},
+    {Py_tp_str, (void *)DDObject_str},
+    {Py_tp_methods, (void *)DD_methods},
+    {Py_tp_init, (void *)DD_init},
+    {Py_tp_getset, (void *)DD_cgetset},
+    {Py_tp_richcompare, (void *)DDType_RichCompare},
+    {Py_tp_hash, (void *)DDObject_hash},
+
+    {Py_nb_add, (void *)DDObject_add},
+    {Py_nb_subtract, (void *)DDObject_subtract},
+    {Py_nb_multiply, (void *)DDObject_mult},
+    {Py_nb_negative, (void *)DDObject_neg},
+    {Py_nb_positive, (void *)DDObject_pos},
+    {Py_nb_absolute, (void *)DDObject_abs},
+    {Py_nb_bool, (void *)DDObject_bool},
+    {Py_nb_int, (void *)DDObject_int},
+    {Py_nb_float, (void *)DDObject_float},
+    {Py_nb_true_divide, (void *)DDObject_true_divide},
+    {0, NULL}
+};
+
+static PyType_Spec DDType_spec = {
+    .name = "pyquadp.qmddfloat.ddfloat",
+    .basicsize = sizeof(DDObject),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT,
+    .slots = DDType_slots,
+};
+
+static PyMethodDef DDModule_methods[] = {
+    {"_from_bytes", (PyCFunction) DDObject__from_bytes, METH_O, "Un-pickle a ddfloat from its raw bytes"},
+    {NULL}  /* Sentinel */
+};
+
+static PyModuleDef DDModule = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "qmddfloat",
+    .m_doc = PyDoc_STR("Double-double precision module for scalar ddfloat's."),
+    .m_size = -1,
+    .m_methods = DDModule_methods,
+};
+
+static PyObject*
+DDObject_to_PyObject(qdd_t value) {
+    DDObject* ret;
+
+    if (DDType == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "ddfloat type not initialized");
+        return NULL;
+    }
+
+    ret = (DDObject*) PyType_GenericAlloc(DDType, 0);
+
+    if (ret != NULL) {
+        ret->value = value;
+    }
+
+    return (PyObject*) ret;
+}
+
+
+static bool
+PyLong_to_DD(PyObject * in, qdd_t * out)
+{
+    long long v;
+    int overflow;
+    PyObject *hi_obj, *rem;
+
+    v = PyLong_AsLongLongAndOverflow(in, &overflow);
+    if (v == -1 && PyErr_Occurred()) {
+        return false;
+    }
+    if (!overflow) {
+        out->hi = (double) v;
+        out->lo = (double) ((__int128) v - (__int128) out->hi);
+        return true;
+    }
+
+    // Round to the nearest double and then take what is left over
+    out->hi = PyLong_AsDouble(in);
+    if (out->hi == -1.0 && PyErr_Occurred()) {
+        return false;
+    }
+    hi_obj = PyLong_FromDouble(out->hi);
+    if (hi_obj == NULL) {
+        return false;
+    }
+    rem = PyNumber_Subtract(in, hi_obj);
+    Py_DECREF(hi_obj);
+    if (rem == NULL) {
+        return false;
+    }
+    out->lo = PyLong_AsDouble(rem);
+    Py_DECREF(rem);
+    if (out->lo == -1.0 && PyErr_Occurred()) {
+        return false;
+    }
+    return true;
+}
+
+
+static bool
+PyObject_to_DDObject(PyObject * in, qdd_t * out)
+{
+    QuadObject q;
+
+    if(DDObject_Check(in)){
+        *out = ((DDObject *) in)->value;
+        return true;
+    }
+
+    if(PyFloat_Check(in)){
+        *out = qdd_from_double(PyFloat_AsDouble(in));
+        return true;
+    }
+
+    if(PyLong_Check(in)){
+        return PyLong_to_DD(in, out);
+    }
+
+    // qfloat and strings are parsed at quad precision and then rounded
+    if(QuadObject_Check(in) || PyUnicode_Check(in)){
+        if(!PyObject_to_QuadObject(in, &q, true)){
+            return false;
+        }
+        *out = qdd_from_quad_rn(q.value);
+        return true;
+    }
+
+    return false;
+}
+
+static bool DDObject_Check(PyObject * obj){
+    if(DDType != NULL && PyObject_TypeCheck(obj, DDType))
+        return true;
+    return false;
+}
+
+
+PyMODINIT_FUNC
+PyInit_qmddfloat(void)
+{
+    PyObject *m;
+    static void *PyDDfloat_API[PyDDfloat_API_pointers];
+    PyObject *c_api_object;
+    PyObject *dd_type_obj;
+    PyObject *module_name_obj;
+
+    if (import_qmfloat() < 0)
+        return NULL;
+
+    m = PyModule_Create(&DDModule);
+    if (m == NULL)
+        return NULL;
+
+    DDObject_unpickle = PyObject_GetAttrString(m, "_from_bytes");
+    if (DDObject_unpickle == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    dd_type_obj = PyType_FromSpec(&DDType_spec);
+    if (dd_type_obj == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+    module_name_obj = PyUnicode_FromString("pyquadp.qmddfloat");
+    if (module_name_obj == NULL) {
+        Py_DECREF(dd_type_obj);
+        Py_DECREF(m);
+        return NULL;
+    }
+    if (PyObject_SetAttrString(dd_type_obj, "__module__", module_name_obj) < 0) {
+        Py_DECREF(module_name_obj);
+        Py_DECREF(dd_type_obj);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_DECREF(module_name_obj);
+
+    DDType = (PyTypeObject *)dd_type_obj;
+
+    /* Initialize the C API pointer array */
+    PyDDfloat_API[PyDDfloat_dd2py_NUM] = (void *)DDObject_to_PyObject;
+    PyDDfloat_API[PyDDfloat_py2dd_NUM] = (void *)PyObject_to_DDObject;
+    PyDDfloat_API[PyDDfloat_check_NUM] = (void *)DDObject_Check;
+    PyDDfloat_API[PyDDfloat_type_NUM] = (void *)DDType;
+
+    if (PyModule_AddObjectRef(m, "ddfloat", dd_type_obj) < 0) {
+        Py_DECREF(dd_type_obj);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_DECREF(dd_type_obj);
+
+
+    /* Create a Capsule containing the API pointer array's address */
+    c_api_object = PyCapsule_New((void *)PyDDfloat_API, "pyquadp.qmddfloat._C_API", NULL);
+    if (c_api_object == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    if (PyModule_AddObjectRef(m, "_C_API", c_api_object) < 0) {
+        Py_DECREF(c_api_object);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_DECREF(c_api_object);
+
+    if (PyDict_SetItemString(PyImport_GetModuleDict(), "qmddfloat", m) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+
+    return m;
+}
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+#include "pyquadp.h"
+
+#include "qdd.h"
+
+#ifndef Py_DDFLOAT_H
+#define Py_DDFLOAT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* C API functions */
+#define PyDDfloat_dd2py_NUM 0
+#define PyDDfloat_py2dd_NUM 1
+#define PyDDfloat_check_NUM 2
+#define PyDDfloat_type_NUM 3
+
+/* Total number of C API pointers */
+#define PyDDfloat_API_pointers 4
+
+#define DD_BUF 128
+
+// exported
+typedef struct {
+    PyObject_HEAD
+    union{
+    qdd_t value;
+    char bytes[sizeof(qdd_t)];
+    };
+} DDObject;
+
+#ifdef DDFLOAT_MODULE
+
+static PyObject* DDObject_to_PyObject(qdd_t value);
+static bool PyObject_to_DDObject(PyObject * in, qdd_t * out);
+static bool DDObject_Check(PyObject * obj);
+
+#else
+
+static void **PyDDfloat_API;
+
+#define DDObject_to_PyObject \
+ (*(PyObject * (*)(qdd_t)) PyDDfloat_API[PyDDfloat_dd2py_NUM])
+
+#define PyObject_to_DDObject \
+ (*(bool (*)(PyObject *, qdd_t *)) PyDDfloat_API[PyDDfloat_py2dd_NUM])
+
+#define DDObject_Check \
+(*(bool (*)(PyObject *)) PyDDfloat_API[PyDDfloat_check_NUM])
+
+#define DDType \
+(*(PyTypeObject *) PyDDfloat_API[PyDDfloat_type_NUM])
+
+/* Return -1 on error, 0 on success.
+ * PyCapsule_Import will set an exception if there's an error.
+ */
+static int
+import_qmddfloat(void)
+{
+    PyDDfloat_API = (void **)PyCapsule_Import("pyquadp.qmddfloat._C_API", 0);
+    return (PyDDfloat_API != NULL) ? 0 : -1;
+}
+
+#endif
+
+// end exported
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
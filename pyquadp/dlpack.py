@@ -0,0 +1,49 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+"""DLPack producers for quad arrays.
+
+Quad arrays are plain NumPy arrays, whose own ``__dlpack__`` rejects the
+quad dtypes. :class:`DLPackArray` wraps one as a DLPack producer backed by
+``qarray.to_dlpack`` and friends, so a consumer's ``from_dlpack`` shares
+its memory. The modules' own ``from_dlpack`` functions take any producer
+or capsule of the matching type.
+"""
+
+from . import qarray, qcarray, qiarray
+
+__all__ = ["DLPackArray"]
+
+# DLPack device type of CPU memory
+_CPU = (1, 0)
+_MODULES = (qarray, qcarray, qiarray)
+
+
+def _module_of(array, name):
+    # The array module whose dtype array has
+    for module in _MODULES:
+        if array.dtype.type is module.dtype.type:
+            return module
+    raise TypeError(f"{name} needs a qarray, qcarray or qiarray, not {array.dtype}")
+
+
+class DLPackArray:
+    """A qarray, qcarray or qiarray array as a DLPack producer.
+
+    qfloat and qint data is exported as 128 bit floats and integers. qcmplx
+    data is exported as 128 bit floats with an extra last dimension of 2, as
+    DLPack has no 256 bit complex type.
+    """
+
+    def __init__(self, array):
+        self.array = array
+        self._module = _module_of(array, "DLPackArray")
+
+    def __dlpack__(self, *, stream=None, max_version=None, dl_device=None, copy=None):
+        if stream is not None:
+            raise BufferError("stream must be None for CPU memory")
+        if dl_device is not None and tuple(dl_device) != _CPU:
+            raise BufferError(f"only CPU export is supported, not device {dl_device}")
+        return self._module.to_dlpack(self.array, max_version=max_version, copy=copy)
+
+    def __dlpack_device__(self):
+        return _CPU
@@ -0,0 +1,18 @@
+from typing import Any
+
+from numpy.typing import NDArray
+
+__all__ = ["DLPackArray"]
+
+class DLPackArray:
+    array: NDArray[Any]
+    def __init__(self, array: NDArray[Any]) -> None: ...
+    def __dlpack__(
+        self,
+        *,
+        stream: Any = ...,
+        max_version: tuple[int, int] | None = ...,
+        dl_device: tuple[int, int] | None = ...,
+        copy: bool | None = ...,
+    ) -> Any: ...
+    def __dlpack_device__(self) -> tuple[int, int]: ...
@@ -0,0 +1,266 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+"""Read and write Fortran unformatted sequential files.
+
+Each record is stored between two length markers of 4 bytes (the gfortran
+default) or 8 bytes (``-frecord-marker=8``). With 4 byte markers gfortran
+splits records of 2 GiB or more into subrecords whose markers carry a sign
+bit; these are handled on both read and write.
+
+A file opened for reading is memory mapped and its records are returned
+as views of the mapping, so ``real(16)`` and ``complex(16)`` data comes
+back as qarray and qcarray arrays without a copy. Arrays keep Fortran
+order: an item read as ``(qarray.dtype, (5, 3))`` is indexed as ``x(5, 3)``
+would be in Fortran.
+"""
+
+import os
+import sys
+
+import numpy as np
+
+from .npyio import _BLOCK
+
+__all__ = ["FortranFile", "FortranFormattingError"]
+
+_NATIVE = "<" if sys.byteorder == "little" else ">"
+# Largest subrecord gfortran writes with 4 byte markers
+_SUBRECORD = 2**31 - 9
+
+
+class FortranFormattingError(ValueError):
+    """The file does not hold valid record markers."""
+
+
+class FortranFile:
+    """A Fortran unformatted sequential file.
+
+    ``mode`` is ``'r'`` to read, ``'w'`` to write or ``'a'`` to append.
+    ``marker`` is the size in bytes of the record markers, 4 or 8, and
+    ``byteorder`` the byte order of both the markers and the data, as set
+    by gfortran's ``-fconvert``; ``'='`` is native.
+
+    Records read from a non-native file are views of the swapped dtype,
+    which NumPy converts as it goes; ``.astype(qarray.dtype)`` makes a
+    native copy.
+    """
+
+    def __init__(self, file, mode="r", *, marker=4, byteorder="="):
+        if mode not in ("r", "w", "a"):
+            raise ValueError(f"mode must be 'r', 'w' or 'a', not {mode!r}")
+        if marker not in (4, 8):
+            raise ValueError(f"marker must be 4 or 8, not {marker!r}")
+        if byteorder not in ("=", "<", ">"):
+            raise ValueError(f"byteorder must be '=', '<' or '>', not {byteorder!r}")
+
+        self.mode = mode
+        self.byteorder = _NATIVE if byteorder == "=" else byteorder
+        self._marker = np.dtype(f"i{marker}").newbyteorder(self.byteorder)
+        self._swap = self.byteorder != _NATIVE
+        self._fp = None
+        self._own_fp = False
+        self._data = None
+        self._pos = 0
+
+        if mode == "r":
+            self._data = self._map(file)
+        elif hasattr(file, "write"):
+            self._fp = file
+        else:
+            self._fp = open(file, mode + "b")
+            self._own_fp = True
+
+    @staticmethod
+    def _map(file):
+        if hasattr(file, "read"):
+            return np.frombuffer(file.read(), dtype=np.uint8)
+        if os.path.getsize(file) == 0:
+            return np.empty(0, dtype=np.uint8)
+        return np.memmap(file, dtype=np.uint8, mode="r")
+
+    def close(self):
+        """Close the file. Arrays already read keep the mapping alive."""
+        if self._own_fp:
+            self._fp.close()
+        self._fp = None
+        self._data = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def _readable(self):
+        if self._data is None:
+            raise ValueError("file is closed or not opened for reading")
+        return self._data
+
+    def _read_marker(self, pos):
+        data = self._readable()
+        end = pos + self._marker.itemsize
+        if end > data.size:
+            raise FortranFormattingError(f"record marker at byte {pos} runs past the end of the file")
+        return int(data[pos:end].view(self._marker)[0])
+
+    def _next_record(self):
+        # Byte ranges of the data of the next record, one per subrecord
+        data = self._readable()
+        if self._pos >= data.size:
+            raise EOFError("no more records in the file")
+
+        size = self._marker.itemsize
+        parts = []
+        pos = self._pos
+        more = True
+        while more:
+            head = self._read_marker(pos)
+            length = abs(head)
+            start = pos + size
+            tail = self._read_marker(start + length) if start + length <= data.size else None
+            if tail is None or abs(tail) != length:
+                raise FortranFormattingError(f"record at byte {pos} has mismatched length markers")
+            if (tail < 0) != bool(parts):
+                raise FortranFormattingError(f"record at byte {pos} has an unexpected continuation marker")
+            parts.append((start, start + length))
+            pos = start + length + size
+            more = head < 0
+        self._pos = pos
+        return parts
+
+    def read_record(self, *dtypes):
+        """Read the next record as one array per dtype.
+
+        Each item is a dtype or a ``(dtype, shape)`` pair. At most one item
+        may have an unknown length, given as a bare dtype or a ``-1`` in its
+        shape, which takes up what the other items leave of the record. A
+        single dtype gives a 1-d array of the whole record; several give a
+        tuple.
+
+        The arrays are views of the mapped file unless the record was split
+        into subrecords, when its pieces are joined into a copy.
+        """
+        if not dtypes:
+            raise ValueError("read_record needs at least one dtype")
+
+        items = []
+        flexible = None
+        fixed = 0
+        for i, item in enumerate(dtypes):
+            if isinstance(item, tuple):
+                dtype, shape = item
+                shape = (shape,) if np.ndim(shape) == 0 else tuple(shape)
+            else:
+                dtype, shape = item, (-1,)
+            dtype = np.dtype(dtype)
+            if self._swap and dtype.isnative:
+                dtype = dtype.newbyteorder(self.byteorder)
+            count = int(np.prod(shape, dtype=np.int64))
+            if -1 in shape:
+                if flexible is not None or shape.count(-1) != 1:
+                    raise ValueError("only one item of a record can have an unknown length")
+                flexible = i
+                count = -count
+            else:
+                fixed += count * dtype.itemsize
+            items.append((dtype, shape, count))
+
+        parts = self._next_record()
+        if len(parts) == 1:
+            start, end = parts[0]
+            raw = self._data[start:end]
+        else:
+            raw = np.concatenate([self._data[start:end] for start, end in parts])
+
+        if flexible is None:
+            if fixed != raw.size:
+                raise ValueError(f"record holds {raw.size} bytes but the dtypes need {fixed}")
+        else:
+            dtype, shape, count = items[flexible]
+            step = count * dtype.itemsize
+            if step == 0 or raw.size < fixed or (raw.size - fixed) % step:
+                raise ValueError(f"record of {raw.size} bytes does not fit the dtypes")
+            length = (raw.size - fixed) // step
+            shape = tuple(length if n == -1 else n for n in shape)
+            items[flexible] = (dtype, shape, count * length)
+
+        result = []
+        offset = 0
+        for dtype, shape, count in items:
+            nbytes = count * dtype.itemsize
+            arr = raw[offset : offset + nbytes].view(dtype)
+            result.append(arr.reshape(shape, order="F"))
+            offset += nbytes
+        return result[0] if len(result) == 1 else tuple(result)
+
+    def skip_record(self):
+        """Skip over the next record."""
+        self._next_record()
+
+    def write_record(self, *items):
+        """Write one record holding each item in turn, in Fortran order.
+
+        The data is written straight from each array, converted to the
+        file's byte order a block at a time when that is not native.
+        """
+        if self._fp is None:
+            raise ValueError("file is closed or not opened for writing")
+
+        arrays = [np.asanyarray(item) for item in items]
+        total = sum(arr.nbytes for arr in arrays)
+        limit = _SUBRECORD if self._marker.itemsize == 4 else max(total, 1)
+        # Subrecord lengths, the last one possibly short or empty
+        lengths = [limit] * (total // limit) + [total % limit]
+        if len(lengths) > 1 and lengths[-1] == 0:
+            lengths.pop()
+
+        writer = _RecordWriter(self._fp, self._marker, lengths)
+        for arr in arrays:
+            flat = arr.reshape(-1, order="F")
+            for start in range(0, flat.size, _BLOCK):
+                block = np.ascontiguousarray(flat[start : start + _BLOCK])
+                if block.dtype.isnative == self._swap:
+                    block = block.byteswap()
+                writer.write(memoryview(block.reshape(-1).view(np.uint8)))
+        writer.close()
+
+
+class _RecordWriter:
+    # Splits a record's bytes across its subrecords, adding the markers
+
+    def __init__(self, fp, marker, lengths):
+        self._fp = fp
+        self._marker = marker
+        self._lengths = lengths
+        self._index = 0
+        self._left = 0
+        self._start()
+
+    def _put_marker(self, value):
+        self._fp.write(np.array([value], dtype=self._marker).tobytes())
+
+    def _start(self):
+        length = self._lengths[self._index]
+        # Negative when more subrecords follow
+        more = self._index + 1 < len(self._lengths)
+        self._put_marker(-length if more else length)
+        self._left = length
+
+    def _end(self):
+        length = self._lengths[self._index]
+        # Negative when this continues an earlier subrecord
+        self._put_marker(-length if self._index else length)
+        self._index += 1
+
+    def write(self, data):
+        while len(data):
+            if not self._left:
+                self._end()
+                self._start()
+            n = min(self._left, len(data))
+            self._fp.write(data[:n])
+            data = data[n:]
+            self._left -= n
+
+    def close(self):
+        self._end()
@@ -0,0 +1,22 @@
+import os
+from typing import IO, Any
+
+from numpy.typing import ArrayLike, DTypeLike, NDArray
+
+_File = str | os.PathLike[str] | IO[bytes]
+_Item = DTypeLike | tuple[DTypeLike, int | tuple[int, ...]]
+
+__all__ = ["FortranFile", "FortranFormattingError"]
+
+class FortranFormattingError(ValueError): ...
+
+class FortranFile:
+    mode: str
+    byteorder: str
+    def __init__(self, file: _File, mode: str = ..., *, marker: int = ..., byteorder: str = ...) -> None: ...
+    def close(self) -> None: ...
+    def __enter__(self) -> FortranFile: ...
+    def __exit__(self, *exc: object) -> None: ...
+    def read_record(self, *dtypes: _Item) -> Any: ...
+    def skip_record(self) -> None: ...
+    def write_record(self, *items: ArrayLike) -> None: ...
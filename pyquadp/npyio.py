@@ -0,0 +1,365 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+"""Save and load quad arrays in NumPy's .npy and .npz formats, and as raw bytes.
+
+The quad dtypes have no descr string of their own, so ``np.save`` writes
+them as anonymous ``V16``/``V32`` bytes. Here the header holds a one field
+structured descr instead, whose field name is the tag, such as
+``[('pyquadp.qfloat<', '|V16')]`` for little endian qfloat data. The file
+stays a standard .npy: plain ``np.load`` reads it as a structured array
+that can be viewed as the quad dtype.
+
+Raw data in either byte order is read and written with
+:func:`frombuffer`, :func:`fromfile` and :func:`tofile`.
+
+The quad dtypes are pickled by the same tag, so arrays of them pickle with
+any protocol; :func:`reducer_override` lets protocol 5 pass their data out
+of band.
+"""
+
+import copyreg
+import os
+import pickle
+import sys
+import zipfile
+from collections.abc import Mapping
+
+import numpy as np
+from numpy.lib import format as _format
+
+from . import ddarray, qarray, qcarray, qiarray, qqarray
+
+__all__ = ["save", "load", "savez", "savez_compressed", "frombuffer", "fromfile", "tofile", "reducer_override"]
+
+_TAG_PREFIX = "pyquadp."
+_NATIVE = "<" if sys.byteorder == "little" else ">"
+_SWAPPED = ">" if _NATIVE == "<" else "<"
+_DTYPES = {
+    "qfloat": qarray.dtype,
+    "qcmplx": qcarray.dtype,
+    "qint": qiarray.dtype,
+    "ddfloat": ddarray.dtype,
+    "qqfloat": qqarray.dtype,
+}
+# Elements swapped per block by tofile
+_BLOCK = 65536
+
+
+def _tag_of(dtype):
+    # Either byte order of a quad dtype, see dtype.newbyteorder
+    for name, quad_dtype in _DTYPES.items():
+        if dtype.type is quad_dtype.type:
+            return f"{_TAG_PREFIX}{name}{_NATIVE if dtype.isnative else _SWAPPED}"
+    return None
+
+
+def _quad_dtype(dtype, byteorder):
+    dtype = np.dtype(dtype)
+    if _tag_of(dtype) is None:
+        raise TypeError(f"dtype must be a qarray, qcarray, qiarray, ddarray or qqarray dtype, not {dtype}")
+    return dtype.newbyteorder(byteorder)
+
+
+def _dtype_of_tag(tag):
+    return _DTYPES[tag[len(_TAG_PREFIX) : -1]].newbyteorder(tag[-1])
+
+
+def _quad_of(dtype):
+    # (quad dtype, byte order) for a tagged header dtype, or None
+    if dtype.names is None or len(dtype.names) != 1:
+        return None
+    tag = dtype.names[0]
+    if not tag.startswith(_TAG_PREFIX) or tag[-1:] not in "<>":
+        return None
+    quad_dtype = _DTYPES.get(tag[len(_TAG_PREFIX) : -1])
+    if quad_dtype is None or dtype.itemsize != quad_dtype.itemsize:
+        return None
+    return quad_dtype, tag[-1]
+
+
+def _write_array(fp, arr):
+    tag = _tag_of(arr.dtype)
+    if tag is None:
+        _format.write_array(fp, np.asanyarray(arr), allow_pickle=False)
+        return
+
+    fortran_order = arr.flags.f_contiguous and not arr.flags.c_contiguous
+    header = {
+        "descr": [(tag, f"|V{arr.dtype.itemsize}")],
+        "fortran_order": fortran_order,
+        "shape": arr.shape,
+    }
+    # Version 1.0 headers are limited to 65535 bytes, enough for 2**12 dims
+    if arr.ndim < 4096:
+        _format.write_array_header_1_0(fp, header)
+    else:
+        _format.write_array_header_2_0(fp, header)
+
+    data = np.ascontiguousarray(arr.T if fortran_order else arr).reshape(-1).view(np.uint8)
+    if _is_real_file(fp):
+        fp.flush()
+        data.tofile(fp)
+    else:
+        fp.write(memoryview(data))
+
+
+def _is_real_file(fp):
+    # tofile and fromfile need an OS level file, zip members are not
+    try:
+        fp.fileno()
+    except (AttributeError, OSError):
+        return False
+    return True
+
+
+def _read_raw(fp, nbytes):
+    if _is_real_file(fp):
+        return np.fromfile(fp, dtype=np.uint8, count=nbytes)
+    return np.frombuffer(fp.read(nbytes), dtype=np.uint8).copy()
+
+
+def _finish(raw, dtype, shape, fortran_order):
+    if raw.size != int(np.prod(shape, dtype=np.int64)) * dtype.itemsize:
+        raise ValueError("Failed to read all data for array: the file is truncated")
+    arr = raw.view(dtype)
+    if fortran_order:
+        return arr.reshape(shape[::-1]).T
+    return arr.reshape(shape)
+
+
+def _read_array(fp, mmap_mode=None, allow_pickle=False, filename=None):
+    # Reads one array at fp's position, which must hold the .npy magic
+    start = fp.tell()
+    version = _format.read_magic(fp)
+    if version == (1, 0):
+        shape, fortran_order, dtype = _format.read_array_header_1_0(fp)
+    else:
+        shape, fortran_order, dtype = _format.read_array_header_2_0(fp)
+
+    quad = _quad_of(dtype)
+    if quad is None:
+        fp.seek(start)
+        if mmap_mode is not None and filename is not None:
+            return _format.open_memmap(filename, mode=mmap_mode)
+        return _format.read_array(fp, allow_pickle=allow_pickle)
+
+    quad_dtype, byteorder = quad
+    nbytes = int(np.prod(shape, dtype=np.int64)) * quad_dtype.itemsize
+    if mmap_mode is None or filename is None or nbytes == 0:
+        # Read into memory in native byte order, swapped in place if need be
+        arr = _finish(_read_raw(fp, nbytes), quad_dtype, shape, fortran_order)
+        if byteorder != _NATIVE:
+            arr.byteswap(inplace=True)
+        return arr
+    if mmap_mode not in ("r", "r+", "c"):
+        raise ValueError(f"mmap_mode must be 'r', 'r+' or 'c', not {mmap_mode!r}")
+
+    # Mapped data keeps the file's byte order
+    raw = np.memmap(filename, dtype=np.uint8, mode=mmap_mode, offset=fp.tell(), shape=(nbytes,))
+    return _finish(raw, quad_dtype.newbyteorder(byteorder), shape, fortran_order)
+
+
+def save(file, arr):
+    """Save an array to a .npy file.
+
+    Data of the quad dtypes is written with a tag in the header that
+    :func:`load` turns back into the quad dtype; anything else is written as
+    ``np.save`` would, without pickling.
+    """
+    if not hasattr(file, "write"):
+        file = os.fspath(file)
+        if not file.endswith(".npy"):
+            file += ".npy"
+        with open(file, "wb") as fp:
+            _write_array(fp, np.asanyarray(arr))
+        return
+    _write_array(file, np.asanyarray(arr))
+
+
+def load(file, mmap_mode=None, allow_pickle=False):
+    """Load an array from a .npy file, or the arrays of a .npz file.
+
+    With ``mmap_mode`` (``'r'``, ``'r+'`` or ``'c'``) a .npy file named by a
+    path is mapped rather than read, so even very large quad arrays open at
+    once. The result is a ``np.memmap`` of the quad dtype.
+    """
+    if hasattr(file, "read"):
+        return _load(file, mmap_mode, allow_pickle, None)
+    filename = os.fspath(file)
+    fp = open(filename, "rb")
+    try:
+        result = _load(fp, mmap_mode, allow_pickle, filename)
+    except BaseException:
+        fp.close()
+        raise
+    if not isinstance(result, NpzFile):
+        fp.close()
+    return result
+
+
+def _load(fp, mmap_mode, allow_pickle, filename):
+    start = fp.tell()
+    magic = fp.read(len(_format.MAGIC_PREFIX))
+    fp.seek(start)
+    if magic.startswith(b"PK\x03\x04") or magic.startswith(b"PK\x05\x06"):
+        return NpzFile(fp, allow_pickle=allow_pickle, own_fid=filename is not None)
+    if magic != _format.MAGIC_PREFIX:
+        raise ValueError(f"{filename or fp!r} is not a .npy or .npz file")
+    return _read_array(fp, mmap_mode, allow_pickle, filename)
+
+
+def _savez(file, args, kwds, compression):
+    arrays = dict(kwds)
+    for i, arr in enumerate(args):
+        key = f"arr_{i}"
+        if key in arrays:
+            raise ValueError(f"Cannot use un-named variables and keyword {key}")
+        arrays[key] = arr
+
+    if not hasattr(file, "write"):
+        file = os.fspath(file)
+        if not file.endswith(".npz"):
+            file += ".npz"
+    with zipfile.ZipFile(file, mode="w", compression=compression, allowZip64=True) as zf:
+        for key, arr in arrays.items():
+            with zf.open(key + ".npy", "w", force_zip64=True) as fp:
+                _write_array(fp, np.asanyarray(arr))
+
+
+def savez(file, *args, **kwds):
+    """Save several arrays into an uncompressed .npz file, as ``np.savez``."""
+    _savez(file, args, kwds, zipfile.ZIP_STORED)
+
+
+def savez_compressed(file, *args, **kwds):
+    """Save several arrays into a compressed .npz file, as ``np.savez_compressed``."""
+    _savez(file, args, kwds, zipfile.ZIP_DEFLATED)
+
+
+def frombuffer(buffer, dtype, count=-1, offset=0, *, byteorder="="):
+    """View raw quad data in a buffer as an array, without copying.
+
+    ``byteorder`` is the order of the data, ``'<'``, ``'>'`` or ``'='`` for
+    native. Non-native data gives an array of the swapped dtype, which
+    NumPy converts as it is used; ``.byteswap().view(dtype)`` makes a native
+    copy.
+    """
+    return np.frombuffer(buffer, dtype=_quad_dtype(dtype, byteorder), count=count, offset=offset)
+
+
+def fromfile(file, dtype, count=-1, offset=0, *, byteorder="="):
+    """Read raw quad data from a file straight into a new native array.
+
+    Data in the other byte order is swapped in place once read.
+    """
+    swapped = _quad_dtype(dtype, byteorder)
+    arr = np.fromfile(file, dtype=swapped.newbyteorder("="), count=count, offset=offset)
+    if not swapped.isnative:
+        arr.byteswap(inplace=True)
+    return arr
+
+
+def tofile(arr, file, *, byteorder="="):
+    """Write the raw data of a quad array in C order.
+
+    Data already in the requested byte order is written from the array
+    itself; otherwise it is swapped a block at a time on the way out.
+    """
+    arr = np.asanyarray(arr)
+    if _tag_of(arr.dtype) is None:
+        raise TypeError(f"tofile needs a qarray, qcarray, qiarray, ddarray or qqarray, not {arr.dtype}")
+    swap = arr.dtype.newbyteorder(byteorder).isnative != arr.dtype.isnative
+    if not hasattr(file, "write"):
+        with open(file, "wb") as fp:
+            _tofile(arr, fp, swap)
+        return
+    _tofile(arr, file, swap)
+
+
+def _tofile(arr, fp, swap):
+    if not swap and _is_real_file(fp):
+        fp.flush()
+        arr.tofile(fp)
+        return
+    flat = arr.reshape(-1)
+    for start in range(0, flat.size, _BLOCK):
+        block = flat[start : start + _BLOCK]
+        block = block.byteswap() if swap else np.ascontiguousarray(block)
+        fp.write(memoryview(block.reshape(-1).view(np.uint8)))
+
+
+def _reduce_dtype(dtype):
+    # np.dtype(qfloat) is an object dtype, so rebuild from the tag instead
+    return _dtype_of_tag, (_tag_of(dtype),)
+
+
+for _dtype in _DTYPES.values():
+    copyreg.pickle(type(_dtype), _reduce_dtype)
+
+
+def reducer_override(obj):
+    """Reduce a quad array so that pickle protocol 5 sends its data out of band.
+
+    NumPy only hands its data to ``pickle`` as a ``PickleBuffer`` for dtypes
+    that support the buffer protocol, which the quad dtypes do not, so it is
+    otherwise copied into the pickle. Use this as a pickler's
+    ``reducer_override`` to pass the data of qarray, qcarray, qiarray,
+    ddarray and qqarray arrays as a ``PickleBuffer``; everything else is
+    left to the pickler.
+    """
+    if type(obj) is not np.ndarray:
+        return NotImplemented
+    tag = _tag_of(obj.dtype)
+    if tag is None:
+        return NotImplemented
+
+    order = "F" if obj.flags.f_contiguous and not obj.flags.c_contiguous else "C"
+    data = np.ascontiguousarray(obj.T if order == "F" else obj).reshape(-1).view(np.uint8)
+    return _unpickle_array, (pickle.PickleBuffer(data), tag, obj.shape, order)
+
+
+def _unpickle_array(buffer, tag, shape, order):
+    arr = np.frombuffer(buffer, dtype=np.uint8).view(_dtype_of_tag(tag))
+    if order == "F":
+        return arr.reshape(shape[::-1]).T
+    return arr.reshape(shape)
+
+
+class NpzFile(Mapping):
+    """Lazy mapping of the arrays in a .npz file, as returned by :func:`load`.
+
+    Each array is read when it is looked up. Close the file, or use it as
+    a context manager, when done.
+    """
+
+    def __init__(self, fid, allow_pickle=False, own_fid=False):
+        self.zip = zipfile.ZipFile(fid)
+        self.allow_pickle = allow_pickle
+        self._fid = fid if own_fid else None
+        self._files = {name[:-4] if name.endswith(".npy") else name: name for name in self.zip.namelist()}
+        self.files = list(self._files)
+
+    def __getitem__(self, key):
+        member = self._files[key]
+        with self.zip.open(member) as fp:
+            if not member.endswith(".npy"):
+                return fp.read()
+            return _read_array(fp, allow_pickle=self.allow_pickle)
+
+    def __iter__(self):
+        return iter(self.files)
+
+    def __len__(self):
+        return len(self.files)
+
+    def close(self):
+        self.zip.close()
+        if self._fid is not None:
+            self._fid.close()
+            self._fid = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
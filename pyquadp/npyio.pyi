@@ -0,0 +1,33 @@
+import os
+from collections.abc import Iterator, Mapping
+from typing import IO, Any
+
+from numpy.typing import ArrayLike, DTypeLike, NDArray
+
+_File = str | os.PathLike[str] | IO[bytes]
+
+__all__ = ["save", "load", "savez", "savez_compressed", "frombuffer", "fromfile", "tofile", "reducer_override"]
+
+def save(file: _File, arr: ArrayLike) -> None: ...
+def load(file: _File, mmap_mode: str | None = ..., allow_pickle: bool = ...) -> Any: ...
+def savez(file: _File, *args: ArrayLike, **kwds: ArrayLike) -> None: ...
+def savez_compressed(file: _File, *args: ArrayLike, **kwds: ArrayLike) -> None: ...
+def frombuffer(
+    buffer: Any, dtype: DTypeLike, count: int = ..., offset: int = ..., *, byteorder: str = ...
+) -> NDArray[Any]: ...
+def fromfile(
+    file: _File, dtype: DTypeLike, count: int = ..., offset: int = ..., *, byteorder: str = ...
+) -> NDArray[Any]: ...
+def tofile(arr: ArrayLike, file: _File, *, byteorder: str = ...) -> None: ...
+def reducer_override(obj: object) -> Any: ...
+
+class NpzFile(Mapping[str, NDArray[Any]]):
+    files: list[str]
+    allow_pickle: bool
+    def __init__(self, fid: IO[bytes], allow_pickle: bool = ..., own_fid: bool = ...) -> None: ...
+    def __getitem__(self, key: str) -> NDArray[Any]: ...
+    def __iter__(self) -> Iterator[str]: ...
+    def __len__(self) -> int: ...
+    def close(self) -> None: ...
+    def __enter__(self) -> NpzFile: ...
+    def __exit__(self, *exc: object) -> None: ...
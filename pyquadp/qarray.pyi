@@ -1,8 +1,9 @@
+import os
 from collections.abc import Sequence
 from typing import Any, TypeAlias, overload
 
 import numpy as np
-from numpy.typing import ArrayLike, NDArray
+from numpy.typing import ArrayLike, DTypeLike, NDArray
 
 from .qmfloat import qfloat
 
@@ -12,6 +13,11 @@ ShapeLike: TypeAlias = int | tuple[int, ...]
 qarray: Any
 dtype: np.dtype[Any]
 dtype_num: int
+fma: np.ufunc
+two_sum: np.ufunc
+two_prod: np.ufunc
+split: np.ufunc
+join: np.ufunc
 
 @overload
 def arange(stop: QFloatLike) -> NDArray[Any]: ...
@@ -28,6 +34,37 @@ def zeros(shape: ShapeLike) -> NDArray[Any]: ...
 def ones(shape: ShapeLike) -> NDArray[Any]: ...
 def from_list(values: Sequence[QFloatLike]) -> NDArray[Any]: ...
 def from_array(values: ArrayLike) -> NDArray[Any]: ...
+def from_strings(values: Sequence[str | bytes] | NDArray[Any], *, threads: int = ...) -> NDArray[Any]: ...
+def to_strings(
+    values: ArrayLike, format_spec: str = ..., *, threads: int = ..., dtype: DTypeLike = ...
+) -> NDArray[Any]: ...
+def loadtxt(
+    fname: str | bytes | os.PathLike[str] | os.PathLike[bytes],
+    *,
+    delimiter: str | None = ...,
+    comments: str | None = ...,
+    skiprows: int = ...,
+    usecols: int | Sequence[int] | None = ...,
+    max_rows: int | None = ...,
+    ndmin: int = ...,
+    threads: int = ...,
+) -> NDArray[Any]: ...
+def savetxt(
+    fname: str | bytes | os.PathLike[str] | os.PathLike[bytes],
+    X: ArrayLike,
+    fmt: str = ...,
+    delimiter: str = ...,
+    newline: str = ...,
+    header: str = ...,
+    footer: str = ...,
+    comments: str = ...,
+    *,
+    threads: int = ...,
+) -> None: ...
+def to_dlpack(x: ArrayLike, *, max_version: tuple[int, int] | None = ..., copy: bool | None = ...) -> Any: ...
+def from_dlpack(x: Any, *, copy: bool | None = ...) -> NDArray[Any]: ...
+def to_arrow(x: ArrayLike, requested_schema: Any = ...) -> tuple[Any, Any]: ...
+def from_arrow(x: Any, *, copy: bool | None = ...) -> NDArray[Any]: ...
 def asarray(
     values: ArrayLike,
     *,
@@ -48,3 +85,13 @@ def empty_like(values: ArrayLike) -> NDArray[Any]: ...
 def zeros_like(values: ArrayLike) -> NDArray[Any]: ...
 def ones_like(values: ArrayLike) -> NDArray[Any]: ...
 def full_like(values: ArrayLike, value: QFloatLike) -> NDArray[Any]: ...
+def set_fast_math(enabled: bool) -> bool: ...
+def get_fast_math() -> bool: ...
+def runtime_info() -> dict[str, Any]: ...
+def qsum(x: ArrayLike, *, threads: int = ..., dtype: DTypeLike = ...) -> qfloat | np.float64: ...
+def qdot(x: ArrayLike, y: ArrayLike, *, threads: int = ..., dtype: DTypeLike = ...) -> qfloat | np.float64: ...
+def qnrm2(x: ArrayLike, *, threads: int = ..., dtype: DTypeLike = ...) -> qfloat | np.float64: ...
+def qgemv(a: ArrayLike, x: ArrayLike, *, threads: int = ..., dtype: DTypeLike = ...) -> NDArray[Any]: ...
+def qaxpy(
+    alpha: QFloatLike, x: ArrayLike, y: ArrayLike, *, threads: int = ..., dtype: DTypeLike = ...
+) -> NDArray[Any]: ...
@@ -0,0 +1,462 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "qarrow.h"
+
+// The structs of the Arrow C Data Interface, which has no header to vendor
+struct ArrowSchema {
+    const char *format;
+    const char *name;
+    const char *metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema *dictionary;
+    void (*release)(struct ArrowSchema *);
+    void *private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void **buffers;
+    struct ArrowArray **children;
+    struct ArrowArray *dictionary;
+    void (*release)(struct ArrowArray *);
+    void *private_data;
+};
+
+// Capsule names of the Arrow PyCapsule interface, and from_arrow's own base
+// capsules which own an array moved out of its producer's capsule
+static const char qarrow_schema_name[] = "arrow_schema";
+static const char qarrow_array_name[] = "arrow_array";
+static const char qarrow_base_name[] = "pyquadp.arrow_array";
+
+static const char qarrow_extension_key[] = "ARROW:extension:name";
+static const char qarrow_extension_metadata_key[] = "ARROW:extension:metadata";
+static const char qarrow_extension_prefix[] = "pyquadp.";
+
+// Data pointer of an empty import whose producer gave none
+static _Alignas(16) char qarrow_empty[32];
+
+// Everything to_arrow allocates for one schema, freed by its release
+typedef struct {
+    char format[16];
+    // Length prefixed key and value pairs after a count, as Arrow encodes them
+    char metadata[];
+} qarrow_schema_data;
+
+// Everything to_arrow allocates for one array, freed by its release
+typedef struct {
+    PyObject *array;
+    // Validity bitmap, NULL as there are no nulls, then the data
+    const void *buffers[2];
+} qarrow_export;
+
+static void
+qarrow_schema_release(struct ArrowSchema *schema)
+{
+    free(schema->private_data);
+    schema->release = NULL;
+}
+
+static void
+qarrow_array_release(struct ArrowArray *array)
+{
+    qarrow_export *ctx = array->private_data;
+    // The consumer may release from any thread, with or without the GIL
+    PyGILState_STATE state = PyGILState_Ensure();
+
+    Py_XDECREF(ctx->array);
+    PyGILState_Release(state);
+    free(ctx);
+    array->release = NULL;
+}
+
+// Releases the schema of a capsule that still owns it
+static void
+qarrow_schema_capsule_destructor(PyObject *capsule)
+{
+    struct ArrowSchema *schema = PyCapsule_GetPointer(capsule, qarrow_schema_name);
+
+    if (schema == NULL) {
+        PyErr_Clear();
+        return;
+    }
+    if (schema->release != NULL) {
+        schema->release(schema);
+    }
+    free(schema);
+}
+
+// Releases the array of a capsule that still owns it, a consumer that moved
+// it out having cleared its release
+static void
+qarrow_array_capsule_destructor(PyObject *capsule)
+{
+    const char *name = PyCapsule_GetName(capsule);
+    struct ArrowArray *array;
+
+    if (name == NULL) {
+        PyErr_Clear();
+        return;
+    }
+    array = PyCapsule_GetPointer(capsule, name);
+    if (array == NULL) {
+        PyErr_Clear();
+        return;
+    }
+    if (array->release != NULL) {
+        array->release(array);
+    }
+    free(array);
+}
+
+static char *
+qarrow_put(char *p, const char *s, int32_t len)
+{
+    memcpy(p, &len, sizeof(len));
+    memcpy(p + sizeof(len), s, (size_t)len);
+    return p + sizeof(len) + len;
+}
+
+static struct ArrowSchema *
+qarrow_schema_new(const qdlpack_kind *kind)
+{
+    struct ArrowSchema *schema;
+    qarrow_schema_data *data;
+    char extension[64];
+    int32_t extension_len;
+    int32_t key = (int32_t)strlen(qarrow_extension_key);
+    int32_t metadata_key = (int32_t)strlen(qarrow_extension_metadata_key);
+    int32_t pairs = 2;
+    char *p;
+
+    extension_len = (int32_t)snprintf(extension, sizeof(extension), "%s%s", qarrow_extension_prefix, kind->name);
+    schema = malloc(sizeof(*schema));
+    data = malloc(sizeof(*data) + 5 * sizeof(int32_t) + (size_t)(key + extension_len + metadata_key));
+    if (schema == NULL || data == NULL) {
+        free(schema);
+        free(data);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    snprintf(data->format, sizeof(data->format), "w:%zu", kind->itemsize);
+    memcpy(data->metadata, &pairs, sizeof(pairs));
+    p = qarrow_put(data->metadata + sizeof(pairs), qarrow_extension_key, key);
+    p = qarrow_put(p, extension, extension_len);
+    p = qarrow_put(p, qarrow_extension_metadata_key, metadata_key);
+    qarrow_put(p, "", 0);
+
+    schema->format = data->format;
+    schema->name = "";
+    schema->metadata = data->metadata;
+    // Not nullable, quad arrays have no missing values
+    schema->flags = 0;
+    schema->n_children = 0;
+    schema->children = NULL;
+    schema->dictionary = NULL;
+    schema->release = qarrow_schema_release;
+    schema->private_data = data;
+    return schema;
+}
+
+PyObject *
+qarrow_to(const qdlpack_kind *kind, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"x", "requested_schema", NULL};
+    PyObject *obj;
+    PyObject *requested_schema = Py_None;
+    PyObject *arr;
+    PyObject *schema_capsule;
+    PyObject *array_capsule;
+    PyObject *result;
+    struct ArrowSchema *schema;
+    struct ArrowArray *array;
+    qarrow_export *ctx;
+    qdlpack_view view;
+
+    // requested_schema may be ignored by a producer that has only one layout
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O:to_arrow", kwlist, &obj, &requested_schema)) {
+        return NULL;
+    }
+
+    arr = kind->as_array(obj, false, &view);
+    if (arr == NULL) {
+        return NULL;
+    }
+    if (view.ndim != 1) {
+        PyErr_Format(PyExc_ValueError, "to_arrow needs a 1-D %s array, got %d dimensions", kind->name, view.ndim);
+        Py_DECREF(arr);
+        return NULL;
+    }
+    // Arrow has no strides, so only a contiguous array is shared
+    if (view.shape[0] > 1 && view.strides[0] != (Py_ssize_t)kind->itemsize) {
+        Py_DECREF(arr);
+        arr = kind->as_array(obj, true, &view);
+        if (arr == NULL) {
+            return NULL;
+        }
+    }
+
+    schema = qarrow_schema_new(kind);
+    if (schema == NULL) {
+        Py_DECREF(arr);
+        return NULL;
+    }
+    schema_capsule = PyCapsule_New(schema, qarrow_schema_name, qarrow_schema_capsule_destructor);
+    if (schema_capsule == NULL) {
+        schema->release(schema);
+        free(schema);
+        Py_DECREF(arr);
+        return NULL;
+    }
+
+    array = malloc(sizeof(*array));
+    ctx = malloc(sizeof(*ctx));
+    if (array == NULL || ctx == NULL) {
+        free(array);
+        free(ctx);
+        Py_DECREF(arr);
+        Py_DECREF(schema_capsule);
+        return PyErr_NoMemory();
+    }
+    ctx->array = arr;
+    ctx->buffers[0] = NULL;
+    ctx->buffers[1] = view.data;
+    array->length = (int64_t)view.shape[0];
+    array->null_count = 0;
+    array->offset = 0;
+    array->n_buffers = 2;
+    array->n_children = 0;
+    array->buffers = ctx->buffers;
+    array->children = NULL;
+    array->dictionary = NULL;
+    array->release = qarrow_array_release;
+    array->private_data = ctx;
+    array_capsule = PyCapsule_New(array, qarrow_array_name, qarrow_array_capsule_destructor);
+    if (array_capsule == NULL) {
+        array->release(array);
+        free(array);
+        Py_DECREF(schema_capsule);
+        return NULL;
+    }
+
+    result = PyTuple_Pack(2, schema_capsule, array_capsule);
+    Py_DECREF(schema_capsule);
+    Py_DECREF(array_capsule);
+    return result;
+}
+
+// The value of key in Arrow metadata, NULL when it is absent
+static const char *
+qarrow_metadata_get(const char *metadata, const char *key, int32_t *len)
+{
+    const char *p = metadata;
+    int32_t pairs;
+    int32_t key_len;
+    int32_t i;
+
+    if (metadata == NULL) {
+        return NULL;
+    }
+    memcpy(&pairs, p, sizeof(pairs));
+    p += sizeof(pairs);
+    for (i = 0; i < pairs; i++) {
+        bool match;
+
+        memcpy(&key_len, p, sizeof(key_len));
+        p += sizeof(key_len);
+        match = (size_t)key_len == strlen(key) && memcmp(p, key, (size_t)key_len) == 0;
+        p += key_len;
+        memcpy(len, p, sizeof(*len));
+        p += sizeof(*len);
+        if (match) {
+            return p;
+        }
+        p += *len;
+    }
+    return NULL;
+}
+
+static int
+qarrow_check_schema(const qdlpack_kind *kind, const struct ArrowSchema *schema)
+{
+    char format[16];
+    const char *extension;
+    int32_t len;
+
+    snprintf(format, sizeof(format), "w:%zu", kind->itemsize);
+    if (strcmp(schema->format, format) != 0) {
+        PyErr_Format(PyExc_TypeError, "%s arrays need Arrow format \"%s\", got \"%s\"", kind->name, format,
+                     schema->format);
+        return -1;
+    }
+    extension = qarrow_metadata_get(schema->metadata, qarrow_extension_key, &len);
+    if (extension != NULL) {
+        size_t prefix = strlen(qarrow_extension_prefix);
+
+        if ((size_t)len != prefix + strlen(kind->name) || memcmp(extension, qarrow_extension_prefix, prefix) != 0
+            || memcmp(extension + prefix, kind->name, (size_t)len - prefix) != 0) {
+            char got[64];
+
+            // PyErr_Format has no precision for strings
+            snprintf(got, sizeof(got), "%.*s", (int)len, extension);
+            PyErr_Format(PyExc_TypeError, "%s arrays need Arrow extension type \"%s%s\", got \"%s\"", kind->name,
+                         qarrow_extension_prefix, kind->name, got);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static bool
+qarrow_has_nulls(const struct ArrowArray *array)
+{
+    const uint8_t *bits = array->buffers[0];
+    int64_t i;
+
+    if (bits == NULL || array->null_count == 0) {
+        return false;
+    }
+    if (array->null_count > 0) {
+        return true;
+    }
+    // A count of -1 is unknown, so look at the bitmap
+    for (i = array->offset; i < array->offset + array->length; i++) {
+        if (!((bits[i >> 3] >> (i & 7)) & 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The schema and array capsules of obj, a pair itself or an Arrow producer
+static PyObject *
+qarrow_capsules_of(PyObject *obj)
+{
+    PyObject *pair;
+
+    if (PyTuple_Check(obj)) {
+        Py_INCREF(obj);
+        pair = obj;
+    } else {
+        pair = PyObject_CallMethod(obj, "__arrow_c_array__", NULL);
+        if (pair == NULL) {
+            if (PyErr_ExceptionMatches(PyExc_AttributeError)) {
+                PyErr_Clear();
+                PyErr_Format(PyExc_TypeError,
+                             "from_arrow needs an Arrow capsule pair or an object with __arrow_c_array__, not %R",
+                             (PyObject *)Py_TYPE(obj));
+            }
+            return NULL;
+        }
+    }
+    if (!PyTuple_Check(pair) || PyTuple_Size(pair) != 2
+        || !PyCapsule_IsValid(PyTuple_GetItem(pair, 0), qarrow_schema_name)
+        || !PyCapsule_IsValid(PyTuple_GetItem(pair, 1), qarrow_array_name)) {
+        Py_DECREF(pair);
+        PyErr_SetString(PyExc_TypeError, "expected a pair of \"arrow_schema\" and \"arrow_array\" capsules");
+        return NULL;
+    }
+    return pair;
+}
+
+PyObject *
+qarrow_from(const qdlpack_kind *kind, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"x", "copy", NULL};
+    PyObject *obj;
+    PyObject *copy_obj = Py_None;
+    PyObject *pair;
+    PyObject *base;
+    PyObject *arr;
+    struct ArrowSchema *schema;
+    struct ArrowArray *array;
+    struct ArrowArray *owned;
+    qdlpack_view view;
+    Py_ssize_t shape[1];
+    Py_ssize_t strides[1];
+    int copy = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$O:from_arrow", kwlist, &obj, &copy_obj)) {
+        return NULL;
+    }
+    if (copy_obj != Py_None) {
+        copy = PyObject_IsTrue(copy_obj);
+        if (copy < 0) {
+            return NULL;
+        }
+    }
+
+    pair = qarrow_capsules_of(obj);
+    if (pair == NULL) {
+        return NULL;
+    }
+    schema = PyCapsule_GetPointer(PyTuple_GetItem(pair, 0), qarrow_schema_name);
+    array = PyCapsule_GetPointer(PyTuple_GetItem(pair, 1), qarrow_array_name);
+    if (schema->release == NULL || array->release == NULL) {
+        PyErr_SetString(PyExc_ValueError, "the Arrow schema or array has already been released");
+        goto fail;
+    }
+    if (qarrow_check_schema(kind, schema) < 0) {
+        goto fail;
+    }
+    if (array->n_buffers != 2 || array->n_children != 0) {
+        PyErr_Format(PyExc_ValueError, "Arrow fixed_size_binary array has %lld buffers and %lld children",
+                     (long long)array->n_buffers, (long long)array->n_children);
+        goto fail;
+    }
+    if (qarrow_has_nulls(array)) {
+        PyErr_Format(PyExc_ValueError, "Arrow array has nulls, which %s arrays cannot hold", kind->name);
+        goto fail;
+    }
+
+    shape[0] = (Py_ssize_t)array->length;
+    strides[0] = (Py_ssize_t)kind->itemsize;
+    view.data = array->buffers[1] == NULL ? qarrow_empty
+                                          : (char *)array->buffers[1] + array->offset * (int64_t)kind->itemsize;
+    view.ndim = 1;
+    view.shape = shape;
+    view.strides = strides;
+    // Arrow buffers are immutable
+    view.readonly = true;
+    view.copied = false;
+
+    // Move the array out of its capsule: the base capsule releases it with
+    // the quad array, the producer's capsule just frees the struct
+    owned = malloc(sizeof(*owned));
+    if (owned == NULL) {
+        PyErr_NoMemory();
+        goto fail;
+    }
+    *owned = *array;
+    array->release = NULL;
+    base = PyCapsule_New(owned, qarrow_base_name, qarrow_array_capsule_destructor);
+    Py_DECREF(pair);
+    if (base == NULL) {
+        owned->release(owned);
+        free(owned);
+        return NULL;
+    }
+
+    arr = kind->from_view(&view, base);
+    if (arr != NULL && copy == 1) {
+        PyObject *view_arr = arr;
+
+        arr = kind->as_array(view_arr, true, &view);
+        Py_DECREF(view_arr);
+    }
+    return arr;
+
+fail:
+    Py_DECREF(pair);
+    return NULL;
+}
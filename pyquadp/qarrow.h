@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+
+// Arrow C Data Interface exchange for the quad array modules.
+//
+// to_arrow returns the "arrow_schema" and "arrow_array" capsule pair of the
+// Arrow PyCapsule interface, as __arrow_c_array__ does. A 1-D array goes out
+// as fixed_size_binary of its itemsize, "w:16" or "w:32", whose only data
+// buffer is the array's own memory in native byte order. The schema carries
+// the ARROW:extension:name "pyquadp.<name>", so consumers keep the bytes as
+// an extension type rather than guessing at them.
+//
+// from_arrow takes such a pair, or any object with __arrow_c_array__, and
+// wraps the data buffer without copying. Plain fixed_size_binary of the right
+// width is accepted too; another extension name or any null is an error.
+//
+// Both reuse the array callbacks of the module's DLPack kind.
+
+#include "qdlpack.h"
+
+// to_arrow(x, requested_schema=None)
+PyObject *qarrow_to(const qdlpack_kind *kind, PyObject *args, PyObject *kwargs);
+
+// from_arrow(x, *, copy=None)
+PyObject *qarrow_from(const qdlpack_kind *kind, PyObject *args, PyObject *kwargs);
@@ -10,12 +10,21 @@
 #include <numpy/arrayobject.h>
 #include <numpy/npy_math.h>
 #include <numpy/ufuncobject.h>
+#include <float.h>
 #include <stdalign.h>
 #include <string.h>
 
 #define QCARRAY_MODULE
 #include "qcarray.h"
 #include "qcmplx.h"
+#include "qdd.h"
+#include "qformat.h"
+#include "qparse.h"
+#include "qsoftquad.h"
+#include "qarrow.h"
+#include "qdlpack.h"
+#include "qtable.h"
+#include "qtext.h"
 
 static int QuadCArrayTypeNum = -1;
 static int QuadArrayTypeNum = -1;
@@ -633,6 +642,67 @@ QuadCArray_register_ufunc_unary_types(
     return 0;
 }
 
+// Classification and logical loops test the bits of both parts; a value is
+// NaN or Inf if either part is, and non-zero if either part is
+
+#define QCARRAY_ISNAN(re, im) (qdd_bits_isnan(re) | qdd_bits_isnan(im))
+#define QCARRAY_ISINF(re, im) (qdd_bits_isinf(re) | qdd_bits_isinf(im))
+#define QCARRAY_ISFINITE(re, im) (qdd_bits_isfinite(re) & qdd_bits_isfinite(im))
+#define QCARRAY_NONZERO(re, im) (qdd_bits_nonzero(re) | qdd_bits_nonzero(im))
+#define QCARRAY_LOGICAL_NOT(re, im) (!QCARRAY_NONZERO(re, im))
+
+#define QCARRAY_DEFINE_PREDICATE_LOOP(name, test) \
+static void \
+QuadCArray_ufunc_##name(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+    npy_intp i; \
+    npy_intp n = dims[0]; \
+    char *in = args[0]; \
+    char *out = args[1]; \
+ \
+    for (i = 0; i < n; ++i) { \
+        const __uint128_t *u = (const __uint128_t *)in; \
+ \
+        *(npy_bool *)out = (npy_bool)test(u[0], u[1]); \
+        in += steps[0]; \
+        out += steps[1]; \
+    } \
+}
+
+QCARRAY_DEFINE_PREDICATE_LOOP(isnan, QCARRAY_ISNAN)
+QCARRAY_DEFINE_PREDICATE_LOOP(isinf, QCARRAY_ISINF)
+QCARRAY_DEFINE_PREDICATE_LOOP(isfinite, QCARRAY_ISFINITE)
+QCARRAY_DEFINE_PREDICATE_LOOP(logical_not, QCARRAY_LOGICAL_NOT)
+
+#undef QCARRAY_DEFINE_PREDICATE_LOOP
+
+#define QCARRAY_DEFINE_LOGICAL_LOOP(name, op) \
+static void \
+QuadCArray_ufunc_##name(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+    npy_intp i; \
+    npy_intp n = dims[0]; \
+    char *in1 = args[0]; \
+    char *in2 = args[1]; \
+    char *out = args[2]; \
+ \
+    for (i = 0; i < n; ++i) { \
+        const __uint128_t *a = (const __uint128_t *)in1; \
+        const __uint128_t *b = (const __uint128_t *)in2; \
+ \
+        *(npy_bool *)out = (npy_bool)(QCARRAY_NONZERO(a[0], a[1]) op QCARRAY_NONZERO(b[0], b[1])); \
+        in1 += steps[0]; \
+        in2 += steps[1]; \
+        out += steps[2]; \
+    } \
+}
+
+QCARRAY_DEFINE_LOGICAL_LOOP(logical_and, &)
+QCARRAY_DEFINE_LOGICAL_LOOP(logical_or, |)
+QCARRAY_DEFINE_LOGICAL_LOOP(logical_xor, ^)
+
+#undef QCARRAY_DEFINE_LOGICAL_LOOP
+
 static int
 QuadCArray_register_ufuncs(void)
 {
@@ -726,6 +796,27 @@ QuadCArray_register_ufuncs(void)
     if (QuadCArray_register_ufunc_unary("cosh", QuadCArray_ufunc_cosh) < 0) {
         return -1;
     }
+    if (QuadCArray_register_ufunc_unary_types("isnan", QuadCArray_ufunc_isnan, QuadCArrayTypeNum, NPY_BOOL) < 0) {
+        return -1;
+    }
+    if (QuadCArray_register_ufunc_unary_types("isinf", QuadCArray_ufunc_isinf, QuadCArrayTypeNum, NPY_BOOL) < 0) {
+        return -1;
+    }
+    if (QuadCArray_register_ufunc_unary_types("isfinite", QuadCArray_ufunc_isfinite, QuadCArrayTypeNum, NPY_BOOL) < 0) {
+        return -1;
+    }
+    if (QuadCArray_register_ufunc_unary_types("logical_not", QuadCArray_ufunc_logical_not, QuadCArrayTypeNum, NPY_BOOL) < 0) {
+        return -1;
+    }
+    if (QuadCArray_register_ufunc_binary_types("logical_and", QuadCArray_ufunc_logical_and, QuadCArrayTypeNum, QuadCArrayTypeNum, NPY_BOOL) < 0) {
+        return -1;
+    }
+    if (QuadCArray_register_ufunc_binary_types("logical_or", QuadCArray_ufunc_logical_or, QuadCArrayTypeNum, QuadCArrayTypeNum, NPY_BOOL) < 0) {
+        return -1;
+    }
+    if (QuadCArray_register_ufunc_binary_types("logical_xor", QuadCArray_ufunc_logical_xor, QuadCArrayTypeNum, QuadCArrayTypeNum, NPY_BOOL) < 0) {
+        return -1;
+    }
 
     return 0;
 }
@@ -779,11 +870,180 @@ QuadCArray_cast_from_float64(
     }
 }
 
+static void
+QuadCArray_cast_from_qarray(
+    void *from,
+    void *to,
+    npy_intp n,
+    void *NPY_UNUSED(fromarr),
+    void *NPY_UNUSED(toarr))
+{
+    npy_intp i;
+    __float128 *src = (__float128 *)from;
+    __complex128 *dst = (__complex128 *)to;
+
+    for (i = 0; i < n; ++i) {
+        __complex128 out = 0.0Q;
+        __real__ out = src[i];
+        __imag__ out = 0.0Q;
+        dst[i] = out;
+    }
+}
+
+static void
+QuadCArray_cast_to_qarray(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+    // Keeps the real part, as complex128 to float64 does
+    npy_intp i;
+    __complex128 *src = (__complex128 *)from;
+    __float128 *dst = (__float128 *)to;
+
+    for (i = 0; i < n; ++i) {
+        dst[i] = __real__ src[i];
+    }
+}
+
+static void
+QuadCArray_cast_to_clongdouble(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+    // Each part narrows with a single rounding, see the qarray casts
+    npy_intp i;
+    __float128 *src = (__float128 *)from;
+    npy_longdouble *dst = (npy_longdouble *)to;
+
+    for (i = 0; i < 2 * n; ++i) {
+        dst[i] = (npy_longdouble)src[i];
+    }
+}
+
+static void
+QuadCArray_cast_from_clongdouble(
+    void *from,
+    void *to,
+    npy_intp n,
+    void *NPY_UNUSED(fromarr),
+    void *NPY_UNUSED(toarr))
+{
+    npy_intp i;
+    npy_longdouble *src = (npy_longdouble *)from;
+    __float128 *dst = (__float128 *)to;
+
+    for (i = 0; i < 2 * n; ++i) {
+        dst[i] = (__float128)src[i];
+    }
+}
+
+static bool
+qcarray_parse_complex(const char *s, size_t len, void *out)
+{
+    return qparse_complex(s, len, (__complex128 *)out);
+}
+
+static void
+QuadCArray_cast_to_text(void *from, void *to, npy_intp n, PyArrayObject *toarr, bool ucs4)
+{
+    // Python complex repr with shortest round trip parts
+    char buf[QFORMAT_COMPLEX_REPR_SIZE];
+    __complex128 *src = (__complex128 *)from;
+    char *dst = (char *)to;
+    npy_intp itemsize = PyArray_ITEMSIZE(toarr);
+    bool swap = !PyArray_ISNOTSWAPPED(toarr);
+    npy_intp i;
+
+    for (i = 0; i < n; ++i) {
+        int len = qformat_complex_repr(src[i], buf);
+
+        if (!qtext_store(buf, (size_t)len, dst + i * itemsize, (size_t)itemsize, ucs4, swap)) {
+            PyErr_Format(
+                PyExc_ValueError,
+                "qcmplx %s does not fit in %R, cast to a sized string dtype such as 'U100'",
+                buf,
+                (PyObject *)PyArray_DESCR(toarr));
+            return;
+        }
+    }
+}
+
+static void
+QuadCArray_cast_from_text(void *from, void *to, npy_intp n, PyArrayObject *fromarr, bool ucs4)
+{
+    char *src = (char *)from;
+    __complex128 *dst = (__complex128 *)to;
+    npy_intp itemsize = PyArray_ITEMSIZE(fromarr);
+    bool swap = !PyArray_ISNOTSWAPPED(fromarr);
+    npy_intp i;
+
+    for (i = 0; i < n; ++i) {
+        if (!qtext_parse(src + i * itemsize, (size_t)itemsize, ucs4, swap, qcarray_parse_complex, &dst[i])) {
+            PyObject *item = PyArray_GETITEM(fromarr, src + i * itemsize);
+
+            if (item != NULL) {
+                PyErr_Format(PyExc_ValueError, "could not convert string to qcmplx: %R", item);
+                Py_DECREF(item);
+            }
+            return;
+        }
+    }
+}
+
+static void
+QuadCArray_cast_to_unicode(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *toarr)
+{
+    QuadCArray_cast_to_text(from, to, n, (PyArrayObject *)toarr, true);
+}
+
+static void
+QuadCArray_cast_to_string(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *toarr)
+{
+    QuadCArray_cast_to_text(from, to, n, (PyArrayObject *)toarr, false);
+}
+
+static void
+QuadCArray_cast_from_unicode(void *from, void *to, npy_intp n, void *fromarr, void *NPY_UNUSED(toarr))
+{
+    QuadCArray_cast_from_text(from, to, n, (PyArrayObject *)fromarr, true);
+}
+
+static void
+QuadCArray_cast_from_string(void *from, void *to, npy_intp n, void *fromarr, void *NPY_UNUSED(toarr))
+{
+    QuadCArray_cast_from_text(from, to, n, (PyArrayObject *)fromarr, false);
+}
+
+static int
+QuadCArray_register_text_casts(
+    PyArray_Descr *quad_descr,
+    int quad_type_num,
+    int type_num,
+    PyArray_VectorUnaryFunc *to_func,
+    PyArray_VectorUnaryFunc *from_func)
+{
+    // Unsafe both ways, as for complex128
+    PyArray_Descr *type_descr;
+
+    if (PyArray_RegisterCastFunc(quad_descr, type_num, to_func) < 0) {
+        return -1;
+    }
+
+    type_descr = PyArray_DescrFromType(type_num);
+    if (type_descr == NULL) {
+        return -1;
+    }
+    if (PyArray_RegisterCastFunc(type_descr, quad_type_num, from_func) < 0) {
+        Py_DECREF(type_descr);
+        return -1;
+    }
+    Py_DECREF(type_descr);
+
+    return 0;
+}
+
 static int
 QuadCArray_register_casts(PyArray_Descr *quad_descr, int quad_type_num)
 {
     PyArray_Descr *complex_descr;
     PyArray_Descr *float_descr;
+    PyArray_Descr *qarray_descr;
 
     if (PyArray_RegisterCastFunc(quad_descr, NPY_CDOUBLE, QuadCArray_cast_to_complex128) < 0) {
         return -1;
@@ -806,6 +1066,26 @@ QuadCArray_register_casts(PyArray_Descr *quad_descr, int quad_type_num)
     }
     Py_DECREF(complex_descr);
 
+    if (PyArray_RegisterCastFunc(quad_descr, NPY_CLONGDOUBLE, QuadCArray_cast_to_clongdouble) < 0) {
+        return -1;
+    }
+    complex_descr = PyArray_DescrFromType(NPY_CLONGDOUBLE);
+    if (complex_descr == NULL) {
+        return -1;
+    }
+    if (PyArray_RegisterCastFunc(complex_descr, quad_type_num, QuadCArray_cast_from_clongdouble) < 0) {
+        Py_DECREF(complex_descr);
+        return -1;
+    }
+#if !(LDBL_MANT_DIG == 106 || defined(__LONG_DOUBLE_IBM128__))
+    // Not safe from IBM double-double, see qfloatarray.c
+    if (PyArray_RegisterCanCast(complex_descr, quad_type_num, NPY_NOSCALAR) < 0) {
+        Py_DECREF(complex_descr);
+        return -1;
+    }
+#endif
+    Py_DECREF(complex_descr);
+
     float_descr = PyArray_DescrFromType(NPY_DOUBLE);
     if (float_descr == NULL) {
         return -1;
@@ -820,6 +1100,35 @@ QuadCArray_register_casts(PyArray_Descr *quad_descr, int quad_type_num)
     }
     Py_DECREF(float_descr);
 
+    // qarray -> qcarray is exact, the way back drops the imaginary part
+    if (PyArray_RegisterCastFunc(quad_descr, QuadArrayTypeNum, QuadCArray_cast_to_qarray) < 0) {
+        return -1;
+    }
+    qarray_descr = PyArray_DescrFromType(QuadArrayTypeNum);
+    if (qarray_descr == NULL) {
+        return -1;
+    }
+    if (PyArray_RegisterCastFunc(qarray_descr, quad_type_num, QuadCArray_cast_from_qarray) < 0) {
+        Py_DECREF(qarray_descr);
+        return -1;
+    }
+    if (PyArray_RegisterCanCast(qarray_descr, quad_type_num, NPY_NOSCALAR) < 0) {
+        Py_DECREF(qarray_descr);
+        return -1;
+    }
+    Py_DECREF(qarray_descr);
+
+    if (QuadCArray_register_text_casts(
+            quad_descr, quad_type_num, NPY_UNICODE, QuadCArray_cast_to_unicode, QuadCArray_cast_from_unicode)
+        < 0) {
+        return -1;
+    }
+    if (QuadCArray_register_text_casts(
+            quad_descr, quad_type_num, NPY_STRING, QuadCArray_cast_to_string, QuadCArray_cast_from_string)
+        < 0) {
+        return -1;
+    }
+
     return 0;
 }
 
@@ -1449,6 +1758,153 @@ qcarray_ones_like(PyObject *NPY_UNUSED(self), PyObject *args)
     return ret;
 }
 
+static int
+qcarray_table_format(const void *item, const qformat_spec *NPY_UNUSED(spec), char *buf, size_t size)
+{
+    char repr[QFORMAT_COMPLEX_REPR_SIZE];
+    __complex128 z;
+    int len;
+
+    memcpy(&z, item, sizeof(z));
+    len = qformat_complex_repr(z, repr);
+    if ((size_t)len < size) {
+        memcpy(buf, repr, (size_t)len + 1);
+    }
+    return len;
+}
+
+static PyObject *
+qcarray_table_new(int nd, const Py_ssize_t *dims, char **data)
+{
+    npy_intp shape[2];
+    PyArrayObject *arr;
+    int i;
+
+    for (i = 0; i < nd; i++) {
+        shape[i] = (npy_intp)dims[i];
+    }
+    arr = QuadCArray_new_empty(nd, shape);
+    if (arr != NULL) {
+        *data = PyArray_DATA(arr);
+    }
+    return (PyObject *)arr;
+}
+
+static PyObject *
+qcarray_table_as_array(PyObject *obj, int *nd, Py_ssize_t *dims, const char **data)
+{
+    PyArrayObject *arr;
+    int i;
+
+    Py_INCREF(QuadCArrayDescr);
+    arr = (PyArrayObject *)PyArray_FromAny(obj, QuadCArrayDescr, 0, 0, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST, NULL);
+    if (arr == NULL) {
+        return NULL;
+    }
+    *nd = PyArray_NDIM(arr);
+    for (i = 0; i < *nd && i < 2; i++) {
+        dims[i] = (Py_ssize_t)PyArray_DIM(arr, i);
+    }
+    *data = PyArray_DATA(arr);
+    return (PyObject *)arr;
+}
+
+static const qtable_kind qcarray_table = {
+    .name = "qcmplx",
+    .itemsize = sizeof(__complex128),
+    .parse = qcarray_parse_complex,
+    .format = qcarray_table_format,
+    .format_spec = false,
+    .new_array = qcarray_table_new,
+    .as_array = qcarray_table_as_array,
+};
+
+static PyObject *
+qcarray_loadtxt(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+    return qtable_loadtxt(&qcarray_table, args, kwargs);
+}
+
+static PyObject *
+qcarray_savetxt(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+    return qtable_savetxt(&qcarray_table, args, kwargs);
+}
+
+static PyObject *
+qcarray_dlpack_as_array(PyObject *obj, bool copy, qdlpack_view *view)
+{
+    PyArrayObject *arr;
+    int flags = copy ? NPY_ARRAY_CARRAY | NPY_ARRAY_ENSURECOPY : NPY_ARRAY_ALIGNED;
+
+    Py_INCREF(QuadCArrayDescr);
+    arr = (PyArrayObject *)PyArray_FromAny(obj, QuadCArrayDescr, 0, 0, flags | NPY_ARRAY_FORCECAST, NULL);
+    if (arr == NULL) {
+        return NULL;
+    }
+    view->data = PyArray_DATA(arr);
+    view->ndim = PyArray_NDIM(arr);
+    view->shape = (const Py_ssize_t *)PyArray_DIMS(arr);
+    view->strides = (const Py_ssize_t *)PyArray_STRIDES(arr);
+    view->readonly = !PyArray_ISWRITEABLE(arr);
+    view->copied = (PyObject *)arr != obj;
+    return (PyObject *)arr;
+}
+
+static PyObject *
+qcarray_dlpack_from_view(const qdlpack_view *view, PyObject *base)
+{
+    PyObject *arr;
+
+    Py_INCREF(QuadCArrayDescr);
+    arr = PyArray_NewFromDescr(&PyArray_Type, QuadCArrayDescr, view->ndim, (const npy_intp *)view->shape,
+                               (const npy_intp *)view->strides, view->data, view->readonly ? 0 : NPY_ARRAY_WRITEABLE,
+                               NULL);
+    if (arr == NULL) {
+        Py_DECREF(base);
+        return NULL;
+    }
+    if (PyArray_SetBaseObject((PyArrayObject *)arr, base) < 0) {
+        Py_DECREF(arr);
+        return NULL;
+    }
+    return arr;
+}
+
+static const qdlpack_kind qcarray_dlpack = {
+    .name = "qcmplx",
+    .code = QDLPACK_FLOAT,
+    .bits = 128,
+    .parts = 2,
+    .itemsize = sizeof(__complex128),
+    .as_array = qcarray_dlpack_as_array,
+    .from_view = qcarray_dlpack_from_view,
+};
+
+static PyObject *
+qcarray_to_dlpack(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+    return qdlpack_to(&qcarray_dlpack, args, kwargs);
+}
+
+static PyObject *
+qcarray_from_dlpack(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+    return qdlpack_from(&qcarray_dlpack, args, kwargs);
+}
+
+static PyObject *
+qcarray_to_arrow(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+    return qarrow_to(&qcarray_dlpack, args, kwargs);
+}
+
+static PyObject *
+qcarray_from_arrow(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+    return qarrow_from(&qcarray_dlpack, args, kwargs);
+}
+
 static PyMethodDef QuadCArrayMethods[] = {
     {"linspace", qcarray_linspace, METH_VARARGS, "Create a 1-D qcarray with evenly spaced samples over an interval."},
     {"empty", qcarray_empty, METH_VARARGS, "Create a 1-D uninitialized qcarray."},
@@ -1465,6 +1921,12 @@ static PyMethodDef QuadCArrayMethods[] = {
     {"zeros_like", qcarray_zeros_like, METH_VARARGS, "Create a zero-filled qcarray with the same shape as input."},
     {"ones_like", qcarray_ones_like, METH_VARARGS, "Create a one-filled qcarray with the same shape as input."},
     {"full_like", qcarray_full_like, METH_VARARGS, "Create a qcarray filled with a value and the same shape as input."},
+    {"loadtxt", (PyCFunction)qcarray_loadtxt, METH_VARARGS | METH_KEYWORDS, "Load a text table into a qcarray, parsing line aligned chunks of the file in parallel."},
+    {"savetxt", (PyCFunction)qcarray_savetxt, METH_VARARGS | METH_KEYWORDS, "Save a 1-D or 2-D array to a text file, formatting blocks of rows in parallel."},
+    {"to_dlpack", (PyCFunction)qcarray_to_dlpack, METH_VARARGS | METH_KEYWORDS, "Export an array as a DLPack capsule that shares its memory, versioned when max_version is given."},
+    {"from_dlpack", (PyCFunction)qcarray_from_dlpack, METH_VARARGS | METH_KEYWORDS, "Wrap a DLPack capsule or producer of 128 bit float pairs, shaped (..., 2), as a qcarray without copying."},
+    {"to_arrow", (PyCFunction)qcarray_to_arrow, METH_VARARGS | METH_KEYWORDS, "Export a 1-D array as Arrow C Data Interface capsules of 32 byte fixed_size_binary that share its memory."},
+    {"from_arrow", (PyCFunction)qcarray_from_arrow, METH_VARARGS | METH_KEYWORDS, "Wrap Arrow capsules or an object with __arrow_c_array__ of 32 byte fixed_size_binary as a read-only qcarray without copying."},
     {NULL, NULL, 0, NULL},
 };
 
@@ -1479,55 +1941,31 @@ static PyModuleDef QuadCArrayModule = {
 static npy_bool
 QuadCArray_nonzero(void *ip, void *arr)
 {
-    int elsize = PyArray_ITEMSIZE(arr);
-    char *ptr = ip;
-    while (elsize--) {
-        if (*ptr++ != 0) {
-            return NPY_TRUE;
-        }
+    __uint128_t u[2];
+
+    // ip may be unaligned; a part equal to -0.0 counts as zero
+    memcpy(u, ip, sizeof(u));
+    if (arr != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)arr)) {
+        qdd_bswap128(&u[0]);
+        qdd_bswap128(&u[1]);
     }
-    return NPY_FALSE;
+    return (npy_bool)QCARRAY_NONZERO(u[0], u[1]);
 }
 
 static void
 QuadCArray_copyswap(__complex128 *dst, __complex128 *src, int swap, void *NPY_UNUSED(arr))
 {
-    size_t i;
-    char *bytes;
-
-    if (src == NULL) {
-        src = dst;
-    }
-    if (src != dst) {
-        memcpy(dst, src, sizeof(__complex128));
-    }
-
-    if (swap != 0) {
-        char tmp;
-        bytes = (char *)dst;
-        for (i = 0; i < (sizeof(__complex128) / 2); ++i) {
-            tmp = bytes[i];
-            bytes[i] = bytes[sizeof(__complex128) - 1 - i];
-            bytes[sizeof(__complex128) - 1 - i] = tmp;
-        }
-    }
+    // The real and imaginary parts are swapped each in place, as NumPy
+    // does for complex128
+    qdd_copyswapn(
+        (char *)dst, sizeof(__complex128), (const char *)src, sizeof(__complex128), 1, sizeof(__complex128), swap != 0);
 }
 
 static void
-QuadCArray_copyswapn(void *dst, npy_intp dstride, void *src, npy_intp sstride, npy_intp n, int swap, void *arr)
+QuadCArray_copyswapn(
+    void *dst, npy_intp dstride, void *src, npy_intp sstride, npy_intp n, int swap, void *NPY_UNUSED(arr))
 {
-    npy_intp i;
-    PyArray_CopySwapFunc *copyswap;
-    char *dstptr = dst;
-    char *srcptr = src;
-
-    copyswap = PyDataType_GetArrFuncs(PyArray_DESCR(arr))->copyswap;
-
-    for (i = 0; i < n; i++) {
-        copyswap(dstptr, srcptr, swap, arr);
-        dstptr += dstride;
-        srcptr += sstride;
-    }
+    qdd_copyswapn(dst, dstride, src, sstride, n, sizeof(__complex128), swap != 0);
 }
 
 static int
@@ -1535,10 +1973,11 @@ QuadCArray_setitem(PyObject *item, __complex128 *data, void *array)
 {
     QuadCObject tmp;
 
-    (void)array;
-
     if (PyObject_to_QuadCObject(item, &tmp, false)) {
-        *data = tmp.value;
+        if (array != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)array)) {
+            qdd_copyswapn((char *)&tmp.value, 0, NULL, 0, 1, sizeof(tmp.value), true);
+        }
+        memcpy(data, &tmp.value, sizeof(tmp.value));
     } else {
         PyErr_SetString(PyExc_TypeError, "Failed to setitem in QuadCArray");
         return -1;
@@ -1547,11 +1986,14 @@ QuadCArray_setitem(PyObject *item, __complex128 *data, void *array)
 }
 
 static PyObject *
-QuadCArray_getitem(__complex128 *data, void *NPY_UNUSED(arr))
+QuadCArray_getitem(__complex128 *data, void *arr)
 {
     QuadCObject tmp;
 
-    tmp.value = *data;
+    memcpy(&tmp.value, data, sizeof(tmp.value));
+    if (arr != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)arr)) {
+        qdd_copyswapn((char *)&tmp.value, 0, NULL, 0, 1, sizeof(tmp.value), true);
+    }
     return QuadCObject_to_PyObject(tmp);
 }
 
@@ -1699,6 +2141,13 @@ PyInit_qcarray(void)
         return NULL;
     }
 
+    // Shared helpers linked into this module pick their kernels here too
+    if (qsoft_init() < 0) {
+        PyErr_Format(PyExc_ValueError, "unknown %s value '%s'", QSOFT_LEVEL_ENV, getenv(QSOFT_LEVEL_ENV));
+        Py_DECREF(m);
+        return NULL;
+    }
+
     PyArray_InitArrFuncs(&QuadCArrayFuncs);
     QuadCArrayFuncs.nonzero = (PyArray_NonzeroFunc *)QuadCArray_nonzero;
     QuadCArrayFuncs.copyswap = (PyArray_CopySwapFunc *)QuadCArray_copyswap;
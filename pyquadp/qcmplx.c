@@ -393,24 +393,28 @@ static PyObject * QuadCObject_from_param(PyTypeObject *type, PyObject * arg){
 
 
 //Pickling
+static PyObject *QuadCObject_unpickle = NULL;
+
+// Module level _from_bytes, so a pickle names it once and then holds only the
+// raw bytes of each qcmplx
+static PyObject *
+QuadCObject__from_bytes(PyObject *module, PyObject *arg) {
+    (void)module;
+    return QuadCObject_from_bytes(QuadCType, arg);
+}
+
 static PyObject *
-QuadCObject___getstate__(QuadCObject *self, PyObject *Py_UNUSED(ignored)) {
+QuadCObject___reduce__(QuadCObject *self, PyObject *Py_UNUSED(ignored)) {
     PyObject *bytes_obj = QuadCObject_to_bytes(self, NULL);
-    PyObject *ret;
 
     if (bytes_obj == NULL) {
         return NULL;
     }
-
-    ret = Py_BuildValue("{sisN}",
-                        PICKLE_VERSION_KEY, PICKLE_VERSION,
-                        "bytes", bytes_obj);
-    return ret;
+    return Py_BuildValue("O(N)", QuadCObject_unpickle, bytes_obj);
 }
 
-	
 
-/* Un-pickle the object */
+/* Un-pickle the dict state written by older versions */
 static PyObject *
 QuadCObject___setstate__(QuadCObject *self, PyObject *state) {
 
@@ -507,8 +511,8 @@ static PyMethodDef Quad_cmethods[] = {
     {"to_bytes", (PyCFunction) QuadCObject_to_bytes, METH_NOARGS, "to_bytes"},
     {"from_bytes", (PyCFunction) QuadCObject_from_bytes, METH_CLASS|METH_O, "from_bytes"},
     {"from_param", (PyCFunction) QuadCObject_from_param, METH_CLASS|METH_O, "from_param"},
-    {"__getstate__", (PyCFunction) QuadCObject___getstate__, METH_NOARGS, "Pickle a complex quad object object" },
-    {"__setstate__", (PyCFunction) QuadCObject___setstate__, METH_O,"Un-pickle a complex quad object object"},
+    {"__reduce__", (PyCFunction) QuadCObject___reduce__, METH_NOARGS, "Pickle a qcmplx as its raw bytes" },
+    {"__setstate__", (PyCFunction) QuadCObject___setstate__, METH_O,"Un-pickle a qcmplx from an older pickle"},
     {NULL}  /* Sentinel */
 };
 
@@ -629,11 +633,17 @@ static PyType_Spec QuadCType_spec = {
     .slots = QuadCType_slots,
 };
 
+static PyMethodDef QuadCModule_methods[] = {
+    {"_from_bytes", (PyCFunction) QuadCObject__from_bytes, METH_O, "Un-pickle a qcmplx from its raw bytes"},
+    {NULL}  /* Sentinel */
+};
+
 static PyModuleDef QuadCModule = {
     PyModuleDef_HEAD_INIT,
     .m_name = "qmcmplx",
     .m_doc = PyDoc_STR("Quad precision module for complex quad's."),
     .m_size = -1,
+    .m_methods = QuadCModule_methods,
 };
 
 PyObject* 
@@ -880,6 +890,12 @@ PyInit_qmcmplx(void)
     if (m == NULL)
         return NULL;
 
+    QuadCObject_unpickle = PyObject_GetAttrString(m, "_from_bytes");
+    if (QuadCObject_unpickle == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
     quadc_type_obj = PyType_FromSpec(&QuadCType_spec);
     if (quadc_type_obj == NULL) {
         Py_DECREF(m);
@@ -0,0 +1,757 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+
+// Double-double primitives and bit-level quad <-> double helpers.
+//
+// A double-double (dd) value is the unevaluated sum hi + lo of two doubles
+// with |lo| <= ulp(hi)/2, giving ~106 bits of precision on the hardware FPU.
+// The helpers here are all static inline so each extension that includes
+// this header gets its own copy and the compiler can keep values in registers.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct {
+    double hi;
+    double lo;
+} qdd_t;
+
+typedef union {
+    __float128 f;
+    __uint128_t u;
+} qdd_quad_bits;
+
+typedef union {
+    double f;
+    uint64_t u;
+} qdd_double_bits;
+
+#define QDD_QUAD_BIAS 16383
+#define QDD_DOUBLE_BIAS 1023
+
+// Error-free transformations
+
+static inline qdd_t
+qdd_two_sum(double a, double b)
+{
+    qdd_t r;
+    double bb;
+
+    r.hi = a + b;
+    bb = r.hi - a;
+    r.lo = (a - (r.hi - bb)) + (b - bb);
+    return r;
+}
+
+static inline qdd_t
+qdd_fast_two_sum(double a, double b)
+{
+    // Requires |a| >= |b| (or a == 0). A zero b leaves a untouched, so a
+    // -0.0 leading part is not turned into +0.0 by a +0.0 error term.
+    qdd_t r;
+
+    r.hi = b == 0.0 ? a : a + b;
+    r.lo = b - (r.hi - a);
+    return r;
+}
+
+#ifndef FP_FAST_FMA
+static inline void
+qdd_split(double a, double *hi, double *lo)
+{
+    // Veltkamp splitting into two 26 bit halves. Above 2^996 the product
+    // with split would overflow, so a is scaled down by 2^28 first and the
+    // halves scaled back up, as in the QD library.
+    const double split = 134217729.0; // 2^27 + 1
+    const double thresh = 6.69692879491417e+299; // 2^996
+    double t;
+
+    if (a > thresh || a < -thresh) {
+        a *= 3.7252902984619140625e-09; // 2^-28
+        t = split * a;
+        *hi = t - (t - a);
+        *lo = a - *hi;
+        *hi *= 268435456.0; // 2^28
+        *lo *= 268435456.0;
+    } else {
+        t = split * a;
+        *hi = t - (t - a);
+        *lo = a - *hi;
+    }
+}
+#endif
+
+static inline qdd_t
+qdd_two_prod(double a, double b)
+{
+    qdd_t r;
+
+    r.hi = a * b;
+#ifdef FP_FAST_FMA
+    r.lo = fma(a, b, -r.hi);
+#else
+    {
+        // Dekker product, exact unless a product of halves underflows
+        double ahi, alo, bhi, blo;
+
+        qdd_split(a, &ahi, &alo);
+        qdd_split(b, &bhi, &blo);
+        r.lo = ((ahi * bhi - r.hi) + ahi * blo + alo * bhi) + alo * blo;
+    }
+#endif
+    return r;
+}
+
+// Double-double arithmetic
+
+static inline qdd_t
+qdd_from_double(double a)
+{
+    qdd_t r = {a, 0.0};
+    return r;
+}
+
+static inline qdd_t
+qdd_add(qdd_t a, qdd_t b)
+{
+    qdd_t s, t;
+
+    s = qdd_two_sum(a.hi, b.hi);
+    t = qdd_two_sum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = qdd_fast_two_sum(s.hi, s.lo);
+    s.lo += t.lo;
+    return qdd_fast_two_sum(s.hi, s.lo);
+}
+
+static inline qdd_t
+qdd_add_sloppy(qdd_t a, qdd_t b)
+{
+    // Cheaper addition, only accurate when a and b do not cancel, e.g. in a
+    // Horner step where the coefficient dominates
+    qdd_t s;
+
+    s = qdd_two_sum(a.hi, b.hi);
+    s.lo += a.lo + b.lo;
+    return qdd_fast_two_sum(s.hi, s.lo);
+}
+
+static inline qdd_t
+qdd_add_d(qdd_t a, double b)
+{
+    qdd_t s;
+
+    s = qdd_two_sum(a.hi, b);
+    s.lo += a.lo;
+    return qdd_fast_two_sum(s.hi, s.lo);
+}
+
+static inline qdd_t
+qdd_neg(qdd_t a)
+{
+    qdd_t r = {-a.hi, -a.lo};
+    return r;
+}
+
+static inline qdd_t
+qdd_mul(qdd_t a, qdd_t b)
+{
+    qdd_t p;
+
+    p = qdd_two_prod(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return qdd_fast_two_sum(p.hi, p.lo);
+}
+
+static inline qdd_t
+qdd_mul_d(qdd_t a, double b)
+{
+    qdd_t p;
+
+    p = qdd_two_prod(a.hi, b);
+    p.lo += a.lo * b;
+    return qdd_fast_two_sum(p.hi, p.lo);
+}
+
+static inline qdd_t
+qdd_sub(qdd_t a, qdd_t b)
+{
+    return qdd_add(a, qdd_neg(b));
+}
+
+static inline qdd_t
+qdd_sqr(qdd_t a)
+{
+    qdd_t p;
+
+    p = qdd_two_prod(a.hi, a.hi);
+    p.lo += 2.0 * a.hi * a.lo;
+    return qdd_fast_two_sum(p.hi, p.lo);
+}
+
+static inline qdd_t
+qdd_div(qdd_t a, qdd_t b)
+{
+    // Quotient digit from the doubles, then one correction from the exact
+    // remainder (relative error ~ 3 * 2^-106)
+    qdd_t p;
+    double q, e;
+
+    q = a.hi / b.hi;
+    p = qdd_two_prod(q, b.hi);
+    e = ((((a.hi - p.hi) - p.lo) + a.lo) - q * b.lo) / b.hi;
+    return qdd_fast_two_sum(q, e);
+}
+
+static inline qdd_t
+qdd_sqrt(qdd_t a)
+{
+    // One Newton step from the double square root (Karp and Markstein)
+    qdd_t r;
+    double x, ax;
+
+    if (a.hi <= 0.0) {
+        r.hi = a.hi == 0.0 ? a.hi : NAN;
+        r.lo = 0.0;
+        return r;
+    }
+    x = 1.0 / sqrt(a.hi);
+    ax = a.hi * x;
+    r = qdd_sub(a, qdd_two_prod(ax, ax));
+    return qdd_two_sum(ax, r.hi * (x * 0.5));
+}
+
+static inline qdd_t
+qdd_mul_pow2(qdd_t a, double p)
+{
+    // Exact scaling by a power of two p, barring overflow and underflow
+    qdd_t r = {a.hi * p, a.lo * p};
+    return r;
+}
+
+static inline qdd_t
+qdd_ldexp(qdd_t a, int e)
+{
+    qdd_t r = {ldexp(a.hi, e), ldexp(a.lo, e)};
+    return r;
+}
+
+static inline qdd_t
+qdd_special(double hi)
+{
+    // The double-double form of a non-finite result
+    qdd_t r = {hi, 0.0};
+    return r;
+}
+
+// Bit-level conversions between __float128 and doubles.
+//
+// These avoid the libgcc soft-float conversion calls on hot paths. They only
+// handle values whose parts are normal doubles; callers are responsible for
+// routing other inputs to a slow path.
+
+static inline double
+qdd_pow2(int e)
+{
+    // 2^e for e in the normal double range
+    qdd_double_bits b;
+
+    b.u = (uint64_t)(e + QDD_DOUBLE_BIAS) << 52;
+    return b.f;
+}
+
+static inline __float128
+qdd_quad_pow2(int e)
+{
+    // 2^e for e in the normal quad range
+    qdd_quad_bits b;
+
+    b.u = (__uint128_t)(unsigned)(e + QDD_QUAD_BIAS) << 112;
+    return b.f;
+}
+
+static inline int
+qdd_quad_exponent(__float128 x)
+{
+    // Unbiased exponent of a normal quad
+    qdd_quad_bits b;
+
+    b.f = x;
+    return (int)((b.u >> 112) & 0x7fff) - QDD_QUAD_BIAS;
+}
+
+static inline __float128
+qdd_quad_scale(__float128 x, int e)
+{
+    // x * 2^e by editing the exponent field; x and the result must be normal
+    qdd_quad_bits b;
+
+    b.f = x;
+    b.u += (__uint128_t)(__int128)e << 112;
+    return b.f;
+}
+
+// Classification straight from the bits of a quad. Shifting out the sign
+// leaves the magnitude bits, which order like the values themselves.
+
+#define QDD_QUAD_INF_SHIFTED (((__uint128_t)0x7fff) << 113)
+
+static inline int
+qdd_bits_isnan(__uint128_t u)
+{
+    return (u << 1) > QDD_QUAD_INF_SHIFTED;
+}
+
+static inline int
+qdd_bits_isinf(__uint128_t u)
+{
+    return (u << 1) == QDD_QUAD_INF_SHIFTED;
+}
+
+static inline int
+qdd_bits_isfinite(__uint128_t u)
+{
+    return (u << 1) < QDD_QUAD_INF_SHIFTED;
+}
+
+static inline int
+qdd_bits_nonzero(__uint128_t u)
+{
+    // NaN counts as non-zero and -0.0 as zero, as for C truth values
+    return (u << 1) != 0;
+}
+
+static inline __float128
+qdd_double_to_quad(double d)
+{
+    // Exact widening for zero and normal doubles
+    qdd_double_bits db;
+    qdd_quad_bits qb;
+    uint64_t exp;
+
+    db.f = d;
+    exp = (db.u >> 52) & 0x7ff;
+    if (exp == 0 || exp == 0x7ff) {
+        return (__float128)d;
+    }
+    qb.u = ((__uint128_t)(db.u >> 63) << 127)
+         | ((__uint128_t)(exp - QDD_DOUBLE_BIAS + QDD_QUAD_BIAS) << 112)
+         | ((__uint128_t)(db.u & 0xfffffffffffffULL) << 60);
+    return qb.f;
+}
+
+static inline uint64_t
+qdd_quad_narrow(__float128 x, int mant_bits, int bias, int exp_max)
+{
+    // Bits of x rounded to nearest even in a binary format with mant_bits
+    // stored significand bits, the given exponent bias and all-ones
+    // exponent exp_max, sign excluded. Handles every input: overflow gives
+    // Inf, results below the normal range round to subnormals or zero and
+    // NaN keeps its leading payload bits and is made quiet. Only the rare
+    // cases branch, the rounding itself does not.
+    qdd_quad_bits b;
+    __uint128_t m, sig, rem, half;
+    uint64_t r;
+    int shift = 112 - mant_bits;
+    int qe, e;
+
+    b.f = x;
+    qe = (int)((b.u >> 112) & 0x7fff);
+    m = b.u & ((((__uint128_t)1) << 112) - 1);
+    if (qe == 0x7fff) {
+        return ((uint64_t)exp_max << mant_bits) | (uint64_t)(m >> shift)
+             | ((uint64_t)(m != 0) << (mant_bits - 1));
+    }
+    e = qe - QDD_QUAD_BIAS + bias;
+    if (e >= exp_max) {
+        return (uint64_t)exp_max << mant_bits;
+    }
+    sig = m | ((__uint128_t)(qe != 0) << 112);
+    if (e <= 0) {
+        // Subnormal result: keep the exponent field at zero
+        shift += 1 - e;
+        e = 1;
+        if (shift > 113) {
+            return 0;
+        }
+    }
+    rem = sig & ((((__uint128_t)1) << shift) - 1);
+    half = ((__uint128_t)1) << (shift - 1);
+    r = ((uint64_t)(e - 1) << mant_bits) + (uint64_t)(sig >> shift);
+    // A carry out of the significand moves into the exponent, up to Inf
+    r += (uint64_t)((rem > half) | ((rem == half) & (unsigned)(r & 1)));
+    return r;
+}
+
+static inline double
+qdd_quad_to_double(__float128 x)
+{
+    // Correctly rounded, the same as (double)x without the libgcc call
+    qdd_quad_bits b;
+    qdd_double_bits d;
+
+    b.f = x;
+    d.u = qdd_quad_narrow(x, 52, QDD_DOUBLE_BIAS, 0x7ff) | ((uint64_t)(b.u >> 127) << 63);
+    return d.f;
+}
+
+static inline float
+qdd_quad_to_float(__float128 x)
+{
+    // Rounds once, where going through double could round twice
+    union {
+        float f;
+        uint32_t u;
+    } f;
+    qdd_quad_bits b;
+
+    b.f = x;
+    f.u = (uint32_t)qdd_quad_narrow(x, 23, 127, 0xff) | ((uint32_t)(b.u >> 127) << 31);
+    return f.f;
+}
+
+static inline double
+qdd_quad_hi(__float128 x)
+{
+    // Leading 53 significand bits of a normal quad, truncated
+    qdd_quad_bits b;
+    qdd_double_bits h;
+    int e;
+
+    b.f = x;
+    e = (int)((b.u >> 112) & 0x7fff) - QDD_QUAD_BIAS;
+    h.u = ((uint64_t)(b.u >> 127) << 63)
+        | ((uint64_t)(e + QDD_DOUBLE_BIAS) << 52)
+        | ((uint64_t)(b.u >> 60) & 0xfffffffffffffULL);
+    return h.f;
+}
+
+static inline void
+qdd_split3(__float128 x, double *d1, double *d2, double *d3)
+{
+    // Exact split of a normal quad into three doubles: d1 holds the leading
+    // 53 significand bits, d2 the next 53 and d3 the last 7. The exponent of
+    // x must leave all three parts in the normal double range.
+    qdd_quad_bits b;
+    __uint128_t m;
+    int e;
+    double sign;
+
+    b.f = x;
+    e = (int)((b.u >> 112) & 0x7fff) - QDD_QUAD_BIAS;
+    sign = (b.u >> 127) ? -1.0 : 1.0;
+    m = (b.u & ((((__uint128_t)1) << 112) - 1)) | (((__uint128_t)1) << 112);
+
+    *d1 = qdd_quad_hi(x);
+    *d2 = sign * (double)(uint64_t)((m >> 7) & 0x1fffffffffffffULL) * qdd_pow2(e - 105);
+    *d3 = sign * (double)(uint64_t)(m & 0x7f) * qdd_pow2(e - 112);
+}
+
+static inline int
+qdd_quad_split_rn(__float128 x, double *hi, double *lo)
+{
+    // hi = x rounded to double and lo = x - hi rounded to double, straight
+    // from the significand bits. Returns 0 without touching hi and lo unless
+    // both parts are normal doubles or lo is zero.
+    qdd_quad_bits b;
+    __uint128_t m;
+    uint64_t q, r;
+    int64_t rem;
+    int e, up;
+
+    b.f = x;
+    e = (int)((b.u >> 112) & 0x7fff) - QDD_QUAD_BIAS;
+    if (e < -910 || e > 1022) {
+        return 0;
+    }
+    m = (b.u & ((((__uint128_t)1) << 112) - 1)) | (((__uint128_t)1) << 112);
+    q = (uint64_t)(m >> 60);
+    r = (uint64_t)m & ((1ULL << 60) - 1);
+    up = r > (1ULL << 59) || (r == (1ULL << 59) && (q & 1));
+    rem = (int64_t)r - ((int64_t)up << 60);
+    // A zero lo takes the sign of hi so hi + lo keeps it
+    if (b.u >> 127) {
+        *hi = (double)(q + up) * -qdd_pow2(e - 52);
+        *lo = (double)rem * -qdd_pow2(e - 112);
+    } else {
+        *hi = (double)(q + up) * qdd_pow2(e - 52);
+        *lo = (double)rem * qdd_pow2(e - 112);
+    }
+    return 1;
+}
+
+static inline qdd_t
+qdd_from_quad(__float128 x)
+{
+    // Truncating conversion to double-double (relative error < 2^-106)
+    double d1, d2, d3;
+    qdd_t r;
+
+    qdd_split3(x, &d1, &d2, &d3);
+    r.hi = d1;
+    r.lo = d2;
+    return r;
+}
+
+static inline __float128
+qdd_to_quad(qdd_t a)
+{
+    if (a.lo == 0.0) {
+        // Keeps the sign of a zero hi
+        return qdd_double_to_quad(a.hi);
+    }
+    return qdd_double_to_quad(a.hi) + qdd_double_to_quad(a.lo);
+}
+
+static inline qdd_t
+qdd_from_quad_rn(__float128 x)
+{
+    // Round to the nearest double-double; hi is x rounded to double, so
+    // overflow and non-finite values come through as in a plain cast
+    qdd_t r;
+
+    r.hi = (double)x;
+    if (!isfinite(r.hi)) {
+        r.lo = 0.0;
+        return r;
+    }
+    r.lo = (double)(x - (__float128)r.hi);
+    return r;
+}
+
+// Fixed-point "wide" accumulators.
+//
+// A wide value is a signed 128-bit integer m standing for m * 2^scale. Sums of
+// quads and doubles that are known to fit are formed exactly (up to the
+// truncation of bits below 2^scale) and rounded once when converted back,
+// which is much cheaper than a chain of soft-float __float128 operations.
+
+static inline int
+qdd_clz128(__uint128_t a)
+{
+    uint64_t hi = (uint64_t)(a >> 64);
+
+    if (hi) {
+        return __builtin_clzll(hi);
+    }
+    return 64 + __builtin_clzll((uint64_t)a);
+}
+
+static inline __uint128_t
+qdd_umulhi(__uint128_t a, __uint128_t b)
+{
+    // High 128 bits of the 256-bit product, truncated
+    uint64_t a0 = (uint64_t)a, a1 = (uint64_t)(a >> 64);
+    uint64_t b0 = (uint64_t)b, b1 = (uint64_t)(b >> 64);
+    __uint128_t p00 = (__uint128_t)a0 * b0;
+    __uint128_t p01 = (__uint128_t)a0 * b1;
+    __uint128_t p10 = (__uint128_t)a1 * b0;
+    __uint128_t mid = (p00 >> 64) + (uint64_t)p01 + (uint64_t)p10;
+
+    return (__uint128_t)a1 * b1 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+}
+
+static inline __int128
+qdd_wide_shift(__int128 m, int shift)
+{
+    // m * 2^shift, truncating towards -inf when shifting right
+    if (shift >= 0) {
+        return (__int128)((__uint128_t)m << shift);
+    }
+    if (shift <= -128) {
+        return m < 0 ? -1 : 0;
+    }
+    return m >> -shift;
+}
+
+static inline __uint128_t
+qdd_quad_significand(__float128 x, int *e)
+{
+    // Significand (with the implicit bit) of a normal quad, x = sig 2^(e-112)
+    qdd_quad_bits b;
+
+    b.f = x;
+    *e = (int)((b.u >> 112) & 0x7fff) - QDD_QUAD_BIAS;
+    return (b.u & ((((__uint128_t)1) << 112) - 1)) | (((__uint128_t)1) << 112);
+}
+
+static inline __int128
+qdd_wide_from_quad(__float128 x, int scale)
+{
+    // Zero or normal x
+    qdd_quad_bits b;
+    __int128 m;
+    int e;
+
+    b.f = x;
+    if ((b.u << 1) == 0) {
+        return 0;
+    }
+    m = (__int128)qdd_quad_significand(x, &e);
+    if (b.u >> 127) {
+        m = -m;
+    }
+    return qdd_wide_shift(m, e - 112 - scale);
+}
+
+static inline __int128
+qdd_wide_from_double(double d, int scale)
+{
+    // Doubles below the normal range are dropped
+    qdd_double_bits b;
+    __int128 m;
+    int e;
+
+    b.f = d;
+    e = (int)((b.u >> 52) & 0x7ff);
+    if (e == 0) {
+        return 0;
+    }
+    m = (__int128)((b.u & 0xfffffffffffffULL) | (1ULL << 52));
+    if (b.u >> 63) {
+        m = -m;
+    }
+    return qdd_wide_shift(m, e - QDD_DOUBLE_BIAS - 52 - scale);
+}
+
+static inline __int128
+qdd_wide_from_dd(qdd_t a, int scale)
+{
+    return qdd_wide_from_double(a.hi, scale) + qdd_wide_from_double(a.lo, scale);
+}
+
+static inline __float128
+qdd_wide_to_quad(__int128 m, int scale)
+{
+    // Round m * 2^scale to nearest, ties to even. The result must be normal.
+    qdd_quad_bits b;
+    __uint128_t a, rem, half;
+    int n, sh;
+
+    if (m == 0) {
+        return 0;
+    }
+    a = m < 0 ? -(__uint128_t)m : (__uint128_t)m;
+    n = 127 - qdd_clz128(a);
+    sh = n - 112;
+    if (sh > 0) {
+        rem = a & ((((__uint128_t)1) << sh) - 1);
+        half = ((__uint128_t)1) << (sh - 1);
+        a >>= sh;
+        if (rem > half || (rem == half && (a & 1))) {
+            a += 1;
+            if (a >> 113) {
+                a >>= 1;
+                n += 1;
+            }
+        }
+    } else {
+        a <<= -sh;
+    }
+    b.u = (a & ((((__uint128_t)1) << 112) - 1))
+        | ((__uint128_t)(unsigned)(n + scale + QDD_QUAD_BIAS) << 112)
+        | ((__uint128_t)(m < 0) << 127);
+    return b.f;
+}
+
+static inline int
+qdd_to_quad_wide(qdd_t a, __float128 *r)
+{
+    // hi + lo rounded once to quad, added as wide values. Returns 0 unless
+    // both parts are normal doubles whose exponents are at most 70 apart.
+    qdd_double_bits h, l;
+    __int128 mh, ml, sh, sl;
+    int eh, el, d;
+
+    h.f = a.hi;
+    l.f = a.lo;
+    eh = (int)((h.u >> 52) & 0x7ff);
+    el = (int)((l.u >> 52) & 0x7ff);
+    d = eh - el;
+    if (eh == 0 || eh == 0x7ff || el == 0 || el == 0x7ff || d > 70 || d < -70) {
+        return 0;
+    }
+    // Shift the larger part left so the smaller one sets the scale, and
+    // apply the signs without branching
+    mh = (__int128)((h.u & 0xfffffffffffffULL) | (1ULL << 52)) << (d > 0 ? d : 0);
+    ml = (__int128)((l.u & 0xfffffffffffffULL) | (1ULL << 52)) << (d < 0 ? -d : 0);
+    sh = -(__int128)(h.u >> 63);
+    sl = -(__int128)(l.u >> 63);
+    *r = qdd_wide_to_quad(((mh ^ sh) - sh) + ((ml ^ sl) - sl), (eh < el ? eh : el) - QDD_DOUBLE_BIAS - 52);
+    return 1;
+}
+
+static inline qdd_t
+qdd_from_wide(__int128 m, int scale)
+{
+    // Truncating conversion of a non-zero wide value to double-double
+    __uint128_t a;
+    double sign, hi, lo;
+    int n;
+
+    sign = m < 0 ? -1.0 : 1.0;
+    a = m < 0 ? -(__uint128_t)m : (__uint128_t)m;
+    n = 127 - qdd_clz128(a);
+    if (n > 105) {
+        a >>= n - 105;
+        scale += n - 105;
+    }
+    hi = (double)(uint64_t)(a >> 53);
+    lo = (double)(uint64_t)(a & 0x1fffffffffffffULL);
+    {
+        qdd_t r = {sign * hi * qdd_pow2(scale + 53), sign * lo * qdd_pow2(scale)};
+        return qdd_fast_two_sum(r.hi, r.lo);
+    }
+}
+
+// Byte order.
+//
+// Every quad dtype element is one or two 16 byte parts (binary128 or
+// int128), and a non-native element has the bytes of each part reversed.
+// Parts are swapped as two 64-bit words so the compiler emits bswap or
+// movbe rather than a byte loop.
+
+static inline void
+qdd_bswap128(void *p)
+{
+    // p may be unaligned
+    uint64_t w[2];
+    uint64_t t;
+
+    memcpy(w, p, sizeof(w));
+    t = __builtin_bswap64(w[0]);
+    w[0] = __builtin_bswap64(w[1]);
+    w[1] = t;
+    memcpy(p, w, sizeof(w));
+}
+
+static inline void
+qdd_copyswapn(char *dst, ptrdiff_t dstride, const char *src, ptrdiff_t sstride, ptrdiff_t n, size_t itemsize,
+              bool swap)
+{
+    // NumPy's copyswapn: copy n strided elements, src NULL meaning in place,
+    // then swap each part of every copied element if asked
+    ptrdiff_t i;
+    size_t k;
+
+    if (src != NULL && src != dst) {
+        if (dstride == (ptrdiff_t)itemsize && sstride == (ptrdiff_t)itemsize) {
+            memmove(dst, src, (size_t)n * itemsize);
+        } else {
+            for (i = 0; i < n; i++) {
+                memmove(dst + i * dstride, src + i * sstride, itemsize);
+            }
+        }
+    }
+    if (!swap) {
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        for (k = 0; k < itemsize; k += 16) {
+            qdd_bswap128(dst + i * dstride + k);
+        }
+    }
+}
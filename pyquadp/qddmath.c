@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include "qddmath.h"
+
+// exp: x = k ln2 + r, expm1(r) from a Taylor series on r/2^10 followed by
+// ten doublings of expm1(2y) = 2 expm1(y) + expm1(y)^2
+#define QDD_EXP_SQUARINGS 10
+#define QDD_EXP_TERMS 9
+#define QDD_EXP_MAX 709.79
+#define QDD_EXP_MIN -745.2
+
+// sin/cos: x = j pi/2 + r, |r| <= pi/4, Taylor series up to r^27
+#define QDD_TRIG_TERMS 27
+#define QDD_TRIG_DD_TERMS 18
+// j * PIO2_C0 is exact while |j| < 2^20
+#define QDD_TRIG_MAX_J 1048576.0
+
+// 1/ln2 and ln2 = C0 + C1 + C2, C0 has 32 significant bits so that k * C0 is
+// exact for every k that gives a finite result
+static const double qdd_inv_ln2 = 0x1.71547652b82fep+0;
+static const double qdd_ln2_c0 = 0x1.62e42ff000000p-1;
+static const double qdd_ln2_c1 = -0x1.718432a1b0e26p-35;
+static const double qdd_ln2_c2 = -0x1.9ff0342542fc3p-90;
+
+// 2/pi and pi/2 = C0 + C1 + C2, C0 has 33 significant bits
+static const double qdd_two_over_pi = 0x1.45f306dc9c883p-1;
+static const double qdd_pio2_c0 = 0x1.921fb54400000p+0;
+static const double qdd_pio2_c1 = 0x1.0b4611a626331p-34;
+static const double qdd_pio2_c2 = 0x1.1701b839a2520p-88;
+
+// 1/n! for n = 2..27
+static const qdd_t qdd_inv_fact[] = {
+    {0x1.0000000000000p-1, 0x0.0p+0},
+    {0x1.5555555555555p-3, 0x1.5555555555555p-57},
+    {0x1.5555555555555p-5, 0x1.5555555555555p-59},
+    {0x1.1111111111111p-7, 0x1.1111111111111p-63},
+    {0x1.6c16c16c16c17p-10, -0x1.f49f49f49f49fp-65},
+    {0x1.a01a01a01a01ap-13, 0x1.a01a01a01a01ap-73},
+    {0x1.a01a01a01a01ap-16, 0x1.a01a01a01a01ap-76},
+    {0x1.71de3a556c734p-19, -0x1.c154f8ddc6c00p-73},
+    {0x1.27e4fb7789f5cp-22, 0x1.cbbc05b4fa99ap-76},
+    {0x1.ae64567f544e4p-26, -0x1.c062e06d1f209p-80},
+    {0x1.1eed8eff8d898p-29, -0x1.2aec959e14c06p-83},
+    {0x1.6124613a86d09p-33, 0x1.f28e0cc748ebep-87},
+    {0x1.93974a8c07c9dp-37, 0x1.05d6f8a2efd1fp-92},
+    {0x1.ae7f3e733b81fp-41, 0x1.1d8656b0ee8cbp-97},
+    {0x1.ae7f3e733b81fp-45, 0x1.1d8656b0ee8cbp-101},
+    {0x1.952c77030ad4ap-49, 0x1.ac981465ddc6cp-103},
+    {0x1.6827863b97d97p-53, 0x1.eec01221a8b0bp-107},
+    {0x1.2f49b46814157p-57, 0x1.2650f61dbdcb4p-112},
+    {0x1.e542ba4020225p-62, 0x1.ea72b4afe3c2fp-120},
+    {0x1.71b8ef6dcf572p-66, -0x1.d043ae40c4647p-120},
+    {0x1.0ce396db7f853p-70, -0x1.aebcdbd20331cp-124},
+    {0x1.761b41316381ap-75, -0x1.3423c7d91404fp-130},
+    {0x1.f2cf01972f578p-80, -0x1.9ada5fcc1ab14p-135},
+    {0x1.3f3ccdd165fa9p-84, -0x1.58ddadf344487p-139},
+    {0x1.88e85fc6a4e5ap-89, -0x1.71c37ebd16540p-143},
+    {0x1.d1ab1c2dccea3p-94, 0x1.054d0c78aea14p-149},
+};
+
+#define QDD_INV_FACT(n) qdd_inv_fact[(n) - 2]
+
+static qdd_t
+qdd_expm1_reduced(qdd_t r)
+{
+    // expm1(r) for |r| <= ~ln2/2, accurate relative to the result
+    qdd_t s, p;
+    double q;
+    int n;
+
+    s = qdd_mul_pow2(r, 0x1p-10);
+
+    // |s| < 2^-11, so from s^6 on the terms only need double precision
+    q = QDD_INV_FACT(QDD_EXP_TERMS).hi;
+    for (n = QDD_EXP_TERMS - 1; n >= 6; --n) {
+        q = q * s.hi + QDD_INV_FACT(n).hi;
+    }
+    p = qdd_from_double(q);
+    for (; n >= 2; --n) {
+        p = qdd_add_sloppy(qdd_mul(p, s), QDD_INV_FACT(n));
+    }
+    p = qdd_add_d(qdd_mul(p, s), 1.0);
+    p = qdd_mul(p, s);
+
+    // 2p and p^2 never cancel as |p| < 1
+    for (n = 0; n < QDD_EXP_SQUARINGS; ++n) {
+        p = qdd_add_sloppy(qdd_mul_pow2(p, 2.0), qdd_sqr(p));
+    }
+    return p;
+}
+
+static qdd_t
+qdd_sub_ln2(qdd_t a, double k)
+{
+    // a - k ln2 for integer k with |k| < 2^21. k C0 is exact and cancels
+    // exactly against a, so the small result keeps its full precision.
+    qdd_t r;
+
+    r = qdd_add_d(a, -k * qdd_ln2_c0);
+    r = qdd_sub(r, qdd_two_prod(k, qdd_ln2_c1));
+    return qdd_add_d(r, -k * qdd_ln2_c2);
+}
+
+static qdd_t
+qdd_mul_ln2(double k)
+{
+    qdd_t r;
+
+    r = qdd_two_sum(k * qdd_ln2_c0, k * qdd_ln2_c2);
+    return qdd_add(r, qdd_two_prod(k, qdd_ln2_c1));
+}
+
+qdd_t
+qdd_exp(qdd_t a)
+{
+    qdd_t r, p;
+    double k;
+
+    if (!isfinite(a.hi)) {
+        return qdd_special(exp(a.hi));
+    }
+    if (a.hi > QDD_EXP_MAX) {
+        return qdd_special(INFINITY);
+    }
+    if (a.hi < QDD_EXP_MIN) {
+        return qdd_special(0.0);
+    }
+
+    k = nearbyint(a.hi * qdd_inv_ln2);
+    r = qdd_sub_ln2(a, k);
+    p = qdd_add_d(qdd_expm1_reduced(r), 1.0);
+    if (fabs(k) < 1000.0) {
+        return qdd_mul_pow2(p, qdd_pow2((int)k));
+    }
+    return qdd_ldexp(p, (int)k);
+}
+
+qdd_t
+qdd_log(qdd_t a)
+{
+    qdd_t m, x, corr;
+    double x0;
+    int e;
+
+    if (!(a.hi > 0.0) || !isfinite(a.hi)) {
+        return qdd_special(log(a.hi));
+    }
+
+    // a = 2^e m with m in [sqrt(1/2), sqrt(2))
+    frexp(a.hi, &e);
+    m = qdd_ldexp(a, -e);
+    if (m.hi < M_SQRT1_2) {
+        m = qdd_mul_pow2(m, 2.0);
+        e -= 1;
+    }
+
+    // One Newton step x = x0 + m exp(-x0) - 1, with the residual written as
+    // m expm1(-x0) + (m - 1) so it stays accurate when m is close to 1. The
+    // error left is about (x0 - log(m))^2 / 2, hence the first order m.lo
+    // term in x0.
+    x0 = log(m.hi) + m.lo / m.hi;
+    corr = qdd_add(qdd_mul(m, qdd_expm1_reduced(qdd_from_double(-x0))), qdd_add_d(m, -1.0));
+    x = qdd_add_d(corr, x0);
+
+    return qdd_add(x, qdd_mul_ln2((double)e));
+}
+
+static void
+qdd_sincos_reduced(qdd_t r, qdd_t *s, qdd_t *c)
+{
+    // sin(r) and cos(r) for |r| <= pi/4 as series in t = -r^2. Terms from
+    // r^18 on are below 2^-55 of the result and only need double precision.
+    qdd_t t, p;
+    double q;
+    int n;
+
+    t = qdd_neg(qdd_sqr(r));
+
+    q = QDD_INV_FACT(QDD_TRIG_TERMS).hi;
+    for (n = QDD_TRIG_TERMS - 2; n >= QDD_TRIG_DD_TERMS + 1; n -= 2) {
+        q = q * t.hi + QDD_INV_FACT(n).hi;
+    }
+    p = qdd_from_double(q);
+    for (; n >= 3; n -= 2) {
+        p = qdd_add_sloppy(qdd_mul(p, t), QDD_INV_FACT(n));
+    }
+    p = qdd_add_d(qdd_mul(p, t), 1.0);
+    *s = qdd_mul(p, r);
+
+    q = QDD_INV_FACT(QDD_TRIG_TERMS - 1).hi;
+    for (n = QDD_TRIG_TERMS - 3; n >= QDD_TRIG_DD_TERMS; n -= 2) {
+        q = q * t.hi + QDD_INV_FACT(n).hi;
+    }
+    p = qdd_from_double(q);
+    for (; n >= 2; n -= 2) {
+        p = qdd_add_sloppy(qdd_mul(p, t), QDD_INV_FACT(n));
+    }
+    *c = qdd_add_d(qdd_mul(p, t), 1.0);
+}
+
+static int
+qdd_trig_reduce(qdd_t a, qdd_t *r)
+{
+    // a = j pi/2 + r, returns j mod 4. As for exp, j C0 is exact and the
+    // remaining parts are subtracted from the already small remainder.
+    double j;
+
+    j = nearbyint(a.hi * qdd_two_over_pi);
+    *r = qdd_add_d(a, -j * qdd_pio2_c0);
+    *r = qdd_sub(*r, qdd_two_prod(j, qdd_pio2_c1));
+    *r = qdd_add_d(*r, -j * qdd_pio2_c2);
+    return (int)((int64_t)j & 3);
+}
+
+qdd_t
+qdd_sin(qdd_t a)
+{
+    qdd_t r, s, c;
+    int j;
+
+    if (!isfinite(a.hi)) {
+        return qdd_special(sin(a.hi));
+    }
+    if (fabs(a.hi * qdd_two_over_pi) >= QDD_TRIG_MAX_J) {
+        return qdd_from_quad_rn(sinq(qdd_to_quad(a)));
+    }
+
+    j = qdd_trig_reduce(a, &r);
+    qdd_sincos_reduced(r, &s, &c);
+    switch (j) {
+        case 0:
+            return s;
+        case 1:
+            return c;
+        case 2:
+            return qdd_neg(s);
+        default:
+            return qdd_neg(c);
+    }
+}
+
+qdd_t
+qdd_cos(qdd_t a)
+{
+    qdd_t r, s, c;
+    int j;
+
+    if (!isfinite(a.hi)) {
+        return qdd_special(cos(a.hi));
+    }
+    if (fabs(a.hi * qdd_two_over_pi) >= QDD_TRIG_MAX_J) {
+        return qdd_from_quad_rn(cosq(qdd_to_quad(a)));
+    }
+
+    j = qdd_trig_reduce(a, &r);
+    qdd_sincos_reduced(r, &s, &c);
+    switch (j) {
+        case 0:
+            return c;
+        case 1:
+            return qdd_neg(s);
+        case 2:
+            return qdd_neg(c);
+        default:
+            return s;
+    }
+}
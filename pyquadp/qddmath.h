@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+#include "pyquadp.h"
+
+#include "qdd.h"
+
+// Elementary functions in double-double arithmetic.
+//
+// Everything runs on the hardware FPU. Results are accurate to a few units
+// in the last place of a double-double (~2^-104 relative). NaN, Inf and
+// overflow/underflow follow the double routines from libm.
+
+qdd_t qdd_exp(qdd_t a);
+qdd_t qdd_log(qdd_t a);
+qdd_t qdd_sin(qdd_t a);
+qdd_t qdd_cos(qdd_t a);
+
+// Arithmetic with IEEE behaviour for non-finite results. The plain qdd_*
+// routines turn Inf into NaN through their error terms, so any non-finite
+// result is replaced by the double operation on the leading parts.
+
+static inline qdd_t
+qdd_ieee_add(qdd_t a, qdd_t b)
+{
+    qdd_t r = qdd_add(a, b);
+    return isfinite(r.hi) ? r : qdd_special(a.hi + b.hi);
+}
+
+static inline qdd_t
+qdd_ieee_sub(qdd_t a, qdd_t b)
+{
+    qdd_t r = qdd_sub(a, b);
+    return isfinite(r.hi) ? r : qdd_special(a.hi - b.hi);
+}
+
+static inline qdd_t
+qdd_ieee_mul(qdd_t a, qdd_t b)
+{
+    qdd_t r = qdd_mul(a, b);
+    return isfinite(r.hi) ? r : qdd_special(a.hi * b.hi);
+}
+
+static inline qdd_t
+qdd_ieee_div(qdd_t a, qdd_t b)
+{
+    qdd_t r;
+
+    if (!isfinite(a.hi) || !isfinite(b.hi) || b.hi == 0.0) {
+        return qdd_special(a.hi / b.hi);
+    }
+    r = qdd_div(a, b);
+    return isfinite(r.hi) ? r : qdd_special(a.hi / b.hi);
+}
+
+static inline qdd_t
+qdd_ieee_sqrt(qdd_t a)
+{
+    if (!isfinite(a.hi)) {
+        return qdd_special(sqrt(a.hi));
+    }
+    return qdd_sqrt(a);
+}
@@ -0,0 +1,443 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "qdlpack.h"
+
+// The structs of dlpack.h version 1.0, which is not vendored here
+#define QDLPACK_MAJOR 1
+#define QDLPACK_MINOR 0
+#define QDLPACK_CPU 1
+#define QDLPACK_FLAG_READ_ONLY (UINT64_C(1) << 0)
+#define QDLPACK_FLAG_IS_COPIED (UINT64_C(1) << 1)
+// NumPy's NPY_MAXDIMS
+#define QDLPACK_MAX_DIMS 64
+
+typedef struct {
+    int32_t device_type;
+    int32_t device_id;
+} qdlpack_device;
+
+typedef struct {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+} qdlpack_dtype;
+
+typedef struct {
+    void *data;
+    qdlpack_device device;
+    int32_t ndim;
+    qdlpack_dtype dtype;
+    int64_t *shape;
+    // In elements, NULL for C-contiguous
+    int64_t *strides;
+    uint64_t byte_offset;
+} qdlpack_tensor;
+
+typedef struct qdlpack_managed {
+    qdlpack_tensor dl_tensor;
+    void *manager_ctx;
+    void (*deleter)(struct qdlpack_managed *self);
+} qdlpack_managed;
+
+typedef struct qdlpack_managed_versioned {
+    struct {
+        uint32_t major;
+        uint32_t minor;
+    } version;
+    void *manager_ctx;
+    void (*deleter)(struct qdlpack_managed_versioned *self);
+    uint64_t flags;
+    qdlpack_tensor dl_tensor;
+} qdlpack_managed_versioned;
+
+// Capsule names. A consumer renames the capsule once it owns the tensor,
+// and from_dlpack's own base capsules get names of their own.
+static const char qdlpack_legacy_name[] = "dltensor";
+static const char qdlpack_versioned_name[] = "dltensor_versioned";
+static const char qdlpack_used_legacy_name[] = "used_dltensor";
+static const char qdlpack_used_versioned_name[] = "used_dltensor_versioned";
+static const char qdlpack_base_legacy_name[] = "pyquadp.dltensor";
+static const char qdlpack_base_versioned_name[] = "pyquadp.dltensor_versioned";
+
+// Everything to_dlpack allocates for one export, freed by the deleter
+typedef struct {
+    union {
+        qdlpack_managed legacy;
+        qdlpack_managed_versioned versioned;
+    } tensor;
+    PyObject *array;
+    // shape then strides
+    int64_t dims[];
+} qdlpack_export;
+
+static void
+qdlpack_export_free(qdlpack_export *ctx)
+{
+    // The consumer may delete from any thread, with or without the GIL
+    PyGILState_STATE state = PyGILState_Ensure();
+    Py_XDECREF(ctx->array);
+    PyGILState_Release(state);
+    free(ctx);
+}
+
+static void
+qdlpack_delete_legacy(qdlpack_managed *self)
+{
+    qdlpack_export_free(self->manager_ctx);
+}
+
+static void
+qdlpack_delete_versioned(qdlpack_managed_versioned *self)
+{
+    qdlpack_export_free(self->manager_ctx);
+}
+
+// Deletes the tensor of a capsule that still owns it
+static void
+qdlpack_capsule_destructor(PyObject *capsule)
+{
+    const char *name = PyCapsule_GetName(capsule);
+
+    if (name == NULL) {
+        PyErr_Clear();
+        return;
+    }
+    if (strcmp(name, qdlpack_legacy_name) == 0 || strcmp(name, qdlpack_base_legacy_name) == 0) {
+        qdlpack_managed *tensor = PyCapsule_GetPointer(capsule, name);
+        if (tensor != NULL && tensor->deleter != NULL) {
+            tensor->deleter(tensor);
+        }
+    } else if (strcmp(name, qdlpack_versioned_name) == 0 || strcmp(name, qdlpack_base_versioned_name) == 0) {
+        qdlpack_managed_versioned *tensor = PyCapsule_GetPointer(capsule, name);
+        if (tensor != NULL && tensor->deleter != NULL) {
+            tensor->deleter(tensor);
+        }
+    }
+}
+
+// -1 for None, else 0 or 1, -2 on error
+static int
+qdlpack_copy_mode(PyObject *obj)
+{
+    int truth;
+
+    if (obj == NULL || obj == Py_None) {
+        return -1;
+    }
+    truth = PyObject_IsTrue(obj);
+    return truth < 0 ? -2 : truth;
+}
+
+static bool
+qdlpack_strides_ok(const qdlpack_view *view, size_t itemsize)
+{
+    int i;
+
+    for (i = 0; i < view->ndim; i++) {
+        if (view->strides[i] % (Py_ssize_t)itemsize != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PyObject *
+qdlpack_to(const qdlpack_kind *kind, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"x", "max_version", "copy", NULL};
+    PyObject *obj;
+    PyObject *max_version = Py_None;
+    PyObject *copy_obj = Py_None;
+    PyObject *arr;
+    PyObject *capsule;
+    qdlpack_export *ctx;
+    qdlpack_tensor *tensor;
+    qdlpack_view view;
+    Py_ssize_t scalar;
+    bool versioned = false;
+    int copy;
+    int ndim;
+    int i;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$OO:to_dlpack", kwlist, &obj, &max_version, &copy_obj)) {
+        return NULL;
+    }
+    copy = qdlpack_copy_mode(copy_obj);
+    if (copy == -2) {
+        return NULL;
+    }
+    if (max_version != Py_None) {
+        int major;
+        int minor;
+
+        if (!PyArg_ParseTuple(max_version, "ii:max_version", &major, &minor)) {
+            return NULL;
+        }
+        // Without a version the consumer only understands the legacy capsule
+        versioned = major >= QDLPACK_MAJOR;
+    }
+
+    arr = kind->as_array(obj, copy == 1, &view);
+    if (arr != NULL && !view.copied && !qdlpack_strides_ok(&view, kind->itemsize)) {
+        Py_DECREF(arr);
+        arr = kind->as_array(obj, true, &view);
+    }
+    if (arr == NULL) {
+        return NULL;
+    }
+    if (copy == 0 && view.copied) {
+        Py_DECREF(arr);
+        PyErr_Format(PyExc_BufferError,
+                     "to_dlpack needs a copy for this input, a native byte order %s array with whole element strides, "
+                     "but copy=False",
+                     kind->name);
+        return NULL;
+    }
+    if (view.readonly && !versioned) {
+        Py_DECREF(arr);
+        PyErr_SetString(PyExc_BufferError,
+                        "a read-only array can only be exported with max_version=(1, 0) or later, "
+                        "the legacy capsule has no read-only flag");
+        return NULL;
+    }
+
+    // Complex parts add a last dimension, strides count scalars
+    ndim = view.ndim + (kind->parts > 1);
+    scalar = (Py_ssize_t)(kind->itemsize / (size_t)kind->parts);
+    ctx = malloc(sizeof(*ctx) + 2 * (size_t)ndim * sizeof(int64_t));
+    if (ctx == NULL) {
+        Py_DECREF(arr);
+        return PyErr_NoMemory();
+    }
+    memset(&ctx->tensor, 0, sizeof(ctx->tensor));
+    ctx->array = arr;
+    for (i = 0; i < view.ndim; i++) {
+        ctx->dims[i] = (int64_t)view.shape[i];
+        ctx->dims[ndim + i] = (int64_t)(view.strides[i] / scalar);
+    }
+    if (ndim > view.ndim) {
+        ctx->dims[view.ndim] = kind->parts;
+        ctx->dims[ndim + view.ndim] = 1;
+    }
+
+    tensor = versioned ? &ctx->tensor.versioned.dl_tensor : &ctx->tensor.legacy.dl_tensor;
+    tensor->data = view.data;
+    tensor->device.device_type = QDLPACK_CPU;
+    tensor->device.device_id = 0;
+    tensor->ndim = ndim;
+    tensor->dtype.code = kind->code;
+    tensor->dtype.bits = kind->bits;
+    tensor->dtype.lanes = 1;
+    tensor->shape = ctx->dims;
+    tensor->strides = ctx->dims + ndim;
+    tensor->byte_offset = 0;
+
+    if (versioned) {
+        ctx->tensor.versioned.version.major = QDLPACK_MAJOR;
+        ctx->tensor.versioned.version.minor = QDLPACK_MINOR;
+        ctx->tensor.versioned.manager_ctx = ctx;
+        ctx->tensor.versioned.deleter = qdlpack_delete_versioned;
+        ctx->tensor.versioned.flags = (view.readonly ? QDLPACK_FLAG_READ_ONLY : 0)
+                                      | (view.copied ? QDLPACK_FLAG_IS_COPIED : 0);
+        capsule = PyCapsule_New(&ctx->tensor.versioned, qdlpack_versioned_name, qdlpack_capsule_destructor);
+    } else {
+        ctx->tensor.legacy.manager_ctx = ctx;
+        ctx->tensor.legacy.deleter = qdlpack_delete_legacy;
+        capsule = PyCapsule_New(&ctx->tensor.legacy, qdlpack_legacy_name, qdlpack_capsule_destructor);
+    }
+    if (capsule == NULL) {
+        Py_DECREF(arr);
+        free(ctx);
+    }
+    return capsule;
+}
+
+// The capsule of obj, a capsule itself or a DLPack producer
+static PyObject *
+qdlpack_capsule_of(PyObject *obj)
+{
+    PyObject *method;
+    PyObject *device;
+    PyObject *kwargs;
+    PyObject *empty;
+    PyObject *capsule;
+
+    if (PyCapsule_CheckExact(obj)) {
+        Py_INCREF(obj);
+        return obj;
+    }
+
+    device = PyObject_CallMethod(obj, "__dlpack_device__", NULL);
+    if (device == NULL) {
+        if (!PyErr_ExceptionMatches(PyExc_AttributeError)) {
+            return NULL;
+        }
+        PyErr_Clear();
+    } else {
+        int device_type;
+        int device_id;
+        int ok = PyArg_ParseTuple(device, "ii", &device_type, &device_id);
+
+        Py_DECREF(device);
+        if (!ok) {
+            return NULL;
+        }
+        if (device_type != QDLPACK_CPU) {
+            PyErr_Format(PyExc_BufferError, "from_dlpack only supports CPU memory, not DLPack device type %d",
+                         device_type);
+            return NULL;
+        }
+    }
+
+    method = PyObject_GetAttrString(obj, "__dlpack__");
+    if (method == NULL) {
+        if (PyErr_ExceptionMatches(PyExc_AttributeError)) {
+            PyErr_Clear();
+            PyErr_Format(PyExc_TypeError, "from_dlpack needs a DLPack capsule or an object with __dlpack__, not %R",
+                         (PyObject *)Py_TYPE(obj));
+        }
+        return NULL;
+    }
+
+    // Ask for the versioned capsule, falling back for older producers
+    empty = PyTuple_New(0);
+    kwargs = Py_BuildValue("{s(ii)}", "max_version", QDLPACK_MAJOR, QDLPACK_MINOR);
+    capsule = (empty == NULL || kwargs == NULL) ? NULL : PyObject_Call(method, empty, kwargs);
+    Py_XDECREF(empty);
+    Py_XDECREF(kwargs);
+    if (capsule == NULL && PyErr_ExceptionMatches(PyExc_TypeError)) {
+        PyErr_Clear();
+        capsule = PyObject_CallNoArgs(method);
+    }
+    Py_DECREF(method);
+    return capsule;
+}
+
+PyObject *
+qdlpack_from(const qdlpack_kind *kind, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"x", "copy", NULL};
+    PyObject *obj;
+    PyObject *copy_obj = Py_None;
+    PyObject *capsule;
+    PyObject *base;
+    PyObject *arr;
+    qdlpack_managed *legacy = NULL;
+    qdlpack_managed_versioned *versioned = NULL;
+    qdlpack_tensor *tensor;
+    qdlpack_view view;
+    Py_ssize_t shape[QDLPACK_MAX_DIMS];
+    Py_ssize_t strides[QDLPACK_MAX_DIMS];
+    Py_ssize_t scalar;
+    Py_ssize_t step;
+    int copy;
+    int ndim;
+    int i;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$O:from_dlpack", kwlist, &obj, &copy_obj)) {
+        return NULL;
+    }
+    copy = qdlpack_copy_mode(copy_obj);
+    if (copy == -2) {
+        return NULL;
+    }
+
+    capsule = qdlpack_capsule_of(obj);
+    if (capsule == NULL) {
+        return NULL;
+    }
+    if (PyCapsule_IsValid(capsule, qdlpack_versioned_name)) {
+        versioned = PyCapsule_GetPointer(capsule, qdlpack_versioned_name);
+        tensor = &versioned->dl_tensor;
+        if (versioned->version.major > QDLPACK_MAJOR) {
+            PyErr_Format(PyExc_BufferError, "DLPack version %u.%u is newer than the supported %d.%d",
+                         (unsigned)versioned->version.major, (unsigned)versioned->version.minor, QDLPACK_MAJOR,
+                         QDLPACK_MINOR);
+            goto fail;
+        }
+    } else if (PyCapsule_IsValid(capsule, qdlpack_legacy_name)) {
+        legacy = PyCapsule_GetPointer(capsule, qdlpack_legacy_name);
+        tensor = &legacy->dl_tensor;
+    } else {
+        PyErr_SetString(PyExc_TypeError, "expected an unused \"dltensor\" or \"dltensor_versioned\" capsule");
+        goto fail;
+    }
+
+    if (tensor->device.device_type != QDLPACK_CPU) {
+        PyErr_Format(PyExc_BufferError, "from_dlpack only supports CPU memory, not DLPack device type %d",
+                     (int)tensor->device.device_type);
+        goto fail;
+    }
+    if (tensor->dtype.code != kind->code || tensor->dtype.bits != kind->bits || tensor->dtype.lanes != 1) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s arrays need DLPack type code %d with %d bits, got code %d with %d bits and %d lanes",
+                     kind->name, (int)kind->code, (int)kind->bits, (int)tensor->dtype.code, (int)tensor->dtype.bits,
+                     (int)tensor->dtype.lanes);
+        goto fail;
+    }
+    ndim = (int)tensor->ndim - (kind->parts > 1);
+    if (ndim < 0 || ndim > QDLPACK_MAX_DIMS) {
+        PyErr_Format(PyExc_BufferError, "DLPack tensor has %d dimensions", (int)tensor->ndim);
+        goto fail;
+    }
+    // The parts of each element must be next to each other
+    if (kind->parts > 1
+        && (tensor->shape[ndim] != kind->parts || (tensor->strides != NULL && tensor->strides[ndim] != 1))) {
+        PyErr_Format(PyExc_BufferError, "%s arrays need a last dimension of %d contiguous parts", kind->name,
+                     kind->parts);
+        goto fail;
+    }
+
+    // C order strides when the producer leaves them out
+    scalar = (Py_ssize_t)(kind->itemsize / (size_t)kind->parts);
+    step = (Py_ssize_t)kind->itemsize;
+    for (i = ndim - 1; i >= 0; i--) {
+        shape[i] = (Py_ssize_t)tensor->shape[i];
+        if (tensor->strides != NULL) {
+            strides[i] = (Py_ssize_t)tensor->strides[i] * scalar;
+        } else {
+            strides[i] = step;
+            step *= shape[i] > 1 ? shape[i] : 1;
+        }
+    }
+    view.data = (char *)tensor->data + tensor->byte_offset;
+    view.ndim = ndim;
+    view.shape = shape;
+    view.strides = strides;
+    view.readonly = versioned != NULL && (versioned->flags & QDLPACK_FLAG_READ_ONLY);
+    view.copied = false;
+
+    // Take the tensor over: the new base capsule deletes it with the array
+    if (versioned != NULL) {
+        base = PyCapsule_New(versioned, qdlpack_base_versioned_name, qdlpack_capsule_destructor);
+    } else {
+        base = PyCapsule_New(legacy, qdlpack_base_legacy_name, qdlpack_capsule_destructor);
+    }
+    if (base == NULL) {
+        goto fail;
+    }
+    if (PyCapsule_SetName(capsule, versioned != NULL ? qdlpack_used_versioned_name : qdlpack_used_legacy_name) < 0) {
+        // Still owned by the original capsule
+        PyCapsule_SetName(base, "pyquadp.unused");
+        Py_DECREF(base);
+        goto fail;
+    }
+    Py_DECREF(capsule);
+
+    arr = kind->from_view(&view, base);
+    if (arr != NULL && copy == 1) {
+        PyObject *view_arr = arr;
+
+        arr = kind->as_array(view_arr, true, &view);
+        Py_DECREF(view_arr);
+    }
+    return arr;
+
+fail:
+    Py_DECREF(capsule);
+    return NULL;
+}
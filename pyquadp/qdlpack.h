@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+
+// DLPack exchange for the quad array modules.
+//
+// to_dlpack hands out a "dltensor" capsule, or the "dltensor_versioned"
+// capsule of DLPack 1.0, whose tensor points at the array's own memory and
+// keeps the array alive until the consumer calls its deleter. from_dlpack
+// takes such a capsule, or any object with __dlpack__, and wraps the memory
+// in an array of the module's dtype without copying. Only CPU memory is
+// supported.
+//
+// DLPack holds the bits of a type in a uint8, so a 256 bit complex has no
+// type code of its own. qcarray data goes out as 128 bit floats with an
+// extra last dimension of 2 holding the real and imaginary parts, as
+// view_as_real would give.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// DLPack type codes used by the quad dtypes
+#define QDLPACK_INT 0
+#define QDLPACK_FLOAT 2
+
+typedef struct {
+    void *data;
+    int ndim;
+    // ndim entries each, strides in bytes
+    const Py_ssize_t *shape;
+    const Py_ssize_t *strides;
+    bool readonly;
+    // Whether data is a copy rather than the caller's own array
+    bool copied;
+} qdlpack_view;
+
+typedef struct {
+    // Scalar type name for error messages, "qfloat"
+    const char *name;
+    uint8_t code;
+    uint8_t bits;
+    // Scalars of code and bits per element, 2 for a complex as a last
+    // dimension of real and imaginary parts
+    int parts;
+    size_t itemsize;
+    // obj as an array of the module's dtype in native byte order, a new
+    // reference, with view describing it. copy forces a new C-contiguous
+    // array.
+    PyObject *(*as_array)(PyObject *obj, bool copy, qdlpack_view *view);
+    // Array of the module's dtype over view's memory, kept alive by base,
+    // which is stolen even on failure
+    PyObject *(*from_view)(const qdlpack_view *view, PyObject *base);
+} qdlpack_kind;
+
+// to_dlpack(x, *, max_version=None, copy=None)
+PyObject *qdlpack_to(const qdlpack_kind *kind, PyObject *args, PyObject *kwargs);
+
+// from_dlpack(x, *, copy=None)
+PyObject *qdlpack_from(const qdlpack_kind *kind, PyObject *args, PyObject *kwargs);
@@ -0,0 +1,429 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include "qdd.h"
+#include "qfastmath.h"
+
+// exp: x = k ln2/256 + r, exp(x) = 2^(k/256) * (1 + expm1(r)), |r| <= ln2/512
+#define QFAST_EXP_N 256
+#define QFAST_EXP_MAX 11354.0
+
+// log: x = 2^E m, m = F (1 + u) with F = i/256 and |u| <= 2^-9
+#define QFAST_LOG_MIN 181
+#define QFAST_LOG_MAX 362
+
+// sin/cos: x = k pi/128 + r, |r| <= pi/256
+#define QFAST_TRIG_N 256
+#define QFAST_TRIG_MAX_EXP 15
+
+// 2^(j/256) as a significand scaled by 2^15, i.e. in units of 2^-127
+static __uint128_t qfast_exp_table[QFAST_EXP_N];
+// log(i/256) and 256/i in units of 2^-127
+static __float128 qfast_log_table[QFAST_LOG_MAX + 1];
+static __uint128_t qfast_log_inv_table[QFAST_LOG_MAX + 1];
+// sin(j pi/128)
+static __float128 qfast_sin_table[QFAST_TRIG_N];
+static qdd_t qfast_sin_dd_table[QFAST_TRIG_N];
+// Significand of ln2_hi as a 98-bit integer
+static __int128 qfast_ln2_sig;
+
+// 256/ln2 and ln2/256 = C1 + C2 + C3, C1 has 30 significant bits so that
+// k * C1 is exact for |k| < 2^23
+static const double qfast_exp_inv_c = 0x1.71547652b82fep+8;
+static const double qfast_exp_c1 = 0x1.62e42ff000000p-9;
+static const double qfast_exp_c2 = -0x1.718432a1b0e26p-43;
+static const double qfast_exp_c3 = -0x1.9ff0342542fc3p-98;
+
+// 1/k! for k = 2..9, double-double where it matters
+static const qdd_t qfast_exp_dd[] = {
+    {0x1.0000000000000p-1, 0.0},
+    {0x1.5555555555555p-3, 0x1.5555555555555p-57},
+    {0x1.5555555555555p-5, 0x1.5555555555555p-59},
+    {0x1.1111111111111p-7, 0x1.1111111111111p-63},
+};
+static const double qfast_exp_d[] = {
+    0x1.6c16c16c16c17p-10,
+    0x1.a01a01a01a01ap-13,
+    0x1.a01a01a01a01ap-16,
+    0x1.71de3a556c734p-19,
+};
+
+// ln2 = LN2_HI + LN2_LO, LN2_HI has 98 significant bits so E * LN2_HI fits
+// in 113 bits for every quad exponent
+static const __float128 qfast_ln2_hi = 0x1.62e42fefa39ef35793c767300000p-1Q;
+static const double qfast_ln2_lo = 0x1.f97b57a079a19p-103;
+
+// (-1)^(k+1)/k for k = 2..13
+static const qdd_t qfast_log_dd[] = {
+    {-0x1.0000000000000p-1, 0.0},
+    {0x1.5555555555555p-2, 0x1.5555555555555p-56},
+    {-0x1.0000000000000p-2, 0.0},
+    {0x1.999999999999ap-3, -0x1.999999999999ap-57},
+    {-0x1.5555555555555p-3, -0x1.5555555555555p-57},
+    {0x1.2492492492492p-3, 0x1.2492492492492p-57},
+};
+static const double qfast_log_d[] = {
+    -0x1.0000000000000p-3,
+    0x1.c71c71c71c71cp-4,
+    -0x1.999999999999ap-4,
+    0x1.745d1745d1746p-4,
+    -0x1.5555555555555p-4,
+    0x1.3b13b13b13b14p-4,
+};
+
+// 128/pi and pi/128 = P1 + P2 + P3, P1 has 92 significant bits so that
+// k * P1 fits in 113 bits for |k| < 2^21
+static const double qfast_trig_inv_c = 0x1.45f306dc9c883p+5;
+static const __float128 qfast_trig_p1 = 0x1.921fb54442d18469898cc5200000p-6Q;
+static const double qfast_trig_p2 = -0x1.1fc8f8cbb5bf7p-99;
+static const double qfast_trig_p3 = 0x1.c1114cf98e804p-154;
+static __int128 qfast_trig_p1_sig;
+
+// (-1)^k/(2k+1)! for the sine series, (-1)^k/(2k)! for the cosine series
+static const qdd_t qfast_sin_dd[] = {
+    {-0x1.5555555555555p-3, -0x1.5555555555555p-57},
+    {0x1.1111111111111p-7, 0x1.1111111111111p-63},
+    {-0x1.a01a01a01a01ap-13, -0x1.a01a01a01a01ap-73},
+};
+static const double qfast_sin_d[] = {
+    0x1.71de3a556c734p-19,
+    -0x1.ae64567f544e4p-26,
+    0x1.6124613a86d09p-33,
+    -0x1.ae7f3e733b81fp-41,
+};
+static const qdd_t qfast_cos_dd[] = {
+    {-0x1.0000000000000p-1, 0.0},
+    {0x1.5555555555555p-5, 0x1.5555555555555p-59},
+    {-0x1.6c16c16c16c17p-10, 0x1.f49f49f49f49fp-65},
+};
+static const double qfast_cos_d[] = {
+    0x1.a01a01a01a01ap-16,
+    -0x1.27e4fb7789f5cp-22,
+    0x1.1eed8eff8d898p-29,
+    -0x1.93974a8c07c9dp-37,
+};
+
+static inline double
+qfast_round(double x)
+{
+    // Round to nearest integer, valid for |x| < 2^51
+    const double shift = 0x1.8p52;
+
+    return (x + shift) - shift;
+}
+
+static inline qdd_t
+qfast_dd_from_quad(__float128 x)
+{
+    qdd_t r = {0.0, 0.0};
+
+    if (x != 0) {
+        r = qdd_from_quad(x);
+    }
+    return r;
+}
+
+void
+qfast_init(void)
+{
+    int i, e;
+    __float128 pi128 = M_PIq / 128;
+
+    for (i = 0; i < QFAST_EXP_N; ++i) {
+        qfast_exp_table[i] = qdd_quad_significand(exp2q((__float128)i / QFAST_EXP_N), &e) << (15 + e);
+    }
+
+    for (i = QFAST_LOG_MIN; i <= QFAST_LOG_MAX; ++i) {
+        qfast_log_table[i] = logq((__float128)i / 256);
+        qfast_log_inv_table[i] = qdd_quad_significand(256 / (__float128)i, &e) << (15 + e);
+    }
+    qfast_ln2_sig = (__int128)(qdd_quad_significand(qfast_ln2_hi, &e) >> 15);
+    qfast_trig_p1_sig = (__int128)(qdd_quad_significand(qfast_trig_p1, &e) >> 21);
+
+    // Only evaluate sin on [0, pi/2] and fill the rest by symmetry, so that
+    // every entry is as accurate as sinq is on that interval.
+    for (i = 0; i <= QFAST_TRIG_N / 4; ++i) {
+        __float128 s = sinq(i * pi128);
+
+        qfast_sin_table[i] = s;
+        qfast_sin_table[QFAST_TRIG_N / 2 - i] = s;
+        qfast_sin_table[(QFAST_TRIG_N / 2 + i) % QFAST_TRIG_N] = -s;
+        qfast_sin_table[(QFAST_TRIG_N - i) % QFAST_TRIG_N] = -s;
+    }
+    qfast_sin_table[0] = 0;
+    qfast_sin_table[QFAST_TRIG_N / 2] = 0;
+    qfast_sin_table[QFAST_TRIG_N / 4] = 1;
+    qfast_sin_table[3 * QFAST_TRIG_N / 4] = -1;
+
+    for (i = 0; i < QFAST_TRIG_N; ++i) {
+        qfast_sin_dd_table[i] = qfast_dd_from_quad(qfast_sin_table[i]);
+    }
+}
+
+__float128
+qfast_expq(__float128 x)
+{
+    double x1, x2, x3, kd, q;
+    qdd_t r, p, t;
+    int e, k;
+    __uint128_t t1;
+
+    e = qdd_quad_exponent(x);
+    if (e < -60 || e > 13) {
+        // Tiny, huge, NaN, Inf and subnormal inputs
+        return expq(x);
+    }
+
+    qdd_split3(x, &x1, &x2, &x3);
+    if (fabs(x1) > QFAST_EXP_MAX) {
+        return expq(x);
+    }
+
+    // r = x - k ln2/256 in double-double. x1 - k C1 is exact by Sterbenz.
+    kd = qfast_round(x1 * qfast_exp_inv_c);
+    k = (int)kd;
+    t = qdd_two_prod(kd, qfast_exp_c2);
+    r = qdd_two_sum(x1 - kd * qfast_exp_c1, -t.hi);
+    r = qdd_add_d(r, x2);
+    r = qdd_add_d(r, x3 - t.lo - kd * qfast_exp_c3);
+
+    // expm1(r), the tail of the series only needs double precision
+    q = qfast_exp_d[3];
+    q = q * r.hi + qfast_exp_d[2];
+    q = q * r.hi + qfast_exp_d[1];
+    q = q * r.hi + qfast_exp_d[0];
+    p = qdd_add_d(qfast_exp_dd[3], q * r.hi);
+    p = qdd_add_sloppy(qdd_mul(p, r), qfast_exp_dd[2]);
+    p = qdd_add_sloppy(qdd_mul(p, r), qfast_exp_dd[1]);
+    p = qdd_add_sloppy(qdd_mul(p, r), qfast_exp_dd[0]);
+    p = qdd_add_d(qdd_mul(p, r), 1.0);
+    p = qdd_mul(p, r);
+
+    // 2^(j/256) (1 + p) 2^(k/256 - j/256) in fixed point
+    t1 = ((__uint128_t)1 << 126) + (__uint128_t)qdd_wide_from_dd(p, -126);
+    t1 = qdd_umulhi(qfast_exp_table[k & (QFAST_EXP_N - 1)], t1);
+    return qdd_wide_to_quad((__int128)t1, (k >> 8) - 125);
+}
+
+__float128
+qfast_logq(__float128 x)
+{
+    qdd_quad_bits b;
+    unsigned int bexp;
+    int e, i, mscale, uscale, scale;
+    __uint128_t m;
+    __int128 f, u, acc;
+    qdd_t ud, p;
+    double q;
+
+    b.f = x;
+    bexp = (unsigned int)(b.u >> 112);
+    if (bexp == 0 || bexp >= 0x7fff) {
+        // Zero, subnormal, negative, NaN and Inf
+        return logq(x);
+    }
+
+    // x = 2^e m with m = sig 2^mscale in [sqrt(2)/2, sqrt(2))
+    m = qdd_quad_significand(x, &e);
+    mscale = -112;
+    if (m >= (((__uint128_t)0x16a09e667f3bcULL) << 64)) {
+        mscale = -113;
+        e += 1;
+    }
+
+    // f = m - i/256 is exact, u = f 256/i with |u| <= 2^-9
+    i = (int)((m + (((__uint128_t)1) << (-mscale - 9))) >> (-mscale - 8));
+    f = (__int128)m - ((__int128)i << (-mscale - 8));
+    if (f == 0) {
+        if (e == 0 && i == 256) {
+            return 0;
+        }
+        u = 0;
+        ud = qdd_from_double(0.0);
+        uscale = 0;
+    } else {
+        u = (__int128)qdd_umulhi((__uint128_t)(f < 0 ? -f : f) << 23, qfast_log_inv_table[i]);
+        if (f < 0) {
+            u = -u;
+        }
+        uscale = mscale - 22;
+        ud = qdd_from_wide(u, uscale);
+    }
+
+    // log1p(u) - u
+    q = qfast_log_d[5];
+    q = q * ud.hi + qfast_log_d[4];
+    q = q * ud.hi + qfast_log_d[3];
+    q = q * ud.hi + qfast_log_d[2];
+    q = q * ud.hi + qfast_log_d[1];
+    q = q * ud.hi + qfast_log_d[0];
+    p = qdd_add_d(qfast_log_dd[5], q * ud.hi);
+    p = qdd_add_sloppy(qdd_mul(p, ud), qfast_log_dd[4]);
+    p = qdd_add_sloppy(qdd_mul(p, ud), qfast_log_dd[3]);
+    p = qdd_add_sloppy(qdd_mul(p, ud), qfast_log_dd[2]);
+    p = qdd_add_sloppy(qdd_mul(p, ud), qfast_log_dd[1]);
+    p = qdd_add_sloppy(qdd_mul(p, ud), qfast_log_dd[0]);
+    p = qdd_mul(qdd_mul(p, ud), ud);
+
+    if (e == 0 && i == 256) {
+        // x close to 1, the result is u + p and may be tiny
+        scale = uscale - (qdd_clz128((__uint128_t)(u < 0 ? -u : u)) - 3);
+        acc = qdd_wide_shift(u, uscale - scale) + qdd_wide_from_dd(p, scale);
+        return qdd_wide_to_quad(acc, scale);
+    }
+
+    // e ln2 + log(i/256) + u + p, |result| >= 2^-9
+    scale = -125;
+    if (e != 0) {
+        scale += 129 - qdd_clz128((__uint128_t)(e < 0 ? -e : e));
+        p = qdd_add_d(p, e * qfast_ln2_lo);
+    }
+    acc = qdd_wide_shift(e * qfast_ln2_sig, -98 - scale)
+        + qdd_wide_from_quad(qfast_log_table[i], scale)
+        + qdd_wide_shift(u, uscale - scale)
+        + qdd_wide_from_dd(p, scale);
+    return qdd_wide_to_quad(acc, scale);
+}
+
+// Reduce x to r = x - k pi/128 = r0 2^rscale - tail, returns k mod 256 or -1
+// when the fast path can not be used
+static inline int
+qfast_trig_reduce(__float128 x, __int128 *r0, int *rscale, qdd_t *tail, qdd_t *rd)
+{
+    int e, k;
+    double kd;
+    __int128 m;
+
+    e = qdd_quad_exponent(x);
+    if (e < -40 || e >= QFAST_TRIG_MAX_EXP) {
+        return -1;
+    }
+
+    kd = qfast_round(qdd_quad_hi(x) * qfast_trig_inv_c);
+    k = (int)kd;
+    m = (__int128)qdd_quad_significand(x, &e);
+    if (x < 0) {
+        m = -m;
+    }
+    *rscale = e - 112;
+
+    if (k == 0) {
+        *r0 = m;
+        *tail = qdd_from_double(0.0);
+    } else {
+        // |x| >= pi/256 here so |r0| < 2^113 and the wrap-around in the
+        // unsigned arithmetic cancels
+        *r0 = (__int128)((__uint128_t)m - (((__uint128_t)((__int128)k * qfast_trig_p1_sig)) << (15 - e)));
+        if (*r0 == 0) {
+            return -1;
+        }
+        *tail = qdd_two_prod(kd, qfast_trig_p2);
+        tail->lo += kd * qfast_trig_p3;
+    }
+    *rd = qdd_add(qdd_from_wide(*r0, *rscale), qdd_neg(*tail));
+
+    return k & (QFAST_TRIG_N - 1);
+}
+
+static inline void
+qfast_trig_poly(qdd_t rd, qdd_t *sr, qdd_t *cr)
+{
+    // sin(r) - r and cos(r) - 1
+    qdd_t r2, p;
+    double q;
+
+    r2 = qdd_mul(rd, rd);
+
+    q = qfast_sin_d[3];
+    q = q * r2.hi + qfast_sin_d[2];
+    q = q * r2.hi + qfast_sin_d[1];
+    q = q * r2.hi + qfast_sin_d[0];
+    p = qdd_add_d(qfast_sin_dd[2], q * r2.hi);
+    p = qdd_add_sloppy(qdd_mul(p, r2), qfast_sin_dd[1]);
+    p = qdd_add_sloppy(qdd_mul(p, r2), qfast_sin_dd[0]);
+    *sr = qdd_mul(qdd_mul(p, r2), rd);
+
+    q = qfast_cos_d[3];
+    q = q * r2.hi + qfast_cos_d[2];
+    q = q * r2.hi + qfast_cos_d[1];
+    q = q * r2.hi + qfast_cos_d[0];
+    p = qdd_add_d(qfast_cos_dd[2], q * r2.hi);
+    p = qdd_add_sloppy(qdd_mul(p, r2), qfast_cos_dd[1]);
+    p = qdd_add_sloppy(qdd_mul(p, r2), qfast_cos_dd[0]);
+    *cr = qdd_mul(p, r2);
+}
+
+// sin(k pi/128 + r) for a table offset j: j = k for sin, j = k + 64 for cos.
+// slow is the libquadmath routine for the same function.
+static inline __float128
+qfast_trig_eval(__float128 (*slow)(__float128), __float128 x, int j, __int128 r0, int rscale, qdd_t tail, qdd_t rd)
+{
+    qdd_t sr, cr, d;
+    __float128 s, c;
+    __uint128_t ar, prod;
+    __int128 acc;
+    int jc, sh, ec, scale;
+
+    jc = (j + QFAST_TRIG_N / 4) & (QFAST_TRIG_N - 1);
+    s = qfast_sin_table[j];
+    c = qfast_sin_table[jc];
+    ar = (__uint128_t)(r0 < 0 ? -r0 : r0);
+    sh = qdd_clz128(ar) - 1;
+
+    if (s == 0) {
+        // Near a zero of the function the result is +-sin(r) = +-(r + sr),
+        // more bits of pi would be needed when the reduced r is tiny
+        if (tail.hi != 0 && rscale - sh + 127 < -30) {
+            return slow(x);
+        }
+        qfast_trig_poly(rd, &sr, &cr);
+        scale = rscale - sh + 2;
+        acc = qdd_wide_shift(r0, rscale - scale)
+            + qdd_wide_from_dd(qdd_add(sr, qdd_neg(tail)), scale);
+        return c < 0 ? -qdd_wide_to_quad(acc, scale) : qdd_wide_to_quad(acc, scale);
+    }
+
+    // s cos(r) + c sin(r) = s + c r0 + (s (cos(r) - 1) + c (sin(r) - r - tail))
+    qfast_trig_poly(rd, &sr, &cr);
+    d = qdd_add(qdd_mul(qfast_sin_dd_table[j], cr),
+                qdd_mul(qfast_sin_dd_table[jc], qdd_add(sr, qdd_neg(tail))));
+    scale = -125;
+    acc = qdd_wide_from_quad(s, scale) + qdd_wide_from_dd(d, scale);
+    if (c != 0) {
+        prod = qdd_umulhi(qdd_quad_significand(c, &ec) << 15, ar << sh);
+        if ((c < 0) != (r0 < 0)) {
+            acc -= qdd_wide_shift((__int128)prod, ec + 1 + rscale - sh - scale);
+        } else {
+            acc += qdd_wide_shift((__int128)prod, ec + 1 + rscale - sh - scale);
+        }
+    }
+    return qdd_wide_to_quad(acc, scale);
+}
+
+__float128
+qfast_sinq(__float128 x)
+{
+    int j, rscale;
+    __int128 r0;
+    qdd_t tail, rd;
+
+    j = qfast_trig_reduce(x, &r0, &rscale, &tail, &rd);
+    if (j < 0) {
+        return sinq(x);
+    }
+    return qfast_trig_eval(sinq, x, j, r0, rscale, tail, rd);
+}
+
+__float128
+qfast_cosq(__float128 x)
+{
+    int j, rscale;
+    __int128 r0;
+    qdd_t tail, rd;
+
+    j = qfast_trig_reduce(x, &r0, &rscale, &tail, &rd);
+    if (j < 0) {
+        return cosq(x);
+    }
+    return qfast_trig_eval(cosq, x, (j + QFAST_TRIG_N / 4) & (QFAST_TRIG_N - 1), r0, rscale, tail, rd);
+}
@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+#include "pyquadp.h"
+
+// Fast, slightly less accurate replacements for a few libquadmath routines.
+//
+// The kernels do their range reduction in __float128 and evaluate the
+// polynomial part in double-double arithmetic on the hardware FPU. Inputs
+// outside the ranges handled by the fast path (NaN, Inf, subnormals, huge
+// arguments, ...) fall through to the libquadmath routine, so every input
+// gives a sensible answer. Errors are bounded by a few ULPs, see README.md.
+
+// Must be called once before any of the kernels are used
+void qfast_init(void);
+
+__float128 qfast_expq(__float128 x);
+__float128 qfast_logq(__float128 x);
+__float128 qfast_sinq(__float128 x);
+__float128 qfast_cosq(__float128 x);
@@ -3,6 +3,8 @@
 
 #define QFLOAT_MODULE
 #include "qfloat.h"
+#include "qformat.h"
+#include "qparse.h"
 
 static PyTypeObject *QuadType = NULL;
 
@@ -11,28 +13,67 @@ static PyTypeObject *QuadType = NULL;
 static PyObject *
 QuadObject_repr(QuadObject * obj)
 {
-    char buf[QUAD_BUF];
-
-    int n = quadmath_snprintf (buf, sizeof buf, "%.36Qe", obj->value);
-    if ((size_t) n < sizeof buf)
-        return PyUnicode_FromFormat("qfloat('%s')",
-                                buf);
-    else
-        return PyUnicode_FromFormat("%s","Bad quad");
+    char buf[QFORMAT_REPR_SIZE];
 
+    qformat_repr(obj->value, buf);
+    return PyUnicode_FromFormat("qfloat('%s')", buf);
 }
 
 
 static PyObject *
 QuadObject_str(QuadObject * obj)
 {
-    char buf[QUAD_BUF];
+    char buf[QFORMAT_REPR_SIZE];
 
-    int n = quadmath_snprintf (buf, sizeof buf, "%.36Qe", obj->value);
-    if ((size_t) n < sizeof buf)
-        return PyUnicode_FromFormat("%s",buf);
-    else
-        return PyUnicode_FromFormat("%s","Bad quad");
+    int n = qformat_repr(obj->value, buf);
+    return PyUnicode_FromStringAndSize(buf, n);
+}
+
+
+static PyObject *
+QuadObject_format(QuadObject * obj, PyObject * arg)
+{
+    const char *spec_str;
+    Py_ssize_t spec_len;
+    qformat_spec spec;
+    char small[128];
+    char *buf = small;
+    PyObject *result;
+    int n;
+
+    if (!PyUnicode_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "format spec must be a str");
+        return NULL;
+    }
+    spec_str = PyUnicode_AsUTF8AndSize(arg, &spec_len);
+    if (spec_str == NULL) {
+        return NULL;
+    }
+    if (!qformat_parse_spec(spec_str, (size_t)spec_len, &spec)) {
+        PyErr_Format(PyExc_ValueError, "Invalid format specifier '%U' for object of type 'qfloat'", arg);
+        return NULL;
+    }
+
+    n = qformat_apply(obj->value, &spec, small, sizeof small);
+    if (n >= 0 && (size_t)n >= sizeof small) {
+        buf = PyMem_Malloc((size_t)n + 1);
+        if (buf == NULL) {
+            return PyErr_NoMemory();
+        }
+        n = qformat_apply(obj->value, &spec, buf, (size_t)n + 1);
+    }
+    if (n < 0) {
+        if (buf != small) {
+            PyMem_Free(buf);
+        }
+        return PyErr_NoMemory();
+    }
+
+    result = PyUnicode_FromStringAndSize(buf, n);
+    if (buf != small) {
+        PyMem_Free(buf);
+    }
+    return result;
 }
 
 
@@ -428,24 +469,28 @@ static PyObject* _as_parameter_(PyObject * self, void * y){
 }
 
 //Pickling
+static PyObject *QuadObject_unpickle = NULL;
+
+// Module level _from_bytes, so a pickle names it once and then holds only the
+// raw bytes of each qfloat
+static PyObject *
+QuadObject__from_bytes(PyObject *module, PyObject *arg) {
+    (void)module;
+    return QuadObject_from_bytes(QuadType, arg);
+}
+
 static PyObject *
-QuadObject___getstate__(QuadObject *self, PyObject *Py_UNUSED(ignored)) {
+QuadObject___reduce__(QuadObject *self, PyObject *Py_UNUSED(ignored)) {
     PyObject *bytes_obj = QuadObject_to_bytes(self, NULL);
-    PyObject *ret;
 
     if (bytes_obj == NULL) {
         return NULL;
     }
-
-    ret = Py_BuildValue("{sisN}",
-                        PICKLE_VERSION_KEY, PICKLE_VERSION,
-                        "bytes", bytes_obj);
-    return ret;
+    return Py_BuildValue("O(N)", QuadObject_unpickle, bytes_obj);
 }
 
-	
 
-/* Un-pickle the object */
+/* Un-pickle the dict state written by older versions */
 static PyObject *
 QuadObject___setstate__(QuadObject *self, PyObject *state) {
 
@@ -963,8 +1008,8 @@ static PyMethodDef Quad_methods[] = {
     {"to_bytes", (PyCFunction) QuadObject_to_bytes, METH_NOARGS, "to_bytes"},
     {"from_bytes", (PyCFunction) QuadObject_from_bytes, METH_CLASS|METH_O, "from_bytes"},
     {"from_param", (PyCFunction) QuadObject_from_param, METH_CLASS|METH_O, "from_param"},
-    {"__getstate__", (PyCFunction) QuadObject___getstate__, METH_NOARGS, "Pickle a quad object object" },
-    {"__setstate__", (PyCFunction) QuadObject___setstate__, METH_O,"Un-pickle a quad object object"},
+    {"__reduce__", (PyCFunction) QuadObject___reduce__, METH_NOARGS, "Pickle a qfloat as its raw bytes" },
+    {"__setstate__", (PyCFunction) QuadObject___setstate__, METH_O,"Un-pickle a qfloat from an older pickle"},
     {"hex", (PyCFunction) QuadObject_to_hex, METH_NOARGS, "to_hex"},
     {"fromhex", (PyCFunction) QuadObject_from_hex, METH_CLASS|METH_O, "from_hex"},
     {"as_integer_ratio", (PyCFunction) QuadObject_as_integer_ratio, METH_NOARGS, "Return (numerator, denominator) exact ratio for finite qfloat."},
@@ -973,6 +1018,7 @@ static PyMethodDef Quad_methods[] = {
     {"__floor__", (PyCFunction) QuadObject_floor_method, METH_NOARGS, "Floor qfloat and return qfloat."},
     {"__ceil__", (PyCFunction) QuadObject_ceil_method, METH_NOARGS, "Ceil qfloat and return qfloat."},
     {"is_integer", (PyCFunction) QuadObject_is_integer, METH_NOARGS, "Return True if qfloat has no fractional component."},
+    {"__format__", (PyCFunction) QuadObject_format, METH_O, "Format qfloat with a float format spec."},
     
     {NULL}  /* Sentinel */
 };
@@ -1046,11 +1092,17 @@ static PyType_Spec QuadType_spec = {
     .slots = QuadType_slots,
 };
 
+static PyMethodDef QuadModule_methods[] = {
+    {"_from_bytes", (PyCFunction) QuadObject__from_bytes, METH_O, "Un-pickle a qfloat from its raw bytes"},
+    {NULL}  /* Sentinel */
+};
+
 static PyModuleDef QuadModule = {
     PyModuleDef_HEAD_INIT,
     .m_name = "qmfloat",
     .m_doc = PyDoc_STR("Quad precision module for scalar quad's."),
     .m_size = -1,
+    .m_methods = QuadModule_methods,
 };
 
 PyObject* 
@@ -1091,30 +1143,13 @@ PyObject_to_QuadObject(PyObject * in, QuadObject * out, const bool alloc)
 
     if(PyUnicode_Check(in)){
         // Is a string
-        const char *buf = PyUnicode_AsUTF8AndSize(in, NULL);
+        Py_ssize_t len;
+        const char *buf = PyUnicode_AsUTF8AndSize(in, &len);
         if (buf==NULL){
             return false;
         }
 
-        if(strcmp(buf,"nan")==0) {
-            out->value = nanq("");
-        } else if (strcmp(buf,"inf")==0){
-            out->value = INFINITY;
-        } else if (strcmp(buf,"-inf")==0){
-            out->value = -INFINITY;
-        } else {
-            char *sp=NULL;
-
-            out->value = strtoflt128(buf, &sp);
-            if(sp!=NULL){
-                if(strcmp(sp,"")!=0){
-                   // printf("%s %d\n",sp,strcmp(sp,""));
-                    return false;
-                }
-            }
-        } 
-
-        return true;
+        return qparse_string(buf, (size_t)len, &out->value);
     }
 
     if(PyNumber_Check(in)) {
@@ -1220,6 +1255,12 @@ PyInit_qmfloat(void)
     if (m == NULL)
         return NULL;
 
+    QuadObject_unpickle = PyObject_GetAttrString(m, "_from_bytes");
+    if (QuadObject_unpickle == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
     quad_type_obj = PyType_FromSpec(&QuadType_spec);
     if (quad_type_obj == NULL) {
         Py_DECREF(m);
@@ -10,20 +10,48 @@
 #include <numpy/arrayobject.h>
 #include <numpy/npy_math.h>
 #include <numpy/ufuncobject.h>
+#include <fenv.h>
+#include <float.h>
 #include <stdalign.h>
 #include <string.h>
 
 #define QFLOATARRAY_MODULE
 #include "qfloatarray.h"
 #include "qfloat.h"
+#include "qfastmath.h"
+#include "qformat.h"
+#include "qsoftquad.h"
+#include "qparse.h"
+#include "qreduce.h"
+#include "qarrow.h"
+#include "qdlpack.h"
+#include "qtable.h"
+#include "qtext.h"
 
 static int QuadArrayTypeNum = -1;
+// Per-thread switch between libquadmath and the qfastmath kernels
+static _Thread_local bool QuadArrayFastMath = false;
 PyArray_ArrFuncs QuadArrayFuncs;
 PyArray_Descr* QuadArrayDescr;
 PyArray_DescrProto QuadArrayDescrProto = {PyObject_HEAD_INIT(NULL)};
 
 static int QuadArray_setitem(PyObject* item, __float128* data, void* array);
 
+// True when every operand of an inner loop is a packed run of quads, which
+// lets the batched qsoftquad kernels take the whole loop
+static inline bool
+QuadArray_is_contiguous(const npy_intp *steps, int nargs)
+{
+  int i;
+
+  for (i = 0; i < nargs; ++i) {
+    if (steps[i] != (npy_intp)sizeof(__float128)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static void
 QuadArray_ufunc_add(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
 {
@@ -32,9 +60,18 @@ QuadArray_ufunc_add(char **args, const npy_intp *dims, const npy_intp *steps, vo
   char *in1 = args[0];
   char *in2 = args[1];
   char *out = args[2];
+  __float128 r;
+
+  if (QuadArray_is_contiguous(steps, 3)) {
+    qsoft_add_n((const __float128 *)in1, (const __float128 *)in2, (__float128 *)out, (size_t)n);
+    return;
+  }
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = *(__float128 *)in1 + *(__float128 *)in2;
+    if (!qsq_add(*(__float128 *)in1, *(__float128 *)in2, &r)) {
+      r = *(__float128 *)in1 + *(__float128 *)in2;
+    }
+    *(__float128 *)out = r;
     in1 += steps[0];
     in2 += steps[1];
     out += steps[2];
@@ -49,9 +86,18 @@ QuadArray_ufunc_subtract(char **args, const npy_intp *dims, const npy_intp *step
   char *in1 = args[0];
   char *in2 = args[1];
   char *out = args[2];
+  __float128 r;
+
+  if (QuadArray_is_contiguous(steps, 3)) {
+    qsoft_sub_n((const __float128 *)in1, (const __float128 *)in2, (__float128 *)out, (size_t)n);
+    return;
+  }
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = *(__float128 *)in1 - *(__float128 *)in2;
+    if (!qsq_sub(*(__float128 *)in1, *(__float128 *)in2, &r)) {
+      r = *(__float128 *)in1 - *(__float128 *)in2;
+    }
+    *(__float128 *)out = r;
     in1 += steps[0];
     in2 += steps[1];
     out += steps[2];
@@ -66,9 +112,18 @@ QuadArray_ufunc_multiply(char **args, const npy_intp *dims, const npy_intp *step
   char *in1 = args[0];
   char *in2 = args[1];
   char *out = args[2];
+  __float128 r;
+
+  if (QuadArray_is_contiguous(steps, 3)) {
+    qsoft_mul_n((const __float128 *)in1, (const __float128 *)in2, (__float128 *)out, (size_t)n);
+    return;
+  }
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = *(__float128 *)in1 * *(__float128 *)in2;
+    if (!qsq_mul(*(__float128 *)in1, *(__float128 *)in2, &r)) {
+      r = *(__float128 *)in1 * *(__float128 *)in2;
+    }
+    *(__float128 *)out = r;
     in1 += steps[0];
     in2 += steps[1];
     out += steps[2];
@@ -76,24 +131,35 @@ QuadArray_ufunc_multiply(char **args, const npy_intp *dims, const npy_intp *step
 }
 
 static void
-QuadArray_ufunc_divide(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_ufunc_fma(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
 {
   npy_intp i;
   npy_intp n = dims[0];
   char *in1 = args[0];
   char *in2 = args[1];
-  char *out = args[2];
+  char *in3 = args[2];
+  char *out = args[3];
+  __float128 r;
+
+  if (QuadArray_is_contiguous(steps, 4)) {
+    qsoft_fma_n((const __float128 *)in1, (const __float128 *)in2, (const __float128 *)in3, (__float128 *)out, (size_t)n);
+    return;
+  }
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = *(__float128 *)in1 / *(__float128 *)in2;
+    if (!qsq_fma(*(__float128 *)in1, *(__float128 *)in2, *(__float128 *)in3, &r)) {
+      r = fmaq(*(__float128 *)in1, *(__float128 *)in2, *(__float128 *)in3);
+    }
+    *(__float128 *)out = r;
     in1 += steps[0];
     in2 += steps[1];
-    out += steps[2];
+    in3 += steps[2];
+    out += steps[3];
   }
 }
 
 static void
-QuadArray_ufunc_power(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_ufunc_divide(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
 {
   npy_intp i;
   npy_intp n = dims[0];
@@ -102,7 +168,7 @@ QuadArray_ufunc_power(char **args, const npy_intp *dims, const npy_intp *steps,
   char *out = args[2];
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = powq(*(__float128 *)in1, *(__float128 *)in2);
+    *(__float128 *)out = *(__float128 *)in1 / *(__float128 *)in2;
     in1 += steps[0];
     in2 += steps[1];
     out += steps[2];
@@ -110,171 +176,402 @@ QuadArray_ufunc_power(char **args, const npy_intp *dims, const npy_intp *steps,
 }
 
 static void
-QuadArray_ufunc_add_qd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_ufunc_power(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
 {
   npy_intp i;
   npy_intp n = dims[0];
-  char *inq = args[0];
-  char *ind = args[1];
+  char *in1 = args[0];
+  char *in2 = args[1];
   char *out = args[2];
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = *(__float128 *)inq + (__float128)(*(npy_float64 *)ind);
-    inq += steps[0];
-    ind += steps[1];
+    *(__float128 *)out = powq(*(__float128 *)in1, *(__float128 *)in2);
+    in1 += steps[0];
+    in2 += steps[1];
     out += steps[2];
   }
 }
 
-static void
-QuadArray_ufunc_add_dq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+static inline __float128
+QuadArray_op_add(__float128 a, __float128 b)
 {
-  npy_intp i;
-  npy_intp n = dims[0];
-  char *ind = args[0];
-  char *inq = args[1];
-  char *out = args[2];
+  __float128 r;
 
-  for (i = 0; i < n; ++i) {
-    *(__float128 *)out = (__float128)(*(npy_float64 *)ind) + *(__float128 *)inq;
-    ind += steps[0];
-    inq += steps[1];
-    out += steps[2];
+  if (!qsq_add(a, b, &r)) {
+    r = a + b;
+  }
+  return r;
+}
+
+static inline __float128
+QuadArray_op_subtract(__float128 a, __float128 b)
+{
+  __float128 r;
+
+  if (!qsq_sub(a, b, &r)) {
+    r = a - b;
+  }
+  return r;
+}
+
+static inline __float128
+QuadArray_op_multiply(__float128 a, __float128 b)
+{
+  __float128 r;
+
+  if (!qsq_mul(a, b, &r)) {
+    r = a * b;
   }
+  return r;
 }
 
+static inline __float128
+QuadArray_op_divide(__float128 a, __float128 b)
+{
+  return a / b;
+}
+
+static inline __float128
+QuadArray_op_power(__float128 a, __float128 b)
+{
+  return powq(a, b);
+}
+
+typedef void QuadArray_block_func(const __float128 *, const __float128 *, __float128 *, size_t);
+
 static void
-QuadArray_ufunc_subtract_qd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_block_add(const __float128 *a, const __float128 *b, __float128 *out, size_t n)
 {
-  npy_intp i;
-  npy_intp n = dims[0];
-  char *inq = args[0];
-  char *ind = args[1];
-  char *out = args[2];
+  qsoft_add_n(a, b, out, n);
+}
+
+static void
+QuadArray_block_subtract(const __float128 *a, const __float128 *b, __float128 *out, size_t n)
+{
+  qsoft_sub_n(a, b, out, n);
+}
+
+static void
+QuadArray_block_multiply(const __float128 *a, const __float128 *b, __float128 *out, size_t n)
+{
+  qsoft_mul_n(a, b, out, n);
+}
+
+static void
+QuadArray_block_divide(const __float128 *a, const __float128 *b, __float128 *out, size_t n)
+{
+  size_t i;
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = *(__float128 *)inq - (__float128)(*(npy_float64 *)ind);
-    inq += steps[0];
-    ind += steps[1];
-    out += steps[2];
+    out[i] = a[i] / b[i];
   }
 }
 
 static void
-QuadArray_ufunc_subtract_dq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_block_power(const __float128 *a, const __float128 *b, __float128 *out, size_t n)
 {
-  npy_intp i;
-  npy_intp n = dims[0];
-  char *ind = args[0];
-  char *inq = args[1];
-  char *out = args[2];
+  size_t i;
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = (__float128)(*(npy_float64 *)ind) - *(__float128 *)inq;
-    ind += steps[0];
-    inq += steps[1];
-    out += steps[2];
+    out[i] = powq(a[i], b[i]);
   }
 }
 
-static void
-QuadArray_ufunc_multiply_qd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+// Loops pairing a qarray with another NumPy type convert the other operand
+// a block at a time into a small stack buffer, rather than NumPy casting it
+// into its own 8192 element buffer first. Converting straight into the
+// operand of each division or libgcc call is slower still, as the bits are
+// built in integer registers and read back as a __float128 at once, which
+// stalls store forwarding. Every type listed converts to quad exactly.
+#define QARRAY_MIXED_BLOCK 256
+
+#define QARRAY_MIXED_TYPES(X) \
+  X(d, npy_float64, NPY_DOUBLE, qdd_double_to_quad) \
+  X(f, npy_float32, NPY_FLOAT, qdd_double_to_quad) \
+  X(l, npy_int64, NPY_INT64, QuadArray_from_int64) \
+  X(i, npy_int32, NPY_INT32, QuadArray_from_int64)
+
+#define QARRAY_MIXED_OPS(X, suffix, ctype, convert) \
+  X(add, suffix, ctype, convert) \
+  X(subtract, suffix, ctype, convert) \
+  X(multiply, suffix, ctype, convert) \
+  X(divide, suffix, ctype, convert) \
+  X(power, suffix, ctype, convert)
+
+static inline __float128
+QuadArray_from_int64(npy_int64 v)
 {
+  qdd_quad_bits b;
+  uint64_t a = v < 0 ? -(uint64_t)v : (uint64_t)v;
+  int n;
+
+  if (a == 0) {
+    return 0;
+  }
+  n = 63 - __builtin_clzll(a);
+  b.u = ((__uint128_t)(v < 0) << 127)
+      | ((__uint128_t)(n + QDD_QUAD_BIAS) << 112)
+      | (((__uint128_t)a << (112 - n)) & QSQ_MANT_MASK);
+  return b.f;
+}
+
+static void
+QuadArray_mixed_block(
+  QuadArray_block_func *func,
+  const __float128 *x,
+  bool x_first,
+  char *inq,
+  npy_intp qstep,
+  char *out,
+  npy_intp ostep,
+  npy_intp n)
+{
+  // x holds the converted operand, the qarray operand and the output are
+  // gathered and scattered when strided
+  __float128 qbuf[QARRAY_MIXED_BLOCK];
+  __float128 obuf[QARRAY_MIXED_BLOCK];
+  const __float128 *q = (const __float128 *)inq;
+  __float128 *o = (__float128 *)out;
   npy_intp i;
-  npy_intp n = dims[0];
-  char *inq = args[0];
-  char *ind = args[1];
-  char *out = args[2];
 
-  for (i = 0; i < n; ++i) {
-    *(__float128 *)out = *(__float128 *)inq * (__float128)(*(npy_float64 *)ind);
-    inq += steps[0];
-    ind += steps[1];
-    out += steps[2];
+  if (qstep != sizeof(__float128)) {
+    for (i = 0; i < n; ++i) {
+      qbuf[i] = *(__float128 *)(inq + i * qstep);
+    }
+    q = qbuf;
+  }
+  if (ostep != sizeof(__float128)) {
+    o = obuf;
+  }
+
+  if (x_first) {
+    func(x, q, o, (size_t)n);
+  } else {
+    func(q, x, o, (size_t)n);
+  }
+
+  if (o == obuf) {
+    for (i = 0; i < n; ++i) {
+      *(__float128 *)(out + i * ostep) = obuf[i];
+    }
+  }
+}
+
+#define QARRAY_DEFINE_MIXED_LOOP_SIDE(op, suffix, ctype, convert, name, xarg, qarg, x_first) \
+static void \
+QuadArray_ufunc_##op##_##name(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+  __float128 x[QARRAY_MIXED_BLOCK]; \
+  npy_intp n = dims[0]; \
+  npy_intp i, j, m; \
+ \
+  if (qarg == 0 && args[0] == args[2] && steps[0] == 0 && steps[2] == 0) { \
+    /* A reduction such as np.add.reduce(x, dtype=qarray.dtype), which \
+       folds x into one quad accumulator */ \
+    __float128 acc = *(__float128 *)args[0]; \
+ \
+    for (i = 0; i < n; i += m) { \
+      m = n - i < QARRAY_MIXED_BLOCK ? n - i : QARRAY_MIXED_BLOCK; \
+      for (j = 0; j < m; ++j) { \
+        x[j] = convert(*(ctype *)(args[xarg] + (i + j) * steps[xarg])); \
+      } \
+      for (j = 0; j < m; ++j) { \
+        acc = QuadArray_op_##op(acc, x[j]); \
+      } \
+    } \
+    *(__float128 *)args[2] = acc; \
+    return; \
+  } \
+ \
+  for (i = 0; i < n; i += m) { \
+    m = n - i < QARRAY_MIXED_BLOCK ? n - i : QARRAY_MIXED_BLOCK; \
+    for (j = 0; j < m; ++j) { \
+      x[j] = convert(*(ctype *)(args[xarg] + (i + j) * steps[xarg])); \
+    } \
+    QuadArray_mixed_block(QuadArray_block_##op, x, x_first, args[qarg] + i * steps[qarg], steps[qarg], \
+                          args[2] + i * steps[2], steps[2], m); \
+  } \
+}
+
+#define QARRAY_DEFINE_MIXED_LOOP(op, suffix, ctype, convert) \
+  QARRAY_DEFINE_MIXED_LOOP_SIDE(op, suffix, ctype, convert, q##suffix, 1, 0, false) \
+  QARRAY_DEFINE_MIXED_LOOP_SIDE(op, suffix, ctype, convert, suffix##q, 0, 1, true)
+
+#define QARRAY_DEFINE_MIXED_LOOPS(suffix, ctype, npy_type, convert) \
+  QARRAY_MIXED_OPS(QARRAY_DEFINE_MIXED_LOOP, suffix, ctype, convert)
+
+QARRAY_MIXED_TYPES(QARRAY_DEFINE_MIXED_LOOPS)
+
+#undef QARRAY_DEFINE_MIXED_LOOPS
+#undef QARRAY_DEFINE_MIXED_LOOP
+#undef QARRAY_DEFINE_MIXED_LOOP_SIDE
+
+// Error-free transformations. two_sum and two_prod return the rounded
+// result together with its exact error, so s + e == a + b and p + e == a * b
+// hold exactly unless the result overflows (e is then 0) or, for two_prod,
+// the error underflows. split rounds a quad to the nearest double-double
+// and join adds the two doubles back with a single rounding, so
+// join(split(x)) == x whenever x fits in the 106 bits of a double-double.
+
+static void
+QuadArray_ufunc_two_sum(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  // Fast2Sum on each block after ordering every pair by magnitude:
+  // e = b - (s - a) is exact when |a| >= |b|
+  __float128 big[QARRAY_MIXED_BLOCK];
+  __float128 small[QARRAY_MIXED_BLOCK];
+  __float128 s[QARRAY_MIXED_BLOCK];
+  __float128 e[QARRAY_MIXED_BLOCK];
+  npy_intp n = dims[0];
+  npy_intp i, j, m;
+
+  for (i = 0; i < n; i += m) {
+    m = n - i < QARRAY_MIXED_BLOCK ? n - i : QARRAY_MIXED_BLOCK;
+    for (j = 0; j < m; ++j) {
+      qdd_quad_bits a, b;
+
+      a.f = *(__float128 *)(args[0] + (i + j) * steps[0]);
+      b.f = *(__float128 *)(args[1] + (i + j) * steps[1]);
+      if ((a.u << 1) >= (b.u << 1)) {
+        big[j] = a.f;
+        small[j] = b.f;
+      } else {
+        big[j] = b.f;
+        small[j] = a.f;
+      }
+    }
+    qsoft_add_n(big, small, s, (size_t)m);
+    qsoft_sub_n(s, big, e, (size_t)m);
+    qsoft_sub_n(small, e, e, (size_t)m);
+    for (j = 0; j < m; ++j) {
+      *(__float128 *)(args[2] + (i + j) * steps[2]) = s[j];
+      *(__float128 *)(args[3] + (i + j) * steps[3]) = isfinite(s[j]) ? e[j] : 0;
+    }
   }
 }
 
 static void
-QuadArray_ufunc_multiply_dq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_ufunc_two_prod(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
 {
-  npy_intp i;
+  __float128 a[QARRAY_MIXED_BLOCK];
+  __float128 b[QARRAY_MIXED_BLOCK];
+  __float128 p[QARRAY_MIXED_BLOCK];
+  __float128 e[QARRAY_MIXED_BLOCK];
   npy_intp n = dims[0];
-  char *ind = args[0];
-  char *inq = args[1];
-  char *out = args[2];
+  npy_intp i, j, m;
 
-  for (i = 0; i < n; ++i) {
-    *(__float128 *)out = (__float128)(*(npy_float64 *)ind) * *(__float128 *)inq;
-    ind += steps[0];
-    inq += steps[1];
-    out += steps[2];
+  for (i = 0; i < n; i += m) {
+    m = n - i < QARRAY_MIXED_BLOCK ? n - i : QARRAY_MIXED_BLOCK;
+    for (j = 0; j < m; ++j) {
+      a[j] = *(__float128 *)(args[0] + (i + j) * steps[0]);
+      b[j] = *(__float128 *)(args[1] + (i + j) * steps[1]);
+    }
+    qsoft_mul_n(a, b, p, (size_t)m);
+    for (j = 0; j < m; ++j) {
+      e[j] = -p[j];
+    }
+    qsoft_fma_n(a, b, e, e, (size_t)m);
+    for (j = 0; j < m; ++j) {
+      *(__float128 *)(args[2] + (i + j) * steps[2]) = p[j];
+      *(__float128 *)(args[3] + (i + j) * steps[3]) = isfinite(p[j]) ? e[j] : 0;
+    }
   }
 }
 
 static void
-QuadArray_ufunc_divide_qd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_ufunc_two_sum_float64(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
 {
   npy_intp i;
   npy_intp n = dims[0];
-  char *inq = args[0];
-  char *ind = args[1];
-  char *out = args[2];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out1 = args[2];
+  char *out2 = args[3];
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = *(__float128 *)inq / (__float128)(*(npy_float64 *)ind);
-    inq += steps[0];
-    ind += steps[1];
-    out += steps[2];
+    qdd_t r = qdd_two_sum(*(double *)in1, *(double *)in2);
+
+    *(double *)out1 = r.hi;
+    *(double *)out2 = isfinite(r.hi) ? r.lo : 0.0;
+    in1 += steps[0];
+    in2 += steps[1];
+    out1 += steps[2];
+    out2 += steps[3];
   }
 }
 
 static void
-QuadArray_ufunc_divide_dq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_ufunc_two_prod_float64(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
 {
   npy_intp i;
   npy_intp n = dims[0];
-  char *ind = args[0];
-  char *inq = args[1];
-  char *out = args[2];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out1 = args[2];
+  char *out2 = args[3];
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = (__float128)(*(npy_float64 *)ind) / *(__float128 *)inq;
-    ind += steps[0];
-    inq += steps[1];
-    out += steps[2];
+    double a = *(double *)in1;
+    double b = *(double *)in2;
+    double p = a * b;
+
+    *(double *)out1 = p;
+    *(double *)out2 = isfinite(p) ? fma(a, b, -p) : 0.0;
+    in1 += steps[0];
+    in2 += steps[1];
+    out1 += steps[2];
+    out2 += steps[3];
   }
 }
 
 static void
-QuadArray_ufunc_power_qd(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_ufunc_split(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
 {
   npy_intp i;
   npy_intp n = dims[0];
-  char *inq = args[0];
-  char *ind = args[1];
-  char *out = args[2];
+  char *in = args[0];
+  char *out1 = args[1];
+  char *out2 = args[2];
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = powq(*(__float128 *)inq, (__float128)(*(npy_float64 *)ind));
-    inq += steps[0];
-    ind += steps[1];
-    out += steps[2];
+    __float128 x = *(__float128 *)in;
+    double hi, lo;
+
+    if (!qdd_quad_split_rn(x, &hi, &lo)) {
+      // x - hi is exact as hi is x rounded to double
+      hi = qdd_quad_to_double(x);
+      lo = isfinite(hi) ? qdd_quad_to_double(QuadArray_op_subtract(x, qdd_double_to_quad(hi))) : 0.0;
+      if (lo == 0.0) {
+        lo = copysign(0.0, hi);
+      }
+    }
+    *(double *)out1 = hi;
+    *(double *)out2 = lo;
+    in += steps[0];
+    out1 += steps[1];
+    out2 += steps[2];
   }
 }
 
 static void
-QuadArray_ufunc_power_dq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+QuadArray_ufunc_join(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
 {
   npy_intp i;
   npy_intp n = dims[0];
-  char *ind = args[0];
-  char *inq = args[1];
+  char *in1 = args[0];
+  char *in2 = args[1];
   char *out = args[2];
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = powq((__float128)(*(npy_float64 *)ind), *(__float128 *)inq);
-    ind += steps[0];
-    inq += steps[1];
+    qdd_t a = {*(double *)in1, *(double *)in2};
+    __float128 r;
+
+    if (!qdd_to_quad_wide(a, &r)) {
+      r = QuadArray_op_add(qdd_double_to_quad(a.hi), qdd_double_to_quad(a.lo));
+    }
+    *(__float128 *)out = r;
+    in1 += steps[0];
+    in2 += steps[1];
     out += steps[2];
   }
 }
@@ -362,9 +659,10 @@ QuadArray_ufunc_exp(char **args, const npy_intp *dims, const npy_intp *steps, vo
   npy_intp n = dims[0];
   char *in = args[0];
   char *out = args[1];
+  __float128 (*func)(__float128) = QuadArrayFastMath ? qfast_expq : expq;
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = expq(*(__float128 *)in);
+    *(__float128 *)out = func(*(__float128 *)in);
     in += steps[0];
     out += steps[1];
   }
@@ -377,9 +675,10 @@ QuadArray_ufunc_log(char **args, const npy_intp *dims, const npy_intp *steps, vo
   npy_intp n = dims[0];
   char *in = args[0];
   char *out = args[1];
+  __float128 (*func)(__float128) = QuadArrayFastMath ? qfast_logq : logq;
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = logq(*(__float128 *)in);
+    *(__float128 *)out = func(*(__float128 *)in);
     in += steps[0];
     out += steps[1];
   }
@@ -392,9 +691,10 @@ QuadArray_ufunc_sin(char **args, const npy_intp *dims, const npy_intp *steps, vo
   npy_intp n = dims[0];
   char *in = args[0];
   char *out = args[1];
+  __float128 (*func)(__float128) = QuadArrayFastMath ? qfast_sinq : sinq;
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = sinq(*(__float128 *)in);
+    *(__float128 *)out = func(*(__float128 *)in);
     in += steps[0];
     out += steps[1];
   }
@@ -407,9 +707,10 @@ QuadArray_ufunc_cos(char **args, const npy_intp *dims, const npy_intp *steps, vo
   npy_intp n = dims[0];
   char *in = args[0];
   char *out = args[1];
+  __float128 (*func)(__float128) = QuadArrayFastMath ? qfast_cosq : cosq;
 
   for (i = 0; i < n; ++i) {
-    *(__float128 *)out = cosq(*(__float128 *)in);
+    *(__float128 *)out = func(*(__float128 *)in);
     in += steps[0];
     out += steps[1];
   }
@@ -460,6 +761,181 @@ QuadArray_ufunc_cosh(char **args, const npy_intp *dims, const npy_intp *steps, v
   }
 }
 
+// Rounding and exponent ufuncs work on the bits, see qsq_round_integral
+
+#define QARRAY_DEFINE_ROUND_LOOP(name, mode) \
+static void \
+QuadArray_ufunc_##name(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+  npy_intp i; \
+  npy_intp n = dims[0]; \
+  char *in = args[0]; \
+  char *out = args[1]; \
+ \
+  for (i = 0; i < n; ++i) { \
+    *(__float128 *)out = qsq_round_integral(*(__float128 *)in, mode); \
+    in += steps[0]; \
+    out += steps[1]; \
+  } \
+}
+
+QARRAY_DEFINE_ROUND_LOOP(trunc, QSQ_ROUND_TRUNC)
+QARRAY_DEFINE_ROUND_LOOP(floor, QSQ_ROUND_FLOOR)
+QARRAY_DEFINE_ROUND_LOOP(ceil, QSQ_ROUND_CEIL)
+QARRAY_DEFINE_ROUND_LOOP(rint, QSQ_ROUND_RINT)
+
+#undef QARRAY_DEFINE_ROUND_LOOP
+
+static void
+QuadArray_ufunc_modf(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  // The fractional part takes the sign of x, and is zero for Inf
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out1 = args[1];
+  char *out2 = args[2];
+
+  for (i = 0; i < n; ++i) {
+    __float128 x = *(__float128 *)in;
+    __float128 t = qsq_round_integral(x, QSQ_ROUND_TRUNC);
+    __float128 f = x;
+
+    if (!isnanq(x)) {
+      f = copysignq(isinfq(x) ? 0 : QuadArray_op_subtract(x, t), x);
+    }
+    *(__float128 *)out1 = f;
+    *(__float128 *)out2 = t;
+    in += steps[0];
+    out1 += steps[1];
+    out2 += steps[2];
+  }
+}
+
+static void
+QuadArray_ufunc_frexp(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out1 = args[1];
+  char *out2 = args[2];
+
+  for (i = 0; i < n; ++i) {
+    int32_t e;
+
+    *(__float128 *)out1 = qsq_frexp(*(__float128 *)in, &e);
+    *(npy_int32 *)out2 = e;
+    in += steps[0];
+    out1 += steps[1];
+    out2 += steps[2];
+  }
+}
+
+#define QARRAY_DEFINE_LDEXP_LOOP(suffix, etype) \
+static void \
+QuadArray_ufunc_ldexp_##suffix(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+  npy_intp i; \
+  npy_intp n = dims[0]; \
+  char *in1 = args[0]; \
+  char *in2 = args[1]; \
+  char *out = args[2]; \
+ \
+  for (i = 0; i < n; ++i) { \
+    __float128 x = *(__float128 *)in1; \
+    int64_t e = *(etype *)in2; \
+ \
+    if (!qsq_ldexp(x, e, (__float128 *)out)) { \
+      /* Anything past this range overflows or underflows anyway */ \
+      *(__float128 *)out = ldexpq(x, (int)(e < -100000 ? -100000 : (e > 100000 ? 100000 : e))); \
+    } \
+    in1 += steps[0]; \
+    in2 += steps[1]; \
+    out += steps[2]; \
+  } \
+}
+
+QARRAY_DEFINE_LDEXP_LOOP(i, npy_int32)
+QARRAY_DEFINE_LDEXP_LOOP(l, npy_int64)
+
+#undef QARRAY_DEFINE_LDEXP_LOOP
+
+// Classification and logical loops test the bits, see qdd_bits_isnan. The
+// contiguous case is a plain loop over the bits the compiler can vectorise.
+
+#define QARRAY_DEFINE_PREDICATE_LOOP(name, test) \
+static void \
+QuadArray_ufunc_##name(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+  npy_intp i; \
+  npy_intp n = dims[0]; \
+  char *in = args[0]; \
+  char *out = args[1]; \
+ \
+  if (steps[0] == sizeof(__uint128_t) && steps[1] == sizeof(npy_bool)) { \
+    const __uint128_t *u = (const __uint128_t *)in; \
+    npy_bool *o = (npy_bool *)out; \
+ \
+    for (i = 0; i < n; ++i) { \
+      o[i] = test(u[i]); \
+    } \
+    return; \
+  } \
+  for (i = 0; i < n; ++i) { \
+    *(npy_bool *)out = test(*(__uint128_t *)in); \
+    in += steps[0]; \
+    out += steps[1]; \
+  } \
+}
+
+#define QARRAY_SIGNBIT(u) ((npy_bool)((u) >> 127))
+#define QARRAY_LOGICAL_NOT(u) (!qdd_bits_nonzero(u))
+
+QARRAY_DEFINE_PREDICATE_LOOP(isnan, qdd_bits_isnan)
+QARRAY_DEFINE_PREDICATE_LOOP(isinf, qdd_bits_isinf)
+QARRAY_DEFINE_PREDICATE_LOOP(isfinite, qdd_bits_isfinite)
+QARRAY_DEFINE_PREDICATE_LOOP(signbit, QARRAY_SIGNBIT)
+QARRAY_DEFINE_PREDICATE_LOOP(logical_not, QARRAY_LOGICAL_NOT)
+
+#undef QARRAY_LOGICAL_NOT
+#undef QARRAY_SIGNBIT
+#undef QARRAY_DEFINE_PREDICATE_LOOP
+
+#define QARRAY_DEFINE_LOGICAL_LOOP(name, op) \
+static void \
+QuadArray_ufunc_##name(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+  npy_intp i; \
+  npy_intp n = dims[0]; \
+  char *in1 = args[0]; \
+  char *in2 = args[1]; \
+  char *out = args[2]; \
+ \
+  if (steps[0] == sizeof(__uint128_t) && steps[1] == sizeof(__uint128_t) && steps[2] == sizeof(npy_bool)) { \
+    const __uint128_t *a = (const __uint128_t *)in1; \
+    const __uint128_t *b = (const __uint128_t *)in2; \
+    npy_bool *o = (npy_bool *)out; \
+ \
+    for (i = 0; i < n; ++i) { \
+      o[i] = qdd_bits_nonzero(a[i]) op qdd_bits_nonzero(b[i]); \
+    } \
+    return; \
+  } \
+  for (i = 0; i < n; ++i) { \
+    *(npy_bool *)out = qdd_bits_nonzero(*(__uint128_t *)in1) op qdd_bits_nonzero(*(__uint128_t *)in2); \
+    in1 += steps[0]; \
+    in2 += steps[1]; \
+    out += steps[2]; \
+  } \
+}
+
+QARRAY_DEFINE_LOGICAL_LOOP(logical_and, &)
+QARRAY_DEFINE_LOGICAL_LOOP(logical_or, |)
+QARRAY_DEFINE_LOGICAL_LOOP(logical_xor, ^)
+
+#undef QARRAY_DEFINE_LOGICAL_LOOP
+
 static int
 QuadArray_register_ufunc_binary(const char *name, PyUFuncGenericFunction loop)
 {
@@ -550,53 +1026,135 @@ QuadArray_register_ufunc_unary(const char *name, PyUFuncGenericFunction loop)
 }
 
 static int
-QuadArray_register_ufuncs(void)
+QuadArray_register_ufunc_predicate(const char *name, PyUFuncGenericFunction loop)
 {
-  if (QuadArray_register_ufunc_binary("add", QuadArray_ufunc_add) < 0) {
+  PyObject *numpy_mod;
+  PyObject *ufunc;
+  int types[2];
+
+  numpy_mod = PyImport_ImportModule("numpy");
+  if (numpy_mod == NULL) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary("subtract", QuadArray_ufunc_subtract) < 0) {
+  ufunc = PyObject_GetAttrString(numpy_mod, name);
+  Py_DECREF(numpy_mod);
+  if (ufunc == NULL) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary("multiply", QuadArray_ufunc_multiply) < 0) {
+
+  types[0] = QuadArrayTypeNum;
+  types[1] = NPY_BOOL;
+
+  if (PyUFunc_RegisterLoopForType((PyUFuncObject *)ufunc, QuadArrayTypeNum, loop, types, NULL) < 0) {
+    Py_DECREF(ufunc);
     return -1;
   }
-  if (QuadArray_register_ufunc_binary("divide", QuadArray_ufunc_divide) < 0) {
+
+  Py_DECREF(ufunc);
+  return 0;
+}
+
+static int
+QuadArray_add_ufunc(PyObject *m, const char *name, const char *doc, int nin, int nout, PyUFuncGenericFunction *funcs,
+                    char *float64_types, PyUFuncGenericFunction qloop, const int *qtypes)
+{
+  // Create a ufunc numpy does not have, with an optional float64 loop, and
+  // give it a loop over the qarray types in qtypes
+  PyObject *ufunc;
+
+  ufunc = PyUFunc_FromFuncAndData(funcs, NULL, float64_types, funcs == NULL ? 0 : 1, nin, nout, PyUFunc_None, name,
+                                  doc, 0);
+  if (ufunc == NULL) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary("power", QuadArray_ufunc_power) < 0) {
+
+  if (PyUFunc_RegisterLoopForType((PyUFuncObject *)ufunc, QuadArrayTypeNum, qloop, qtypes, NULL) < 0) {
+    Py_DECREF(ufunc);
+    return -1;
+  }
+
+  if (PyModule_AddObjectRef(m, name, ufunc) < 0) {
+    Py_DECREF(ufunc);
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("add", QuadArray_ufunc_add_qd, QuadArrayTypeNum, NPY_DOUBLE, QuadArrayTypeNum) < 0) {
+
+  Py_DECREF(ufunc);
+  return 0;
+}
+
+static int
+QuadArray_add_ufuncs(PyObject *m)
+{
+  // The float64 loop tables must outlive the ufuncs
+  static PyUFuncGenericFunction two_sum_funcs[] = {QuadArray_ufunc_two_sum_float64};
+  static PyUFuncGenericFunction two_prod_funcs[] = {QuadArray_ufunc_two_prod_float64};
+  static char float64_types[] = {NPY_DOUBLE, NPY_DOUBLE, NPY_DOUBLE, NPY_DOUBLE};
+  int q = QuadArrayTypeNum;
+  int fma_types[] = {q, q, q, q};
+  int pair_types[] = {q, q, q, q};
+  int split_types[] = {q, NPY_DOUBLE, NPY_DOUBLE};
+  int join_types[] = {NPY_DOUBLE, NPY_DOUBLE, q};
+
+  // numpy has no fma ufunc, so create one and give it a qarray loop
+  if (QuadArray_add_ufunc(m, "fma", "fma(x, y, z) computes x * y + z with a single rounding", 3, 1, NULL, NULL,
+                          QuadArray_ufunc_fma, fma_types) < 0) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("add", QuadArray_ufunc_add_dq, NPY_DOUBLE, QuadArrayTypeNum, QuadArrayTypeNum) < 0) {
+  if (QuadArray_add_ufunc(m, "two_sum",
+                          "two_sum(a, b) returns (s, e) with s = a + b rounded and e its exact error, s + e == a + b",
+                          2, 2, two_sum_funcs, float64_types, QuadArray_ufunc_two_sum, pair_types) < 0) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("subtract", QuadArray_ufunc_subtract_qd, QuadArrayTypeNum, NPY_DOUBLE, QuadArrayTypeNum) < 0) {
+  if (QuadArray_add_ufunc(m, "two_prod",
+                          "two_prod(a, b) returns (p, e) with p = a * b rounded and e its exact error, p + e == a * b",
+                          2, 2, two_prod_funcs, float64_types, QuadArray_ufunc_two_prod, pair_types) < 0) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("subtract", QuadArray_ufunc_subtract_dq, NPY_DOUBLE, QuadArrayTypeNum, QuadArrayTypeNum) < 0) {
+  if (QuadArray_add_ufunc(m, "split",
+                          "split(x) returns float64 arrays (hi, lo) with hi + lo the nearest double-double to x", 1,
+                          2, NULL, NULL, QuadArray_ufunc_split, split_types) < 0) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("multiply", QuadArray_ufunc_multiply_qd, QuadArrayTypeNum, NPY_DOUBLE, QuadArrayTypeNum) < 0) {
+  if (QuadArray_add_ufunc(m, "join", "join(hi, lo) returns the qarray hi + lo, inverting split", 2, 1, NULL, NULL,
+                          QuadArray_ufunc_join, join_types) < 0) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("multiply", QuadArray_ufunc_multiply_dq, NPY_DOUBLE, QuadArrayTypeNum, QuadArrayTypeNum) < 0) {
+  return 0;
+}
+
+static int
+QuadArray_register_ufuncs(void)
+{
+  if (QuadArray_register_ufunc_binary("add", QuadArray_ufunc_add) < 0) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("divide", QuadArray_ufunc_divide_qd, QuadArrayTypeNum, NPY_DOUBLE, QuadArrayTypeNum) < 0) {
+  if (QuadArray_register_ufunc_binary("subtract", QuadArray_ufunc_subtract) < 0) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("divide", QuadArray_ufunc_divide_dq, NPY_DOUBLE, QuadArrayTypeNum, QuadArrayTypeNum) < 0) {
+  if (QuadArray_register_ufunc_binary("multiply", QuadArray_ufunc_multiply) < 0) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("power", QuadArray_ufunc_power_qd, QuadArrayTypeNum, NPY_DOUBLE, QuadArrayTypeNum) < 0) {
+  if (QuadArray_register_ufunc_binary("divide", QuadArray_ufunc_divide) < 0) {
     return -1;
   }
-  if (QuadArray_register_ufunc_binary_types("power", QuadArray_ufunc_power_dq, NPY_DOUBLE, QuadArrayTypeNum, QuadArrayTypeNum) < 0) {
+  if (QuadArray_register_ufunc_binary("power", QuadArray_ufunc_power) < 0) {
     return -1;
   }
+#define QARRAY_REGISTER_MIXED_LOOP(op, suffix, npy_type, unused) \
+  if (QuadArray_register_ufunc_binary_types(#op, QuadArray_ufunc_##op##_q##suffix, QuadArrayTypeNum, npy_type, QuadArrayTypeNum) < 0) { \
+    return -1; \
+  } \
+  if (QuadArray_register_ufunc_binary_types(#op, QuadArray_ufunc_##op##_##suffix##q, npy_type, QuadArrayTypeNum, QuadArrayTypeNum) < 0) { \
+    return -1; \
+  }
+#define QARRAY_REGISTER_MIXED_LOOPS(suffix, ctype, npy_type, convert) \
+  QARRAY_MIXED_OPS(QARRAY_REGISTER_MIXED_LOOP, suffix, npy_type, convert)
+
+  QARRAY_MIXED_TYPES(QARRAY_REGISTER_MIXED_LOOPS)
+
+#undef QARRAY_REGISTER_MIXED_LOOPS
+#undef QARRAY_REGISTER_MIXED_LOOP
+
   if (QuadArray_register_ufunc_unary("negative", QuadArray_ufunc_negative) < 0) {
     return -1;
   }
@@ -633,42 +1191,117 @@ QuadArray_register_ufuncs(void)
   if (QuadArray_register_ufunc_unary("cosh", QuadArray_ufunc_cosh) < 0) {
     return -1;
   }
-  return 0;
-}
-
-static void
-QuadArray_cast_to_float64(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
-{
-  npy_intp i;
-  __float128 *src = (__float128 *)from;
-  npy_float64 *dst = (npy_float64 *)to;
-
-  for (i = 0; i < n; ++i) {
-    dst[i] = (npy_float64)__float128_to_double(src[i]);
+  if (QuadArray_register_ufunc_unary("trunc", QuadArray_ufunc_trunc) < 0) {
+    return -1;
   }
-}
-
-static void
-QuadArray_cast_to_float32(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
-{
-  npy_intp i;
-  __float128 *src = (__float128 *)from;
-  npy_float32 *dst = (npy_float32 *)to;
-
-  for (i = 0; i < n; ++i) {
-    dst[i] = (npy_float32)__float128_to_double(src[i]);
+  if (QuadArray_register_ufunc_unary("floor", QuadArray_ufunc_floor) < 0) {
+    return -1;
   }
-}
-
-static void
-QuadArray_cast_from_float64(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
-{
-  npy_intp i;
-  npy_float64 *src = (npy_float64 *)from;
-  __float128 *dst = (__float128 *)to;
-
-  for (i = 0; i < n; ++i) {
-    dst[i] = (__float128)src[i];
+  if (QuadArray_register_ufunc_unary("ceil", QuadArray_ufunc_ceil) < 0) {
+    return -1;
+  }
+  // np.round and ndarray.round use rint
+  if (QuadArray_register_ufunc_unary("rint", QuadArray_ufunc_rint) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_predicate("isnan", QuadArray_ufunc_isnan) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_predicate("isinf", QuadArray_ufunc_isinf) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_predicate("isfinite", QuadArray_ufunc_isfinite) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_predicate("signbit", QuadArray_ufunc_signbit) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_predicate("logical_not", QuadArray_ufunc_logical_not) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_binary_types("logical_and", QuadArray_ufunc_logical_and, QuadArrayTypeNum, QuadArrayTypeNum, NPY_BOOL) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_binary_types("logical_or", QuadArray_ufunc_logical_or, QuadArrayTypeNum, QuadArrayTypeNum, NPY_BOOL) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_binary_types("logical_xor", QuadArray_ufunc_logical_xor, QuadArrayTypeNum, QuadArrayTypeNum, NPY_BOOL) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_binary_types("modf", QuadArray_ufunc_modf, QuadArrayTypeNum, QuadArrayTypeNum, QuadArrayTypeNum) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_binary_types("frexp", QuadArray_ufunc_frexp, QuadArrayTypeNum, QuadArrayTypeNum, NPY_INT32) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_binary_types("ldexp", QuadArray_ufunc_ldexp_i, QuadArrayTypeNum, NPY_INT32, QuadArrayTypeNum) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_ufunc_binary_types("ldexp", QuadArray_ufunc_ldexp_l, QuadArrayTypeNum, NPY_INT64, QuadArrayTypeNum) < 0) {
+    return -1;
+  }
+  return 0;
+}
+
+// The float conversions are done on the bits inline rather than through
+// libgcc or the qfloat capsule. NumPy hands legacy casts contiguous
+// buffers; loads and stores go through memcpy so unaligned ones are fine too.
+// Narrowing a NaN still flags FE_INVALID, as the libgcc conversion did.
+
+static void
+QuadArray_cast_to_float64(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  const char *src = (const char *)from;
+  char *dst = (char *)to;
+
+  for (i = 0; i < n; ++i) {
+    __float128 x;
+    npy_float64 d;
+
+    memcpy(&x, src + i * sizeof(x), sizeof(x));
+    d = qdd_quad_to_double(x);
+    if (isnan(d)) {
+      feraiseexcept(FE_INVALID);
+    }
+    memcpy(dst + i * sizeof(d), &d, sizeof(d));
+  }
+}
+
+static void
+QuadArray_cast_to_float32(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  const char *src = (const char *)from;
+  char *dst = (char *)to;
+
+  for (i = 0; i < n; ++i) {
+    __float128 x;
+    npy_float32 f;
+
+    memcpy(&x, src + i * sizeof(x), sizeof(x));
+    f = qdd_quad_to_float(x);
+    if (isnan(f)) {
+      feraiseexcept(FE_INVALID);
+    }
+    memcpy(dst + i * sizeof(f), &f, sizeof(f));
+  }
+}
+
+static void
+QuadArray_cast_from_float64(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  const char *src = (const char *)from;
+  char *dst = (char *)to;
+
+  for (i = 0; i < n; ++i) {
+    npy_float64 d;
+    __float128 x;
+
+    memcpy(&d, src + i * sizeof(d), sizeof(d));
+    x = qdd_double_to_quad(d);
+    memcpy(dst + i * sizeof(x), &x, sizeof(x));
   }
 }
 
@@ -676,7 +1309,40 @@ static void
 QuadArray_cast_from_float32(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
 {
   npy_intp i;
-  npy_float32 *src = (npy_float32 *)from;
+  const char *src = (const char *)from;
+  char *dst = (char *)to;
+
+  for (i = 0; i < n; ++i) {
+    npy_float32 f;
+    __float128 x;
+
+    memcpy(&f, src + i * sizeof(f), sizeof(f));
+    x = qdd_double_to_quad((double)f);
+    memcpy(dst + i * sizeof(x), &x, sizeof(x));
+  }
+}
+
+// long double is the x87 80-bit format on x86-64, plain double on some
+// platforms and binary128 on others. The compiler's conversions widen
+// exactly and narrow with a single correct rounding in every case.
+
+static void
+QuadArray_cast_to_longdouble(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  __float128 *src = (__float128 *)from;
+  npy_longdouble *dst = (npy_longdouble *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = (npy_longdouble)src[i];
+  }
+}
+
+static void
+QuadArray_cast_from_longdouble(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  npy_longdouble *src = (npy_longdouble *)from;
   __float128 *dst = (__float128 *)to;
 
   for (i = 0; i < n; ++i) {
@@ -684,6 +1350,217 @@ QuadArray_cast_from_float32(void *from, void *to, npy_intp n, void *NPY_UNUSED(f
   }
 }
 
+// Every fixed-width integer converts exactly into the 113-bit significand.
+// The way back truncates and follows NumPy's float64 casts on x86-64: the
+// signed types below 64 bits convert through int32 (so int8 and int16 wrap
+// and NaN or values outside int32 give INT32_MIN narrowed to the target),
+// int64 gives INT64_MIN, and the unsigned types convert through 64 bits with
+// INT64_MIN as the invalid value. [lo, hi] is the range that converts.
+#define QARRAY_INTEGER_TYPES(X) \
+  X(i8, npy_int8, NPY_INT8, INT32_MIN, INT32_MAX) \
+  X(i16, npy_int16, NPY_INT16, INT32_MIN, INT32_MAX) \
+  X(i32, npy_int32, NPY_INT32, INT32_MIN, INT32_MAX) \
+  X(i64, npy_int64, NPY_INT64, INT64_MIN, INT64_MAX) \
+  X(u8, npy_uint8, NPY_UINT8, INT64_MIN, UINT64_MAX) \
+  X(u16, npy_uint16, NPY_UINT16, INT64_MIN, UINT64_MAX) \
+  X(u32, npy_uint32, NPY_UINT32, INT64_MIN, UINT64_MAX) \
+  X(u64, npy_uint64, NPY_UINT64, INT64_MIN, UINT64_MAX)
+
+#define QARRAY_DEFINE_INTEGER_CASTS(suffix, ctype, npy_type, lo, hi) \
+static void \
+QuadArray_cast_to_##suffix(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr)) \
+{ \
+  npy_intp i; \
+  __float128 *src = (__float128 *)from; \
+  ctype *dst = (ctype *)to; \
+  __int128 v; \
+\
+  for (i = 0; i < n; ++i) { \
+    if (!qsq_to_int128(src[i], &v) || v < (__int128)lo || v > (__int128)hi) { \
+      feraiseexcept(FE_INVALID); \
+      v = lo; \
+    } \
+    dst[i] = (ctype)v; \
+  } \
+} \
+\
+static void \
+QuadArray_cast_from_##suffix(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr)) \
+{ \
+  npy_intp i; \
+  ctype *src = (ctype *)from; \
+  __float128 *dst = (__float128 *)to; \
+\
+  for (i = 0; i < n; ++i) { \
+    dst[i] = (__float128)src[i]; \
+  } \
+}
+
+QARRAY_INTEGER_TYPES(QARRAY_DEFINE_INTEGER_CASTS)
+
+#undef QARRAY_DEFINE_INTEGER_CASTS
+
+static void
+QuadArray_cast_to_bool(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  qdd_quad_bits *src = (qdd_quad_bits *)from;
+  npy_bool *dst = (npy_bool *)to;
+
+  // Non-zero, NaN included, ignoring the sign of zero
+  for (i = 0; i < n; ++i) {
+    dst[i] = (src[i].u << 1) != 0;
+  }
+}
+
+static void
+QuadArray_cast_from_bool(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  npy_bool *src = (npy_bool *)from;
+  __float128 *dst = (__float128 *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = src[i] ? 1 : 0;
+  }
+}
+
+static bool
+qarray_parse_quad(const char *s, size_t len, void *out)
+{
+  return qparse_string(s, len, (__float128 *)out);
+}
+
+static void
+QuadArray_cast_to_text(void *from, void *to, npy_intp n, PyArrayObject *toarr, bool ucs4)
+{
+  // Shortest round trip text, an element too short for it is an error
+  // rather than a silently truncated number
+  char buf[QFORMAT_REPR_SIZE];
+  __float128 *src = (__float128 *)from;
+  char *dst = (char *)to;
+  npy_intp itemsize = PyArray_ITEMSIZE(toarr);
+  bool swap = !PyArray_ISNOTSWAPPED(toarr);
+  npy_intp i;
+
+  for (i = 0; i < n; ++i) {
+    int len = qformat_repr(src[i], buf);
+
+    if (!qtext_store(buf, (size_t)len, dst + i * itemsize, (size_t)itemsize, ucs4, swap)) {
+      PyErr_Format(PyExc_ValueError, "qfloat %s does not fit in %R, cast to a sized string dtype such as 'U48' or use qarray.to_strings", buf,
+                   (PyObject *)PyArray_DESCR(toarr));
+      return;
+    }
+  }
+}
+
+static void
+QuadArray_cast_from_text(void *from, void *to, npy_intp n, PyArrayObject *fromarr, bool ucs4)
+{
+  char *src = (char *)from;
+  __float128 *dst = (__float128 *)to;
+  npy_intp itemsize = PyArray_ITEMSIZE(fromarr);
+  bool swap = !PyArray_ISNOTSWAPPED(fromarr);
+  npy_intp i;
+
+  for (i = 0; i < n; ++i) {
+    if (!qtext_parse(src + i * itemsize, (size_t)itemsize, ucs4, swap, qarray_parse_quad, &dst[i])) {
+      PyObject *item = PyArray_GETITEM(fromarr, src + i * itemsize);
+
+      if (item != NULL) {
+        PyErr_Format(PyExc_ValueError, "could not convert string to qfloat: %R", item);
+        Py_DECREF(item);
+      }
+      return;
+    }
+  }
+}
+
+static void
+QuadArray_cast_to_unicode(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *toarr)
+{
+  QuadArray_cast_to_text(from, to, n, (PyArrayObject *)toarr, true);
+}
+
+static void
+QuadArray_cast_to_string(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *toarr)
+{
+  QuadArray_cast_to_text(from, to, n, (PyArrayObject *)toarr, false);
+}
+
+static void
+QuadArray_cast_from_unicode(void *from, void *to, npy_intp n, void *fromarr, void *NPY_UNUSED(toarr))
+{
+  QuadArray_cast_from_text(from, to, n, (PyArrayObject *)fromarr, true);
+}
+
+static void
+QuadArray_cast_from_string(void *from, void *to, npy_intp n, void *fromarr, void *NPY_UNUSED(toarr))
+{
+  QuadArray_cast_from_text(from, to, n, (PyArrayObject *)fromarr, false);
+}
+
+static int
+QuadArray_register_text_casts(
+  PyArray_Descr *quad_descr,
+  int quad_type_num,
+  int type_num,
+  PyArray_VectorUnaryFunc *to_func,
+  PyArray_VectorUnaryFunc *from_func)
+{
+  // Parsing and printing are both unsafe casts, as NumPy has them for float64
+  PyArray_Descr *type_descr;
+
+  if (PyArray_RegisterCastFunc(quad_descr, type_num, to_func) < 0) {
+    return -1;
+  }
+
+  type_descr = PyArray_DescrFromType(type_num);
+  if (type_descr == NULL) {
+    return -1;
+  }
+  if (PyArray_RegisterCastFunc(type_descr, quad_type_num, from_func) < 0) {
+    Py_DECREF(type_descr);
+    return -1;
+  }
+  Py_DECREF(type_descr);
+
+  return 0;
+}
+
+static int
+QuadArray_register_cast_pair(
+  PyArray_Descr *quad_descr,
+  int quad_type_num,
+  int type_num,
+  PyArray_VectorUnaryFunc *to_func,
+  PyArray_VectorUnaryFunc *from_func)
+{
+  // Casting into qarray is exact and so safe, casting out is unsafe as
+  // NumPy has it for float64 to integer
+  PyArray_Descr *type_descr;
+
+  if (PyArray_RegisterCastFunc(quad_descr, type_num, to_func) < 0) {
+    return -1;
+  }
+
+  type_descr = PyArray_DescrFromType(type_num);
+  if (type_descr == NULL) {
+    return -1;
+  }
+  if (PyArray_RegisterCastFunc(type_descr, quad_type_num, from_func) < 0) {
+    Py_DECREF(type_descr);
+    return -1;
+  }
+  if (PyArray_RegisterCanCast(type_descr, quad_type_num, NPY_NOSCALAR) < 0) {
+    Py_DECREF(type_descr);
+    return -1;
+  }
+  Py_DECREF(type_descr);
+
+  return 0;
+}
+
 static int
 QuadArray_register_casts(PyArray_Descr *quad_descr, int quad_type_num)
 {
@@ -731,6 +1608,49 @@ QuadArray_register_casts(PyArray_Descr *quad_descr, int quad_type_num)
   }
   Py_DECREF(float32_descr);
 
+  if (QuadArray_register_cast_pair(quad_descr, quad_type_num, NPY_BOOL, QuadArray_cast_to_bool, QuadArray_cast_from_bool) < 0) {
+    return -1;
+  }
+
+#if LDBL_MANT_DIG == 106 || defined(__LONG_DOUBLE_IBM128__)
+  // IBM double-double has fewer significand bits than binary128 but can
+  // hold values whose parts are far apart, so the cast in is not safe
+  if (PyArray_RegisterCastFunc(quad_descr, NPY_LONGDOUBLE, QuadArray_cast_to_longdouble) < 0) {
+    return -1;
+  }
+  {
+    PyArray_Descr *longdouble_descr = PyArray_DescrFromType(NPY_LONGDOUBLE);
+    if (longdouble_descr == NULL) {
+      return -1;
+    }
+    if (PyArray_RegisterCastFunc(longdouble_descr, quad_type_num, QuadArray_cast_from_longdouble) < 0) {
+      Py_DECREF(longdouble_descr);
+      return -1;
+    }
+    Py_DECREF(longdouble_descr);
+  }
+#else
+  if (QuadArray_register_cast_pair(quad_descr, quad_type_num, NPY_LONGDOUBLE, QuadArray_cast_to_longdouble, QuadArray_cast_from_longdouble) < 0) {
+    return -1;
+  }
+#endif
+
+#define QARRAY_REGISTER_INTEGER_CASTS(suffix, ctype, npy_type, lo, hi) \
+  if (QuadArray_register_cast_pair(quad_descr, quad_type_num, npy_type, QuadArray_cast_to_##suffix, QuadArray_cast_from_##suffix) < 0) { \
+    return -1; \
+  }
+
+  QARRAY_INTEGER_TYPES(QARRAY_REGISTER_INTEGER_CASTS)
+
+#undef QARRAY_REGISTER_INTEGER_CASTS
+
+  if (QuadArray_register_text_casts(quad_descr, quad_type_num, NPY_UNICODE, QuadArray_cast_to_unicode, QuadArray_cast_from_unicode) < 0) {
+    return -1;
+  }
+  if (QuadArray_register_text_casts(quad_descr, quad_type_num, NPY_STRING, QuadArray_cast_to_string, QuadArray_cast_from_string) < 0) {
+    return -1;
+  }
+
   return 0;
 }
 
@@ -1427,99 +2347,1080 @@ qarray_ones_like(PyObject *NPY_UNUSED(self), PyObject *args)
   return ret;
 }
 
-static PyMethodDef QuadArrayMethods[] = {
-  {"arange", qarray_arange, METH_VARARGS, "Create a 1-D qarray with evenly spaced values in an interval."},
-  {"linspace", qarray_linspace, METH_VARARGS, "Create a 1-D qarray with evenly spaced samples over an interval."},
-  {"empty", qarray_empty, METH_VARARGS, "Create a 1-D uninitialized qarray."},
-  {"full", qarray_full, METH_VARARGS, "Create a 1-D qarray filled with a value."},
-  {"zeros", qarray_zeros, METH_VARARGS, "Create a 1-D qarray of zeros."},
-  {"ones", qarray_ones, METH_VARARGS, "Create a 1-D qarray of ones."},
-  {"from_list", qarray_from_list, METH_VARARGS, "Create a qarray from a Python sequence."},
-  {"from_array", qarray_from_array, METH_VARARGS, "Create a qarray from an array-like object."},
-  {"asarray", (PyCFunction)qarray_asarray, METH_VARARGS | METH_KEYWORDS, "Create a qarray from an array-like object."},
-  {"array", (PyCFunction)qarray_array, METH_VARARGS | METH_KEYWORDS, "Create a qarray from an array-like object."},
-  {"asfortranarray", qarray_asfortranarray, METH_VARARGS, "Create a Fortran-contiguous qarray from an array-like object."},
-  {"ravel", (PyCFunction)qarray_ravel, METH_VARARGS | METH_KEYWORDS, "Return a contiguous flattened qarray from an array-like object."},
-  {"empty_like", qarray_empty_like, METH_VARARGS, "Create an empty qarray with the same shape as input."},
-  {"zeros_like", qarray_zeros_like, METH_VARARGS, "Create a zero-filled qarray with the same shape as input."},
-  {"ones_like", qarray_ones_like, METH_VARARGS, "Create a one-filled qarray with the same shape as input."},
-  {"full_like", qarray_full_like, METH_VARARGS, "Create a qarray filled with a value and the same shape as input."},
-  {NULL, NULL, 0, NULL},
-};
-
-static PyModuleDef QuadArrayModule = {
-    PyModuleDef_HEAD_INIT,
-    .m_name = "qarray",
-    .m_doc = "Quad precision module for array quad's.",
-    .m_methods = QuadArrayMethods,
-    .m_size = -1,
-};
+static PyObject *
+qarray_set_fast_math(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  int enabled;
+  bool previous = QuadArrayFastMath;
 
+  if (!PyArg_ParseTuple(args, "p:set_fast_math", &enabled)) {
+    return NULL;
+  }
 
-static npy_bool 
-QuadArray_nonzero(void *ip, void *arr){
+  QuadArrayFastMath = enabled;
+  return PyBool_FromLong(previous);
+}
 
-    int elsize = PyArray_ITEMSIZE(arr);
-    char *ptr = ip;
-    while (elsize--) {
-        if (*ptr++ != 0) {
-            return NPY_TRUE;
-        }
-    }
-    return NPY_FALSE;
+static PyObject *
+qarray_get_fast_math(PyObject *NPY_UNUSED(self), PyObject *NPY_UNUSED(args))
+{
+  return PyBool_FromLong(QuadArrayFastMath);
 }
 
-static void
-QuadArray_copyswap(__float128 *dst, __float128 *src,
-                    int swap, void *NPY_UNUSED(arr))
+static PyArrayObject *
+qarray_reduce_operand(PyObject *obj, qreduce_kind *kind)
 {
-  size_t i;
-  char *bytes;
+  // Anything float64 holds exactly is streamed as float64, the rest (qarray,
+  // 64-bit integers, ...) is read as quad. NumPy counts int64 to float64 as
+  // a safe cast, so wide integers are checked for separately.
+  PyArrayObject *arr;
+  PyArrayObject *out;
+  PyArray_Descr *descr;
+  int type_num;
 
-  if (src == NULL) {
-    src = dst;
+  arr = (PyArrayObject *)PyArray_FromAny(obj, NULL, 0, 0, 0, NULL);
+  if (arr == NULL) {
+    return NULL;
+  }
+  type_num = PyArray_DESCR(arr)->type_num;
+  if (type_num != QuadArrayTypeNum && PyArray_CanCastSafely(type_num, NPY_DOUBLE)
+      && !(PyTypeNum_ISINTEGER(type_num) && PyArray_ITEMSIZE(arr) > 4)) {
+    *kind = QREDUCE_FLOAT64;
+    descr = PyArray_DescrFromType(NPY_DOUBLE);
+  } else {
+    *kind = QREDUCE_QUAD;
+    descr = QuadArrayDescr;
+    Py_INCREF(descr);
   }
-  if (src != dst) {
-    memcpy(dst, src, sizeof(__float128));
+  if (descr == NULL) {
+    Py_DECREF(arr);
+    return NULL;
   }
 
-  if (swap != 0) {
-    char tmp;
-    bytes = (char *)dst;
-    for (i = 0; i < (sizeof(__float128) / 2); ++i) {
-      tmp = bytes[i];
-      bytes[i] = bytes[sizeof(__float128) - 1 - i];
-      bytes[sizeof(__float128) - 1 - i] = tmp;
-    }
-    }
+  out = (PyArrayObject *)PyArray_FromAny((PyObject *)arr, descr, 0, 0, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST, NULL);
+  Py_DECREF(arr);
+  return out;
 }
 
-static void
-QuadArray_copyswapn(void *dst, npy_intp dstride, void *src,
-                   npy_intp sstride, npy_intp n, int swap, void *arr)
+static int
+qarray_parse_threads(int threads)
 {
-    npy_intp i;
-    PyArray_CopySwapFunc *copyswap;
-    char *dstptr = dst;
-    char *srcptr = src;
-
-    copyswap = PyDataType_GetArrFuncs(PyArray_DESCR(arr))->copyswap;
-
-    for (i = 0; i < n; i++) {
-        copyswap(dstptr, srcptr, swap, arr);
-        dstptr += dstride;
-        srcptr += sstride;
-    }
+  if (threads < 0) {
+    PyErr_SetString(PyExc_ValueError, "threads must be non-negative");
+    return -1;
+  }
+  return threads == 0 ? qreduce_cpu_count() : threads;
 }
 
+static int
+qarray_parse_result_kind(PyObject *dtype_obj, qreduce_kind *kind)
+{
+  // Results are quad unless dtype asks for float64
+  PyArray_Descr *descr = NULL;
+  int type_num;
 
-static int QuadArray_setitem(PyObject* item, __float128* data, void* array){
-  QuadObject tmp;
-
-  (void)array;
+  *kind = QREDUCE_QUAD;
+  if (dtype_obj == NULL || dtype_obj == Py_None) {
+    return 0;
+  }
+  if (!PyArray_DescrConverter(dtype_obj, &descr)) {
+    return -1;
+  }
+  type_num = descr->type_num;
+  Py_DECREF(descr);
+  if (type_num == NPY_DOUBLE) {
+    *kind = QREDUCE_FLOAT64;
+  } else if (type_num != QuadArrayTypeNum) {
+    PyErr_SetString(PyExc_ValueError, "dtype must be float64 or qarray.dtype");
+    return -1;
+  }
+  return 0;
+}
+
+static PyObject *
+qarray_result_scalar(qreduce_kind kind, void *data)
+{
+  PyArray_Descr *descr;
+  PyObject *result;
+  QuadObject q;
+
+  if (kind == QREDUCE_QUAD) {
+    memcpy(&q.value, data, sizeof(q.value));
+    return QuadObject_to_PyObject(q);
+  }
+  descr = PyArray_DescrFromType(NPY_DOUBLE);
+  if (descr == NULL) {
+    return NULL;
+  }
+  result = PyArray_Scalar(data, descr, NULL);
+  Py_DECREF(descr);
+  return result;
+}
+
+static PyArrayObject *
+qarray_result_array(qreduce_kind kind, int nd, npy_intp *dims)
+{
+  if (kind == QREDUCE_QUAD) {
+    return QuadArray_new_empty(nd, dims);
+  }
+  return (PyArrayObject *)PyArray_SimpleNew(nd, dims, NPY_DOUBLE);
+}
+
+static PyObject *
+qarray_qsum(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {"x", "threads", "dtype", NULL};
+  PyObject *obj;
+  PyObject *dtype_obj = NULL;
+  PyArrayObject *arr;
+  qreduce_kind kind;
+  qreduce_kind out_kind;
+  __float128 result;
+  int threads = 1;
+  int rc;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$iO", kwlist, &obj, &threads, &dtype_obj)) {
+    return NULL;
+  }
+  threads = qarray_parse_threads(threads);
+  if (threads < 0 || qarray_parse_result_kind(dtype_obj, &out_kind) < 0) {
+    return NULL;
+  }
+  arr = qarray_reduce_operand(obj, &kind);
+  if (arr == NULL) {
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  rc = qreduce_sum(PyArray_DATA(arr), kind, (size_t)PyArray_SIZE(arr), threads, out_kind, &result);
+  Py_END_ALLOW_THREADS
+  Py_DECREF(arr);
+  if (rc < 0) {
+    return PyErr_NoMemory();
+  }
+
+  return qarray_result_scalar(out_kind, &result);
+}
+
+static PyObject *
+qarray_qdot(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {"x", "y", "threads", "dtype", NULL};
+  PyObject *xobj;
+  PyObject *yobj;
+  PyObject *dtype_obj = NULL;
+  PyArrayObject *x;
+  PyArrayObject *y;
+  qreduce_kind xkind;
+  qreduce_kind ykind;
+  qreduce_kind out_kind;
+  __float128 result;
+  int threads = 1;
+  int rc;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|$iO", kwlist, &xobj, &yobj, &threads, &dtype_obj)) {
+    return NULL;
+  }
+  threads = qarray_parse_threads(threads);
+  if (threads < 0 || qarray_parse_result_kind(dtype_obj, &out_kind) < 0) {
+    return NULL;
+  }
+  x = qarray_reduce_operand(xobj, &xkind);
+  if (x == NULL) {
+    return NULL;
+  }
+  y = qarray_reduce_operand(yobj, &ykind);
+  if (y == NULL) {
+    Py_DECREF(x);
+    return NULL;
+  }
+  if (PyArray_SIZE(x) != PyArray_SIZE(y)) {
+    Py_DECREF(x);
+    Py_DECREF(y);
+    PyErr_SetString(PyExc_ValueError, "x and y must have the same number of elements");
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  rc = qreduce_dot(PyArray_DATA(x), xkind, PyArray_DATA(y), ykind, (size_t)PyArray_SIZE(x), threads, out_kind,
+                   &result);
+  Py_END_ALLOW_THREADS
+  Py_DECREF(x);
+  Py_DECREF(y);
+  if (rc < 0) {
+    return PyErr_NoMemory();
+  }
+
+  return qarray_result_scalar(out_kind, &result);
+}
+
+static PyObject *
+qarray_qnrm2(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {"x", "threads", "dtype", NULL};
+  PyObject *obj;
+  PyObject *dtype_obj = NULL;
+  PyArrayObject *arr;
+  qreduce_kind kind;
+  qreduce_kind out_kind;
+  __float128 result;
+  double result_d;
+  int threads = 1;
+  int rc;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$iO", kwlist, &obj, &threads, &dtype_obj)) {
+    return NULL;
+  }
+  threads = qarray_parse_threads(threads);
+  if (threads < 0 || qarray_parse_result_kind(dtype_obj, &out_kind) < 0) {
+    return NULL;
+  }
+  arr = qarray_reduce_operand(obj, &kind);
+  if (arr == NULL) {
+    return NULL;
+  }
+
+  // The sum of squares cannot overflow or underflow in quad for float64 data
+  Py_BEGIN_ALLOW_THREADS
+  rc = qreduce_dot(PyArray_DATA(arr), kind, PyArray_DATA(arr), kind, (size_t)PyArray_SIZE(arr), threads,
+                   QREDUCE_QUAD, &result);
+  Py_END_ALLOW_THREADS
+  Py_DECREF(arr);
+  if (rc < 0) {
+    return PyErr_NoMemory();
+  }
+
+  result = sqrtq(result);
+  if (out_kind == QREDUCE_FLOAT64) {
+    result_d = qdd_quad_to_double(result);
+    return qarray_result_scalar(out_kind, &result_d);
+  }
+  return qarray_result_scalar(out_kind, &result);
+}
+
+static PyObject *
+qarray_qgemv(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {"a", "x", "threads", "dtype", NULL};
+  PyObject *aobj;
+  PyObject *xobj;
+  PyObject *dtype_obj = NULL;
+  PyArrayObject *a;
+  PyArrayObject *x;
+  PyArrayObject *out;
+  qreduce_kind akind;
+  qreduce_kind xkind;
+  qreduce_kind out_kind;
+  npy_intp m;
+  int threads = 1;
+  int rc;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|$iO", kwlist, &aobj, &xobj, &threads, &dtype_obj)) {
+    return NULL;
+  }
+  threads = qarray_parse_threads(threads);
+  if (threads < 0 || qarray_parse_result_kind(dtype_obj, &out_kind) < 0) {
+    return NULL;
+  }
+  a = qarray_reduce_operand(aobj, &akind);
+  if (a == NULL) {
+    return NULL;
+  }
+  x = qarray_reduce_operand(xobj, &xkind);
+  if (x == NULL) {
+    Py_DECREF(a);
+    return NULL;
+  }
+  if (PyArray_NDIM(a) != 2 || PyArray_NDIM(x) != 1 || PyArray_DIM(a, 1) != PyArray_DIM(x, 0)) {
+    Py_DECREF(a);
+    Py_DECREF(x);
+    PyErr_SetString(PyExc_ValueError, "a must be 2-D and x 1-D with len(x) == a.shape[1]");
+    return NULL;
+  }
+
+  m = PyArray_DIM(a, 0);
+  out = qarray_result_array(out_kind, 1, &m);
+  if (out == NULL) {
+    Py_DECREF(a);
+    Py_DECREF(x);
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  rc = qreduce_gemv(PyArray_DATA(a), akind, PyArray_DATA(x), xkind, (size_t)m, (size_t)PyArray_DIM(a, 1), threads,
+                    out_kind, PyArray_DATA(out));
+  Py_END_ALLOW_THREADS
+  Py_DECREF(a);
+  Py_DECREF(x);
+  if (rc < 0) {
+    Py_DECREF(out);
+    return PyErr_NoMemory();
+  }
+
+  return (PyObject *)out;
+}
+
+static PyObject *
+qarray_qaxpy(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {"alpha", "x", "y", "threads", "dtype", NULL};
+  PyObject *alpha_obj;
+  PyObject *xobj;
+  PyObject *yobj;
+  PyObject *dtype_obj = NULL;
+  PyArrayObject *x;
+  PyArrayObject *y;
+  PyArrayObject *out;
+  qreduce_kind xkind;
+  qreduce_kind ykind;
+  qreduce_kind out_kind;
+  __float128 alpha;
+  int threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO|$iO", kwlist, &alpha_obj, &xobj, &yobj, &threads,
+                                   &dtype_obj)) {
+    return NULL;
+  }
+  threads = qarray_parse_threads(threads);
+  if (threads < 0 || qarray_parse_result_kind(dtype_obj, &out_kind) < 0) {
+    return NULL;
+  }
+  if (QuadArray_setitem(alpha_obj, &alpha, NULL) < 0) {
+    return NULL;
+  }
+  x = qarray_reduce_operand(xobj, &xkind);
+  if (x == NULL) {
+    return NULL;
+  }
+  y = qarray_reduce_operand(yobj, &ykind);
+  if (y == NULL) {
+    Py_DECREF(x);
+    return NULL;
+  }
+  if (!PyArray_SAMESHAPE(x, y)) {
+    Py_DECREF(x);
+    Py_DECREF(y);
+    PyErr_SetString(PyExc_ValueError, "x and y must have the same shape");
+    return NULL;
+  }
+
+  out = qarray_result_array(out_kind, PyArray_NDIM(x), PyArray_DIMS(x));
+  if (out == NULL) {
+    Py_DECREF(x);
+    Py_DECREF(y);
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  qreduce_axpy(alpha, PyArray_DATA(x), xkind, PyArray_DATA(y), ykind, (size_t)PyArray_SIZE(x), threads, out_kind,
+               PyArray_DATA(out));
+  Py_END_ALLOW_THREADS
+  Py_DECREF(x);
+  Py_DECREF(y);
+
+  return (PyObject *)out;
+}
+
+typedef struct {
+  const char *data;
+  npy_intp itemsize;
+  npy_intp n;
+  bool unicode;
+  bool swap;
+  npy_string_allocator *allocator;
+  __float128 *out;
+  npy_intp bad;
+} qarray_text_job;
+
+static bool
+qarray_parse_text(const qarray_text_job *job, const char *item, __float128 *out)
+{
+  npy_static_string text = {0, NULL};
+
+  if (job->allocator == NULL) {
+    return qtext_parse(item, (size_t)job->itemsize, job->unicode, job->swap, qarray_parse_quad, out);
+  }
+  // StringDType elements, a missing value never parses
+  if (NpyString_load(job->allocator, (const npy_packed_static_string *)item, &text) != 0) {
+    return false;
+  }
+  return qparse_string(text.buf, text.size, out);
+}
+
+static void
+qarray_text_task(void *ctx, size_t task)
+{
+  qarray_text_job *job = (qarray_text_job *)ctx;
+  npy_intp start = (npy_intp)task * QREDUCE_CHUNK;
+  npy_intp stop = start + QREDUCE_CHUNK < job->n ? start + QREDUCE_CHUNK : job->n;
+  npy_intp i;
+
+  for (i = start; i < stop; i++) {
+    if (!qarray_parse_text(job, job->data + i * job->itemsize, &job->out[i])) {
+      // Keep the first bad element whatever order the chunks finish in
+      npy_intp cur = __atomic_load_n(&job->bad, __ATOMIC_RELAXED);
+
+      while ((cur < 0 || i < cur)
+             && !__atomic_compare_exchange_n(&job->bad, &cur, i, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      }
+      return;
+    }
+  }
+}
+
+static PyObject *
+qarray_from_text_array(PyArrayObject *src, int threads)
+{
+  qarray_text_job job;
+  PyArrayObject *arr;
+  PyArrayObject *out;
+  size_t nchunks;
+
+  arr = PyArray_GETCONTIGUOUS(src);
+  if (arr == NULL) {
+    return NULL;
+  }
+  out = QuadArray_new_empty(PyArray_NDIM(arr), PyArray_DIMS(arr));
+  if (out == NULL) {
+    Py_DECREF(arr);
+    return NULL;
+  }
+
+  job.data = PyArray_BYTES(arr);
+  job.itemsize = PyArray_ITEMSIZE(arr);
+  job.n = PyArray_SIZE(arr);
+  job.unicode = PyArray_TYPE(arr) == NPY_UNICODE;
+  job.swap = !PyArray_ISNOTSWAPPED(arr);
+  job.allocator = NULL;
+  job.out = (__float128 *)PyArray_DATA(out);
+  job.bad = -1;
+  nchunks = ((size_t)job.n + QREDUCE_CHUNK - 1) / QREDUCE_CHUNK;
+
+  Py_BEGIN_ALLOW_THREADS
+  // Loading StringDType elements only reads, so the threads share one lock
+  if (PyArray_TYPE(arr) == NPY_VSTRING) {
+    job.allocator = NpyString_acquire_allocator((PyArray_StringDTypeObject *)PyArray_DESCR(arr));
+  }
+  qreduce_parallel_for(nchunks, threads, qarray_text_task, &job);
+  if (job.allocator != NULL) {
+    NpyString_release_allocator(job.allocator);
+  }
+  Py_END_ALLOW_THREADS
+
+  if (job.bad >= 0) {
+    PyObject *item = PyArray_GETITEM(arr, job.data + job.bad * job.itemsize);
+
+    if (item != NULL) {
+      PyErr_Format(PyExc_ValueError, "could not convert string to qfloat: %R", item);
+      Py_DECREF(item);
+    }
+    Py_DECREF(out);
+    out = NULL;
+  }
+  Py_DECREF(arr);
+  return (PyObject *)out;
+}
+
+static PyObject *
+qarray_from_strings(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {"values", "threads", NULL};
+  PyObject *obj;
+  PyObject *seq;
+  Py_ssize_t i;
+  Py_ssize_t n;
+  npy_intp dims[1];
+  PyArrayObject *arr;
+  __float128 *data;
+  int threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$i", kwlist, &obj, &threads)) {
+    return NULL;
+  }
+  threads = qarray_parse_threads(threads);
+  if (threads < 0) {
+    return NULL;
+  }
+
+  // S, U and StringDType arrays are read in place, without the GIL
+  if (PyArray_Check(obj)
+      && (PyArray_TYPE((PyArrayObject *)obj) == NPY_STRING || PyArray_TYPE((PyArrayObject *)obj) == NPY_UNICODE
+          || PyArray_TYPE((PyArrayObject *)obj) == NPY_VSTRING)) {
+    return qarray_from_text_array((PyArrayObject *)obj, threads);
+  }
+
+  seq = PySequence_Fast(obj, "from_strings requires a sequence of str or bytes");
+  if (seq == NULL) {
+    return NULL;
+  }
+
+  n = PySequence_Size(seq);
+  if (n < 0) {
+    Py_DECREF(seq);
+    return NULL;
+  }
+  dims[0] = (npy_intp)n;
+  arr = QuadArray_new_empty(1, dims);
+  if (arr == NULL) {
+    Py_DECREF(seq);
+    return NULL;
+  }
+
+  data = (__float128 *)PyArray_DATA(arr);
+  for (i = 0; i < n; ++i) {
+    PyObject *item = PySequence_GetItem(seq, i);
+    const char *buf = NULL;
+    Py_ssize_t len = 0;
+
+    if (item == NULL) {
+      Py_DECREF(arr);
+      Py_DECREF(seq);
+      return NULL;
+    }
+    if (PyUnicode_Check(item)) {
+      buf = PyUnicode_AsUTF8AndSize(item, &len);
+    } else if (PyBytes_Check(item)) {
+      if (PyBytes_AsStringAndSize(item, (char **)&buf, &len) < 0) {
+        buf = NULL;
+      }
+    } else {
+      PyErr_SetString(PyExc_TypeError, "from_strings requires a sequence of str or bytes");
+    }
+    if (buf != NULL && !qparse_string(buf, (size_t)len, &data[i])) {
+      PyErr_Format(PyExc_ValueError, "could not convert string to qfloat: %R", item);
+      buf = NULL;
+    }
+    Py_DECREF(item);
+    if (buf == NULL) {
+      Py_DECREF(arr);
+      Py_DECREF(seq);
+      return NULL;
+    }
+  }
+
+  Py_DECREF(seq);
+  return (PyObject *)arr;
+}
+
+typedef struct {
+  const __float128 *data;
+  npy_intp n;
+  const qformat_spec *spec;
+  char **text;
+  int *lens;
+  npy_intp *widths;
+  int out_type;
+  char *out;
+  npy_intp out_itemsize;
+  npy_string_allocator *allocator;
+  bool failed;
+} qarray_format_job;
+
+static npy_intp
+qarray_utf8_width(const char *s, int len)
+{
+  // Code points in a UTF-8 string, the fill character may be multi-byte
+  npy_intp width = 0;
+  int i;
+
+  for (i = 0; i < len; i++) {
+    width += ((unsigned char)s[i] & 0xc0) != 0x80;
+  }
+  return width;
+}
+
+static void
+qarray_format_task(void *ctx, size_t task)
+{
+  // First pass: format a chunk into one buffer and note the widest element,
+  // in characters for U and bytes otherwise
+  qarray_format_job *job = (qarray_format_job *)ctx;
+  npy_intp start = (npy_intp)task * QREDUCE_CHUNK;
+  npy_intp stop = start + QREDUCE_CHUNK < job->n ? start + QREDUCE_CHUNK : job->n;
+  size_t cap = (size_t)(stop - start) * 16;
+  size_t used = 0;
+  npy_intp widest = 0;
+  npy_intp i;
+  char *text = malloc(cap);
+
+  if (text == NULL) {
+    job->failed = true;
+    return;
+  }
+  for (i = start; i < stop; i++) {
+    int len = qformat_apply(job->data[i], job->spec, text + used, cap - used);
+
+    if (len >= 0 && (size_t)len >= cap - used) {
+      char *grown;
+
+      cap = 2 * cap + (size_t)len + 1;
+      grown = realloc(text, cap);
+      if (grown == NULL) {
+        len = -1;
+      } else {
+        text = grown;
+        len = qformat_apply(job->data[i], job->spec, text + used, cap - used);
+      }
+    }
+    if (len < 0) {
+      free(text);
+      job->failed = true;
+      return;
+    }
+    job->lens[i] = len;
+    if (job->out_type != NPY_UNICODE) {
+      widest = len > widest ? len : widest;
+    } else if (qarray_utf8_width(text + used, len) > widest) {
+      widest = qarray_utf8_width(text + used, len);
+    }
+    used += (size_t)len;
+  }
+  job->text[task] = text;
+  job->widths[task] = widest;
+}
+
+static void
+qarray_store_task(void *ctx, size_t task)
+{
+  // Second pass: copy a chunk's text into the output elements
+  qarray_format_job *job = (qarray_format_job *)ctx;
+  npy_intp start = (npy_intp)task * QREDUCE_CHUNK;
+  npy_intp stop = start + QREDUCE_CHUNK < job->n ? start + QREDUCE_CHUNK : job->n;
+  const unsigned char *p = (const unsigned char *)job->text[task];
+  npy_intp i;
+
+  for (i = start; i < stop; i++) {
+    char *item = job->out + i * job->out_itemsize;
+    const unsigned char *end = p + job->lens[i];
+    npy_uint32 *out = (npy_uint32 *)item;
+    npy_intp j = 0;
+
+    if (job->out_type == NPY_VSTRING) {
+      if (NpyString_pack(job->allocator, (npy_packed_static_string *)item, (const char *)p, (size_t)job->lens[i]) < 0) {
+        job->failed = true;
+      }
+      p = end;
+      continue;
+    }
+    if (job->out_type == NPY_STRING) {
+      memcpy(item, p, (size_t)job->lens[i]);
+      memset(item + job->lens[i], 0, (size_t)(job->out_itemsize - job->lens[i]));
+      p = end;
+      continue;
+    }
+
+    // UTF-8 to UCS4, only the fill character is ever outside ASCII
+    while (p < end) {
+      npy_uint32 c = *p++;
+      int extra = c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : c >= 0xc0 ? 1 : 0;
+
+      c &= extra == 0 ? 0x7f : 0x3f >> extra;
+      for (; extra > 0; extra--) {
+        c = (c << 6) | (*p++ & 0x3f);
+      }
+      out[j++] = c;
+    }
+    for (; 4 * j < job->out_itemsize; j++) {
+      out[j] = 0;
+    }
+  }
+}
+
+static PyObject *
+qarray_to_strings(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {"values", "format_spec", "threads", "dtype", NULL};
+  PyObject *obj;
+  PyObject *spec_obj = NULL;
+  const char *spec_str = "";
+  Py_ssize_t spec_len = 0;
+  qformat_spec spec;
+  qarray_format_job job;
+  PyArrayObject *arr;
+  PyArrayObject *out = NULL;
+  PyArray_Descr *descr;
+  PyArray_Descr *out_descr = NULL;
+  npy_intp widest;
+  size_t nchunks;
+  size_t c;
+  int threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|U$iO&", kwlist, &obj, &spec_obj, &threads,
+                                   PyArray_DescrConverter2, &out_descr)) {
+    return NULL;
+  }
+  threads = qarray_parse_threads(threads);
+  if (threads < 0) {
+    Py_XDECREF(out_descr);
+    return NULL;
+  }
+  job.out_type = out_descr == NULL ? NPY_UNICODE : out_descr->type_num;
+  if (job.out_type != NPY_UNICODE && job.out_type != NPY_STRING && job.out_type != NPY_VSTRING) {
+    PyErr_SetString(PyExc_TypeError, "to_strings dtype must be a str, bytes or StringDType dtype");
+    Py_DECREF(out_descr);
+    return NULL;
+  }
+  if (spec_obj != NULL) {
+    spec_str = PyUnicode_AsUTF8AndSize(spec_obj, &spec_len);
+    if (spec_str == NULL) {
+      Py_XDECREF(out_descr);
+      return NULL;
+    }
+  }
+  if (!qformat_parse_spec(spec_str, (size_t)spec_len, &spec)) {
+    PyErr_Format(PyExc_ValueError, "Invalid format specifier '%s' for object of type 'qfloat'", spec_str);
+    Py_XDECREF(out_descr);
+    return NULL;
+  }
+
+  descr = QuadArrayDescr;
+  Py_INCREF(descr);
+  arr = (PyArrayObject *)PyArray_FromAny(obj, descr, 0, 0, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST, NULL);
+  if (arr == NULL) {
+    Py_XDECREF(out_descr);
+    return NULL;
+  }
+
+  job.data = (const __float128 *)PyArray_DATA(arr);
+  job.n = PyArray_SIZE(arr);
+  job.spec = &spec;
+  job.allocator = NULL;
+  job.failed = false;
+  nchunks = ((size_t)job.n + QREDUCE_CHUNK - 1) / QREDUCE_CHUNK;
+  job.text = calloc(nchunks + 1, sizeof(*job.text));
+  job.widths = calloc(nchunks + 1, sizeof(*job.widths));
+  job.lens = malloc(((size_t)job.n + 1) * sizeof(*job.lens));
+  if (job.text == NULL || job.widths == NULL || job.lens == NULL) {
+    PyErr_NoMemory();
+    goto done;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  qreduce_parallel_for(nchunks, threads, qarray_format_task, &job);
+  Py_END_ALLOW_THREADS
+  if (job.failed) {
+    PyErr_NoMemory();
+    goto done;
+  }
+
+  // U and S output is as wide as the widest element, and at least 1
+  widest = 1;
+  for (c = 0; c < nchunks; c++) {
+    if (job.widths[c] > widest) {
+      widest = job.widths[c];
+    }
+  }
+  if (job.out_type == NPY_VSTRING) {
+    Py_INCREF(out_descr);
+    out = (PyArrayObject *)PyArray_NewFromDescr(&PyArray_Type, out_descr, PyArray_NDIM(arr), PyArray_DIMS(arr), NULL,
+                                                NULL, 0, NULL);
+  } else {
+    out = (PyArrayObject *)PyArray_New(&PyArray_Type, PyArray_NDIM(arr), PyArray_DIMS(arr), job.out_type, NULL, NULL,
+                                       (int)(job.out_type == NPY_UNICODE ? 4 * widest : widest), 0, NULL);
+  }
+  if (out == NULL) {
+    goto done;
+  }
+  job.out = PyArray_BYTES(out);
+  job.out_itemsize = PyArray_ITEMSIZE(out);
+
+  Py_BEGIN_ALLOW_THREADS
+  if (job.out_type == NPY_VSTRING) {
+    // Packing goes through the array's allocator, one thread at a time
+    job.allocator = NpyString_acquire_allocator((PyArray_StringDTypeObject *)PyArray_DESCR(out));
+    for (c = 0; c < nchunks; c++) {
+      qarray_store_task(&job, c);
+    }
+    NpyString_release_allocator(job.allocator);
+  } else {
+    qreduce_parallel_for(nchunks, threads, qarray_store_task, &job);
+  }
+  Py_END_ALLOW_THREADS
+  if (job.failed) {
+    PyErr_NoMemory();
+    Py_CLEAR(out);
+  }
+
+done:
+  if (job.text != NULL) {
+    for (c = 0; c < nchunks; c++) {
+      free(job.text[c]);
+    }
+  }
+  free(job.text);
+  free(job.widths);
+  free(job.lens);
+  Py_XDECREF(out_descr);
+  Py_DECREF(arr);
+  return (PyObject *)out;
+}
+
+static PyObject *
+qarray_runtime_info(PyObject *NPY_UNUSED(self), PyObject *NPY_UNUSED(args))
+{
+  PyObject *info;
+  PyObject *levels;
+  PyObject *item;
+  const char *env;
+  int i;
+
+  levels = PyList_New(qsoft_num_levels());
+  if (levels == NULL) {
+    return NULL;
+  }
+  for (i = 0; i < qsoft_num_levels(); ++i) {
+    item = PyUnicode_FromString(qsoft_level_name_at(i));
+    if (item == NULL) {
+      Py_DECREF(levels);
+      return NULL;
+    }
+    PyList_SetItem(levels, i, item);
+  }
+
+  env = getenv(QSOFT_LEVEL_ENV);
+  info = Py_BuildValue("{s:s,s:s,s:N,s:s,s:z,s:O}",
+                       "cpu_level", qsoft_cpu_level_name(),
+                       "selected_level", qsoft_level_name(),
+                       "available_levels", levels,
+                       "env_var", QSOFT_LEVEL_ENV,
+                       "env_value", env,
+                       "fast_math", QuadArrayFastMath ? Py_True : Py_False);
+  return info;
+}
+
+static int
+qarray_table_format(const void *item, const qformat_spec *spec, char *buf, size_t size)
+{
+  char repr[QFORMAT_REPR_SIZE];
+  __float128 x;
+  int len;
+
+  memcpy(&x, item, sizeof(x));
+  if (spec != NULL) {
+    return qformat_apply(x, spec, buf, size);
+  }
+  len = qformat_repr(x, repr);
+  if ((size_t)len < size) {
+    memcpy(buf, repr, (size_t)len + 1);
+  }
+  return len;
+}
+
+static PyObject *
+qarray_table_new(int nd, const Py_ssize_t *dims, char **data)
+{
+  npy_intp shape[2];
+  PyArrayObject *arr;
+  int i;
+
+  for (i = 0; i < nd; i++) {
+    shape[i] = (npy_intp)dims[i];
+  }
+  arr = QuadArray_new_empty(nd, shape);
+  if (arr != NULL) {
+    *data = PyArray_DATA(arr);
+  }
+  return (PyObject *)arr;
+}
+
+static PyObject *
+qarray_table_as_array(PyObject *obj, int *nd, Py_ssize_t *dims, const char **data)
+{
+  PyArrayObject *arr;
+  int i;
+
+  Py_INCREF(QuadArrayDescr);
+  arr = (PyArrayObject *)PyArray_FromAny(obj, QuadArrayDescr, 0, 0, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST, NULL);
+  if (arr == NULL) {
+    return NULL;
+  }
+  *nd = PyArray_NDIM(arr);
+  for (i = 0; i < *nd && i < 2; i++) {
+    dims[i] = (Py_ssize_t)PyArray_DIM(arr, i);
+  }
+  *data = PyArray_DATA(arr);
+  return (PyObject *)arr;
+}
+
+static const qtable_kind qarray_table = {
+  .name = "qfloat",
+  .itemsize = sizeof(__float128),
+  .parse = qarray_parse_quad,
+  .format = qarray_table_format,
+  .format_spec = true,
+  .new_array = qarray_table_new,
+  .as_array = qarray_table_as_array,
+};
+
+static PyObject *
+qarray_loadtxt(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qtable_loadtxt(&qarray_table, args, kwargs);
+}
+
+static PyObject *
+qarray_savetxt(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qtable_savetxt(&qarray_table, args, kwargs);
+}
+
+static PyObject *
+qarray_dlpack_as_array(PyObject *obj, bool copy, qdlpack_view *view)
+{
+  PyArrayObject *arr;
+  int flags = copy ? NPY_ARRAY_CARRAY | NPY_ARRAY_ENSURECOPY : NPY_ARRAY_ALIGNED;
+
+  Py_INCREF(QuadArrayDescr);
+  arr = (PyArrayObject *)PyArray_FromAny(obj, QuadArrayDescr, 0, 0, flags | NPY_ARRAY_FORCECAST, NULL);
+  if (arr == NULL) {
+    return NULL;
+  }
+  view->data = PyArray_DATA(arr);
+  view->ndim = PyArray_NDIM(arr);
+  view->shape = (const Py_ssize_t *)PyArray_DIMS(arr);
+  view->strides = (const Py_ssize_t *)PyArray_STRIDES(arr);
+  view->readonly = !PyArray_ISWRITEABLE(arr);
+  view->copied = (PyObject *)arr != obj;
+  return (PyObject *)arr;
+}
+
+static PyObject *
+qarray_dlpack_from_view(const qdlpack_view *view, PyObject *base)
+{
+  PyObject *arr;
+
+  Py_INCREF(QuadArrayDescr);
+  arr = PyArray_NewFromDescr(&PyArray_Type, QuadArrayDescr, view->ndim, (const npy_intp *)view->shape,
+                             (const npy_intp *)view->strides, view->data, view->readonly ? 0 : NPY_ARRAY_WRITEABLE,
+                             NULL);
+  if (arr == NULL) {
+    Py_DECREF(base);
+    return NULL;
+  }
+  if (PyArray_SetBaseObject((PyArrayObject *)arr, base) < 0) {
+    Py_DECREF(arr);
+    return NULL;
+  }
+  return arr;
+}
+
+static const qdlpack_kind qarray_dlpack = {
+  .name = "qfloat",
+  .code = QDLPACK_FLOAT,
+  .bits = 128,
+  .parts = 1,
+  .itemsize = sizeof(__float128),
+  .as_array = qarray_dlpack_as_array,
+  .from_view = qarray_dlpack_from_view,
+};
+
+static PyObject *
+qarray_to_dlpack(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qdlpack_to(&qarray_dlpack, args, kwargs);
+}
+
+static PyObject *
+qarray_from_dlpack(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qdlpack_from(&qarray_dlpack, args, kwargs);
+}
+
+static PyObject *
+qarray_to_arrow(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qarrow_to(&qarray_dlpack, args, kwargs);
+}
+
+static PyObject *
+qarray_from_arrow(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qarrow_from(&qarray_dlpack, args, kwargs);
+}
+
+static PyMethodDef QuadArrayMethods[] = {
+  {"arange", qarray_arange, METH_VARARGS, "Create a 1-D qarray with evenly spaced values in an interval."},
+  {"linspace", qarray_linspace, METH_VARARGS, "Create a 1-D qarray with evenly spaced samples over an interval."},
+  {"empty", qarray_empty, METH_VARARGS, "Create a 1-D uninitialized qarray."},
+  {"full", qarray_full, METH_VARARGS, "Create a 1-D qarray filled with a value."},
+  {"zeros", qarray_zeros, METH_VARARGS, "Create a 1-D qarray of zeros."},
+  {"ones", qarray_ones, METH_VARARGS, "Create a 1-D qarray of ones."},
+  {"from_list", qarray_from_list, METH_VARARGS, "Create a qarray from a Python sequence."},
+  {"from_array", qarray_from_array, METH_VARARGS, "Create a qarray from an array-like object."},
+  {"asarray", (PyCFunction)qarray_asarray, METH_VARARGS | METH_KEYWORDS, "Create a qarray from an array-like object."},
+  {"array", (PyCFunction)qarray_array, METH_VARARGS | METH_KEYWORDS, "Create a qarray from an array-like object."},
+  {"asfortranarray", qarray_asfortranarray, METH_VARARGS, "Create a Fortran-contiguous qarray from an array-like object."},
+  {"ravel", (PyCFunction)qarray_ravel, METH_VARARGS | METH_KEYWORDS, "Return a contiguous flattened qarray from an array-like object."},
+  {"empty_like", qarray_empty_like, METH_VARARGS, "Create an empty qarray with the same shape as input."},
+  {"zeros_like", qarray_zeros_like, METH_VARARGS, "Create a zero-filled qarray with the same shape as input."},
+  {"ones_like", qarray_ones_like, METH_VARARGS, "Create a one-filled qarray with the same shape as input."},
+  {"full_like", qarray_full_like, METH_VARARGS, "Create a qarray filled with a value and the same shape as input."},
+  {"set_fast_math", qarray_set_fast_math, METH_VARARGS, "Enable or disable the fast exp/log/sin/cos loops for this thread, returns the previous setting."},
+  {"get_fast_math", qarray_get_fast_math, METH_NOARGS, "Return True if the fast exp/log/sin/cos loops are enabled for this thread."},
+  {"qsum", (PyCFunction)qarray_qsum, METH_VARARGS | METH_KEYWORDS, "Sum all elements of an array in quad precision, reading float64 data without converting it."},
+  {"qdot", (PyCFunction)qarray_qdot, METH_VARARGS | METH_KEYWORDS, "Dot product of two arrays accumulated in quad precision, float64 products are exact."},
+  {"qnrm2", (PyCFunction)qarray_qnrm2, METH_VARARGS | METH_KEYWORDS, "Euclidean norm of an array with the sum of squares accumulated in quad precision."},
+  {"qgemv", (PyCFunction)qarray_qgemv, METH_VARARGS | METH_KEYWORDS, "Matrix-vector product a @ x accumulated in quad precision, split over rows."},
+  {"qaxpy", (PyCFunction)qarray_qaxpy, METH_VARARGS | METH_KEYWORDS, "Compute alpha * x + y with a single rounding per element."},
+  {"from_strings", (PyCFunction)qarray_from_strings, METH_VARARGS | METH_KEYWORDS, "Parse a sequence or S/U array of decimal strings into a qarray."},
+  {"to_strings", (PyCFunction)qarray_to_strings, METH_VARARGS | METH_KEYWORDS, "Format each element of an array as text, shortest round trip by default, into a U, S or StringDType array."},
+  {"runtime_info", qarray_runtime_info, METH_NOARGS, "Return a dict describing the CPU level selected for the batched kernels."},
+  {"loadtxt", (PyCFunction)qarray_loadtxt, METH_VARARGS | METH_KEYWORDS, "Load a text table into a qarray, parsing line aligned chunks of the file in parallel."},
+  {"savetxt", (PyCFunction)qarray_savetxt, METH_VARARGS | METH_KEYWORDS, "Save a 1-D or 2-D array to a text file, formatting blocks of rows in parallel."},
+  {"to_dlpack", (PyCFunction)qarray_to_dlpack, METH_VARARGS | METH_KEYWORDS, "Export an array as a DLPack capsule that shares its memory, versioned when max_version is given."},
+  {"from_dlpack", (PyCFunction)qarray_from_dlpack, METH_VARARGS | METH_KEYWORDS, "Wrap a DLPack capsule or producer of 128 bit floats as a qarray without copying."},
+  {"to_arrow", (PyCFunction)qarray_to_arrow, METH_VARARGS | METH_KEYWORDS, "Export a 1-D array as Arrow C Data Interface capsules of 16 byte fixed_size_binary that share its memory."},
+  {"from_arrow", (PyCFunction)qarray_from_arrow, METH_VARARGS | METH_KEYWORDS, "Wrap Arrow capsules or an object with __arrow_c_array__ of 16 byte fixed_size_binary as a read-only qarray without copying."},
+  {NULL, NULL, 0, NULL},
+};
+
+static PyModuleDef QuadArrayModule = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "qarray",
+    .m_doc = "Quad precision module for array quad's.",
+    .m_methods = QuadArrayMethods,
+    .m_size = -1,
+};
+
+
+static npy_bool 
+QuadArray_nonzero(void *ip, void *arr){
+
+    __uint128_t u;
+
+    // ip may be unaligned; -0.0 is false and NaN true
+    memcpy(&u, ip, sizeof(u));
+    if (arr != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)arr)) {
+        qdd_bswap128(&u);
+    }
+    return (npy_bool)qdd_bits_nonzero(u);
+}
+
+static void
+QuadArray_copyswap(__float128 *dst, __float128 *src,
+                    int swap, void *NPY_UNUSED(arr))
+{
+  qdd_copyswapn((char *)dst, sizeof(__float128), (const char *)src, sizeof(__float128), 1, sizeof(__float128), swap != 0);
+}
+
+static void
+QuadArray_copyswapn(void *dst, npy_intp dstride, void *src,
+                   npy_intp sstride, npy_intp n, int swap, void *NPY_UNUSED(arr))
+{
+  // One memmove for contiguous data and a bswap64 pair per swapped element
+  qdd_copyswapn(dst, dstride, src, sstride, n, sizeof(__float128), swap != 0);
+}
+
+
+static int QuadArray_setitem(PyObject* item, __float128* data, void* array){
+  QuadObject tmp;
 
   if (PyObject_to_QuadObject(item, &tmp, false)) {
-    *data = tmp.value;
+    // data may be unaligned, or in a non-native byte order array
+    if (array != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)array)) {
+      qdd_bswap128(&tmp.value);
+    }
+    memcpy(data, &tmp.value, sizeof(tmp.value));
   } else {
         PyErr_SetString(PyExc_TypeError,
                     "Failed to setitem in QuadArray");
@@ -1529,11 +3430,14 @@ static int QuadArray_setitem(PyObject* item, __float128* data, void* array){
 }
 
 static PyObject *
-QuadArray_getitem(__float128* data, void* NPY_UNUSED(arr))
+QuadArray_getitem(__float128* data, void* arr)
 {
   QuadObject tmp;
 
-  tmp.value = *data;
+  memcpy(&tmp.value, data, sizeof(tmp.value));
+  if (arr != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)arr)) {
+    qdd_bswap128(&tmp.value);
+  }
 
   return QuadObject_to_PyObject(tmp);
 }
@@ -1658,6 +3562,13 @@ PyInit_qarray(void)
         return NULL;
     }
 
+    qfast_init();
+    if (qsoft_init() < 0) {
+      PyErr_Format(PyExc_ValueError, "unknown %s value '%s'", QSOFT_LEVEL_ENV, getenv(QSOFT_LEVEL_ENV));
+      Py_DECREF(m);
+      return NULL;
+    }
+
     PyArray_InitArrFuncs(&QuadArrayFuncs);
     QuadArrayFuncs.nonzero = (PyArray_NonzeroFunc*) QuadArray_nonzero;
     QuadArrayFuncs.copyswap = (PyArray_CopySwapFunc*) QuadArray_copyswap;
@@ -1712,6 +3623,10 @@ PyInit_qarray(void)
       Py_DECREF(m);
       return NULL;
     }
+    if (QuadArray_add_ufuncs(m) < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
 
     if (PyModule_AddObjectRef(m, "qarray", (PyObject *)&QuadType) < 0) {
       Py_DECREF(m);
@@ -0,0 +1,840 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#include "qdd.h"
+#include "qformat.h"
+#include "qparse.h"
+
+// Distances at or past this many 2^-64 units are too far to matter
+#define QFORMAT_FAR (((__uint128_t)1) << 126)
+// Largest width or precision accepted in a format spec
+#define QFORMAT_SPEC_MAX 1000000
+
+typedef enum {
+    QFORMAT_OUT,
+    QFORMAT_IN,
+    QFORMAT_UNSURE,
+} qformat_side;
+
+static const __uint128_t qformat_pow10[39] = {
+    (__uint128_t)1ULL,
+    (__uint128_t)10ULL,
+    (__uint128_t)100ULL,
+    (__uint128_t)1000ULL,
+    (__uint128_t)10000ULL,
+    (__uint128_t)100000ULL,
+    (__uint128_t)1000000ULL,
+    (__uint128_t)10000000ULL,
+    (__uint128_t)100000000ULL,
+    (__uint128_t)1000000000ULL,
+    (__uint128_t)10000000000ULL,
+    (__uint128_t)100000000000ULL,
+    (__uint128_t)1000000000000ULL,
+    (__uint128_t)10000000000000ULL,
+    (__uint128_t)100000000000000ULL,
+    (__uint128_t)1000000000000000ULL,
+    (__uint128_t)10000000000000000ULL,
+    (__uint128_t)100000000000000000ULL,
+    (__uint128_t)1000000000000000000ULL,
+    (__uint128_t)10000000000000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 10,
+    (__uint128_t)10000000000000000000ULL * 100,
+    (__uint128_t)10000000000000000000ULL * 1000,
+    (__uint128_t)10000000000000000000ULL * 10000,
+    (__uint128_t)10000000000000000000ULL * 100000,
+    (__uint128_t)10000000000000000000ULL * 1000000,
+    (__uint128_t)10000000000000000000ULL * 10000000,
+    (__uint128_t)10000000000000000000ULL * 100000000,
+    (__uint128_t)10000000000000000000ULL * 1000000000,
+    (__uint128_t)10000000000000000000ULL * 10000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 100000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 1000000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 10000000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 100000000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 1000000000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 10000000000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 100000000000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 1000000000000000000ULL,
+    (__uint128_t)10000000000000000000ULL * 10000000000000000000ULL,
+};
+
+static inline __uint128_t
+qformat_shr256(__uint128_t hi, __uint128_t lo, int n)
+{
+    // Low 128 bits of (hi:lo) >> n, 0 < n < 256
+    if (n >= 128) {
+        return hi >> (n - 128);
+    }
+    return (hi << (128 - n)) | (lo >> n);
+}
+
+static inline __uint128_t
+qformat_fixed(__uint128_t v, uint64_t frac)
+{
+    // v + frac / 2^64 in units of 2^-64
+    return (v >> 62) != 0 ? QFORMAT_FAR : (v << 64) | frac;
+}
+
+// x * 10^-k as d + frac / 2^64, low by less than eps / 2^64, and the gaps
+// to the rounding boundaries either side in 2^-64 units, low by less than
+// gap_err
+typedef struct {
+    __uint128_t d;
+    uint64_t frac;
+    __uint128_t eps;
+    __uint128_t lower;
+    __uint128_t upper;
+    __uint128_t gap_err;
+} qformat_scaled;
+
+static inline qformat_side
+qformat_classify(__uint128_t dmin, __uint128_t dmax, __uint128_t gap, __uint128_t gap_err)
+{
+    // Where a candidate between dmin and dmax away from x lies
+    if (dmax < gap) {
+        return QFORMAT_IN;
+    }
+    if (dmin > gap + gap_err) {
+        return QFORMAT_OUT;
+    }
+    return QFORMAT_UNSURE;
+}
+
+// The multiples of 10^t either side of d and where they lie
+typedef struct {
+    __uint128_t base;
+    qformat_side below;
+    qformat_side above;
+    __uint128_t dist_below[2];
+    __uint128_t dist_above[2];
+} qformat_cut;
+
+static void
+qformat_sides(const qformat_scaled *s, int t, qformat_cut *c)
+{
+    __uint128_t pw = qformat_pow10[t];
+    __uint128_t rem, a;
+
+    c->base = s->d / pw;
+    rem = s->d - c->base * pw;
+
+    c->dist_below[0] = qformat_fixed(rem, s->frac);
+    c->dist_below[1] = c->dist_below[0] + s->eps;
+    c->below = c->base == 0 ? QFORMAT_OUT : qformat_classify(c->dist_below[0], c->dist_below[1], s->lower, s->gap_err);
+
+    a = qformat_fixed(pw - rem, 0);
+    c->dist_above[1] = a == QFORMAT_FAR ? a : a - s->frac;
+    c->dist_above[0] = c->dist_above[1] > s->eps ? c->dist_above[1] - s->eps : 0;
+    c->above = qformat_classify(c->dist_above[0], c->dist_above[1], s->upper, s->gap_err);
+}
+
+static inline bool
+qformat_unsure(const qformat_cut *c)
+{
+    return c->below == QFORMAT_UNSURE || c->above == QFORMAT_UNSURE;
+}
+
+static inline bool
+qformat_fits(const qformat_cut *c)
+{
+    return c->below == QFORMAT_IN || c->above == QFORMAT_IN;
+}
+
+// Fast path: returns false if the shortest digits could not be settled
+static bool
+qformat_shortest_fast(__uint128_t m, int e2, bool lower_closer, __uint128_t *digits, int *exp10)
+{
+    qformat_scaled s;
+    qformat_cut best, cut;
+    __uint128_t big, hi, lo, half, width;
+    int z, lead, k, f, shift, g, t, tlo, thi, stop;
+
+    // Subnormals are normalised for the product, the gap keeps its size
+    z = qdd_clz128(m) - 15;
+    m <<= z;
+    lead = e2 - z + 112;
+    k = (int)floor(lead * 0.30102999566398120) - 36;
+    if (-k < QPARSE_QMIN || -k > QPARSE_QMAX) {
+        return false;
+    }
+
+    // x * 10^-k = m * big * 2^-shift, short of the truth by under 2^-126 relative
+    qparse_pow10(-k, &big, &f);
+    hi = qparse_mul_128(m, big, &lo);
+    shift = -(e2 - z + f);
+    if (shift <= 64 || shift >= 256) {
+        return false;
+    }
+    s.d = qformat_shr256(hi, lo, shift);
+    s.frac = (uint64_t)qformat_shr256(hi, lo, shift - 64);
+    if (s.d < qformat_pow10[36] || s.d >= qformat_pow10[38]) {
+        return false;
+    }
+    s.eps = (s.d >> 62) + 2;
+
+    // Half the gap to the next quad is 2^(e2 - 1) * 10^-k
+    g = z + 63 - shift;
+    if (g >= 0) {
+        if (g >= 62 || (big >> (126 - g)) != 0) {
+            return false;
+        }
+        half = big << g;
+        s.gap_err = ((__uint128_t)2 << g) + 1;
+    } else {
+        half = -g >= 128 ? 0 : big >> -g;
+        s.gap_err = 2;
+    }
+    s.upper = half;
+    s.lower = lower_closer ? half >> 1 : half;
+
+    // Largest t with a multiple of 10^t inside the rounding interval. An
+    // interval as wide as 10^t always holds one, so start there and step
+    // down for the error; a longer one only fits by luck.
+    width = (s.lower + s.upper) >> 64;
+    for (tlo = 0; tlo < 38 && qformat_pow10[tlo + 1] <= width; tlo++) {
+    }
+    for (;;) {
+        qformat_sides(&s, tlo, &best);
+        if (qformat_fits(&best)) {
+            break;
+        }
+        if (qformat_unsure(&best) || tlo == 0) {
+            return false;
+        }
+        tlo--;
+    }
+
+    // Each extra digit dropped is ten times less likely, so check the next
+    // two in turn and bisect anything beyond
+    stop = tlo + 3 < 39 ? tlo + 3 : 39;
+    for (thi = tlo + 1; thi < stop; thi++) {
+        qformat_sides(&s, thi, &cut);
+        if (qformat_unsure(&cut)) {
+            return false;
+        }
+        if (!qformat_fits(&cut)) {
+            break;
+        }
+        tlo = thi;
+        best = cut;
+    }
+    if (thi == stop && stop < 39) {
+        // Both fitted, bisect the rest of the way
+        for (thi = 39; thi - tlo > 1;) {
+            t = (tlo + thi) / 2;
+            qformat_sides(&s, t, &cut);
+            if (qformat_unsure(&cut)) {
+                return false;
+            }
+            if (qformat_fits(&cut)) {
+                tlo = t;
+                best = cut;
+            } else {
+                thi = t;
+            }
+        }
+    }
+
+    if (qformat_unsure(&best)) {
+        return false;
+    }
+    if (best.below == QFORMAT_IN && best.above == QFORMAT_IN) {
+        if (best.dist_above[1] < best.dist_below[0]) {
+            best.base++;
+        } else if (!(best.dist_below[1] < best.dist_above[0])) {
+            return false;
+        }
+    } else if (best.above == QFORMAT_IN) {
+        best.base++;
+    }
+
+    *digits = best.base;
+    *exp10 = k + tlo;
+    return true;
+}
+
+static bool
+qformat_reads_back(__float128 x, const char *digits, int n, int exp10)
+{
+    char buf[QFORMAT_MAX_DIGITS + 16];
+    char *end;
+    __float128 y;
+
+    memcpy(buf, digits, (size_t)n);
+    snprintf(buf + n, sizeof buf - (size_t)n, "e%d", exp10);
+    y = strtoflt128(buf, &end);
+    return memcmp(&x, &y, sizeof(x)) == 0;
+}
+
+static bool
+qformat_round_up(char *digits, int n, int *exp10)
+{
+    // Add one in the last place, a carry out of the top leaves "1"
+    int i;
+
+    for (i = n - 1; i >= 0; i--) {
+        if (digits[i] != '9') {
+            digits[i]++;
+            return true;
+        }
+        digits[i] = '0';
+    }
+    digits[0] = '1';
+    *exp10 += n;
+    return false;
+}
+
+typedef struct {
+    char digits[QFORMAT_MAX_DIGITS];
+    int n;
+    int exp10;
+    bool ok;
+} qformat_candidate;
+
+// Truncate the exact digits ds to n places and round them up, and check
+// whether either reads back as x
+static bool
+qformat_try_length(__float128 x, const char *ds, int ndigits, int point, int n, qformat_candidate *down,
+                   qformat_candidate *up)
+{
+    memcpy(down->digits, ds, (size_t)n);
+    down->n = n;
+    down->exp10 = point - n + 1;
+    down->ok = qformat_reads_back(x, down->digits, n, down->exp10);
+
+    up->ok = false;
+    if (ndigits > n) {
+        memcpy(up->digits, ds, (size_t)n);
+        up->exp10 = point - n + 1;
+        up->n = qformat_round_up(up->digits, n, &up->exp10) ? n : 1;
+        up->ok = qformat_reads_back(x, up->digits, up->n, up->exp10);
+    }
+    return down->ok || up->ok;
+}
+
+// Exact path from the full decimal expansion of x. Returns the number of
+// digits, or 0 if out of memory.
+static int
+qformat_shortest_exact(__float128 x, int e2, int lead, char *digits, int *exp10)
+{
+    qformat_candidate down, up;
+    const qformat_candidate *best;
+    char *buf, *ds, *e;
+    int size, precision, ndigits, point, lo, hi, mid, n;
+    bool use_up;
+
+    // m * 2^e2 has fewer than 36 + 0.7 * -e2 significant digits
+    precision = 40 + (e2 < 0 ? (int)(-e2 * 0.69897) : 0) + (lead > 0 ? (int)(lead * 0.30103) : 0);
+    size = precision + 16;
+    buf = malloc((size_t)size);
+    if (buf == NULL) {
+        return 0;
+    }
+    quadmath_snprintf(buf, (size_t)size, "%.*Qe", precision, fabsq(x));
+
+    // "d.ddd...e+X" becomes the digit string ds, the first worth 10^point
+    e = strchr(buf, 'e');
+    point = atoi(e + 1);
+    buf[1] = buf[0];
+    ds = buf + 1;
+    ndigits = (int)(e - ds);
+    while (ndigits > 1 && ds[ndigits - 1] == '0') {
+        ndigits--;
+    }
+
+    // Reading back only gets easier with more digits, and 36 always do
+    lo = 0;
+    hi = ndigits < QFORMAT_MAX_DIGITS ? ndigits : QFORMAT_MAX_DIGITS;
+    while (hi - lo > 1) {
+        mid = (lo + hi) / 2;
+        if (qformat_try_length(x, ds, ndigits, point, mid, &down, &up)) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    qformat_try_length(x, ds, ndigits, point, hi, &down, &up);
+
+    // Closest of the two, ties to an even last digit
+    use_up = up.ok && !down.ok;
+    if (up.ok && down.ok) {
+        if (ds[hi] != '5') {
+            use_up = ds[hi] > '5';
+        } else {
+            use_up = ndigits > hi + 1 || ((ds[hi - 1] - '0') & 1);
+        }
+    }
+    best = use_up ? &up : &down;
+    free(buf);
+
+    n = best->n;
+    *exp10 = best->exp10;
+    memcpy(digits, best->digits, (size_t)n);
+    while (n > 1 && digits[n - 1] == '0') {
+        n--;
+        (*exp10)++;
+    }
+    return n;
+}
+
+int
+qformat_shortest(__float128 x, char *digits, int *exp10)
+{
+    qdd_quad_bits b;
+    __uint128_t m, d;
+    uint64_t hi, lo;
+    int biased, e2, lead, n, i, len;
+    char tmp[40];
+
+    x = fabsq(x);
+    b.f = x;
+    biased = (int)((b.u >> 112) & 0x7fff);
+    m = b.u & ((((__uint128_t)1) << 112) - 1);
+    if (biased == 0) {
+        e2 = 1 - QDD_QUAD_BIAS - 112;
+    } else {
+        m |= ((__uint128_t)1) << 112;
+        e2 = biased - QDD_QUAD_BIAS - 112;
+    }
+    lead = e2 + 127 - qdd_clz128(m);
+
+    if (!qformat_shortest_fast(m, e2, biased > 1 && m == (((__uint128_t)1) << 112), &d, exp10)) {
+        return qformat_shortest_exact(x, e2, lead, digits, exp10);
+    }
+
+    // d < 10^38, two 64-bit halves keep the digit loop off 128-bit division
+    n = 0;
+    for (hi = (uint64_t)(d / qformat_pow10[19]), lo = (uint64_t)(d % qformat_pow10[19]), i = 0; i < 19; i++) {
+        tmp[n++] = (char)('0' + (int)(lo % 10));
+        lo /= 10;
+    }
+    while (hi != 0) {
+        tmp[n++] = (char)('0' + (int)(hi % 10));
+        hi /= 10;
+    }
+    while (n > 1 && tmp[n - 1] == '0') {
+        n--;
+    }
+
+    // Reverse, dropping trailing zeros into the exponent
+    for (i = 0; tmp[i] == '0'; i++) {
+        (*exp10)++;
+    }
+    for (len = 0; len < n - i; len++) {
+        digits[len] = tmp[n - 1 - len];
+    }
+    return len;
+}
+
+int
+qformat_repr(__float128 x, char *buf)
+{
+    char digits[QFORMAT_MAX_DIGITS];
+    char *p = buf;
+    int n, exp10, point, i;
+
+    if (isnanq(x)) {
+        strcpy(buf, "nan");
+        return 3;
+    }
+    if (signbitq(x)) {
+        *p++ = '-';
+    }
+    if (isinfq(x)) {
+        strcpy(p, "inf");
+        return (int)(p - buf) + 3;
+    }
+    if (x == 0) {
+        strcpy(p, "0.0");
+        return (int)(p - buf) + 3;
+    }
+
+    n = qformat_shortest(x, digits, &exp10);
+    if (n == 0) {
+        // Out of memory on the exact path, which never happens for the
+        // values the fast path gives up on in practice
+        n = quadmath_snprintf(p, QFORMAT_REPR_SIZE - 1, "%.35Qe", fabsq(x));
+        return (int)(p - buf) + n;
+    }
+    point = exp10 + n - 1;
+
+    // Python's repr switches to exponent form outside [1e-4, 1e16)
+    if (point >= -4 && point < 16) {
+        if (point < 0) {
+            *p++ = '0';
+            *p++ = '.';
+            for (i = 0; i < -point - 1; i++) {
+                *p++ = '0';
+            }
+            memcpy(p, digits, (size_t)n);
+            p += n;
+        } else if (n <= point + 1) {
+            memcpy(p, digits, (size_t)n);
+            p += n;
+            for (i = n; i <= point; i++) {
+                *p++ = '0';
+            }
+            *p++ = '.';
+            *p++ = '0';
+        } else {
+            memcpy(p, digits, (size_t)point + 1);
+            p += point + 1;
+            *p++ = '.';
+            memcpy(p, digits + point + 1, (size_t)(n - point - 1));
+            p += n - point - 1;
+        }
+        *p = '\0';
+        return (int)(p - buf);
+    }
+
+    *p++ = digits[0];
+    if (n > 1) {
+        *p++ = '.';
+        memcpy(p, digits + 1, (size_t)n - 1);
+        p += n - 1;
+    }
+    p += sprintf(p, "e%c%02d", point < 0 ? '-' : '+', point < 0 ? -point : point);
+    return (int)(p - buf);
+}
+
+static int
+qformat_complex_part(__float128 x, char *buf)
+{
+    // Complex parts drop the ".0" a float repr keeps
+    int n = qformat_repr(x, buf);
+
+    if (n > 2 && buf[n - 2] == '.' && buf[n - 1] == '0') {
+        n -= 2;
+        buf[n] = '\0';
+    }
+    return n;
+}
+
+int
+qformat_complex_repr(__complex128 z, char *buf)
+{
+    __float128 re = crealq(z);
+    __float128 im = cimagq(z);
+    char *p = buf;
+
+    if (re == 0 && !signbitq(re)) {
+        p += qformat_complex_part(im, p);
+        *p++ = 'j';
+        *p = '\0';
+        return (int)(p - buf);
+    }
+
+    *p++ = '(';
+    p += qformat_complex_part(re, p);
+    if (!signbitq(im) || isnanq(im)) {
+        *p++ = '+';
+    }
+    p += qformat_complex_part(im, p);
+    *p++ = 'j';
+    *p++ = ')';
+    *p = '\0';
+    return (int)(p - buf);
+}
+
+int
+qformat_int128(__int128 v, char *buf)
+{
+    unsigned __int128 u = v < 0 ? 0 - (unsigned __int128)v : (unsigned __int128)v;
+    char tmp[QFORMAT_INT128_SIZE];
+    int n = 0, len = 0;
+
+    do {
+        tmp[n++] = (char)('0' + (int)(u % 10));
+        u /= 10;
+    } while (u != 0);
+    if (v < 0) {
+        buf[len++] = '-';
+    }
+    while (n > 0) {
+        buf[len++] = tmp[--n];
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+static bool
+qformat_is_align(char c)
+{
+    return c == '<' || c == '>' || c == '=' || c == '^';
+}
+
+static bool
+qformat_read_int(const char *spec, size_t len, size_t *i, int *out)
+{
+    // Returns false if there are no digits or too many
+    size_t start = *i;
+    long v = 0;
+
+    while (*i < len && spec[*i] >= '0' && spec[*i] <= '9') {
+        v = v * 10 + (spec[*i] - '0');
+        if (v > QFORMAT_SPEC_MAX) {
+            return false;
+        }
+        (*i)++;
+    }
+    *out = (int)v;
+    return *i > start;
+}
+
+bool
+qformat_parse_spec(const char *spec, size_t len, qformat_spec *out)
+{
+    size_t i = 0;
+    size_t cp = 1;
+    bool fill_given = false;
+
+    memset(out, 0, sizeof(*out));
+    out->fill[0] = ' ';
+    out->fill_len = 1;
+    out->precision = -1;
+
+    // The fill may be any character, so skip a whole UTF-8 sequence
+    if (len > 0) {
+        unsigned char c = (unsigned char)spec[0];
+        cp = c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+    }
+    if (len > cp && qformat_is_align(spec[cp])) {
+        memcpy(out->fill, spec, cp);
+        out->fill_len = (int)cp;
+        out->align = spec[cp];
+        fill_given = true;
+        i = cp + 1;
+    } else if (len > 0 && qformat_is_align(spec[0])) {
+        out->align = spec[0];
+        i = 1;
+    }
+
+    if (i < len && (spec[i] == '+' || spec[i] == '-' || spec[i] == ' ')) {
+        out->sign = spec[i++];
+    }
+    if (i < len && spec[i] == 'z') {
+        out->no_neg_zero = true;
+        i++;
+    }
+    if (i < len && spec[i] == '#') {
+        out->alternate = true;
+        i++;
+    }
+    if (i < len && spec[i] == '0') {
+        // Zero padding, unless a fill or alignment was given
+        if (!fill_given) {
+            out->fill[0] = '0';
+        }
+        if (out->align == 0) {
+            out->align = '=';
+        }
+        i++;
+    }
+    if (i < len && spec[i] >= '0' && spec[i] <= '9' && !qformat_read_int(spec, len, &i, &out->width)) {
+        return false;
+    }
+    if (i < len && (spec[i] == ',' || spec[i] == '_')) {
+        out->grouping = spec[i++];
+    }
+    if (i < len && spec[i] == '.') {
+        i++;
+        if (!qformat_read_int(spec, len, &i, &out->precision)) {
+            return false;
+        }
+    }
+    if (i < len && strchr("eEfFgG%", spec[i]) != NULL && spec[i] != '\0') {
+        out->type = spec[i++];
+    }
+    return i == len;
+}
+
+static int
+qformat_strip_zeros(char *s, int n)
+{
+    // "1.2300e+05" to "1.23e+05", "1.000e+05" to "1e+05"
+    char *e = strchr(s, 'e');
+    char *end;
+
+    if (e == NULL || memchr(s, '.', (size_t)(e - s)) == NULL) {
+        return n;
+    }
+    for (end = e; end[-1] == '0'; end--) {
+    }
+    if (end[-1] == '.') {
+        end--;
+    }
+    memmove(end, e, (size_t)(s + n - e) + 1);
+    return n - (int)(e - end);
+}
+
+static void
+qformat_put(char *buf, size_t size, size_t *pos, const char *src, size_t len)
+{
+    // Append what fits, leaving room for the NUL
+    if (*pos + 1 < size) {
+        memcpy(buf + *pos, src, *pos + len < size - 1 ? len : size - 1 - *pos);
+    }
+    *pos += len;
+}
+
+int
+qformat_apply(__float128 x, const qformat_spec *spec, char *buf, size_t size)
+{
+    char small[QFORMAT_REPR_SIZE + 64];
+    char fmt[32];
+    char *body = small;
+    char *grouped = NULL;
+    const char *sign = "";
+    size_t body_len, total, pad, left, right, i, pos;
+    bool negative;
+    int n;
+
+    negative = signbitq(x) && !isnanq(x);
+    x = fabsq(x);
+
+    if (spec->type == 0 && spec->precision < 0) {
+        n = qformat_repr(x, small);
+    } else {
+        char type = spec->type == 0 ? 'g' : spec->type == '%' ? 'f' : spec->type;
+        int precision = spec->precision < 0 ? 6 : spec->precision;
+
+        if (spec->type == '%') {
+            x *= 100;
+        }
+        snprintf(fmt, sizeof fmt, "%%%s.*Q%c", spec->alternate ? "#" : "", type);
+        n = quadmath_snprintf(small, sizeof small - 16, fmt, precision, x);
+        if (n < 0) {
+            return -1;
+        }
+        // Leave room for a suffix, or the exponent form below
+        if ((size_t)n >= sizeof small - 16) {
+            body = malloc((size_t)n + 16);
+            if (body == NULL) {
+                return -1;
+            }
+            quadmath_snprintf(body, (size_t)n + 1, fmt, precision, x);
+        }
+        if (spec->type == '%') {
+            body[n++] = '%';
+            body[n] = '\0';
+        } else if (spec->type == 0 && finiteq(x) && strchr(body, 'e') == NULL) {
+            // No type is 'g' that keeps a digit after the point, so an
+            // integer part as long as the precision goes to exponent form
+            int p = precision > 1 ? precision : 1;
+
+            if ((int)strspn(body, "0123456789") >= p && (body[0] != '0' || x == 0)) {
+                n = quadmath_snprintf(body, (size_t)n + 16, spec->alternate ? "%#.*Qe" : "%.*Qe", p - 1, x);
+                if (!spec->alternate) {
+                    n = qformat_strip_zeros(body, n);
+                }
+            } else if (strchr(body, '.') == NULL) {
+                body[n++] = '.';
+                body[n++] = '0';
+                body[n] = '\0';
+            }
+        }
+    }
+    if (spec->type == 0 && spec->precision < 0 && spec->alternate && strchr(body, '.') == NULL
+        && strchr(body, 'e') != NULL) {
+        // '#' keeps the point in "1e+16" too
+        memmove(strchr(body, 'e') + 1, strchr(body, 'e'), (size_t)n - (size_t)(strchr(body, 'e') - body) + 1);
+        *strchr(body, 'e') = '.';
+        n++;
+    }
+    body_len = (size_t)n;
+
+    if (negative && spec->no_neg_zero && strspn(body, "0.") == strcspn(body, "e%")) {
+        negative = false;
+    }
+    if (negative) {
+        sign = "-";
+    } else if (spec->sign == '+') {
+        sign = "+";
+    } else if (spec->sign == ' ') {
+        sign = " ";
+    }
+
+    if (spec->grouping) {
+        size_t digits = strspn(body, "0123456789");
+        size_t zeros = 0;
+
+        // Zero padding is grouped along with the digits
+        if (digits > 0 && spec->align == '=' && spec->fill_len == 1 && spec->fill[0] == '0') {
+            while (spec->width > 0
+                   && strlen(sign) + digits + zeros + (digits + zeros - 1) / 3 + body_len - digits
+                          < (size_t)spec->width) {
+                zeros++;
+            }
+        }
+        if (digits + zeros > 3) {
+            size_t extra = zeros + (digits + zeros - 1) / 3;
+
+            grouped = malloc(body_len + extra + 1);
+            if (grouped == NULL) {
+                if (body != small) {
+                    free(body);
+                }
+                return -1;
+            }
+            pos = 0;
+            for (i = 0; i < digits + zeros; i++) {
+                if (i > 0 && (digits + zeros - i) % 3 == 0) {
+                    grouped[pos++] = spec->grouping;
+                }
+                grouped[pos++] = i < zeros ? '0' : body[i - zeros];
+            }
+            memcpy(grouped + pos, body + digits, body_len - digits + 1);
+            if (body != small) {
+                free(body);
+            }
+            body = grouped;
+            body_len += extra;
+        }
+    }
+
+    // Width counts characters, the fill may take several bytes
+    total = strlen(sign) + body_len;
+    pad = spec->width > 0 && (size_t)spec->width > total ? (size_t)spec->width - total : 0;
+    switch (spec->align) {
+    case '<':
+        left = 0;
+        right = pad;
+        break;
+    case '^':
+        left = pad / 2;
+        right = pad - left;
+        break;
+    default:
+        left = pad;
+        right = 0;
+        break;
+    }
+
+    total += pad * (size_t)spec->fill_len;
+    pos = 0;
+    if (spec->align == '=') {
+        qformat_put(buf, size, &pos, sign, strlen(sign));
+    }
+    for (i = 0; i < left; i++) {
+        qformat_put(buf, size, &pos, spec->fill, (size_t)spec->fill_len);
+    }
+    if (spec->align != '=') {
+        qformat_put(buf, size, &pos, sign, strlen(sign));
+    }
+    qformat_put(buf, size, &pos, body, body_len);
+    for (i = 0; i < right; i++) {
+        qformat_put(buf, size, &pos, spec->fill, (size_t)spec->fill_len);
+    }
+    if (size > 0) {
+        buf[pos < size - 1 ? pos : size - 1] = '\0';
+    }
+
+    if (body != small) {
+        free(body);
+    }
+    return total > INT_MAX ? -1 : (int)total;
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+
+// Binary128 to decimal text.
+//
+// qformat_shortest finds the shortest decimal string that reads back as the
+// same quad, and the closest one to it if there are several, as Python's
+// float repr does. The digits come from one 113 by 128-bit product against
+// the qparse table of powers of ten. Every decision taken from that product
+// allows for its error, and anything too close to call is redone from the
+// exact decimal expansion printed by quadmath_snprintf.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// At most 36 digits are needed for a quad to round trip
+#define QFORMAT_MAX_DIGITS 36
+// Long enough for any qformat_repr output and its NUL
+#define QFORMAT_REPR_SIZE 48
+// Likewise for qformat_complex_repr and qformat_int128
+#define QFORMAT_COMPLEX_REPR_SIZE (2 * QFORMAT_REPR_SIZE + 4)
+#define QFORMAT_INT128_SIZE 42
+
+// Shortest round trip digits of |x|, for finite non-zero x. Writes the
+// digits, without a NUL, and returns how many there are; |x| reads back
+// from digits * 10^*exp10.
+int qformat_shortest(__float128 x, char *digits, int *exp10);
+
+// Python repr style text of x, "3.14", "1e+100", "-0.0", "inf" or "nan".
+// Returns the length written to buf, which needs QFORMAT_REPR_SIZE bytes.
+int qformat_repr(__float128 x, char *buf);
+
+// Python complex repr style text of z, "(1+2j)", "-3j" or "(nan+infj)",
+// into QFORMAT_COMPLEX_REPR_SIZE bytes. Returns the length.
+int qformat_complex_repr(__complex128 z, char *buf);
+
+// Decimal text of v into QFORMAT_INT128_SIZE bytes. Returns the length.
+int qformat_int128(__int128 v, char *buf);
+
+// A parsed Python format specification,
+// [[fill]align][sign][z][#][0][width][grouping][.precision][type]
+typedef struct {
+    char fill[4];
+    int fill_len;
+    char align;
+    char sign;
+    bool no_neg_zero;
+    bool alternate;
+    char grouping;
+    int width;
+    int precision;
+    char type;
+} qformat_spec;
+
+// Returns false if spec is not valid for a float
+bool qformat_parse_spec(const char *spec, size_t len, qformat_spec *out);
+
+// Format x as format(float, spec) would with quad digits; an empty type
+// with no precision gives the shortest repr. Returns the full length and
+// writes at most size - 1 bytes and a NUL to buf, like snprintf, or -1 if
+// out of memory.
+int qformat_apply(__float128 x, const qformat_spec *spec, char *buf, size_t size);
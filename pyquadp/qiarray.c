@@ -7,15 +7,24 @@
 
 #include <numpy/arrayobject.h>
 #include <numpy/ufuncobject.h>
+#include <fenv.h>
 #include <limits.h>
 #include <stdalign.h>
 #include <string.h>
 
 #define QIARRAY_MODULE
 #include "qiarray.h"
+#include "qformat.h"
 #include "qint.h"
+#include "qparse.h"
+#include "qsoftquad.h"
+#include "qarrow.h"
+#include "qdlpack.h"
+#include "qtable.h"
+#include "qtext.h"
 
 static int QuadIArrayTypeNum = -1;
+static int QuadArrayTypeNum = -1;
 
 static PyArray_ArrFuncs QuadIArrayFuncs;
 static PyArray_Descr *QuadIArrayDescr;
@@ -670,9 +679,190 @@ QuadIArray_register_ufunc_unary(const char *name, PyUFuncGenericFunction loop)
   return 0;
 }
 
+#define QIARRAY_DEFINE_QARRAY_BINARY_OP(name, op) \
+static void \
+QuadIArray_ufunc_##name##_qf(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+  npy_intp i; \
+  npy_intp n = dims[0]; \
+  char *inq = args[0]; \
+  char *inf = args[1]; \
+  char *out = args[2]; \
+\
+  for (i = 0; i < n; ++i) { \
+    *(__float128 *)out = (__float128)(*(__int128 *)inq) op *(__float128 *)inf; \
+    inq += steps[0]; \
+    inf += steps[1]; \
+    out += steps[2]; \
+  } \
+} \
+\
+static void \
+QuadIArray_ufunc_##name##_fq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+  npy_intp i; \
+  npy_intp n = dims[0]; \
+  char *inf = args[0]; \
+  char *inq = args[1]; \
+  char *out = args[2]; \
+\
+  for (i = 0; i < n; ++i) { \
+    *(__float128 *)out = *(__float128 *)inf op (__float128)(*(__int128 *)inq); \
+    inf += steps[0]; \
+    inq += steps[1]; \
+    out += steps[2]; \
+  } \
+}
+
+QIARRAY_DEFINE_QARRAY_BINARY_OP(add, +)
+QIARRAY_DEFINE_QARRAY_BINARY_OP(subtract, -)
+QIARRAY_DEFINE_QARRAY_BINARY_OP(multiply, *)
+
+#undef QIARRAY_DEFINE_QARRAY_BINARY_OP
+
+static void
+QuadIArray_ufunc_qarray_unsupported(char **NPY_UNUSED(args), const npy_intp *NPY_UNUSED(dims),
+                                    const npy_intp *NPY_UNUSED(steps), void *data)
+{
+  // data is the ufunc name. The loop only exists to stop NumPy from
+  // truncating a qarray operand to fit the integer loop.
+  if (!PyErr_Occurred()) {
+    PyErr_Format(PyExc_TypeError, "ufunc '%s' does not support a qiarray and a qarray operand, cast one of them first",
+                 (const char *)data);
+  }
+}
+
+static int
+QuadIArray_register_ufunc_qarray_unsupported(const char *name)
+{
+  PyObject *numpy_mod;
+  PyObject *ufunc;
+  int types[2][3] = {
+    {QuadIArrayTypeNum, QuadArrayTypeNum, QuadArrayTypeNum},
+    {QuadArrayTypeNum, QuadIArrayTypeNum, QuadArrayTypeNum},
+  };
+  int i;
+
+  numpy_mod = PyImport_ImportModule("numpy");
+  if (numpy_mod == NULL) {
+    return -1;
+  }
+  ufunc = PyObject_GetAttrString(numpy_mod, name);
+  Py_DECREF(numpy_mod);
+  if (ufunc == NULL) {
+    return -1;
+  }
+
+  for (i = 0; i < 2; ++i) {
+    if (PyUFunc_RegisterLoopForType((PyUFuncObject *)ufunc, QuadIArrayTypeNum, QuadIArray_ufunc_qarray_unsupported,
+                                    types[i], (void *)name) < 0) {
+      Py_DECREF(ufunc);
+      return -1;
+    }
+  }
+
+  Py_DECREF(ufunc);
+  return 0;
+}
+
+static void
+QuadIArray_ufunc_decompose(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  // Inf and NaN raise the invalid flag and give (0, 0)
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *outm = args[1];
+  char *oute = args[2];
+  bool invalid = false;
+
+  for (i = 0; i < n; ++i) {
+    __int128 m;
+    int32_t e;
+
+    invalid |= !qsq_decompose(*(__float128 *)in, &m, &e);
+    *(__int128 *)outm = m;
+    *(npy_int32 *)oute = e;
+    in += steps[0];
+    outm += steps[1];
+    oute += steps[2];
+  }
+  if (invalid) {
+    feraiseexcept(FE_INVALID);
+  }
+}
+
+#define QIARRAY_DEFINE_COMPOSE(suffix, etype) \
+static void \
+QuadIArray_ufunc_compose_##suffix(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data)) \
+{ \
+  npy_intp i; \
+  npy_intp n = dims[0]; \
+  char *inm = args[0]; \
+  char *ine = args[1]; \
+  char *out = args[2]; \
+  int flags = 0; \
+ \
+  for (i = 0; i < n; ++i) { \
+    switch (qsq_compose(*(__int128 *)inm, *(etype *)ine, (__float128 *)out)) { \
+    case QSQ_COMPOSE_EXACT: \
+      break; \
+    case QSQ_COMPOSE_INEXACT: \
+      flags |= FE_INEXACT; \
+      break; \
+    case QSQ_COMPOSE_UNDERFLOW: \
+      flags |= FE_INEXACT | FE_UNDERFLOW; \
+      break; \
+    case QSQ_COMPOSE_OVERFLOW: \
+      flags |= FE_INEXACT | FE_OVERFLOW; \
+      break; \
+    } \
+    inm += steps[0]; \
+    ine += steps[1]; \
+    out += steps[2]; \
+  } \
+  if (flags) { \
+    feraiseexcept(flags); \
+  } \
+}
+
+QIARRAY_DEFINE_COMPOSE(i, npy_int32)
+QIARRAY_DEFINE_COMPOSE(l, npy_int64)
+
+#undef QIARRAY_DEFINE_COMPOSE
+
 static int
 QuadIArray_register_ufuncs(void)
 {
+  static const char *const integer_only[] = {
+    "floor_divide", "remainder", "left_shift", "right_shift", "bitwise_and", "bitwise_or", "bitwise_xor",
+  };
+  size_t k;
+
+  // NumPy treats casts between same-sized user dtypes as safe both ways,
+  // so without these the qiarray loops below would also accept a qarray
+  // operand and truncate it. Mixed add, subtract and multiply are done in
+  // quad precision; the integer-only ufuncs raise TypeError instead.
+#define QIARRAY_REGISTER_QARRAY_LOOPS(name) \
+  if (QuadIArray_register_ufunc_binary_types(#name, QuadIArray_ufunc_##name##_qf, QuadIArrayTypeNum, QuadArrayTypeNum, QuadArrayTypeNum) < 0) { \
+    return -1; \
+  } \
+  if (QuadIArray_register_ufunc_binary_types(#name, QuadIArray_ufunc_##name##_fq, QuadArrayTypeNum, QuadIArrayTypeNum, QuadArrayTypeNum) < 0) { \
+    return -1; \
+  }
+
+  QIARRAY_REGISTER_QARRAY_LOOPS(add)
+  QIARRAY_REGISTER_QARRAY_LOOPS(subtract)
+  QIARRAY_REGISTER_QARRAY_LOOPS(multiply)
+
+#undef QIARRAY_REGISTER_QARRAY_LOOPS
+
+  for (k = 0; k < sizeof(integer_only) / sizeof(integer_only[0]); ++k) {
+    if (QuadIArray_register_ufunc_qarray_unsupported(integer_only[k]) < 0) {
+      return -1;
+    }
+  }
+
   if (QuadIArray_register_ufunc_binary("add", QuadIArray_ufunc_add) < 0) {
     return -1;
   }
@@ -813,6 +1003,108 @@ QuadIArray_register_cast_pair(
   return 0;
 }
 
+static void
+QuadIArray_cast_to_qarray(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  // Exact up to 2^113, correctly rounded beyond
+  npy_intp i;
+  __int128 *src = (__int128 *)from;
+  __float128 *dst = (__float128 *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = (__float128)src[i];
+  }
+}
+
+static void
+QuadIArray_cast_from_qarray(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  // Truncates toward zero, NaN and out of range values raise the invalid
+  // flag and give the most negative value
+  npy_intp i;
+  __float128 *src = (__float128 *)from;
+  __int128 *dst = (__int128 *)to;
+
+  for (i = 0; i < n; ++i) {
+    if (!qsq_to_int128(src[i], &dst[i])) {
+      feraiseexcept(FE_INVALID);
+    }
+  }
+}
+
+static bool
+qiarray_parse_int(const char *s, size_t len, void *out)
+{
+  return qparse_int128(s, len, (__int128 *)out);
+}
+
+static void
+QuadIArray_cast_to_text(void *from, void *to, npy_intp n, PyArrayObject *toarr, bool ucs4)
+{
+  char buf[QFORMAT_INT128_SIZE];
+  __int128 *src = (__int128 *)from;
+  char *dst = (char *)to;
+  npy_intp itemsize = PyArray_ITEMSIZE(toarr);
+  bool swap = !PyArray_ISNOTSWAPPED(toarr);
+  npy_intp i;
+
+  for (i = 0; i < n; ++i) {
+    int len = qformat_int128(src[i], buf);
+
+    if (!qtext_store(buf, (size_t)len, dst + i * itemsize, (size_t)itemsize, ucs4, swap)) {
+      PyErr_Format(PyExc_ValueError, "qint %s does not fit in %R, cast to a sized string dtype such as 'U40'", buf,
+                   (PyObject *)PyArray_DESCR(toarr));
+      return;
+    }
+  }
+}
+
+static void
+QuadIArray_cast_from_text(void *from, void *to, npy_intp n, PyArrayObject *fromarr, bool ucs4)
+{
+  char *src = (char *)from;
+  __int128 *dst = (__int128 *)to;
+  npy_intp itemsize = PyArray_ITEMSIZE(fromarr);
+  bool swap = !PyArray_ISNOTSWAPPED(fromarr);
+  npy_intp i;
+
+  for (i = 0; i < n; ++i) {
+    if (!qtext_parse(src + i * itemsize, (size_t)itemsize, ucs4, swap, qiarray_parse_int, &dst[i])) {
+      PyObject *item = PyArray_GETITEM(fromarr, src + i * itemsize);
+
+      if (item != NULL) {
+        PyErr_Format(PyExc_ValueError, "could not convert string to qint: %R", item);
+        Py_DECREF(item);
+      }
+      return;
+    }
+  }
+}
+
+static void
+QuadIArray_cast_to_unicode(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *toarr)
+{
+  QuadIArray_cast_to_text(from, to, n, (PyArrayObject *)toarr, true);
+}
+
+static void
+QuadIArray_cast_to_string(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *toarr)
+{
+  QuadIArray_cast_to_text(from, to, n, (PyArrayObject *)toarr, false);
+}
+
+static void
+QuadIArray_cast_from_unicode(void *from, void *to, npy_intp n, void *fromarr, void *NPY_UNUSED(toarr))
+{
+  QuadIArray_cast_from_text(from, to, n, (PyArrayObject *)fromarr, true);
+}
+
+static void
+QuadIArray_cast_from_string(void *from, void *to, npy_intp n, void *fromarr, void *NPY_UNUSED(toarr))
+{
+  QuadIArray_cast_from_text(from, to, n, (PyArrayObject *)fromarr, false);
+}
+
 static int
 QuadIArray_register_casts(PyArray_Descr *quad_descr, int quad_type_num)
 {
@@ -825,6 +1117,23 @@ QuadIArray_register_casts(PyArray_Descr *quad_descr, int quad_type_num)
 
 #undef QIARRAY_REGISTER_CASTS
 
+  // qiarray -> qarray is safe in the way int64 -> float64 is, so mixed
+  // operations promote to qarray
+  if (QuadIArray_register_cast_pair(quad_descr, quad_type_num, QuadArrayTypeNum, QuadIArray_cast_to_qarray, QuadIArray_cast_from_qarray) < 0) {
+    return -1;
+  }
+  if (PyArray_RegisterCanCast(quad_descr, QuadArrayTypeNum, NPY_NOSCALAR) < 0) {
+    return -1;
+  }
+
+  // Text casts are unsafe both ways, as they are for int64
+  if (QuadIArray_register_cast_pair(quad_descr, quad_type_num, NPY_UNICODE, QuadIArray_cast_to_unicode, QuadIArray_cast_from_unicode) < 0) {
+    return -1;
+  }
+  if (QuadIArray_register_cast_pair(quad_descr, quad_type_num, NPY_STRING, QuadIArray_cast_to_string, QuadIArray_cast_from_string) < 0) {
+    return -1;
+  }
+
   return 0;
 }
 
@@ -1488,6 +1797,153 @@ qiarray_ones_like(PyObject *NPY_UNUSED(self), PyObject *args)
   return ret;
 }
 
+static int
+qiarray_table_format(const void *item, const qformat_spec *NPY_UNUSED(spec), char *buf, size_t size)
+{
+  char text[QFORMAT_INT128_SIZE];
+  __int128 v;
+  int len;
+
+  memcpy(&v, item, sizeof(v));
+  len = qformat_int128(v, text);
+  if ((size_t)len < size) {
+    memcpy(buf, text, (size_t)len + 1);
+  }
+  return len;
+}
+
+static PyObject *
+qiarray_table_new(int nd, const Py_ssize_t *dims, char **data)
+{
+  npy_intp shape[2];
+  PyArrayObject *arr;
+  int i;
+
+  for (i = 0; i < nd; i++) {
+    shape[i] = (npy_intp)dims[i];
+  }
+  arr = QuadIArray_new_empty(nd, shape);
+  if (arr != NULL) {
+    *data = PyArray_DATA(arr);
+  }
+  return (PyObject *)arr;
+}
+
+static PyObject *
+qiarray_table_as_array(PyObject *obj, int *nd, Py_ssize_t *dims, const char **data)
+{
+  PyArrayObject *arr;
+  int i;
+
+  Py_INCREF(QuadIArrayDescr);
+  arr = (PyArrayObject *)PyArray_FromAny(obj, QuadIArrayDescr, 0, 0, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST, NULL);
+  if (arr == NULL) {
+    return NULL;
+  }
+  *nd = PyArray_NDIM(arr);
+  for (i = 0; i < *nd && i < 2; i++) {
+    dims[i] = (Py_ssize_t)PyArray_DIM(arr, i);
+  }
+  *data = PyArray_DATA(arr);
+  return (PyObject *)arr;
+}
+
+static const qtable_kind qiarray_table = {
+  .name = "qint",
+  .itemsize = sizeof(__int128),
+  .parse = qiarray_parse_int,
+  .format = qiarray_table_format,
+  .format_spec = false,
+  .new_array = qiarray_table_new,
+  .as_array = qiarray_table_as_array,
+};
+
+static PyObject *
+qiarray_loadtxt(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qtable_loadtxt(&qiarray_table, args, kwargs);
+}
+
+static PyObject *
+qiarray_savetxt(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qtable_savetxt(&qiarray_table, args, kwargs);
+}
+
+static PyObject *
+qiarray_dlpack_as_array(PyObject *obj, bool copy, qdlpack_view *view)
+{
+  PyArrayObject *arr;
+  int flags = copy ? NPY_ARRAY_CARRAY | NPY_ARRAY_ENSURECOPY : NPY_ARRAY_ALIGNED;
+
+  Py_INCREF(QuadIArrayDescr);
+  arr = (PyArrayObject *)PyArray_FromAny(obj, QuadIArrayDescr, 0, 0, flags | NPY_ARRAY_FORCECAST, NULL);
+  if (arr == NULL) {
+    return NULL;
+  }
+  view->data = PyArray_DATA(arr);
+  view->ndim = PyArray_NDIM(arr);
+  view->shape = (const Py_ssize_t *)PyArray_DIMS(arr);
+  view->strides = (const Py_ssize_t *)PyArray_STRIDES(arr);
+  view->readonly = !PyArray_ISWRITEABLE(arr);
+  view->copied = (PyObject *)arr != obj;
+  return (PyObject *)arr;
+}
+
+static PyObject *
+qiarray_dlpack_from_view(const qdlpack_view *view, PyObject *base)
+{
+  PyObject *arr;
+
+  Py_INCREF(QuadIArrayDescr);
+  arr = PyArray_NewFromDescr(&PyArray_Type, QuadIArrayDescr, view->ndim, (const npy_intp *)view->shape,
+                             (const npy_intp *)view->strides, view->data, view->readonly ? 0 : NPY_ARRAY_WRITEABLE,
+                             NULL);
+  if (arr == NULL) {
+    Py_DECREF(base);
+    return NULL;
+  }
+  if (PyArray_SetBaseObject((PyArrayObject *)arr, base) < 0) {
+    Py_DECREF(arr);
+    return NULL;
+  }
+  return arr;
+}
+
+static const qdlpack_kind qiarray_dlpack = {
+  .name = "qint",
+  .code = QDLPACK_INT,
+  .bits = 128,
+  .parts = 1,
+  .itemsize = sizeof(__int128),
+  .as_array = qiarray_dlpack_as_array,
+  .from_view = qiarray_dlpack_from_view,
+};
+
+static PyObject *
+qiarray_to_dlpack(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qdlpack_to(&qiarray_dlpack, args, kwargs);
+}
+
+static PyObject *
+qiarray_from_dlpack(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qdlpack_from(&qiarray_dlpack, args, kwargs);
+}
+
+static PyObject *
+qiarray_to_arrow(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qarrow_to(&qiarray_dlpack, args, kwargs);
+}
+
+static PyObject *
+qiarray_from_arrow(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  return qarrow_from(&qiarray_dlpack, args, kwargs);
+}
+
 static PyMethodDef QuadIArrayMethods[] = {
   {"arange", qiarray_arange, METH_VARARGS, "Create a 1-D qiarray with evenly spaced integer values in an interval."},
   {"empty", qiarray_empty, METH_VARARGS, "Create a 1-D uninitialized qiarray."},
@@ -1504,6 +1960,12 @@ static PyMethodDef QuadIArrayMethods[] = {
   {"zeros_like", qiarray_zeros_like, METH_VARARGS, "Create a zero-filled qiarray with the same shape as input."},
   {"ones_like", qiarray_ones_like, METH_VARARGS, "Create a one-filled qiarray with the same shape as input."},
   {"full_like", qiarray_full_like, METH_VARARGS, "Create a qiarray filled with a value and the same shape as input."},
+  {"loadtxt", (PyCFunction)qiarray_loadtxt, METH_VARARGS | METH_KEYWORDS, "Load a text table into a qiarray, parsing line aligned chunks of the file in parallel."},
+  {"savetxt", (PyCFunction)qiarray_savetxt, METH_VARARGS | METH_KEYWORDS, "Save a 1-D or 2-D array to a text file, formatting blocks of rows in parallel."},
+  {"to_dlpack", (PyCFunction)qiarray_to_dlpack, METH_VARARGS | METH_KEYWORDS, "Export an array as a DLPack capsule that shares its memory, versioned when max_version is given."},
+  {"from_dlpack", (PyCFunction)qiarray_from_dlpack, METH_VARARGS | METH_KEYWORDS, "Wrap a DLPack capsule or producer of 128 bit integers as a qiarray without copying."},
+  {"to_arrow", (PyCFunction)qiarray_to_arrow, METH_VARARGS | METH_KEYWORDS, "Export a 1-D array as Arrow C Data Interface capsules of 16 byte fixed_size_binary that share its memory."},
+  {"from_arrow", (PyCFunction)qiarray_from_arrow, METH_VARARGS | METH_KEYWORDS, "Wrap Arrow capsules or an object with __arrow_c_array__ of 16 byte fixed_size_binary as a read-only qiarray without copying."},
   {NULL, NULL, 0, NULL},
 };
 
@@ -1521,6 +1983,7 @@ QuadIArray_nonzero(void *ip, void *arr)
   int elsize = PyArray_ITEMSIZE(arr);
   char *ptr = ip;
 
+  // Zero whatever the byte order
   while (elsize--) {
     if (*ptr++ != 0) {
       return NPY_TRUE;
@@ -1532,41 +1995,23 @@ QuadIArray_nonzero(void *ip, void *arr)
 static void
 QuadIArray_copyswap(__int128 *dst, __int128 *src, int swap, void *NPY_UNUSED(arr))
 {
-  size_t i;
-  char *bytes;
-
-  if (src == NULL) {
-    src = dst;
-  }
-  if (src != dst) {
-    memcpy(dst, src, sizeof(__int128));
-  }
-
-  if (swap != 0) {
-    char tmp;
-    bytes = (char *)dst;
-    for (i = 0; i < (sizeof(__int128) / 2); ++i) {
-      tmp = bytes[i];
-      bytes[i] = bytes[sizeof(__int128) - 1 - i];
-      bytes[sizeof(__int128) - 1 - i] = tmp;
-    }
-  }
+  qdd_copyswapn((char *)dst, sizeof(__int128), (const char *)src, sizeof(__int128), 1, sizeof(__int128), swap != 0);
 }
 
 static void
-QuadIArray_copyswapn(void *dst, npy_intp dstride, void *src, npy_intp sstride, npy_intp n, int swap, void *arr)
+QuadIArray_copyswapn(void *dst, npy_intp dstride, void *src, npy_intp sstride, npy_intp n, int swap, void *NPY_UNUSED(arr))
 {
-  npy_intp i;
-  PyArray_CopySwapFunc *copyswap;
-  char *dstptr = dst;
-  char *srcptr = src;
+  qdd_copyswapn(dst, dstride, src, sstride, n, sizeof(__int128), swap != 0);
+}
 
-  copyswap = PyDataType_GetArrFuncs(PyArray_DESCR(arr))->copyswap;
-  for (i = 0; i < n; ++i) {
-    copyswap(dstptr, srcptr, swap, arr);
-    dstptr += dstride;
-    srcptr += sstride;
+static void
+QuadIArray_store(__int128 *data, __int128 value, void *array)
+{
+  // data may be unaligned, or in a non-native byte order array
+  if (array != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)array)) {
+    qdd_bswap128(&value);
   }
+  memcpy(data, &value, sizeof(value));
 }
 
 static int
@@ -1575,10 +2020,8 @@ QuadIArray_setitem(PyObject *item, __int128 *data, void *array)
   QuadIObject tmp;
   PyObject *index_obj = NULL;
 
-  (void)array;
-
   if (PyObject_to_QuadIObject(item, &tmp, false)) {
-    *data = tmp.value;
+    QuadIArray_store(data, tmp.value, array);
     return 0;
   }
 
@@ -1591,7 +2034,7 @@ QuadIArray_setitem(PyObject *item, __int128 *data, void *array)
   index_obj = PyNumber_Index(item);
   if (index_obj != NULL) {
     if (PyObject_to_QuadIObject(index_obj, &tmp, false)) {
-      *data = tmp.value;
+      QuadIArray_store(data, tmp.value, array);
       Py_DECREF(index_obj);
       return 0;
     }
@@ -1611,11 +2054,14 @@ QuadIArray_setitem(PyObject *item, __int128 *data, void *array)
 }
 
 static PyObject *
-QuadIArray_getitem(__int128 *data, void *NPY_UNUSED(arr))
+QuadIArray_getitem(__int128 *data, void *arr)
 {
   QuadIObject tmp;
 
-  tmp.value = *data;
+  memcpy(&tmp.value, data, sizeof(tmp.value));
+  if (arr != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)arr)) {
+    qdd_bswap128(&tmp.value);
+  }
   return QuadIObject_to_PyObject(tmp);
 }
 
@@ -1676,10 +2122,75 @@ QuadIArray_fillwithscalar(__int128 *buffer, npy_intp length, __int128 *value, vo
   }
 }
 
+static int
+QuadIArray_add_ufunc(PyObject *m, const char *name, const char *doc, int nin, int nout, PyUFuncGenericFunction loop,
+                     const int *types)
+{
+  PyObject *ufunc;
+
+  ufunc = PyUFunc_FromFuncAndData(NULL, NULL, NULL, 0, nin, nout, PyUFunc_None, name, doc, 0);
+  if (ufunc == NULL) {
+    return -1;
+  }
+
+  if (PyUFunc_RegisterLoopForType((PyUFuncObject *)ufunc, QuadIArrayTypeNum, loop, types, NULL) < 0) {
+    Py_DECREF(ufunc);
+    return -1;
+  }
+
+  if (PyModule_AddObjectRef(m, name, ufunc) < 0) {
+    Py_DECREF(ufunc);
+    return -1;
+  }
+
+  Py_DECREF(ufunc);
+  return 0;
+}
+
+static int
+QuadIArray_add_loop(PyObject *m, const char *name, PyUFuncGenericFunction loop, const int *types)
+{
+  PyObject *ufunc;
+  int ret;
+
+  ufunc = PyObject_GetAttrString(m, name);
+  if (ufunc == NULL) {
+    return -1;
+  }
+  ret = PyUFunc_RegisterLoopForType((PyUFuncObject *)ufunc, QuadIArrayTypeNum, loop, types, NULL);
+  Py_DECREF(ufunc);
+  return ret;
+}
+
+static int
+QuadIArray_add_ufuncs(PyObject *m)
+{
+  // Exact interchange between qarray values and integer (mantissa, exponent)
+  // pairs, which live here as qarray cannot depend on qiarray
+  int decompose_types[] = {QuadArrayTypeNum, QuadIArrayTypeNum, NPY_INT32};
+  int compose_types[] = {QuadIArrayTypeNum, NPY_INT32, QuadArrayTypeNum};
+  int compose_int64_types[] = {QuadIArrayTypeNum, NPY_INT64, QuadArrayTypeNum};
+
+  if (QuadIArray_add_ufunc(m, "decompose",
+                           "decompose(x) returns (m, e), a qiarray and an int32 array with x == m * 2**e and m odd",
+                           1, 2, QuadIArray_ufunc_decompose, decompose_types) < 0) {
+    return -1;
+  }
+  if (QuadIArray_add_ufunc(m, "compose", "compose(m, e) returns the qarray m * 2**e rounded once to nearest", 2, 1,
+                           QuadIArray_ufunc_compose_i, compose_types) < 0) {
+    return -1;
+  }
+  // int64 exponents, such as a list of Python ints, cannot be cast to int32
+  // safely so get their own loop
+  return QuadIArray_add_loop(m, "compose", QuadIArray_ufunc_compose_l, compose_int64_types);
+}
+
 PyMODINIT_FUNC
 PyInit_qiarray(void)
 {
   PyObject *m;
+  PyObject *qarray_mod;
+  PyObject *qarray_type_num_obj;
   int qiarrayNum;
 
   m = PyModule_Create(&QuadIArrayModule);
@@ -1692,6 +2203,24 @@ PyInit_qiarray(void)
     return NULL;
   }
 
+  qarray_mod = PyImport_ImportModule("pyquadp.qarray");
+  if (qarray_mod == NULL) {
+    Py_DECREF(m);
+    return NULL;
+  }
+  qarray_type_num_obj = PyObject_GetAttrString(qarray_mod, "dtype_num");
+  Py_DECREF(qarray_mod);
+  if (qarray_type_num_obj == NULL) {
+    Py_DECREF(m);
+    return NULL;
+  }
+  QuadArrayTypeNum = (int)PyLong_AsLong(qarray_type_num_obj);
+  Py_DECREF(qarray_type_num_obj);
+  if (QuadArrayTypeNum < 0 && PyErr_Occurred()) {
+    Py_DECREF(m);
+    return NULL;
+  }
+
   import_array();
   if (PyErr_Occurred()) {
     Py_DECREF(m);
@@ -1703,6 +2232,13 @@ PyInit_qiarray(void)
     return NULL;
   }
 
+  // Shared helpers linked into this module pick their kernels here too
+  if (qsoft_init() < 0) {
+    PyErr_Format(PyExc_ValueError, "unknown %s value '%s'", QSOFT_LEVEL_ENV, getenv(QSOFT_LEVEL_ENV));
+    Py_DECREF(m);
+    return NULL;
+  }
+
   PyArray_InitArrFuncs(&QuadIArrayFuncs);
   QuadIArrayFuncs.nonzero = (PyArray_NonzeroFunc *)QuadIArray_nonzero;
   QuadIArrayFuncs.copyswap = (PyArray_CopySwapFunc *)QuadIArray_copyswap;
@@ -1757,6 +2293,10 @@ PyInit_qiarray(void)
     Py_DECREF(m);
     return NULL;
   }
+  if (QuadIArray_add_ufuncs(m) < 0) {
+    Py_DECREF(m);
+    return NULL;
+  }
 
   if (PyModule_AddObjectRef(m, "qiarray", (PyObject *)&QuadIType) < 0) {
     Py_DECREF(m);
@@ -1,3 +1,4 @@
+import os
 from collections.abc import Sequence
 from typing import Any, TypeAlias, overload
 
@@ -12,6 +13,8 @@ ShapeLike: TypeAlias = int | tuple[int, ...]
 qiarray: Any
 dtype: np.dtype[Any]
 dtype_num: int
+decompose: np.ufunc
+compose: np.ufunc
 
 @overload
 def arange(stop: QIntLike) -> NDArray[Any]: ...
@@ -43,3 +46,30 @@ def empty_like(_values: ArrayLike) -> NDArray[Any]: ...
 def zeros_like(_values: ArrayLike) -> NDArray[Any]: ...
 def ones_like(_values: ArrayLike) -> NDArray[Any]: ...
 def full_like(_values: ArrayLike, _value: QIntLike) -> NDArray[Any]: ...
+def loadtxt(
+    fname: str | bytes | os.PathLike[str] | os.PathLike[bytes],
+    *,
+    delimiter: str | None = ...,
+    comments: str | None = ...,
+    skiprows: int = ...,
+    usecols: int | Sequence[int] | None = ...,
+    max_rows: int | None = ...,
+    ndmin: int = ...,
+    threads: int = ...,
+) -> NDArray[Any]: ...
+def savetxt(
+    fname: str | bytes | os.PathLike[str] | os.PathLike[bytes],
+    X: ArrayLike,
+    fmt: str = ...,
+    delimiter: str = ...,
+    newline: str = ...,
+    header: str = ...,
+    footer: str = ...,
+    comments: str = ...,
+    *,
+    threads: int = ...,
+) -> None: ...
+def to_dlpack(x: ArrayLike, *, max_version: tuple[int, int] | None = ..., copy: bool | None = ...) -> Any: ...
+def from_dlpack(x: Any, *, copy: bool | None = ...) -> NDArray[Any]: ...
+def to_arrow(x: ArrayLike, requested_schema: Any = ...) -> tuple[Any, Any]: ...
+def from_arrow(x: Any, *, copy: bool | None = ...) -> NDArray[Any]: ...
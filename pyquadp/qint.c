@@ -728,24 +728,28 @@ static PyObject* _as_parameter_(PyObject * self, void * y){
 }
 
 //Pickling
+static PyObject *QuadIObject_unpickle = NULL;
+
+// Module level _from_bytes, so a pickle names it once and then holds only the
+// raw bytes of each qint
+static PyObject *
+QuadIObject__from_bytes(PyObject *module, PyObject *arg) {
+    (void)module;
+    return QuadIObject_from_bytes(QuadIType, arg);
+}
+
 static PyObject *
-QuadIObject___getstate__(QuadIObject *self, PyObject *Py_UNUSED(ignored)) {
+QuadIObject___reduce__(QuadIObject *self, PyObject *Py_UNUSED(ignored)) {
     PyObject *bytes_obj = QuadIObject_to_bytes(self, NULL);
-    PyObject *ret;
 
     if (bytes_obj == NULL) {
         return NULL;
     }
-
-    ret = Py_BuildValue("{sisN}",
-                        PICKLE_VERSION_KEY, PICKLE_VERSION,
-                        "bytes", bytes_obj);
-    return ret;
+    return Py_BuildValue("O(N)", QuadIObject_unpickle, bytes_obj);
 }
 
-	
 
-/* Un-pickle the object */
+/* Un-pickle the dict state written by older versions */
 static PyObject *
 QuadIObject___setstate__(QuadIObject *self, PyObject *state) {
 
@@ -923,8 +927,8 @@ static PyMethodDef QuadI_methods[] = {
     {"to_bytes", (PyCFunction) QuadIObject_to_bytes, METH_NOARGS, "to_bytes"},
     {"from_bytes", (PyCFunction) QuadIObject_from_bytes, METH_CLASS|METH_O, "from_bytes"},
     {"from_param", (PyCFunction) QuadIObject_from_param, METH_CLASS|METH_O, "from_param"},
-    {"__getstate__", (PyCFunction) QuadIObject___getstate__, METH_NOARGS, "Pickle a quad object object" },
-    {"__setstate__", (PyCFunction) QuadIObject___setstate__, METH_O,"Un-pickle a quad object object"},
+    {"__reduce__", (PyCFunction) QuadIObject___reduce__, METH_NOARGS, "Pickle a qint as its raw bytes" },
+    {"__setstate__", (PyCFunction) QuadIObject___setstate__, METH_O,"Un-pickle a qint from an older pickle"},
     {"hex", (PyCFunction) QuadIObject_to_hex, METH_NOARGS, "to_hex"},
     {"fromhex", (PyCFunction) QuadIObject_from_hex, METH_CLASS|METH_O, "from_hex"},
     {"bit_length", (PyCFunction) QuadIObject_bit_length, METH_NOARGS, "Return number of bits needed to represent absolute value."},
@@ -1015,11 +1019,17 @@ static PyType_Spec QuadIType_spec = {
     .slots = QuadIType_slots,
 };
 
+static PyMethodDef QuadIModule_methods[] = {
+    {"_from_bytes", (PyCFunction) QuadIObject__from_bytes, METH_O, "Un-pickle a qint from its raw bytes"},
+    {NULL}  /* Sentinel */
+};
+
 static PyModuleDef QuadIModule = {
     PyModuleDef_HEAD_INIT,
     .m_name = "qmint",
     .m_doc = "Quad precision module for scalar integer quad's.",
     .m_size = -1,
+    .m_methods = QuadIModule_methods,
 };
 
 PyObject* 
@@ -1139,6 +1149,12 @@ PyInit_qmint(void)
     if (m == NULL)
         return NULL;
 
+    QuadIObject_unpickle = PyObject_GetAttrString(m, "_from_bytes");
+    if (QuadIObject_unpickle == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
     quadi_type_obj = PyType_FromSpec(&QuadIType_spec);
     if (quadi_type_obj == NULL) {
         Py_DECREF(m);
@@ -0,0 +1,51 @@
+from typing import TypeAlias, overload
+
+from .qmfloat import qfloat
+
+DDFloatLike: TypeAlias = "ddfloat | float | int | str | qfloat"
+
+class ddfloat:
+    hi: float
+    lo: float
+
+    @overload
+    def __new__(cls, _value: DDFloatLike = ...) -> "ddfloat": ...
+    @overload
+    def __new__(cls, _hi: DDFloatLike, _lo: DDFloatLike) -> "ddfloat": ...
+    @classmethod
+    def from_bytes(cls, _value: bytes) -> "ddfloat": ...
+    def to_bytes(self) -> bytes: ...
+    def to_qfloat(self) -> qfloat: ...
+    def __getstate__(self) -> dict[str, object]: ...
+    def __setstate__(self, _state: dict[str, object]) -> None: ...
+    def __bool__(self) -> bool: ...
+    def __float__(self) -> float: ...
+    def __int__(self) -> int: ...
+    def __abs__(self) -> "ddfloat": ...
+    def __neg__(self) -> "ddfloat": ...
+    def __pos__(self) -> "ddfloat": ...
+    @overload
+    def __add__(self, other: qfloat) -> qfloat: ...
+    @overload
+    def __add__(self, other: "ddfloat | float | int | str") -> "ddfloat": ...
+    def __radd__(self, other: "ddfloat | float | int | str") -> "ddfloat": ...
+    @overload
+    def __sub__(self, other: qfloat) -> qfloat: ...
+    @overload
+    def __sub__(self, other: "ddfloat | float | int | str") -> "ddfloat": ...
+    def __rsub__(self, other: "ddfloat | float | int | str") -> "ddfloat": ...
+    @overload
+    def __mul__(self, other: qfloat) -> qfloat: ...
+    @overload
+    def __mul__(self, other: "ddfloat | float | int | str") -> "ddfloat": ...
+    def __rmul__(self, other: "ddfloat | float | int | str") -> "ddfloat": ...
+    @overload
+    def __truediv__(self, other: qfloat) -> qfloat: ...
+    @overload
+    def __truediv__(self, other: "ddfloat | float | int | str") -> "ddfloat": ...
+    def __rtruediv__(self, other: "ddfloat | float | int | str") -> "ddfloat": ...
+    def __lt__(self, other: DDFloatLike) -> bool: ...
+    def __le__(self, other: DDFloatLike) -> bool: ...
+    def __gt__(self, other: DDFloatLike) -> bool: ...
+    def __ge__(self, other: DDFloatLike) -> bool: ...
+    def __hash__(self) -> int: ...
@@ -16,6 +16,7 @@ class qfloat:
     def __getstate__(self) -> dict[str, object]: ...
     def __setstate__(self, _state: dict[str, object]) -> None: ...
     def hex(self) -> str: ...
+    def __format__(self, format_spec: str) -> str: ...
     def as_integer_ratio(self) -> tuple[int, int]: ...
     def __round__(self, ndigits: int | None = ...) -> "qfloat": ...
     def __trunc__(self) -> "qfloat": ...
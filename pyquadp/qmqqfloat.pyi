@@ -0,0 +1,39 @@
+from typing import TypeAlias, overload
+
+from .qmfloat import qfloat
+
+QQFloatLike: TypeAlias = "qqfloat | qfloat | float | int | str"
+
+class qqfloat:
+    hi: qfloat
+    lo: qfloat
+
+    @overload
+    def __new__(cls, _value: QQFloatLike = ...) -> "qqfloat": ...
+    @overload
+    def __new__(cls, _hi: QQFloatLike, _lo: QQFloatLike) -> "qqfloat": ...
+    @classmethod
+    def from_bytes(cls, _value: bytes) -> "qqfloat": ...
+    def to_bytes(self) -> bytes: ...
+    def to_qfloat(self) -> qfloat: ...
+    def __getstate__(self) -> dict[str, object]: ...
+    def __setstate__(self, _state: dict[str, object]) -> None: ...
+    def __bool__(self) -> bool: ...
+    def __float__(self) -> float: ...
+    def __int__(self) -> int: ...
+    def __abs__(self) -> "qqfloat": ...
+    def __neg__(self) -> "qqfloat": ...
+    def __pos__(self) -> "qqfloat": ...
+    def __add__(self, other: QQFloatLike) -> "qqfloat": ...
+    def __radd__(self, other: QQFloatLike) -> "qqfloat": ...
+    def __sub__(self, other: QQFloatLike) -> "qqfloat": ...
+    def __rsub__(self, other: QQFloatLike) -> "qqfloat": ...
+    def __mul__(self, other: QQFloatLike) -> "qqfloat": ...
+    def __rmul__(self, other: QQFloatLike) -> "qqfloat": ...
+    def __truediv__(self, other: QQFloatLike) -> "qqfloat": ...
+    def __rtruediv__(self, other: QQFloatLike) -> "qqfloat": ...
+    def __lt__(self, other: QQFloatLike) -> bool: ...
+    def __le__(self, other: QQFloatLike) -> bool: ...
+    def __gt__(self, other: QQFloatLike) -> bool: ...
+    def __ge__(self, other: QQFloatLike) -> bool: ...
+    def __hash__(self) -> int: ...
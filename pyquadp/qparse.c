@@ -0,0 +1,826 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <string.h>
+
+#include "qdd.h"
+#include "qparse.h"
+
+// Significant digits kept in the 128-bit accumulator, 10^38 < 2^127
+#define QPARSE_MAX_DIGITS 38
+// 10^q = 10^(QPARSE_STEP * j) * 5^r * 2^r with 5^r < 2^64
+#define QPARSE_STEP 28
+#define QPARSE_JMIN (-179)
+_Static_assert(QPARSE_QMIN == QPARSE_STEP * QPARSE_JMIN, "power of ten table does not match QPARSE_QMIN");
+// Bits of the 128-bit product below the 113-bit significand
+#define QPARSE_ROUND_BITS 15
+#define QPARSE_HALF (1u << (QPARSE_ROUND_BITS - 1))
+#define QPARSE_ROUND_MASK ((1u << QPARSE_ROUND_BITS) - 1)
+// Stack buffer for the strtoflt128 fallback, longer strings are copied to the heap
+#define QPARSE_BUFFER 128
+
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+    int32_t e;
+} qparse_pow10_entry;
+
+// 10^(28 j) = (hi:lo) * 2^e for j in [-179, 178], with the 128-bit mantissa
+// normalised to [2^127, 2^128) and truncated. Generated with
+//
+//   v = Fraction(10) ** (28 * j)
+//   e = the integer with 2**127 <= v / 2**e < 2**128
+//   m = floor(v / 2**e)
+static const qparse_pow10_entry qparse_pow10_table[] = {
+    {0xb491165ac6b0ad76ULL, 0x6de87d653e43df31ULL, -16777}, // 1e-5012
+    {0xb6536903bf8f2bdaULL, 0x2b55c9e70e00c557ULL, -16684}, // 1e-4984
+    {0xb81a1ec0ebf12af1ULL, 0xbad933e1f4e65074ULL, -16591}, // 1e-4956
+    {0xb9e5428330737362ULL, 0xbddb2dfde3f8a6e3ULL, -16498}, // 1e-4928
+    {0xbbb4df56baf62972ULL, 0x692aa2588216d185ULL, -16405}, // 1e-4900
+    {0xbd89006346a9a34dULL, 0x88227fdfc13ab53dULL, -16312}, // 1e-4872
+    {0xbf61b0ec60c4f5dcULL, 0x8ee3a73ee750b831ULL, -16219}, // 1e-4844
+    {0xc13efc51ade7df64ULL, 0xe05fe4207ca3d508ULL, -16126}, // 1e-4816
+    {0xc320ee0f3029bb57ULL, 0xff5733244e3b6baaULL, -16033}, // 1e-4788
+    {0xc50791bd8dd72edbULL, 0x3c55f3f947fef0e9ULL, -15940}, // 1e-4760
+    {0xc6f2f31258e041c6ULL, 0xafde347f46fdb9dfULL, -15847}, // 1e-4732
+    {0xc8e31de056f89c19ULL, 0x0915564d8ab057eeULL, -15754}, // 1e-4704
+    {0xcad81e17ca6ba427ULL, 0x08b7d94af9c24e41ULL, -15661}, // 1e-4676
+    {0xccd1ffc6bba63e21ULL, 0x801e38463183fc88ULL, -15568}, // 1e-4648
+    {0xced0cf194377f1ebULL, 0x77707cab526fa3ebULL, -15475}, // 1e-4620
+    {0xd0d49859d60d40a3ULL, 0xcfadf6b2aa7c4f43ULL, -15382}, // 1e-4592
+    {0xd2dd67f18ea4f7baULL, 0x6819fcbc5dba0576ULL, -15289}, // 1e-4564
+    {0xd4eb4a687c0253e8ULL, 0x9e601e707a2c3488ULL, -15196}, // 1e-4536
+    {0xd6fe4c65ed9dcaf0ULL, 0x0910b187a046b5a4ULL, -15103}, // 1e-4508
+    {0xd9167ab0c1965798ULL, 0xa8edffdccfe4db4bULL, -15010}, // 1e-4480
+    {0xdb33e22fb3652809ULL, 0x9b246c227911db44ULL, -14917}, // 1e-4452
+    {0xdd568fe9ab559344ULL, 0xb17cd86e7fcece75ULL, -14824}, // 1e-4424
+    {0xdf7e91060ec33f46ULL, 0x5aafdc42ca320902ULL, -14731}, // 1e-4396
+    {0xe1abf2cd11206610ULL, 0x1151250681d59705ULL, -14638}, // 1e-4368
+    {0xe3dec2a805c62cb4ULL, 0x38b47f50c3e4979fULL, -14545}, // 1e-4340
+    {0xe6170e21b2910457ULL, 0x025a8e1e5dbb41d6ULL, -14452}, // 1e-4312
+    {0xe854e2e6a34b1200ULL, 0xc9d524dfdfe4e2d9ULL, -14359}, // 1e-4284
+    {0xea984ec57de69f13ULL, 0x66e849253e5da0c2ULL, -14266}, // 1e-4256
+    {0xece15faf578a9935ULL, 0x647e32d3c54df9ddULL, -14173}, // 1e-4228
+    {0xef3023b80a732d93ULL, 0xf5a7800f23ef67b8ULL, -14080}, // 1e-4200
+    {0xf184a9168ca89077ULL, 0x07776b7971f752fdULL, -13987}, // 1e-4172
+    {0xf3defe25478e074aULL, 0x0e85fc7f4edbd3caULL, -13894}, // 1e-4144
+    {0xf63f3162704b5070ULL, 0x48fe1d3430b5e548ULL, -13801}, // 1e-4116
+    {0xf8a551706112897cULL, 0x4268a54f70bd28c4ULL, -13708}, // 1e-4088
+    {0xfb116d15f344b9b0ULL, 0x953d136b9a19cdb5ULL, -13615}, // 1e-4060
+    {0xfd83933eda772c0bULL, 0x5052e9289f0f2333ULL, -13522}, // 1e-4032
+    {0xfffbd2fc005bc986ULL, 0x2c9af917ddc988c9ULL, -13429}, // 1e-4004
+    {0x813d1dc1f0c754d6ULL, 0x01b02378a405b421ULL, -13335}, // 1e-3976
+    {0x827f6e1975a58a93ULL, 0xec2caa7b143ce01aULL, -13242}, // 1e-3948
+    {0x83c4e245ed051dc1ULL, 0xb782db1fc6aba49bULL, -13149}, // 1e-3920
+    {0x850d821c0c86f175ULL, 0x753f080dab88ee0aULL, -13056}, // 1e-3892
+    {0x86595584116caf3cULL, 0x4250be2eeba87d15ULL, -12963}, // 1e-3864
+    {0x87a86479f14d8ea3ULL, 0x9031fecc0841642dULL, -12870}, // 1e-3836
+    {0x88fab70d8b44952aULL, 0x3f1f93f1943ca9b6ULL, -12777}, // 1e-3808
+    {0x8a505562d9997d8aULL, 0x268889f30fc7a120ULL, -12684}, // 1e-3780
+    {0x8ba947b223e5783eULL, 0x2c87f18b39478aa2ULL, -12591}, // 1e-3752
+    {0x8d05964831b4fa23ULL, 0xed1e8ad53278b981ULL, -12498}, // 1e-3724
+    {0x8e6549867da7d11aULL, 0x4054f5360249ebd1ULL, -12405}, // 1e-3696
+    {0x8fc869e36910b987ULL, 0xbdfb5daa8751f12bULL, -12312}, // 1e-3668
+    {0x912effea7015b2c5ULL, 0xc1187fa0c18adbbeULL, -12219}, // 1e-3640
+    {0x9299143c5e525385ULL, 0x772ced20f3be4933ULL, -12126}, // 1e-3612
+    {0x9406af8f83fd6265ULL, 0x4b4de34e0ebc3e06ULL, -12033}, // 1e-3584
+    {0x9577daafeb92fa15ULL, 0x8e08f0978ac01650ULL, -11940}, // 1e-3556
+    {0x96ec9e7f9004839bULL, 0xac73f0226eff5ea1ULL, -11847}, // 1e-3528
+    {0x986503f6936fd47bULL, 0xae686cf29a7b688dULL, -11754}, // 1e-3500
+    {0x99e11423765ec1d0ULL, 0x2184706ea46a4c38ULL, -11661}, // 1e-3472
+    {0x9b60d82b4f907ca1ULL, 0x202c9c950e81f6f2ULL, -11568}, // 1e-3444
+    {0x9ce4594a044e0f1bULL, 0xddadb80577b906bdULL, -11475}, // 1e-3416
+    {0x9e6ba0d2814b55a5ULL, 0x1f2a6e9ba997d195ULL, -11382}, // 1e-3388
+    {0x9ff6b82ef415d222ULL, 0x60dbd8aa443b560fULL, -11289}, // 1e-3360
+    {0xa185a8e10512bb3fULL, 0x2d22a5f73de44d43ULL, -11196}, // 1e-3332
+    {0xa3187c82120dace6ULL, 0x7401c6f091f87727ULL, -11103}, // 1e-3304
+    {0xa4af3cc3695962a2ULL, 0x9314c38af248ceacULL, -11010}, // 1e-3276
+    {0xa649f36e8583e81aULL, 0x4d5b32f713d7f476ULL, -10917}, // 1e-3248
+    {0xa7e8aa65499faf6dULL, 0x44ed06a6c73283f1ULL, -10824}, // 1e-3220
+    {0xa98b6ba23e2300c7ULL, 0xb4b39dd9ddb8d317ULL, -10731}, // 1e-3192
+    {0xab324138ce5f3a23ULL, 0x43ab66aa259bb140ULL, -10638}, // 1e-3164
+    {0xacdd3555869159d1ULL, 0xec41c1793d69d0d1ULL, -10545}, // 1e-3136
+    {0xae8c523e528d5220ULL, 0x2f9b11c68554e06eULL, -10452}, // 1e-3108
+    {0xb03fa252bd05a815ULL, 0x3ca5a7540d9d56c9ULL, -10359}, // 1e-3080
+    {0xb1f7300c2f70e31aULL, 0x6cc8610fe1204db5ULL, -10266}, // 1e-3052
+    {0xb3b305fe328e571fULL, 0x92e1bc1fbb33f18dULL, -10173}, // 1e-3024
+    {0xb5732ed6af8bd6a7ULL, 0x2c9155c7f2f76a10ULL, -10080}, // 1e-2996
+    {0xb737b55e31cdde04ULL, 0xa908fd4a88728b6aULL, -9987}, // 1e-2968
+    {0xb900a478295bccffULL, 0xc3bc70daed20545dULL, -9894}, // 1e-2940
+    {0xbace07232df1c802ULL, 0x7c4c65d15c614c56ULL, -9801}, // 1e-2912
+    {0xbc9fe87942b9ddf3ULL, 0x984b360db52f4726ULL, -9708}, // 1e-2884
+    {0xbe7653b01aae13e5ULL, 0xef84cc99cb4c5d17ULL, -9615}, // 1e-2856
+    {0xc05154195da4fbd5ULL, 0x2112bef1b26149feULL, -9522}, // 1e-2828
+    {0xc230f522ee0a7fc2ULL, 0xcfc147ade4843a24ULL, -9429}, // 1e-2800
+    {0xc41542572f468eacULL, 0x4068e186399dc435ULL, -9336}, // 1e-2772
+    {0xc5fe475d4cd35cffULL, 0x4668677d5f46c29bULL, -9243}, // 1e-2744
+    {0xc7ec0ff98204ee6eULL, 0xeb22603aa63048d9ULL, -9150}, // 1e-2716
+    {0xc9dea80d6283a34cULL, 0x474b3cb1fe1d6a7fULL, -9057}, // 1e-2688
+    {0xcbd61b98237b87d6ULL, 0xb23c80cfbe16abc0ULL, -8964}, // 1e-2660
+    {0xcdd276b6e582284fULL, 0xd6ea3b733029ef0bULL, -8871}, // 1e-2632
+    {0xcfd3c5a4ff34b104ULL, 0x824f4075b7d3949bULL, -8778}, // 1e-2604
+    {0xd1da14bc489025eaULL, 0x3736730a9e47fef8ULL, -8685}, // 1e-2576
+    {0xd3e57075670581ebULL, 0xda84beac12680510ULL, -8592}, // 1e-2548
+    {0xd5f5e5681a4b9285ULL, 0x3d24e68dc1027246ULL, -8499}, // 1e-2520
+    {0xd80b804b89f068deULL, 0x014da5d423752d8bULL, -8406}, // 1e-2492
+    {0xda264df693ac3e30ULL, 0x742ab8f3864562c8ULL, -8313}, // 1e-2464
+    {0xdc465b601a77adf0ULL, 0x8f5f77dfdc869ac6ULL, -8220}, // 1e-2436
+    {0xde6bb59f56672cdaULL, 0x8c119f3680212413ULL, -8127}, // 1e-2408
+    {0xe09669ec254da8cfULL, 0x60203bcbc6354d53ULL, -8034}, // 1e-2380
+    {0xe2c6859f5c284230ULL, 0x43190b523f872b9cULL, -7941}, // 1e-2352
+    {0xe4fc163319551441ULL, 0x10eaa1481b149e5aULL, -7848}, // 1e-2324
+    {0xe7372943179706fcULL, 0x2a0969bf88679396ULL, -7755}, // 1e-2296
+    {0xe977cc8d01e8a9b1ULL, 0x69d9c1f7d0b33e49ULL, -7662}, // 1e-2268
+    {0xebbe0df0c8201ac5ULL, 0x131565be33dda91aULL, -7569}, // 1e-2240
+    {0xee09fb70f46605ebULL, 0x453dbea8ff260ac2ULL, -7476}, // 1e-2212
+    {0xf05ba3330181c750ULL, 0xccfb1cc2ef1f44deULL, -7383}, // 1e-2184
+    {0xf2b3137fb1fcc743ULL, 0x0ad3b225cc56a181ULL, -7290}, // 1e-2156
+    {0xf5105ac3681f2716ULL, 0x5f8385b3a882ff4cULL, -7197}, // 1e-2128
+    {0xf773878e7ec7dd45ULL, 0x2b566ef4caf507b0ULL, -7104}, // 1e-2100
+    {0xf9dca895a3226409ULL, 0x166c15f456786c27ULL, -7011}, // 1e-2072
+    {0xfc4bccb22f3c2305ULL, 0x2b49c17cf287a651ULL, -6918}, // 1e-2044
+    {0xfec102e2857bc1f9ULL, 0x6c656c3b1f2c9d91ULL, -6825}, // 1e-2016
+    {0x809e2d25367e4bf4ULL, 0x0cc90239661bb26eULL, -6731}, // 1e-1988
+    {0x81def119b76837c8ULL, 0xfa70b9a2ca60b004ULL, -6638}, // 1e-1960
+    {0x8322d5069a14efdcULL, 0xd0be910fa323527cULL, -6545}, // 1e-1932
+    {0x8469e0b6f2b8bd9bULL, 0x6a22490e8e9ec98bULL, -6452}, // 1e-1904
+    {0x85b41c0945241144ULL, 0x5015e086841d2c28ULL, -6359}, // 1e-1876
+    {0x87018eefb53c6325ULL, 0x69138459b0fa72d4ULL, -6266}, // 1e-1848
+    {0x8852417037edf7daULL, 0x9a8a962eda71e86dULL, -6173}, // 1e-1820
+    {0x89a63ba4c497b50eULL, 0x6c83ad1260ff20f4ULL, -6080}, // 1e-1792
+    {0x8afd85bb86f23727ULL, 0x9f2bbad927b779d1ULL, -5987}, // 1e-1764
+    {0x8c5827f711735b46ULL, 0xd82ef2860273de8dULL, -5894}, // 1e-1736
+    {0x8db62aae902f73f6ULL, 0x28e92e707150bc1eULL, -5801}, // 1e-1708
+    {0x8f17964dfc3961f2ULL, 0x416d7f9ab1e67580ULL, -5708}, // 1e-1680
+    {0x907c73564f82cd82ULL, 0xc1e15a2c8ff4df56ULL, -5615}, // 1e-1652
+    {0x91e4ca5db93dbfecULL, 0x56700866b85d57feULL, -5522}, // 1e-1624
+    {0x9350a40fd2c0dfa4ULL, 0x352e1fc6a1aada9aULL, -5429}, // 1e-1596
+    {0x94c0092dd4ef9511ULL, 0x43cf71d5c4fd7868ULL, -5336}, // 1e-1568
+    {0x9633028ece2760d3ULL, 0xb070fbde944761c0ULL, -5243}, // 1e-1540
+    {0x97a9991fd8b3afc0ULL, 0x387898a6e22f821bULL, -5150}, // 1e-1512
+    {0x9923d5e451c97bf8ULL, 0xc66b5979a2ce2ef5ULL, -5057}, // 1e-1484
+    {0x9aa1c1f6110c0dd0ULL, 0x8f8857e875e7774eULL, -4964}, // 1e-1456
+    {0x9c236685a09c3276ULL, 0x801125c857604ca5ULL, -4871}, // 1e-1428
+    {0x9da8ccda75b341b5ULL, 0xa5c58d5f91a476d7ULL, -4778}, // 1e-1400
+    {0x9f31fe5329cb4f78ULL, 0x77bb986469851f56ULL, -4685}, // 1e-1372
+    {0xa0bf0465b455e921ULL, 0x6e1f7f1642ebaac8ULL, -4592}, // 1e-1344
+    {0xa24fe89fa502c239ULL, 0x68758cbf71b19436ULL, -4499}, // 1e-1316
+    {0xa3e4b4a65e97b76aULL, 0xfad2be1679765f27ULL, -4406}, // 1e-1288
+    {0xa57d7237525b9240ULL, 0xf77d1a9ff40226f3ULL, -4313}, // 1e-1260
+    {0xa71a2b283c14fba6ULL, 0x800cfab80c4e2eb1ULL, -4220}, // 1e-1232
+    {0xa8bae9675e9f0eb7ULL, 0xad3cb74fd4cac6deULL, -4127}, // 1e-1204
+    {0xaa5fb6fbc115010bULL, 0x850b0c5976b21027ULL, -4034}, // 1e-1176
+    {0xac089e056c965942ULL, 0x99daeeede2e0eb1bULL, -3941}, // 1e-1148
+    {0xadb5a8bdaaa53051ULL, 0x61363686961a41e5ULL, -3848}, // 1e-1120
+    {0xaf66e177441ffdb2ULL, 0x2c638fcbb822f998ULL, -3755}, // 1e-1092
+    {0xb11c529ec0d87268ULL, 0xc6f075c4b81fc72dULL, -3662}, // 1e-1064
+    {0xb2d606baa7c8ea89ULL, 0x2eb30a609088263eULL, -3569}, // 1e-1036
+    {0xb494086bbfea00c3ULL, 0xb4e4be5b6455ef96ULL, -3476}, // 1e-1008
+    {0xb656626d51a9d353ULL, 0x384efd538d690c57ULL, -3383}, // 1e-980
+    {0xb81d1f9569068d8eULL, 0x24d256c540a50309ULL, -3290}, // 1e-952
+    {0xb9e84ad5184dcd48ULL, 0x94cde1ba3cfca943ULL, -3197}, // 1e-924
+    {0xbbb7ef38bb827f2dULL, 0x6d4aa5b50bb5dc0dULL, -3104}, // 1e-896
+    {0xbd8c17e83c6ad135ULL, 0xaebcc797b23b9bb6ULL, -3011}, // 1e-868
+    {0xbf64d0275747de70ULL, 0x925624c0d7d93317ULL, -2918}, // 1e-840
+    {0xc1422355e038bb64ULL, 0x8035810006a8cfb6ULL, -2825}, // 1e-812
+    {0xc3241cf0094a8e70ULL, 0x8e5a2e5116baf191ULL, -2732}, // 1e-784
+    {0xc50ac88ea93763c0ULL, 0x249494d1bf7c86ecULL, -2639}, // 1e-756
+    {0xc6f631e782d57096ULL, 0xb0560c246f90e9e8ULL, -2546}, // 1e-728
+    {0xc8e664cd8d387df8ULL, 0x1e2bd23627c69801ULL, -2453}, // 1e-700
+    {0xcadb6d313c8736fcULL, 0x2ffff1289a804c5aULL, -2360}, // 1e-672
+    {0xccd55720cb861b6eULL, 0xd95729515330f114ULL, -2267}, // 1e-644
+    {0xced42ec885d9dbbeULL, 0xa855e127113c887bULL, -2174}, // 1e-616
+    {0xd0d800731302e7a4ULL, 0x064b9e215703f17fULL, -2081}, // 1e-588
+    {0xd2e0d889c213fd60ULL, 0xe00bad8dfc0d8c8eULL, -1988}, // 1e-560
+    {0xd4eec394d6258bf8ULL, 0x28e54542d9b56dc9ULL, -1895}, // 1e-532
+    {0xd701ce3bd387bf47ULL, 0xc654d07271e6c39fULL, -1802}, // 1e-504
+    {0xd91a0545cdb51185ULL, 0xe287c2ad77ead647ULL, -1709}, // 1e-476
+    {0xdb377599b6074244ULL, 0x84c663cee6b86e7cULL, -1616}, // 1e-448
+    {0xdd5a2c3eab3097cbULL, 0xbd54467eec6dd2bbULL, -1523}, // 1e-420
+    {0xdf82365c497b5453ULL, 0xcb285ceb2fed040dULL, -1430}, // 1e-392
+    {0xe1afa13afbd14d6dULL, 0x82189c09a3a1ec21ULL, -1337}, // 1e-364
+    {0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL, -1244}, // 1e-336
+    {0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL, -1151}, // 1e-308
+    {0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL, -1058}, // 1e-280
+    {0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL, -965}, // 1e-252
+    {0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL, -872}, // 1e-224
+    {0xef340a98172aace4ULL, 0x86fb897116c87c34ULL, -779}, // 1e-196
+    {0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL, -686}, // 1e-168
+    {0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL, -593}, // 1e-140
+    {0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL, -500}, // 1e-112
+    {0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL, -407}, // 1e-84
+    {0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL, -314}, // 1e-56
+    {0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL, -221}, // 1e-28
+    {0x8000000000000000ULL, 0x0000000000000000ULL, -127}, // 1e0
+    {0x813f3978f8940984ULL, 0x4000000000000000ULL, -34}, // 1e28
+    {0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL, 59}, // 1e56
+    {0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL, 152}, // 1e84
+    {0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL, 245}, // 1e112
+    {0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL, 338}, // 1e140
+    {0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL, 431}, // 1e168
+    {0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL, 524}, // 1e196
+    {0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL, 617}, // 1e224
+    {0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL, 710}, // 1e252
+    {0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL, 803}, // 1e280
+    {0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL, 896}, // 1e308
+    {0x8fcac257558ee4e6ULL, 0x213a4f0aa5e8a7b1ULL, 989}, // 1e336
+    {0x91315e37db165aa9ULL, 0x2c0de8dd3d020c0cULL, 1082}, // 1e364
+    {0x929b7871de7f22b9ULL, 0x1c306f5d1b0b5fdfULL, 1175}, // 1e392
+    {0x940919bbd4620b6dULL, 0x250535bcc387778eULL, 1268}, // 1e420
+    {0x957a4ae1ebf7f3d3ULL, 0xa7ea9c8838ce9437ULL, 1361}, // 1e448
+    {0x96ef14c6454aa840ULL, 0x4cf76e8df8d89498ULL, 1454}, // 1e476
+    {0x9867806127ece4f4ULL, 0xbf1d49cacccd5e68ULL, 1547}, // 1e504
+    {0x99e396c13a3acff1ULL, 0xb0c5560a402ac0b2ULL, 1640}, // 1e532
+    {0x9b63610bb9243e46ULL, 0x655494c5c95d77f2ULL, 1733}, // 1e560
+    {0x9ce6e87cb0821c85ULL, 0xc3bfbae0f3e130e2ULL, 1826}, // 1e588
+    {0x9e6e366733f85561ULL, 0x02e008393fd60b55ULL, 1919}, // 1e616
+    {0x9ff95435986594c9ULL, 0x6632249f8a06c2c6ULL, 2012}, // 1e644
+    {0xa1884b69ade24964ULL, 0x55e04dba4b3bd4ddULL, 2105}, // 1e672
+    {0xa31b259cfa50498fULL, 0x7478a3cbba44ec48ULL, 2198}, // 1e700
+    {0xa4b1ec80f47c84adULL, 0x44b222741eb1ebbfULL, 2291}, // 1e728
+    {0xa64ca9df3fd42cf6ULL, 0x8f96bee42fda4243ULL, 2384}, // 1e756
+    {0xa7eb6799e8aec999ULL, 0x1cf4a5c3bc09fa6fULL, 2477}, // 1e784
+    {0xa98e2faba12ea481ULL, 0x8af70b7be4ecb750ULL, 2570}, // 1e812
+    {0xab350c27feb90accULL, 0x3c4a575151b294dcULL, 2663}, // 1e840
+    {0xace0073bb807da80ULL, 0x8480950470d805edULL, 2756}, // 1e868
+    {0xae8f2b2ce3d5dbe9ULL, 0x870a8d87239d8f35ULL, 2849}, // 1e896
+    {0xb042825b38276899ULL, 0xbcc0502652e7e71dULL, 2942}, // 1e924
+    {0xb1fa17404a30e5e8ULL, 0xdd929f09c3eff5acULL, 3035}, // 1e952
+    {0xb3b5f46fcedc9c88ULL, 0x16c0208e3cc9e873ULL, 3128}, // 1e980
+    {0xb5762497dbf17a9eULL, 0x1931b583a9431d7eULL, 3221}, // 1e1008
+    {0xb73ab28129dc51bbULL, 0xbf0f83fb9a0d7ed7ULL, 3314}, // 1e1036
+    {0xb903a90f561d25e2ULL, 0xe30db03e0f8dd286ULL, 3407}, // 1e1064
+    {0xbad11341265a26cbULL, 0x9f7165ae2b921943ULL, 3500}, // 1e1092
+    {0xbca2fc30cc19f090ULL, 0x9eb5cb19647508c5ULL, 3593}, // 1e1120
+    {0xbe796f142926b4f1ULL, 0x8c9281465b0c0f44ULL, 3686}, // 1e1148
+    {0xc054773d149bf26bULL, 0x24bd4c00042ad125ULL, 3779}, // 1e1176
+    {0xc2342019a0a0627eULL, 0xee1f4ea0cec13421ULL, 3872}, // 1e1204
+    {0xc418753460cdcca9ULL, 0x7ea30dbd7ea479e3ULL, 3965}, // 1e1232
+    {0xc6018234b1486fb5ULL, 0x46c1734e983d9305ULL, 4058}, // 1e1260
+    {0xc7ef52defe87b751ULL, 0x764f4cf916b4deceULL, 4151}, // 1e1288
+    {0xc9e1f3150dd1f818ULL, 0xa7c8570e77a19e03ULL, 4244}, // 1e1316
+    {0xcbd96ed6466cf081ULL, 0xbeb7fbdc1cbe8b37ULL, 4337}, // 1e1344
+    {0xcdd5d23ffb84d18eULL, 0xe373203b69f2eb6aULL, 4430}, // 1e1372
+    {0xcfd7298db6cb9672ULL, 0xdce472c619aa3f63ULL, 4523}, // 1e1400
+    {0xd1dd811983d276d4ULL, 0x53c35ad3235d128cULL, 4616}, // 1e1428
+    {0xd3e8e55c3c1f43d0ULL, 0xe47defc14a406e4fULL, 4709}, // 1e1456
+    {0xd5f962edd3ff8467ULL, 0x69fd88c48e1ac6b1ULL, 4802}, // 1e1484
+    {0xd80f0685a81b2a81ULL, 0xb7157c60a24a0569ULL, 4895}, // 1e1512
+    {0xda29dcfacbc8be72ULL, 0x22fc05be6269f878ULL, 4988}, // 1e1540
+    {0xdc49f3445824e360ULL, 0xfb0b98f6bbc4f0cbULL, 5081}, // 1e1568
+    {0xde6f5679bbef1bd9ULL, 0x35e3a416f04ca9aaULL, 5174}, // 1e1596
+    {0xe09a13d30c2dba62ULL, 0xc6c6c1764e047e15ULL, 5267}, // 1e1624
+    {0xe2ca38a9559aeee3ULL, 0xc905de537f07ec9bULL, 5360}, // 1e1652
+    {0xe4ffd276eedce658ULL, 0x87e8dcfc09dbc33aULL, 5453}, // 1e1680
+    {0xe73aeed7cb8af755ULL, 0x45a4713b13d24707ULL, 5546}, // 1e1708
+    {0xe97b9b89d001dab3ULL, 0xb1a3642a8da3cf4fULL, 5639}, // 1e1736
+    {0xebc1e66d2608f4c9ULL, 0x5a1b25540eb6b8aaULL, 5732}, // 1e1764
+    {0xee0ddd84924ab88cULL, 0x2d4070f33b21ab7bULL, 5825}, // 1e1792
+    {0xf05f8ef5caa2331eULL, 0x727544d538f3f31eULL, 5918}, // 1e1820
+    {0xf2b70909cd3fd35cULL, 0xa2bf0c63a814e04eULL, 6011}, // 1e1848
+    {0xf5145a2d38a78635ULL, 0x51528e351ace7c2bULL, 6104}, // 1e1876
+    {0xf77790f0a48a45ceULL, 0x08f13995cf9c2747ULL, 6197}, // 1e1904
+    {0xf9e0bc08fb7d3ebfULL, 0xc167073ac21593d6ULL, 6290}, // 1e1932
+    {0xfc4fea4fd590b40aULL, 0x7a37993eb21444faULL, 6383}, // 1e1960
+    {0xfec52ac3d3c8cfc1ULL, 0xbd4c24b2c0457430ULL, 6476}, // 1e1988
+    {0x80a046447e3d49f1ULL, 0xb7b1ada9cdeba84dULL, 6570}, // 1e2016
+    {0x81e10f748c479223ULL, 0xc2ce91a881edd191ULL, 6663}, // 1e2044
+    {0x8324f8aa08d7d411ULL, 0x0cc6866c5d69b2cbULL, 6756}, // 1e2072
+    {0x846c09b028ae0395ULL, 0x04f609974dd3ffe9ULL, 6849}, // 1e2100
+    {0x85b64a659077660eULL, 0x7fe2b4308dcbf1a3ULL, 6942}, // 1e2128
+    {0x8703c2bc85483e07ULL, 0x38d0ef9ab8a8f2c8ULL, 7035}, // 1e2156
+    {0x88547abb1d8e5bd9ULL, 0x1d73ef3eaac3c964ULL, 7128}, // 1e2184
+    {0x89a87a7b727dc0d2ULL, 0x5c7015cd0e51679aULL, 7221}, // 1e2212
+    {0x8affca2bd1f88549ULL, 0x1e34291b1ef566c7ULL, 7314}, // 1e2240
+    {0x8c5a720ef0f33507ULL, 0x11c0b3bacd7601b3ULL, 7407}, // 1e2268
+    {0x8db87a7c1e56d873ULL, 0x9e9383d73d486881ULL, 7500}, // 1e2296
+    {0x8f19ebdf7661e3e9ULL, 0xac89bfa5e79484a6ULL, 7593}, // 1e2324
+    {0x907eceba168949b3ULL, 0x9cc5ee51962c011aULL, 7686}, // 1e2352
+    {0x91e72ba251daee3dULL, 0x564f722fcaa40dd4ULL, 7779}, // 1e2380
+    {0x93530b43e5e2c129ULL, 0x413407cfeeac9743ULL, 7872}, // 1e2408
+    {0x94c276603013c119ULL, 0xc69f0b71ef89019eULL, 7965}, // 1e2436
+    {0x963575ce63b6332dULL, 0x7efa7d29c44e11b7ULL, 8058}, // 1e2464
+    {0x97ac127bc05c5a60ULL, 0xb450373470f0746bULL, 8151}, // 1e2492
+    {0x9926556bc8defe43ULL, 0x5a848859645d1c6fULL, 8244}, // 1e2520
+    {0x9aa447b87ae313b7ULL, 0x2c95a08e49a4c15bULL, 8337}, // 1e2548
+    {0x9c25f29286e9ddb6ULL, 0x51edea897b34601fULL, 8430}, // 1e2576
+    {0x9dab5f4188ecdf77ULL, 0xdd5daebb2f169c8bULL, 8523}, // 1e2604
+    {0x9f3497244186fca4ULL, 0xb50008d92529e91fULL, 8616}, // 1e2632
+    {0xa0c1a3b0cfac27b5ULL, 0x13e15517552a7bc7ULL, 8709}, // 1e2660
+    {0xa2528e74eaf101fcULL, 0xf09e780bcc8238d9ULL, 8802}, // 1e2688
+    {0xa3e761161e63d464ULL, 0x3c85a6192ebf4818ULL, 8895}, // 1e2716
+    {0xa580255203f84b47ULL, 0x3a5828869701a165ULL, 8988}, // 1e2744
+    {0xa71ce4fe80876383ULL, 0x3033d77325daf287ULL, 9081}, // 1e2772
+    {0xa8bdaa0a0064fa44ULL, 0x8b231a70eb5444ceULL, 9174}, // 1e2800
+    {0xaa627e7bb48c74c5ULL, 0x4251ff2792301ce5ULL, 9267}, // 1e2828
+    {0xac0b6c73d065f8ccULL, 0xfa1bde1f473556a4ULL, 9360}, // 1e2856
+    {0xadb87e2bc825b270ULL, 0x2a73f1628aa4208eULL, 9453}, // 1e2884
+    {0xaf69bdf68fc6a740ULL, 0x7730e00421da4d55ULL, 9546}, // 1e2912
+    {0xb11f3640daa29adeULL, 0x9254aa6fbbb55f5cULL, 9639}, // 1e2940
+    {0xb2d8f1915ba88ca5ULL, 0x7f959cb702329d14ULL, 9732}, // 1e2968
+    {0xb496fa89063359f7ULL, 0xfc797c10226cda5bULL, 9825}, // 1e2996
+    {0xb6595be34f821493ULL, 0x40c3a071220f5567ULL, 9918}, // 1e3024
+    {0xb820207670d3a02eULL, 0x57854716b3f18898ULL, 10011}, // 1e3052
+    {0xb9eb5333aa272e9bULL, 0x11c48d02b8326bd3ULL, 10104}, // 1e3080
+    {0xbbbaff2785a33595ULL, 0x209d5496b884ccffULL, 10197}, // 1e3108
+    {0xbd8f2f7a1ba47d6dULL, 0x566765461bd2f61bULL, 10290}, // 1e3136
+    {0xbf67ef6f5776ebcaULL, 0x7d7acebf8aadfb4bULL, 10383}, // 1e3164
+    {0xc1454a673cb9b1ceULL, 0xb889018e4f6e9a52ULL, 10476}, // 1e3192
+    {0xc3274bde2d708910ULL, 0x1556481f9c26f53dULL, 10569}, // 1e3220
+    {0xc50dff6d30c3aefcULL, 0xf85333a94848659fULL, 10662}, // 1e3248
+    {0xc6f970ca3a705279ULL, 0x67ce61ccfd48c510ULL, 10755}, // 1e3276
+    {0xc8e9abc872eb2bc1ULL, 0x1a1aeae7cf8a9d3dULL, 10848}, // 1e3304
+    {0xcadebc588036fae3ULL, 0x9d3d9605b201eb8aULL, 10941}, // 1e3332
+    {0xccd8ae88cf70ad84ULL, 0x12e29f09d9061609ULL, 11034}, // 1e3360
+    {0xced78e85df12f0e4ULL, 0xeb3149759843e989ULL, 11127}, // 1e3388
+    {0xd0db689a89f2f9b1ULL, 0xdf7601457ca20b35ULL, 11220}, // 1e3416
+    {0xd2e4493052f84f6fULL, 0x45beebb8a6b94a98ULL, 11313}, // 1e3444
+    {0xd4f23ccfb1916df5ULL, 0xcbdcd02f23cc7690ULL, 11406}, // 1e3472
+    {0xd70550205ee713ecULL, 0xd67aeffbfcacc7b9ULL, 11499}, // 1e3500
+    {0xd91d8fe9a3d019ccULL, 0x44289dd21b589d7aULL, 11592}, // 1e3528
+    {0xdb3b0912a787b190ULL, 0x4881d9e963e4ce8fULL, 11685}, // 1e3556
+    {0xdd5dc8a2bf27f3f7ULL, 0x95aa118ec1d08317ULL, 11778}, // 1e3584
+    {0xdf85dbc1bdeaa4ddULL, 0x36d5b4a1a707195fULL, 11871}, // 1e3612
+    {0xe1b34fb846321d04ULL, 0x72c4d2cad73b0a7bULL, 11964}, // 1e3640
+    {0xe3e631f01b5c4c7dULL, 0xe6331d95a376b8c8ULL, 12057}, // 1e3668
+    {0xe61e8ff47461cda9ULL, 0xe20a88f1134f906dULL, 12150}, // 1e3696
+    {0xe85c77724f4305c5ULL, 0x158950ef08de22beULL, 12243}, // 1e3724
+    {0xea9ff638c54554e1ULL, 0xc7c91d5c341ed39dULL, 12336}, // 1e3752
+    {0xece91a3960025c31ULL, 0x7cb5735c85c60ad7ULL, 12429}, // 1e3780
+    {0xef37f1886f4b6690ULL, 0xf659ede2159a45ecULL, 12522}, // 1e3808
+    {0xf18c8a5d5fe30463ULL, 0x33a802cdaed28cf3ULL, 12615}, // 1e3836
+    {0xf3e6f313130ef0efULL, 0x78d946bab954b82fULL, 12708}, // 1e3864
+    {0xf6473a2837045caaULL, 0xb325712dd8c98916ULL, 12801}, // 1e3892
+    {0xf8ad6e3fa030bd15ULL, 0xc9b1474d8f89c269ULL, 12894}, // 1e3920
+    {0xfb199e20a3614828ULL, 0xc8c37010926872b0ULL, 12987}, // 1e3948
+    {0xfd8bd8b770cb469eULL, 0x6b1d2745340e7b14ULL, 13080}, // 1e3976
+    {0x8002168ab7fbb6eeULL, 0x3c67b6bbb284e49eULL, 13174}, // 1e4004
+    {0x81415538ce493bd5ULL, 0xf22e502fcdd4bca2ULL, 13267}, // 1e4032
+    {0x8283b014721299bbULL, 0xd00832554d9149c7ULL, 13360}, // 1e4060
+    {0x83c92edf425b292dULL, 0x7c1735fc3b813c8cULL, 13453}, // 1e4088
+    {0x8511d96e362c1a73ULL, 0xfa9d4d41a7042940ULL, 13546}, // 1e4116
+    {0x865db7a9ccd2839eULL, 0x0367500a8e9a178fULL, 13639}, // 1e4144
+    {0x87acd18e3e95bedaULL, 0x8f1672ec7d776c85ULL, 13732}, // 1e4172
+    {0x88ff2f2bade74531ULL, 0xc9ac50475e25293aULL, 13825}, // 1e4200
+    {0x8a54d8a6590d3496ULL, 0xe9cc6e8725ec5d92ULL, 13918}, // 1e4228
+    {0x8badd636cc48b341ULL, 0x0879b2e5f6ee8b1cULL, 14011}, // 1e4256
+    {0x8d0a302a14796534ULL, 0x0ddc924865236fc7ULL, 14104}, // 1e4284
+    {0x8e69eee1f23f2be5ULL, 0x2f33c652bd12fab7ULL, 14197}, // 1e4312
+    {0x8fcd1ad50d9b6af0ULL, 0x62fe50ce55eed182ULL, 14290}, // 1e4340
+    {0x9133bc8f2a130fe5ULL, 0xad6a6308a8e8b557ULL, 14383}, // 1e4368
+    {0x929ddcb15b529e4eULL, 0x4b07b86f1db31283ULL, 14476}, // 1e4396
+    {0x940b83f23a55842aULL, 0x9dbaa465efe141a0ULL, 14569}, // 1e4424
+    {0x957cbb1e1b11fe52ULL, 0x6b3c9c8f4da2a4d8ULL, 14662}, // 1e4452
+    {0x96f18b1742aad751ULL, 0x888c9ab2fc5b3437ULL, 14755}, // 1e4480
+    {0x9869fcd61e284e93ULL, 0x8e33034a7a9e5d55ULL, 14848}, // 1e4508
+    {0x99e6196979b978f1ULL, 0xba00864671d1053fULL, 14941}, // 1e4536
+    {0x9b65e9f6b87f6efeULL, 0xc7fddfd9302c767dULL, 15034}, // 1e4564
+    {0x9ce977ba0ce3a0bdULL, 0x61d59d402aae4feaULL, 15127}, // 1e4592
+    {0x9e70cc06b17aa9c6ULL, 0xde85adfe03e691b5ULL, 15220}, // 1e4620
+    {0x9ffbf04722750449ULL, 0x803c1cd864033781ULL, 15313}, // 1e4648
+    {0xa18aedfd579efcafULL, 0x40bbc431f624b546ULL, 15406}, // 1e4676
+    {0xa31dcec2fef14b30ULL, 0xa28a151725a55e10ULL, 15499}, // 1e4704
+    {0xa4b49c49b7b3bc11ULL, 0xfbb16e441eec585aULL, 15592}, // 1e4732
+    {0xa64f605b4e3352cdULL, 0x5b8452af2302fe13ULL, 15685}, // 1e4760
+    {0xa7ee24d9f80d57f7ULL, 0x9d2acf5772f77020ULL, 15778}, // 1e4788
+    {0xa990f3c09110c544ULL, 0x82b84cabc828bf93ULL, 15871}, // 1e4816
+    {0xab37d722d8b786abULL, 0xee2722ad5f60d16eULL, 15964}, // 1e4844
+    {0xace2d92db0390b59ULL, 0x8d29dd5122e4278dULL, 16057}, // 1e4872
+    {0xae9204275937a4c0ULL, 0xa8c91282e5af94eaULL, 16150}, // 1e4900
+    {0xb045626fb50a35e7ULL, 0x58f8fde02c03a6c6ULL, 16243}, // 1e4928
+    {0xb1fcfe8084a3b8bfULL, 0x35a5744effe56f34ULL, 16336}, // 1e4956
+    {0xb3b8e2eda91a232dULL, 0xd950102978dbd0ffULL, 16429}, // 1e4984
+};
+
+static const uint64_t qparse_pow5[QPARSE_STEP] = {
+    1ULL,
+    5ULL,
+    25ULL,
+    125ULL,
+    625ULL,
+    3125ULL,
+    15625ULL,
+    78125ULL,
+    390625ULL,
+    1953125ULL,
+    9765625ULL,
+    48828125ULL,
+    244140625ULL,
+    1220703125ULL,
+    6103515625ULL,
+    30517578125ULL,
+    152587890625ULL,
+    762939453125ULL,
+    3814697265625ULL,
+    19073486328125ULL,
+    95367431640625ULL,
+    476837158203125ULL,
+    2384185791015625ULL,
+    11920928955078125ULL,
+    59604644775390625ULL,
+    298023223876953125ULL,
+    1490116119384765625ULL,
+    7450580596923828125ULL,
+};
+
+static inline bool
+qparse_is_digit(char c)
+{
+    return (unsigned char)(c - '0') < 10;
+}
+
+static inline bool
+qparse_is_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+void
+qparse_pow10(int q, __uint128_t *m, int *e)
+{
+    const qparse_pow10_entry *p;
+    __uint128_t hi, lo;
+    int j, r, lz;
+
+    j = (q - QPARSE_QMIN) / QPARSE_STEP;
+    r = (q - QPARSE_QMIN) - QPARSE_STEP * j;
+    p = &qparse_pow10_table[j];
+
+    lo = (__uint128_t)p->lo * qparse_pow5[r];
+    hi = (__uint128_t)p->hi * qparse_pow5[r] + (lo >> 64);
+    lz = qdd_clz128(hi);
+    *m = lz == 0 ? hi : (hi << lz) | ((__uint128_t)(uint64_t)lo >> (64 - lz));
+    *e = p->e + r + 64 - lz;
+}
+
+// Round w * 10^q to binary128. w_exact is false if digits were dropped from
+// w, so the decimal value lies in [w, w + 1) * 10^q.
+static bool
+qparse_round(__uint128_t w, int q, bool w_exact, bool negative, __float128 *out)
+{
+    const qparse_pow10_entry *p;
+    __uint128_t hi, lo, x, y, m, a;
+    uint64_t low64;
+    unsigned int rem, err;
+    int lz, lz1, shift, j, r, e;
+    qdd_quad_bits b;
+
+    j = (q - QPARSE_QMIN) / QPARSE_STEP;
+    r = (q - QPARSE_QMIN) - QPARSE_STEP * j;
+    p = &qparse_pow10_table[j];
+    a = ((__uint128_t)p->hi << 64) | p->lo;
+
+    // w * 5^r exactly as 192 bits, normalised and truncated to 128
+    lz = qdd_clz128(w);
+    w <<= lz;
+    lo = (__uint128_t)(uint64_t)w * qparse_pow5[r];
+    hi = (__uint128_t)(uint64_t)(w >> 64) * qparse_pow5[r] + (lo >> 64);
+    low64 = (uint64_t)lo;
+    lz1 = qdd_clz128(hi);
+    x = lz1 == 0 ? hi : (hi << lz1) | ((__uint128_t)low64 >> (64 - lz1));
+
+    // Times 10^(28 j), both factors are in [2^127, 2^128)
+    hi = qparse_mul_128(x, a, &lo);
+    if (hi >> 127) {
+        y = hi;
+        shift = 128;
+    } else {
+        y = (hi << 1) | (lo >> 127);
+        shift = 127;
+    }
+    e = 127 + (64 - lz1) + shift + p->e + r - lz;
+
+    // Every step above truncates, so the exact value is in [y, y + err)
+    // units of the last place of y. Each truncated factor contributes under
+    // two units, dropped digits up to 2^128 / 10^37.
+    err = w_exact ? 8 : 48;
+    rem = (unsigned int)y & QPARSE_ROUND_MASK;
+    m = y >> QPARSE_ROUND_BITS;
+    if (rem > QPARSE_HALF) {
+        m++;
+        if (m >> 113) {
+            m >>= 1;
+            e++;
+        }
+    } else if (rem + err > QPARSE_HALF) {
+        return false;
+    }
+
+    if (e < 1 - QDD_QUAD_BIAS || e > QDD_QUAD_BIAS) {
+        return false;
+    }
+
+    b.u = ((__uint128_t)negative << 127) | ((__uint128_t)(unsigned)(e + QDD_QUAD_BIAS) << 112)
+          | (m & ((((__uint128_t)1) << 112) - 1));
+    *out = b.f;
+    return true;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// Eight ASCII digits at once, see Lemire, "Faster integer parsing"
+static inline bool
+qparse_is_eight_digits(uint64_t v)
+{
+    return ((v & 0xf0f0f0f0f0f0f0f0ULL) | (((v + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) >> 4))
+           == 0x3333333333333333ULL;
+}
+
+static inline uint64_t
+qparse_eight_digits(uint64_t v)
+{
+    v -= 0x3030303030303030ULL;
+    v = v * 10 + (v >> 8);
+    return (((v & 0x000000ff000000ffULL) * (100 + (1000000ULL << 32)))
+            + (((v >> 16) & 0x000000ff000000ffULL) * (1 + (10000ULL << 32))))
+           >> 32;
+}
+#endif
+
+// Fold the digits in [p, end) into w, which must not overflow
+static inline __uint128_t
+qparse_accumulate(__uint128_t w, const char *p, const char *end)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v;
+
+    while (end - p >= 8) {
+        memcpy(&v, p, sizeof(v));
+        w = w * 100000000ULL + qparse_eight_digits(v);
+        p += 8;
+    }
+#endif
+    for (; p < end; p++) {
+        w = w * 10 + (unsigned int)(*p - '0');
+    }
+    return w;
+}
+
+static inline const char *
+qparse_skip_digits(const char *p, const char *end)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v;
+
+    while (end - p >= 8) {
+        memcpy(&v, p, sizeof(v));
+        if (!qparse_is_eight_digits(v)) {
+            break;
+        }
+        p += 8;
+    }
+#endif
+    while (p < end && qparse_is_digit(*p)) {
+        p++;
+    }
+    return p;
+}
+
+bool
+qparse_decimal(const char *s, size_t len, __float128 *out)
+{
+    const char *p = s;
+    const char *end = s + len;
+    const char *int_start, *int_end, *frac_start, *frac_end, *first;
+    __uint128_t w = 0;
+    long nsig, dexp;
+    long exp10 = 0;
+    bool negative = false;
+    bool w_exact = true;
+
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    int_start = p;
+    p = int_end = qparse_skip_digits(p, end);
+    frac_start = frac_end = p;
+    if (p < end && *p == '.') {
+        frac_start = p + 1;
+        p = frac_end = qparse_skip_digits(frac_start, end);
+    }
+    if (int_end == int_start && frac_end == frac_start) {
+        return false;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        bool exp_negative = false;
+
+        p++;
+        if (p < end && (*p == '+' || *p == '-')) {
+            exp_negative = *p == '-';
+            p++;
+        }
+        if (p == end || !qparse_is_digit(*p)) {
+            return false;
+        }
+        for (; p < end && qparse_is_digit(*p); p++) {
+            if (exp10 < 100000000) {
+                exp10 = exp10 * 10 + (*p - '0');
+            }
+        }
+        if (exp_negative) {
+            exp10 = -exp10;
+        }
+    }
+    if (p != end) {
+        return false;
+    }
+
+    // Leading zeros are not significant
+    for (first = int_start; first < int_end && *first == '0'; first++) {
+    }
+    if (first == int_end) {
+        for (first = frac_start; first < frac_end && *first == '0'; first++) {
+        }
+        nsig = frac_end - first;
+    } else {
+        nsig = (int_end - first) + (frac_end - frac_start);
+    }
+    if (nsig == 0) {
+        *out = negative ? -0.0Q : 0.0Q;
+        return true;
+    }
+    dexp = exp10 - (frac_end - frac_start);
+
+    if (nsig <= QPARSE_MAX_DIGITS) {
+        if (first < int_end) {
+            w = qparse_accumulate(w, first, int_end);
+            first = frac_start;
+        }
+        w = qparse_accumulate(w, first, frac_end);
+    } else {
+        // Keep the leading digits and remember whether any dropped one was non-zero
+        const char *d = first;
+        long k;
+
+        for (k = 0; k < nsig; k++) {
+            if (d == int_end) {
+                d = frac_start;
+            }
+            if (k < QPARSE_MAX_DIGITS) {
+                w = w * 10 + (unsigned int)(*d - '0');
+            } else {
+                w_exact &= *d == '0';
+            }
+            d++;
+        }
+        dexp += nsig - QPARSE_MAX_DIGITS;
+    }
+
+    if (dexp < QPARSE_QMIN || dexp > QPARSE_QMAX) {
+        return false;
+    }
+    return qparse_round(w, (int)dexp, w_exact, negative, out);
+}
+
+bool
+qparse_string(const char *s, size_t len, __float128 *out)
+{
+    char stack_buf[QPARSE_BUFFER];
+    char *buf;
+    char *sp = NULL;
+    bool ok;
+
+    while (len > 0 && qparse_is_space(*s)) {
+        s++;
+        len--;
+    }
+    while (len > 0 && qparse_is_space(s[len - 1])) {
+        len--;
+    }
+    if (len == 0) {
+        return false;
+    }
+
+    if (qparse_decimal(s, len, out)) {
+        return true;
+    }
+
+    // strtoflt128 needs a terminated copy, which must not hide an embedded NUL
+    if (memchr(s, '\0', len) != NULL) {
+        return false;
+    }
+    if (len < QPARSE_BUFFER) {
+        buf = stack_buf;
+    } else {
+        buf = malloc(len + 1);
+        if (buf == NULL) {
+            return false;
+        }
+    }
+    memcpy(buf, s, len);
+    buf[len] = '\0';
+
+    *out = strtoflt128(buf, &sp);
+    ok = sp == buf + len;
+
+    if (buf != stack_buf) {
+        free(buf);
+    }
+    return ok;
+}
+
+static bool
+qparse_imag_part(const char *s, size_t len, __float128 *out)
+{
+    // A bare sign is a unit imaginary, "j" or "-j"
+    if (len == 0 || (len == 1 && (s[0] == '+' || s[0] == '-'))) {
+        *out = len == 1 && s[0] == '-' ? -1 : 1;
+        return true;
+    }
+    return qparse_string(s, len, out);
+}
+
+bool
+qparse_complex(const char *s, size_t len, __complex128 *out)
+{
+    __float128 re = 0, im = 0;
+    size_t split, i;
+
+    while (len > 0 && qparse_is_space(*s)) {
+        s++;
+        len--;
+    }
+    while (len > 0 && qparse_is_space(s[len - 1])) {
+        len--;
+    }
+    if (len >= 2 && s[0] == '(' && s[len - 1] == ')') {
+        s++;
+        len -= 2;
+        while (len > 0 && qparse_is_space(*s)) {
+            s++;
+            len--;
+        }
+        while (len > 0 && qparse_is_space(s[len - 1])) {
+            len--;
+        }
+    }
+    if (len == 0) {
+        return false;
+    }
+
+    if (s[len - 1] != 'j' && s[len - 1] != 'J') {
+        if (!qparse_string(s, len, &re)) {
+            return false;
+        }
+    } else {
+        // The imaginary part starts at the last sign not in an exponent
+        len--;
+        split = 0;
+        for (i = 1; i < len; i++) {
+            if ((s[i] == '+' || s[i] == '-') && s[i - 1] != 'e' && s[i - 1] != 'E') {
+                split = i;
+            }
+        }
+        if (split > 0 && !qparse_string(s, split, &re)) {
+            return false;
+        }
+        if (qparse_is_space(s[split]) || !qparse_imag_part(s + split, len - split, &im)) {
+            return false;
+        }
+    }
+
+    __real__ *out = re;
+    __imag__ *out = im;
+    return true;
+}
+
+bool
+qparse_int128(const char *s, size_t len, __int128 *out)
+{
+    unsigned __int128 value = 0;
+    unsigned __int128 limit;
+    bool negative = false;
+    size_t i;
+
+    while (len > 0 && qparse_is_space(*s)) {
+        s++;
+        len--;
+    }
+    while (len > 0 && qparse_is_space(s[len - 1])) {
+        len--;
+    }
+    if (len > 0 && (s[0] == '+' || s[0] == '-')) {
+        negative = s[0] == '-';
+        s++;
+        len--;
+    }
+    if (len == 0) {
+        return false;
+    }
+
+    // |INT128_MIN| is one more than INT128_MAX
+    limit = ((unsigned __int128)1 << 127) - (negative ? 0 : 1);
+    for (i = 0; i < len; i++) {
+        unsigned digit = (unsigned)(s[i] - '0');
+
+        if (digit > 9 || value > (limit - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+
+    *out = negative ? (__int128)(0 - value) : (__int128)value;
+    return true;
+}
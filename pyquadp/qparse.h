@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+
+// Correctly rounded decimal string to binary128 conversion.
+//
+// Plain decimals are converted with a single 128-bit by 128-bit product
+// against a table of truncated powers of ten, in the style of the
+// Eisel-Lemire algorithm. The error of that product is bounded, so when the
+// rounding direction is not certain (inputs within a few parts in 2^128 of
+// a halfway point), or the result is subnormal or overflows, the string is
+// handed to strtoflt128 which does the exact big-decimal arithmetic.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Decimal exponents covered by the power of ten table
+#define QPARSE_QMIN (-5012)
+#define QPARSE_QMAX 5011
+
+static inline __uint128_t
+qparse_mul_128(__uint128_t a, __uint128_t b, __uint128_t *lo)
+{
+    // High and low halves of the full 256-bit product
+    uint64_t a0 = (uint64_t)a, a1 = (uint64_t)(a >> 64);
+    uint64_t b0 = (uint64_t)b, b1 = (uint64_t)(b >> 64);
+    __uint128_t p00 = (__uint128_t)a0 * b0;
+    __uint128_t p01 = (__uint128_t)a0 * b1;
+    __uint128_t p10 = (__uint128_t)a1 * b0;
+    __uint128_t mid = (p00 >> 64) + (uint64_t)p01 + (uint64_t)p10;
+
+    *lo = (mid << 64) | (uint64_t)p00;
+    return (__uint128_t)a1 * b1 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+}
+
+// 10^q for q in [QPARSE_QMIN, QPARSE_QMAX] as (*m + d) * 2^*e, with *m in
+// [2^127, 2^128) and 0 <= d < 2
+void qparse_pow10(int q, __uint128_t *m, int *e);
+
+// Fast path only: parse all of s[0, len) as [+-]digits[.digits][(e|E)[+-]digits].
+// Returns false, leaving *out untouched, for any other syntax or when the
+// result needs the exact fallback.
+bool qparse_decimal(const char *s, size_t len, __float128 *out);
+
+// Parse all of s[0, len), ignoring leading and trailing ASCII whitespace.
+// Accepts everything strtoflt128 does (hex floats, inf, nan, ...) and
+// returns false if s is not a valid number.
+bool qparse_string(const char *s, size_t len, __float128 *out);
+
+// Python complex() syntax, "1+2j", "(1-2e3j)", "-j", "4", with each part
+// parsed by qparse_string
+bool qparse_complex(const char *s, size_t len, __complex128 *out);
+
+// [+-]digits with leading and trailing whitespace ignored. Returns false if
+// s is not an integer or does not fit in 128 bits.
+bool qparse_int128(const char *s, size_t len, __int128 *out);
@@ -0,0 +1,2068 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+// Quad-double dtype, registered the same way as qarray in qfloatarray.c
+
+#define NPY_TARGET_VERSION NPY_2_0_API_VERSION
+#define NPY_NO_DEPRECATED_API NPY_2_0_API_VERSION
+
+#include "pyquadp.h"
+
+#include <numpy/arrayobject.h>
+#include <numpy/npy_math.h>
+#include <numpy/ufuncobject.h>
+#include <stdalign.h>
+#include <string.h>
+
+#include "qqarray.h"
+#include "qqfloat.h"
+#include "qqmath.h"
+
+static int QQArrayTypeNum = -1;
+static int QuadArrayTypeNum = -1;
+PyArray_ArrFuncs QQArrayFuncs;
+PyArray_Descr* QQArrayDescr;
+PyArray_DescrProto QQArrayDescrProto = {PyObject_HEAD_INIT(NULL)};
+
+static int QQArray_setitem(PyObject* item, qq_t* data, void* array);
+
+// True when every operand of an inner loop is a packed run of quad-doubles,
+// the plain indexed loop then saves the pointer bumps on every element
+static inline bool
+QQArray_is_contiguous(const npy_intp *steps, int nargs)
+{
+  int i;
+
+  for (i = 0; i < nargs; ++i) {
+    if (steps[i] != (npy_intp)sizeof(qq_t)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void
+QQArray_ufunc_add(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  if (QQArray_is_contiguous(steps, 3)) {
+    const qq_t *a = (const qq_t *)in1;
+    const qq_t *b = (const qq_t *)in2;
+    qq_t *r = (qq_t *)out;
+
+    for (i = 0; i < n; ++i) {
+      r[i] = qq_ieee_add(a[i], b[i]);
+    }
+    return;
+  }
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_add(*(qq_t *)in1, *(qq_t *)in2);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_subtract(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  if (QQArray_is_contiguous(steps, 3)) {
+    const qq_t *a = (const qq_t *)in1;
+    const qq_t *b = (const qq_t *)in2;
+    qq_t *r = (qq_t *)out;
+
+    for (i = 0; i < n; ++i) {
+      r[i] = qq_ieee_sub(a[i], b[i]);
+    }
+    return;
+  }
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_sub(*(qq_t *)in1, *(qq_t *)in2);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_multiply(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  if (QQArray_is_contiguous(steps, 3)) {
+    const qq_t *a = (const qq_t *)in1;
+    const qq_t *b = (const qq_t *)in2;
+    qq_t *r = (qq_t *)out;
+
+    for (i = 0; i < n; ++i) {
+      r[i] = qq_ieee_mul(a[i], b[i]);
+    }
+    return;
+  }
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_mul(*(qq_t *)in1, *(qq_t *)in2);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_divide(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  if (QQArray_is_contiguous(steps, 3)) {
+    const qq_t *a = (const qq_t *)in1;
+    const qq_t *b = (const qq_t *)in2;
+    qq_t *r = (qq_t *)out;
+
+    for (i = 0; i < n; ++i) {
+      r[i] = qq_ieee_div(a[i], b[i]);
+    }
+    return;
+  }
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_div(*(qq_t *)in1, *(qq_t *)in2);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_add_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_add(*(qq_t *)inqq, qq_from_quad(*(npy_float64 *)ind));
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_add_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_add(qq_from_quad(*(npy_float64 *)ind), *(qq_t *)inqq);
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_subtract_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_sub(*(qq_t *)inqq, qq_from_quad(*(npy_float64 *)ind));
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_subtract_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_sub(qq_from_quad(*(npy_float64 *)ind), *(qq_t *)inqq);
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_multiply_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_mul(*(qq_t *)inqq, qq_from_quad(*(npy_float64 *)ind));
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_multiply_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_mul(qq_from_quad(*(npy_float64 *)ind), *(qq_t *)inqq);
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_divide_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_div(*(qq_t *)inqq, qq_from_quad(*(npy_float64 *)ind));
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_divide_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_div(qq_from_quad(*(npy_float64 *)ind), *(qq_t *)inqq);
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_add_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_add(*(qq_t *)inqq, qq_from_quad(*(__float128 *)inq));
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_add_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_add(qq_from_quad(*(__float128 *)inq), *(qq_t *)inqq);
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_subtract_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_sub(*(qq_t *)inqq, qq_from_quad(*(__float128 *)inq));
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_subtract_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_sub(qq_from_quad(*(__float128 *)inq), *(qq_t *)inqq);
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_multiply_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_mul(*(qq_t *)inqq, qq_from_quad(*(__float128 *)inq));
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_multiply_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_mul(qq_from_quad(*(__float128 *)inq), *(qq_t *)inqq);
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_divide_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_div(*(qq_t *)inqq, qq_from_quad(*(__float128 *)inq));
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_divide_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    *(qq_t *)out = qq_ieee_div(qq_from_quad(*(__float128 *)inq), *(qq_t *)inqq);
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_equal(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)in1;
+    qq_t b = *(qq_t *)in2;
+    *(npy_bool *)out = a.hi == b.hi && a.lo == b.lo;
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_not_equal(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)in1;
+    qq_t b = *(qq_t *)in2;
+    *(npy_bool *)out = !(a.hi == b.hi && a.lo == b.lo);
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)in1;
+    qq_t b = *(qq_t *)in2;
+    // Ordered comparisons with NaN are quietly false, as for float64
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(a, b));
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less_equal(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)in1;
+    qq_t b = *(qq_t *)in2;
+    // Ordered comparisons with NaN are quietly false, as for float64
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo));
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)in1;
+    qq_t b = *(qq_t *)in2;
+    // Ordered comparisons with NaN are quietly false, as for float64
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(b, a));
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater_equal(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in1 = args[0];
+  char *in2 = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)in1;
+    qq_t b = *(qq_t *)in2;
+    // Ordered comparisons with NaN are quietly false, as for float64
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi > b.hi || (a.hi == b.hi && a.lo >= b.lo));
+    in1 += steps[0];
+    in2 += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_negative(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qq_t v = *(qq_t *)in;
+    *(qq_t *)out = qq_neg(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+QQArray_ufunc_positive(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qq_t v = *(qq_t *)in;
+    *(qq_t *)out = v;
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+QQArray_ufunc_absolute(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qq_t v = *(qq_t *)in;
+    *(qq_t *)out = v.hi < 0 ? qq_neg(v) : v;
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+QQArray_ufunc_square(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qq_t v = *(qq_t *)in;
+    *(qq_t *)out = qq_ieee_mul(v, v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+QQArray_ufunc_sqrt(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qq_t v = *(qq_t *)in;
+    *(qq_t *)out = qq_ieee_sqrt(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+QQArray_ufunc_exp(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qq_t v = *(qq_t *)in;
+    *(qq_t *)out = qq_exp(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+QQArray_ufunc_log(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *in = args[0];
+  char *out = args[1];
+
+  for (i = 0; i < n; ++i) {
+    qq_t v = *(qq_t *)in;
+    *(qq_t *)out = qq_log(v);
+    in += steps[0];
+    out += steps[1];
+  }
+}
+
+static void
+QQArray_ufunc_equal_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(__float128 *)inq);
+    *(npy_bool *)out = a.hi == b.hi && a.lo == b.lo;
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_equal_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(__float128 *)inq);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = a.hi == b.hi && a.lo == b.lo;
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_equal_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(npy_float64 *)ind);
+    *(npy_bool *)out = a.hi == b.hi && a.lo == b.lo;
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_equal_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(npy_float64 *)ind);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = a.hi == b.hi && a.lo == b.lo;
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_not_equal_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(__float128 *)inq);
+    *(npy_bool *)out = !(a.hi == b.hi && a.lo == b.lo);
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_not_equal_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(__float128 *)inq);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !(a.hi == b.hi && a.lo == b.lo);
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_not_equal_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(npy_float64 *)ind);
+    *(npy_bool *)out = !(a.hi == b.hi && a.lo == b.lo);
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_not_equal_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(npy_float64 *)ind);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !(a.hi == b.hi && a.lo == b.lo);
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(__float128 *)inq);
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(a, b));
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(__float128 *)inq);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(a, b));
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(npy_float64 *)ind);
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(a, b));
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(npy_float64 *)ind);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(a, b));
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less_equal_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(__float128 *)inq);
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo));
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less_equal_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(__float128 *)inq);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo));
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less_equal_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(npy_float64 *)ind);
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo));
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_less_equal_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(npy_float64 *)ind);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo));
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(__float128 *)inq);
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(b, a));
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(__float128 *)inq);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(b, a));
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(npy_float64 *)ind);
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(b, a));
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(npy_float64 *)ind);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (qq_lt(b, a));
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater_equal_qq_q(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *inq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(__float128 *)inq);
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi > b.hi || (a.hi == b.hi && a.lo >= b.lo));
+    inqq += steps[0];
+    inq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater_equal_q_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inq = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(__float128 *)inq);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi > b.hi || (a.hi == b.hi && a.lo >= b.lo));
+    inq += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater_equal_qq_d(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *inqq = args[0];
+  char *ind = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = *(qq_t *)inqq;
+    qq_t b = qq_from_quad(*(npy_float64 *)ind);
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi > b.hi || (a.hi == b.hi && a.lo >= b.lo));
+    inqq += steps[0];
+    ind += steps[1];
+    out += steps[2];
+  }
+}
+
+static void
+QQArray_ufunc_greater_equal_d_qq(char **args, const npy_intp *dims, const npy_intp *steps, void *NPY_UNUSED(data))
+{
+  npy_intp i;
+  npy_intp n = dims[0];
+  char *ind = args[0];
+  char *inqq = args[1];
+  char *out = args[2];
+
+  for (i = 0; i < n; ++i) {
+    qq_t a = qq_from_quad(*(npy_float64 *)ind);
+    qq_t b = *(qq_t *)inqq;
+    *(npy_bool *)out = !isnanq(a.hi) && !isnanq(b.hi) && (a.hi > b.hi || (a.hi == b.hi && a.lo >= b.lo));
+    ind += steps[0];
+    inqq += steps[1];
+    out += steps[2];
+  }
+}
+
+static int
+QQArray_register_ufunc_types(const char *name, PyUFuncGenericFunction loop, int *types)
+{
+  PyObject *numpy_mod;
+  PyObject *ufunc;
+
+  numpy_mod = PyImport_ImportModule("numpy");
+  if (numpy_mod == NULL) {
+    return -1;
+  }
+  ufunc = PyObject_GetAttrString(numpy_mod, name);
+  Py_DECREF(numpy_mod);
+  if (ufunc == NULL) {
+    return -1;
+  }
+
+  if (PyUFunc_RegisterLoopForType((PyUFuncObject *)ufunc, QQArrayTypeNum, loop, types, NULL) < 0) {
+    Py_DECREF(ufunc);
+    return -1;
+  }
+
+  Py_DECREF(ufunc);
+  return 0;
+}
+
+static int
+QQArray_register_ufunc_binary_types(const char *name, PyUFuncGenericFunction loop, int in0, int in1, int out)
+{
+  int types[3];
+
+  types[0] = in0;
+  types[1] = in1;
+  types[2] = out;
+  return QQArray_register_ufunc_types(name, loop, types);
+}
+
+static int
+QQArray_register_ufunc_binary(const char *name, PyUFuncGenericFunction loop)
+{
+  return QQArray_register_ufunc_binary_types(name, loop, QQArrayTypeNum, QQArrayTypeNum, QQArrayTypeNum);
+}
+
+static int
+QQArray_register_ufunc_unary(const char *name, PyUFuncGenericFunction loop)
+{
+  int types[2];
+
+  types[0] = QQArrayTypeNum;
+  types[1] = QQArrayTypeNum;
+  return QQArray_register_ufunc_types(name, loop, types);
+}
+
+typedef struct {
+  const char *name;
+  PyUFuncGenericFunction qq;
+  PyUFuncGenericFunction qq_q;
+  PyUFuncGenericFunction q_qq;
+  PyUFuncGenericFunction qq_d;
+  PyUFuncGenericFunction d_qq;
+} QQArray_binary_loops;
+
+static const QQArray_binary_loops QQArrayBinaryLoops[] = {
+  {"add", QQArray_ufunc_add, QQArray_ufunc_add_qq_q, QQArray_ufunc_add_q_qq, QQArray_ufunc_add_qq_d, QQArray_ufunc_add_d_qq},
+  {"subtract", QQArray_ufunc_subtract, QQArray_ufunc_subtract_qq_q, QQArray_ufunc_subtract_q_qq, QQArray_ufunc_subtract_qq_d, QQArray_ufunc_subtract_d_qq},
+  {"multiply", QQArray_ufunc_multiply, QQArray_ufunc_multiply_qq_q, QQArray_ufunc_multiply_q_qq, QQArray_ufunc_multiply_qq_d, QQArray_ufunc_multiply_d_qq},
+  {"divide", QQArray_ufunc_divide, QQArray_ufunc_divide_qq_q, QQArray_ufunc_divide_q_qq, QQArray_ufunc_divide_qq_d, QQArray_ufunc_divide_d_qq},
+};
+
+static const struct {
+  const char *name;
+  PyUFuncGenericFunction loop;
+} QQArrayUnaryLoops[] = {
+  {"negative", QQArray_ufunc_negative},
+  {"positive", QQArray_ufunc_positive},
+  {"absolute", QQArray_ufunc_absolute},
+  {"square", QQArray_ufunc_square},
+  {"sqrt", QQArray_ufunc_sqrt},
+  {"exp", QQArray_ufunc_exp},
+  {"log", QQArray_ufunc_log},
+};
+
+static const struct {
+  const char *name;
+  PyUFuncGenericFunction qq;
+  PyUFuncGenericFunction qq_q;
+  PyUFuncGenericFunction q_qq;
+  PyUFuncGenericFunction qq_d;
+  PyUFuncGenericFunction d_qq;
+} QQArrayCompareLoops[] = {
+  {"equal", QQArray_ufunc_equal, QQArray_ufunc_equal_qq_q, QQArray_ufunc_equal_q_qq, QQArray_ufunc_equal_qq_d, QQArray_ufunc_equal_d_qq},
+  {"not_equal", QQArray_ufunc_not_equal, QQArray_ufunc_not_equal_qq_q, QQArray_ufunc_not_equal_q_qq, QQArray_ufunc_not_equal_qq_d, QQArray_ufunc_not_equal_d_qq},
+  {"less", QQArray_ufunc_less, QQArray_ufunc_less_qq_q, QQArray_ufunc_less_q_qq, QQArray_ufunc_less_qq_d, QQArray_ufunc_less_d_qq},
+  {"less_equal", QQArray_ufunc_less_equal, QQArray_ufunc_less_equal_qq_q, QQArray_ufunc_less_equal_q_qq, QQArray_ufunc_less_equal_qq_d, QQArray_ufunc_less_equal_d_qq},
+  {"greater", QQArray_ufunc_greater, QQArray_ufunc_greater_qq_q, QQArray_ufunc_greater_q_qq, QQArray_ufunc_greater_qq_d, QQArray_ufunc_greater_d_qq},
+  {"greater_equal", QQArray_ufunc_greater_equal, QQArray_ufunc_greater_equal_qq_q, QQArray_ufunc_greater_equal_q_qq, QQArray_ufunc_greater_equal_qq_d, QQArray_ufunc_greater_equal_d_qq},
+};
+
+static int
+QQArray_register_ufuncs(void)
+{
+  size_t i;
+
+  // NumPy tries the loops of a user dtype in registration order and
+  // qarray -> float64 counts as a safe cast, so the qarray loops come before
+  // the float64 ones, as for ddarray
+  for (i = 0; i < sizeof(QQArrayBinaryLoops) / sizeof(QQArrayBinaryLoops[0]); ++i) {
+    const QQArray_binary_loops *loops = &QQArrayBinaryLoops[i];
+
+    if (QQArray_register_ufunc_binary(loops->name, loops->qq) < 0) {
+      return -1;
+    }
+    if (QQArray_register_ufunc_binary_types(loops->name, loops->qq_q, QQArrayTypeNum, QuadArrayTypeNum, QQArrayTypeNum) < 0) {
+      return -1;
+    }
+    if (QQArray_register_ufunc_binary_types(loops->name, loops->q_qq, QuadArrayTypeNum, QQArrayTypeNum, QQArrayTypeNum) < 0) {
+      return -1;
+    }
+    if (QQArray_register_ufunc_binary_types(loops->name, loops->qq_d, QQArrayTypeNum, NPY_DOUBLE, QQArrayTypeNum) < 0) {
+      return -1;
+    }
+    if (QQArray_register_ufunc_binary_types(loops->name, loops->d_qq, NPY_DOUBLE, QQArrayTypeNum, QQArrayTypeNum) < 0) {
+      return -1;
+    }
+  }
+
+  for (i = 0; i < sizeof(QQArrayUnaryLoops) / sizeof(QQArrayUnaryLoops[0]); ++i) {
+    if (QQArray_register_ufunc_unary(QQArrayUnaryLoops[i].name, QQArrayUnaryLoops[i].loop) < 0) {
+      return -1;
+    }
+  }
+
+  // Normalised pairs compare on hi and then lo. There is no safe cast out
+  // of qqarray for NumPy to fall back on, so qarray and float64 operands are
+  // widened exactly to pairs by their own loops, in the arithmetic order.
+  for (i = 0; i < sizeof(QQArrayCompareLoops) / sizeof(QQArrayCompareLoops[0]); ++i) {
+    const char *name = QQArrayCompareLoops[i].name;
+
+    if (QQArray_register_ufunc_binary_types(name, QQArrayCompareLoops[i].qq, QQArrayTypeNum, QQArrayTypeNum, NPY_BOOL) < 0) {
+      return -1;
+    }
+    if (QQArray_register_ufunc_binary_types(name, QQArrayCompareLoops[i].qq_q, QQArrayTypeNum, QuadArrayTypeNum, NPY_BOOL) < 0) {
+      return -1;
+    }
+    if (QQArray_register_ufunc_binary_types(name, QQArrayCompareLoops[i].q_qq, QuadArrayTypeNum, QQArrayTypeNum, NPY_BOOL) < 0) {
+      return -1;
+    }
+    if (QQArray_register_ufunc_binary_types(name, QQArrayCompareLoops[i].qq_d, QQArrayTypeNum, NPY_DOUBLE, NPY_BOOL) < 0) {
+      return -1;
+    }
+    if (QQArray_register_ufunc_binary_types(name, QQArrayCompareLoops[i].d_qq, NPY_DOUBLE, QQArrayTypeNum, NPY_BOOL) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void
+QQArray_cast_to_float64(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  qq_t *src = (qq_t *)from;
+  npy_float64 *dst = (npy_float64 *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = (npy_float64)src[i].hi;
+  }
+}
+
+static void
+QQArray_cast_to_float32(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  qq_t *src = (qq_t *)from;
+  npy_float32 *dst = (npy_float32 *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = (npy_float32)src[i].hi;
+  }
+}
+
+static void
+QQArray_cast_to_qarray(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  qq_t *src = (qq_t *)from;
+  __float128 *dst = (__float128 *)to;
+
+  // hi is already hi + lo rounded to a quad
+  for (i = 0; i < n; ++i) {
+    dst[i] = src[i].hi;
+  }
+}
+
+static void
+QQArray_cast_from_float64(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  npy_float64 *src = (npy_float64 *)from;
+  qq_t *dst = (qq_t *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = qq_from_quad(src[i]);
+  }
+}
+
+static void
+QQArray_cast_from_float32(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  npy_float32 *src = (npy_float32 *)from;
+  qq_t *dst = (qq_t *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = qq_from_quad(src[i]);
+  }
+}
+
+static void
+QQArray_cast_from_qarray(void *from, void *to, npy_intp n, void *NPY_UNUSED(fromarr), void *NPY_UNUSED(toarr))
+{
+  npy_intp i;
+  __float128 *src = (__float128 *)from;
+  qq_t *dst = (qq_t *)to;
+
+  for (i = 0; i < n; ++i) {
+    dst[i] = qq_from_quad(src[i]);
+  }
+}
+
+static int
+QQArray_register_cast_from(int from_type_num, PyArray_VectorUnaryFunc *cast, bool safe)
+{
+  PyArray_Descr *from_descr;
+
+  from_descr = PyArray_DescrFromType(from_type_num);
+  if (from_descr == NULL) {
+    return -1;
+  }
+  if (PyArray_RegisterCastFunc(from_descr, QQArrayTypeNum, cast) < 0) {
+    Py_DECREF(from_descr);
+    return -1;
+  }
+  if (safe && PyArray_RegisterCanCast(from_descr, QQArrayTypeNum, NPY_NOSCALAR) < 0) {
+    Py_DECREF(from_descr);
+    return -1;
+  }
+  Py_DECREF(from_descr);
+  return 0;
+}
+
+static int
+QQArray_register_casts(PyArray_Descr *qq_descr)
+{
+  // Casts out of qqarray round, so none of them is marked safe. That also
+  // keeps NumPy from picking a qarray or float64 loop for mixed calls, which
+  // would silently drop to the lower precision.
+  if (PyArray_RegisterCastFunc(qq_descr, NPY_DOUBLE, QQArray_cast_to_float64) < 0) {
+    return -1;
+  }
+  if (PyArray_RegisterCastFunc(qq_descr, NPY_FLOAT, QQArray_cast_to_float32) < 0) {
+    return -1;
+  }
+  if (PyArray_RegisterCastFunc(qq_descr, QuadArrayTypeNum, QQArray_cast_to_qarray) < 0) {
+    return -1;
+  }
+
+  if (QQArray_register_cast_from(NPY_DOUBLE, QQArray_cast_from_float64, true) < 0) {
+    return -1;
+  }
+  if (QQArray_register_cast_from(NPY_FLOAT, QQArray_cast_from_float32, true) < 0) {
+    return -1;
+  }
+  if (QQArray_register_cast_from(QuadArrayTypeNum, QQArray_cast_from_qarray, true) < 0) {
+    return -1;
+  }
+
+  return 0;
+}
+
+static PyArrayObject *
+QQArray_new_empty(int nd, npy_intp *dims)
+{
+  PyArray_Descr *descr;
+
+  if (QQArrayDescr == NULL) {
+    PyErr_SetString(PyExc_RuntimeError, "qqarray dtype not initialized");
+    return NULL;
+  }
+
+  descr = QQArrayDescr;
+  Py_INCREF(descr);
+  return (PyArrayObject *)PyArray_SimpleNewFromDescr(nd, dims, descr);
+}
+
+static int
+qqarray_parse_shape(PyObject *shape_obj, int *nd_out, npy_intp **dims_out)
+{
+  PyObject *seq;
+  Py_ssize_t nd;
+  npy_intp i;
+  npy_intp *dims;
+
+  if (PyLong_Check(shape_obj)) {
+    Py_ssize_t n = PyLong_AsSsize_t(shape_obj);
+    if (n < 0 && PyErr_Occurred()) {
+      return -1;
+    }
+    if (n < 0) {
+      PyErr_SetString(PyExc_ValueError, "size must be non-negative");
+      return -1;
+    }
+
+    dims = PyMem_Malloc(sizeof(npy_intp));
+    if (dims == NULL) {
+      PyErr_NoMemory();
+      return -1;
+    }
+    dims[0] = (npy_intp)n;
+    *nd_out = 1;
+    *dims_out = dims;
+    return 0;
+  }
+
+  seq = PySequence_Fast(shape_obj, "shape must be an int or a sequence of ints");
+  if (seq == NULL) {
+    return -1;
+  }
+
+  nd = PySequence_Size(seq);
+  if (nd < 0) {
+    Py_DECREF(seq);
+    return -1;
+  }
+  if (nd == 0) {
+    Py_DECREF(seq);
+    *nd_out = 0;
+    *dims_out = NULL;
+    return 0;
+  }
+
+  dims = PyMem_Malloc((size_t)nd * sizeof(npy_intp));
+  if (dims == NULL) {
+    Py_DECREF(seq);
+    PyErr_NoMemory();
+    return -1;
+  }
+
+  for (i = 0; i < (npy_intp)nd; ++i) {
+    PyObject *item = PySequence_GetItem(seq, i);
+    if (item == NULL) {
+      Py_DECREF(seq);
+      PyMem_Free(dims);
+      return -1;
+    }
+    Py_ssize_t n = PyLong_AsSsize_t(item);
+    Py_DECREF(item);
+    if (n < 0 && PyErr_Occurred()) {
+      Py_DECREF(seq);
+      PyMem_Free(dims);
+      return -1;
+    }
+    if (n < 0) {
+      Py_DECREF(seq);
+      PyMem_Free(dims);
+      PyErr_SetString(PyExc_ValueError, "size must be non-negative");
+      return -1;
+    }
+    dims[i] = (npy_intp)n;
+  }
+
+  Py_DECREF(seq);
+  *nd_out = (int)nd;
+  *dims_out = dims;
+
+  return 0;
+}
+
+static PyObject *
+qqarray_from_object(PyObject *obj, int copy)
+{
+  int requirements;
+  PyArray_Descr *descr;
+
+  requirements = NPY_ARRAY_ENSUREARRAY | NPY_ARRAY_FORCECAST;
+  if (copy) {
+    requirements |= NPY_ARRAY_ENSURECOPY;
+  }
+
+  descr = QQArrayDescr;
+  Py_INCREF(descr);
+  return PyArray_FromAny(obj, descr, 0, NPY_MAXDIMS, requirements, NULL);
+}
+
+static PyObject *
+qqarray_full_value(PyObject *shape_obj, qq_t fill)
+{
+  int nd;
+  npy_intp i;
+  npy_intp size;
+  npy_intp *dims = NULL;
+  PyArrayObject *arr;
+  qq_t *data;
+
+  if (qqarray_parse_shape(shape_obj, &nd, &dims) < 0) {
+    return NULL;
+  }
+
+  arr = QQArray_new_empty(nd, dims);
+  PyMem_Free(dims);
+  if (arr == NULL) {
+    return NULL;
+  }
+
+  size = PyArray_SIZE(arr);
+  data = (qq_t *)PyArray_DATA(arr);
+  for (i = 0; i < size; ++i) {
+    data[i] = fill;
+  }
+  return (PyObject *)arr;
+}
+
+static PyObject *
+qqarray_zeros(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *shape_obj;
+
+  if (!PyArg_ParseTuple(args, "O", &shape_obj)) {
+    return NULL;
+  }
+  return qqarray_full_value(shape_obj, qq_from_quad(0));
+}
+
+static PyObject *
+qqarray_ones(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *shape_obj;
+
+  if (!PyArg_ParseTuple(args, "O", &shape_obj)) {
+    return NULL;
+  }
+  return qqarray_full_value(shape_obj, qq_from_quad(1));
+}
+
+static PyObject *
+qqarray_full(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *shape_obj;
+  PyObject *fill_obj;
+  qq_t fill;
+
+  if (!PyArg_ParseTuple(args, "OO", &shape_obj, &fill_obj)) {
+    return NULL;
+  }
+  if (QQArray_setitem(fill_obj, &fill, NULL) < 0) {
+    return NULL;
+  }
+  return qqarray_full_value(shape_obj, fill);
+}
+
+static PyObject *
+qqarray_empty(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *shape_obj;
+  int nd;
+  npy_intp *dims = NULL;
+  PyArrayObject *arr;
+
+  if (!PyArg_ParseTuple(args, "O", &shape_obj)) {
+    return NULL;
+  }
+  if (qqarray_parse_shape(shape_obj, &nd, &dims) < 0) {
+    return NULL;
+  }
+
+  arr = QQArray_new_empty(nd, dims);
+  PyMem_Free(dims);
+  return (PyObject *)arr;
+}
+
+static PyObject *
+qqarray_from_list(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+  PyObject *seq;
+  Py_ssize_t i;
+  Py_ssize_t n;
+  npy_intp dims[1];
+  PyArrayObject *arr;
+  qq_t *data;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+
+  seq = PySequence_Fast(obj, "from_list requires a sequence");
+  if (seq == NULL) {
+    return NULL;
+  }
+
+  n = PySequence_Size(seq);
+  if (n < 0) {
+    Py_DECREF(seq);
+    return NULL;
+  }
+  dims[0] = (npy_intp)n;
+  arr = QQArray_new_empty(1, dims);
+  if (arr == NULL) {
+    Py_DECREF(seq);
+    return NULL;
+  }
+
+  data = (qq_t *)PyArray_DATA(arr);
+  for (i = 0; i < n; ++i) {
+    PyObject *item = PySequence_GetItem(seq, i);
+    if (item == NULL) {
+      Py_DECREF(arr);
+      Py_DECREF(seq);
+      return NULL;
+    }
+    if (QQArray_setitem(item, &data[i], arr) < 0) {
+      Py_DECREF(item);
+      Py_DECREF(arr);
+      Py_DECREF(seq);
+      return NULL;
+    }
+    Py_DECREF(item);
+  }
+
+  Py_DECREF(seq);
+  return (PyObject *)arr;
+}
+
+static PyObject *
+qqarray_from_array(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+
+  return qqarray_from_object(obj, 1);
+}
+
+static PyObject *
+qqarray_asarray(PyObject *NPY_UNUSED(self), PyObject *args, PyObject *kwargs)
+{
+  static char *kwlist[] = {"values", "copy", NULL};
+  PyObject *obj;
+  int copy = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|p", kwlist, &obj, &copy)) {
+    return NULL;
+  }
+
+  return qqarray_from_object(obj, copy);
+}
+
+static PyObject *
+qqarray_empty_like(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+  PyArrayObject *input;
+  PyArrayObject *arr;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+
+  input = (PyArrayObject *)PyArray_FROM_O(obj);
+  if (input == NULL) {
+    return NULL;
+  }
+
+  arr = QQArray_new_empty(PyArray_NDIM(input), PyArray_DIMS(input));
+  Py_DECREF(input);
+  return (PyObject *)arr;
+}
+
+static PyObject *
+qqarray_full_like_value(PyObject *obj, qq_t fill)
+{
+  PyArrayObject *input;
+  PyArrayObject *arr;
+  qq_t *data;
+  npy_intp i;
+  npy_intp n;
+
+  input = (PyArrayObject *)PyArray_FROM_O(obj);
+  if (input == NULL) {
+    return NULL;
+  }
+
+  arr = QQArray_new_empty(PyArray_NDIM(input), PyArray_DIMS(input));
+  Py_DECREF(input);
+  if (arr == NULL) {
+    return NULL;
+  }
+
+  data = (qq_t *)PyArray_DATA(arr);
+  n = PyArray_SIZE(arr);
+  for (i = 0; i < n; ++i) {
+    data[i] = fill;
+  }
+
+  return (PyObject *)arr;
+}
+
+static PyObject *
+qqarray_zeros_like(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+  return qqarray_full_like_value(obj, qq_from_quad(0));
+}
+
+static PyObject *
+qqarray_ones_like(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    return NULL;
+  }
+  return qqarray_full_like_value(obj, qq_from_quad(1));
+}
+
+static PyObject *
+qqarray_full_like(PyObject *NPY_UNUSED(self), PyObject *args)
+{
+  PyObject *obj;
+  PyObject *value;
+  qq_t fill;
+
+  if (!PyArg_ParseTuple(args, "OO", &obj, &value)) {
+    return NULL;
+  }
+  if (QQArray_setitem(value, &fill, NULL) < 0) {
+    return NULL;
+  }
+  return qqarray_full_like_value(obj, fill);
+}
+
+static PyMethodDef QQArrayMethods[] = {
+  {"empty", qqarray_empty, METH_VARARGS, "Create an uninitialized qqarray."},
+  {"full", qqarray_full, METH_VARARGS, "Create a qqarray filled with a value."},
+  {"zeros", qqarray_zeros, METH_VARARGS, "Create a qqarray of zeros."},
+  {"ones", qqarray_ones, METH_VARARGS, "Create a qqarray of ones."},
+  {"from_list", qqarray_from_list, METH_VARARGS, "Create a qqarray from a Python sequence."},
+  {"from_array", qqarray_from_array, METH_VARARGS, "Create a qqarray from an array-like object."},
+  {"asarray", (PyCFunction)qqarray_asarray, METH_VARARGS | METH_KEYWORDS, "Create a qqarray from an array-like object, copying only if needed."},
+  {"empty_like", qqarray_empty_like, METH_VARARGS, "Create an empty qqarray with the same shape as input."},
+  {"zeros_like", qqarray_zeros_like, METH_VARARGS, "Create a zero-filled qqarray with the same shape as input."},
+  {"ones_like", qqarray_ones_like, METH_VARARGS, "Create a one-filled qqarray with the same shape as input."},
+  {"full_like", qqarray_full_like, METH_VARARGS, "Create a qqarray filled with a value and the same shape as input."},
+  {NULL, NULL, 0, NULL},
+};
+
+static PyModuleDef QQArrayModule = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "qqarray",
+    .m_doc = "Quad-double precision module for arrays.",
+    .m_methods = QQArrayMethods,
+    .m_size = -1,
+};
+
+
+static npy_bool
+QQArray_nonzero(qq_t *ip, void *NPY_UNUSED(arr))
+{
+  // lo is zero whenever hi is, this also keeps -0.0 falsy
+  return ip->hi != 0;
+}
+
+static void
+QQArray_copyswap(qq_t *dst, qq_t *src, int swap, void *NPY_UNUSED(arr))
+{
+  if (src == NULL) {
+    src = dst;
+  }
+  if (src != dst) {
+    memcpy(dst, src, sizeof(qq_t));
+  }
+
+  // Byte swap each quad in place, hi stays first
+  if (swap != 0) {
+    qdd_quad_bits bits;
+
+    bits.f = dst->hi;
+    bits.u = __builtin_bswap128(bits.u);
+    dst->hi = bits.f;
+    bits.f = dst->lo;
+    bits.u = __builtin_bswap128(bits.u);
+    dst->lo = bits.f;
+  }
+}
+
+static void
+QQArray_copyswapn(void *dst, npy_intp dstride, void *src,
+                  npy_intp sstride, npy_intp n, int swap, void *arr)
+{
+  npy_intp i;
+  char *dstptr = dst;
+  char *srcptr = src;
+
+  if (src == NULL) {
+    if (swap == 0) {
+      return;
+    }
+    srcptr = dstptr;
+    sstride = dstride;
+  }
+
+  for (i = 0; i < n; i++) {
+    QQArray_copyswap((qq_t *)dstptr, (qq_t *)srcptr, swap, arr);
+    dstptr += dstride;
+    srcptr += sstride;
+  }
+}
+
+static int QQArray_setitem(PyObject* item, qq_t* data, void* array){
+  qq_t tmp;
+
+  if (!PyObject_to_QQObject(item, &tmp)) {
+    if (!PyErr_Occurred()) {
+      PyErr_SetString(PyExc_TypeError, "Failed to setitem in QQArray");
+    }
+    return -1;
+  }
+  // data may be unaligned, or in a non-native byte order array
+  QQArray_copyswap(&tmp, NULL, array != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)array), NULL);
+  memcpy(data, &tmp, sizeof(tmp));
+  return 0;
+}
+
+static PyObject *
+QQArray_getitem(qq_t* data, void* arr)
+{
+  qq_t tmp;
+
+  memcpy(&tmp, data, sizeof(tmp));
+  QQArray_copyswap(&tmp, NULL, arr != NULL && !PyArray_ISNOTSWAPPED((PyArrayObject *)arr), NULL);
+  return QQObject_to_PyObject(tmp);
+}
+
+static int
+QQArray_compare(qq_t *pa, qq_t *pb, PyArrayObject *NPY_UNUSED(ap))
+{
+  npy_bool anan, bnan;
+
+  anan = isnanq(pa->hi);
+  bnan = isnanq(pb->hi);
+
+  if (anan) {
+    return bnan ? 0 : -1;
+  }
+  if (bnan) {
+    return 1;
+  }
+  if (qq_lt(*pa, *pb)) {
+    return -1;
+  }
+  if (qq_lt(*pb, *pa)) {
+    return 1;
+  }
+  return 0;
+}
+
+static int
+QQArray_argmax(qq_t *ip, npy_intp n, npy_intp *max_ind, PyArrayObject *NPY_UNUSED(aip))
+{
+  npy_intp i;
+  qq_t mp = *ip;
+
+  *max_ind = 0;
+
+  if (isnanq(mp.hi)) {
+    // nan encountered; it's maximal
+    return 0;
+  }
+
+  for (i = 1; i < n; i++) {
+    ip++;
+    if (isnanq(ip->hi)) {
+      // nan encountered, it's maximal
+      *max_ind = i;
+      break;
+    }
+    if (qq_lt(mp, *ip)) {
+      mp = *ip;
+      *max_ind = i;
+    }
+  }
+  return 0;
+}
+
+static int
+QQArray_argmin(qq_t *ip, npy_intp n, npy_intp *min_ind, PyArrayObject *NPY_UNUSED(aip))
+{
+  npy_intp i;
+  qq_t mp = *ip;
+
+  *min_ind = 0;
+
+  if (isnanq(mp.hi)) {
+    // nan encountered; it's minimal
+    return 0;
+  }
+
+  for (i = 1; i < n; i++) {
+    ip++;
+    if (isnanq(ip->hi)) {
+      // nan encountered, it's minimal
+      *min_ind = i;
+      break;
+    }
+    if (qq_lt(*ip, mp)) {
+      mp = *ip;
+      *min_ind = i;
+    }
+  }
+  return 0;
+}
+
+static void
+QQArray_fillwithscalar(qq_t *buffer, npy_intp length, qq_t *value, void *NPY_UNUSED(ignored))
+{
+  npy_intp i;
+  qq_t val = *value;
+
+  for (i = 0; i < length; ++i) {
+    buffer[i] = val;
+  }
+}
+
+PyMODINIT_FUNC
+PyInit_qqarray(void)
+{
+
+    PyObject *m;
+    PyObject *qarray_mod;
+    PyObject *qarray_type_num_obj;
+    int qqarrayNum;
+
+    m = PyModule_Create(&QQArrayModule);
+    if (m == NULL)
+        return NULL;
+
+    if (import_qmqqfloat() < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    qarray_mod = PyImport_ImportModule("pyquadp.qarray");
+    if (qarray_mod == NULL) {
+      Py_DECREF(m);
+      return NULL;
+    }
+    qarray_type_num_obj = PyObject_GetAttrString(qarray_mod, "dtype_num");
+    Py_DECREF(qarray_mod);
+    if (qarray_type_num_obj == NULL) {
+      Py_DECREF(m);
+      return NULL;
+    }
+    QuadArrayTypeNum = (int)PyLong_AsLong(qarray_type_num_obj);
+    Py_DECREF(qarray_type_num_obj);
+    if (QuadArrayTypeNum < 0 && PyErr_Occurred()) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    // Initialize numpy
+    import_array();
+    if (PyErr_Occurred()) {
+      Py_DECREF(m);
+        return NULL;
+    }
+    import_umath();
+    if (PyErr_Occurred()) {
+      Py_DECREF(m);
+        return NULL;
+    }
+
+    PyArray_InitArrFuncs(&QQArrayFuncs);
+    QQArrayFuncs.nonzero = (PyArray_NonzeroFunc*) QQArray_nonzero;
+    QQArrayFuncs.copyswap = (PyArray_CopySwapFunc*) QQArray_copyswap;
+    QQArrayFuncs.copyswapn = (PyArray_CopySwapNFunc*) QQArray_copyswapn;
+    QQArrayFuncs.setitem = (PyArray_SetItemFunc*) QQArray_setitem;
+    QQArrayFuncs.getitem = (PyArray_GetItemFunc*) QQArray_getitem;
+    QQArrayFuncs.compare = (PyArray_CompareFunc*) QQArray_compare;
+    QQArrayFuncs.argmax = (PyArray_ArgFunc*) QQArray_argmax;
+    QQArrayFuncs.argmin = (PyArray_ArgFunc*) QQArray_argmin;
+    QQArrayFuncs.fillwithscalar = (PyArray_FillWithScalarFunc*) QQArray_fillwithscalar;
+
+
+    QQArrayDescrProto = (PyArray_DescrProto){
+      .typeobj = &QQType,
+      .kind = 'V',
+      .type = 'q',
+      .byteorder = '=',
+      .flags = NPY_NEEDS_PYAPI | NPY_USE_GETITEM | NPY_USE_SETITEM,
+      .type_num = 0, // assigned at registration
+      .elsize = sizeof(qq_t),
+      .alignment = alignof(qq_t),
+      .f = &QQArrayFuncs,
+      .subarray = NULL,
+      .fields = NULL,
+      .names = NULL,
+      .metadata = NULL,
+      .c_metadata = NULL,
+    };
+
+    Py_SET_TYPE(&QQArrayDescrProto, &PyArrayDescr_Type);
+
+    Py_INCREF(&QQType);
+    qqarrayNum = PyArray_RegisterDataType(&QQArrayDescrProto);
+
+    if (qqarrayNum < 0) {
+      Py_DECREF(m);
+        return NULL;
+    }
+    QQArrayTypeNum = qqarrayNum;
+    QQArrayDescr = PyArray_DescrFromType(qqarrayNum);
+    if (QQArrayDescr == NULL) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    if (QQArray_register_casts(QQArrayDescr) < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    if (QQArray_register_ufuncs() < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    if (PyModule_AddObjectRef(m, "qqarray", (PyObject *)&QQType) < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+    if (PyModule_AddIntConstant(m, "dtype_num", qqarrayNum) < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+    if (PyModule_AddObjectRef(m, "dtype", (PyObject *)QQArrayDescr) < 0) {
+      Py_DECREF(m);
+      return NULL;
+    }
+
+    return m;
+}
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+#include "pyquadp.h"
+
+#include <numpy/arrayobject.h>
+#undef I
+
+#ifndef Py_QQArray_H
+#define Py_QQArray_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,27 @@
+from collections.abc import Sequence
+from typing import Any, TypeAlias
+
+import numpy as np
+from numpy.typing import ArrayLike, NDArray
+
+from .qmfloat import qfloat
+from .qmqqfloat import qqfloat
+
+QQFloatLike: TypeAlias = qqfloat | qfloat | float | int | str
+ShapeLike: TypeAlias = int | tuple[int, ...]
+
+qqarray: Any
+dtype: np.dtype[Any]
+dtype_num: int
+
+def empty(shape: ShapeLike) -> NDArray[Any]: ...
+def full(shape: ShapeLike, value: QQFloatLike) -> NDArray[Any]: ...
+def zeros(shape: ShapeLike) -> NDArray[Any]: ...
+def ones(shape: ShapeLike) -> NDArray[Any]: ...
+def from_list(values: Sequence[QQFloatLike]) -> NDArray[Any]: ...
+def from_array(values: ArrayLike) -> NDArray[Any]: ...
+def asarray(values: ArrayLike, *, copy: bool = ...) -> NDArray[Any]: ...
+def empty_like(values: ArrayLike) -> NDArray[Any]: ...
+def zeros_like(values: ArrayLike) -> NDArray[Any]: ...
+def ones_like(values: ArrayLike) -> NDArray[Any]: ...
+def full_like(values: ArrayLike, value: QQFloatLike) -> NDArray[Any]: ...
@@ -0,0 +1,677 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <string.h>
+
+#define QQFLOAT_MODULE
+#include "qqfloat.h"
+#include "qfloat.h"
+
+static PyTypeObject *QQType = NULL;
+
+
+static PyObject *
+QQObject_repr(QQObject * obj)
+{
+    char buf[QQ_BUF];
+
+    int n = qq_to_string(buf, sizeof buf, obj->value, QQ_REPR_DIGITS);
+    if ((size_t) n < sizeof buf)
+        return PyUnicode_FromFormat("qqfloat('%s')",
+                                buf);
+    else
+        return PyUnicode_FromFormat("%s","Bad quad-double");
+
+}
+
+
+static PyObject *
+QQObject_str(QQObject * obj)
+{
+    char buf[QQ_BUF];
+
+    int n = qq_to_string(buf, sizeof buf, obj->value, QQ_REPR_DIGITS);
+    if ((size_t) n < sizeof buf)
+        return PyUnicode_FromFormat("%s",buf);
+    else
+        return PyUnicode_FromFormat("%s","Bad quad-double");
+}
+
+
+static PyObject *
+QQObject_conversion_failed(void){
+    // Conversions that fail on an unsupported type leave no error set
+    if (PyErr_Occurred()) {
+        return NULL;
+    }
+    Py_RETURN_NOTIMPLEMENTED;
+}
+
+
+static PyObject *
+QQObject_binary_op1(const int op, PyObject * o1){
+
+    qq_t d1, result;
+
+    if(!PyObject_to_QQObject(o1, &d1)){
+        return QQObject_conversion_failed();
+    }
+
+    switch(op){
+        case OP_negative:
+            result = qq_neg(d1);
+            break;
+        case OP_positive:
+            result = d1;
+            break;
+        case OP_absolute:
+            result = d1.hi < 0 ? qq_neg(d1) : d1;
+            break;
+        default:
+            Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    return QQObject_to_PyObject(result);
+}
+
+
+static PyObject *
+QQObject_binary_op2(const int op, PyObject * o1, PyObject * o2 ){
+
+    qq_t d1, d2, result;
+
+    // qfloat operands convert exactly, so mixing gives a qqfloat
+    if(!PyObject_to_QQObject(o1, &d1)){
+        return QQObject_conversion_failed();
+    }
+
+    if(!PyObject_to_QQObject(o2, &d2)){
+        return QQObject_conversion_failed();
+    }
+
+    switch(op){
+        case OP_add:
+            result = qq_ieee_add(d1, d2);
+            break;
+        case OP_sub:
+            result = qq_ieee_sub(d1, d2);
+            break;
+        case OP_mult:
+            result = qq_ieee_mul(d1, d2);
+            break;
+        case OP_true_divide:
+            result = qq_ieee_div(d1, d2);
+            break;
+        default:
+            Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    return QQObject_to_PyObject(result);
+}
+
+
+static PyObject *
+QQObject_add(PyObject * o1, PyObject * o2 ){
+    return QQObject_binary_op2(OP_add, o1, o2);
+}
+
+static PyObject *
+QQObject_subtract(PyObject * o1, PyObject * o2 ){
+    return QQObject_binary_op2(OP_sub, o1, o2);
+}
+
+static PyObject *
+QQObject_mult(PyObject * o1, PyObject * o2 ){
+    return QQObject_binary_op2(OP_mult, o1, o2);
+}
+
+static PyObject *
+QQObject_true_divide(PyObject * o1, PyObject * o2 ){
+    return QQObject_binary_op2(OP_true_divide, o1, o2);
+}
+
+static PyObject *
+QQObject_neg(PyObject * o1){
+    return QQObject_binary_op1(OP_negative, o1);
+}
+
+static PyObject *
+QQObject_pos(PyObject * o1){
+    return QQObject_binary_op1(OP_positive, o1);
+}
+
+static PyObject *
+QQObject_abs(PyObject * o1){
+    return QQObject_binary_op1(OP_absolute, o1);
+}
+
+static int QQObject_bool(PyObject * o1){
+    return ((QQObject *) o1)->value.hi != 0;
+}
+
+static PyObject *
+QQObject_quad_to_int(__float128 x){
+    // x must be integral, wider values are built from the 113 bit significand
+    PyObject *hi, *lo, *shift, *tmp, *result;
+    __uint128_t m;
+    int e;
+
+    if (!finiteq(x)) {
+        // Raises the same errors as int(float("inf")) and int(float("nan"))
+        return PyLong_FromDouble((double) x);
+    }
+    if (fabsq(x) < 0x1p63Q) {
+        return PyLong_FromLongLong((long long) x);
+    }
+
+    frexpq(x, &e);
+    m = (__uint128_t) scalbnq(fabsq(x), 113 - e);
+
+    hi = PyLong_FromUnsignedLongLong((unsigned long long) (m >> 64));
+    if (hi == NULL) {
+        return NULL;
+    }
+    shift = PyLong_FromLong(64);
+    if (shift == NULL) {
+        Py_DECREF(hi);
+        return NULL;
+    }
+    tmp = PyNumber_Lshift(hi, shift);
+    Py_DECREF(hi);
+    Py_DECREF(shift);
+    if (tmp == NULL) {
+        return NULL;
+    }
+    lo = PyLong_FromUnsignedLongLong((unsigned long long) m);
+    if (lo == NULL) {
+        Py_DECREF(tmp);
+        return NULL;
+    }
+    result = PyNumber_Or(tmp, lo);
+    Py_DECREF(tmp);
+    Py_DECREF(lo);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    // The bits shifted out to the right are all zero as x is integral
+    shift = PyLong_FromLong(e >= 113 ? e - 113 : 113 - e);
+    if (shift == NULL) {
+        Py_DECREF(result);
+        return NULL;
+    }
+    tmp = e >= 113 ? PyNumber_Lshift(result, shift) : PyNumber_Rshift(result, shift);
+    Py_DECREF(result);
+    Py_DECREF(shift);
+    if (tmp == NULL || x > 0) {
+        return tmp;
+    }
+    result = PyNumber_Negative(tmp);
+    Py_DECREF(tmp);
+    return result;
+}
+
+static PyObject *
+QQObject_int(PyObject * o1){
+    qq_t d = ((QQObject *) o1)->value;
+    PyObject *hi, *lo, *result;
+    __float128 frac;
+
+    // As for ddfloat: a non-integral hi has no integer within lo of it,
+    // otherwise round lo towards zero relative to the sign of the whole value
+    if (!finiteq(d.hi) || truncq(d.hi) != d.hi) {
+        return QQObject_quad_to_int(truncq(d.hi));
+    }
+    frac = d.hi > 0 ? floorq(d.lo) : ceilq(d.lo);
+
+    hi = QQObject_quad_to_int(d.hi);
+    if (hi == NULL) {
+        return NULL;
+    }
+    lo = QQObject_quad_to_int(frac);
+    if (lo == NULL) {
+        Py_DECREF(hi);
+        return NULL;
+    }
+    result = PyNumber_Add(hi, lo);
+    Py_DECREF(hi);
+    Py_DECREF(lo);
+    return result;
+}
+
+static PyObject *
+QQObject_float(PyObject * o1){
+    return PyFloat_FromDouble((double) ((QQObject *) o1)->value.hi);
+}
+
+
+static PyObject *
+QQType_RichCompare(PyObject * o1, PyObject * o2, int opid){
+    qq_t d1, d2;
+    int lt, eq;
+    bool res;
+
+    if(!PyObject_to_QQObject(o1, &d1)){
+        return QQObject_conversion_failed();
+    }
+
+    if(!PyObject_to_QQObject(o2, &d2)){
+        return QQObject_conversion_failed();
+    }
+
+    if (isnanq(d1.hi) || isnanq(d2.hi)) {
+        if (opid == Py_NE) {
+            Py_RETURN_TRUE;
+        }
+        Py_RETURN_FALSE;
+    }
+
+    lt = qq_lt(d1, d2);
+    eq = d1.hi == d2.hi && d1.lo == d2.lo;
+
+    switch (opid){
+        case Py_EQ:
+            res = eq;
+            break;
+        case Py_NE:
+            res = !eq;
+            break;
+        case Py_LE:
+            res = lt || eq;
+            break;
+        case Py_LT:
+            res = lt;
+            break;
+        case Py_GT:
+            res = !lt && !eq;
+            break;
+        case Py_GE:
+            res = !lt;
+            break;
+        default:
+            PyErr_SetString(PyExc_AttributeError, "Unknown comparison function.");
+            return NULL;
+    }
+
+    return PyBool_FromLong(res);
+}
+
+
+static PyObject * QQObject_to_bytes(QQObject * self, PyObject * args){
+    return PyBytes_FromStringAndSize(self->bytes, sizeof(qq_t));
+}
+
+
+static PyObject * QQObject_from_bytes(PyTypeObject *type, PyObject * arg){
+    // Gets the type object not an instance in type
+    // As its METH_O we dont need to unpack arg
+    qq_t res;
+
+    if(!PyBytes_Check(arg)){
+        PyErr_SetString(PyExc_TypeError, "Expected a bytes object");
+        return NULL;
+    }
+
+    if(PyBytes_Size(arg) == sizeof(res)){
+        memcpy(&res, PyBytes_AsString(arg), sizeof(res));
+    } else{
+        PyErr_SetString(PyExc_ValueError, "Byte array wrong size for a quad-double");
+        return NULL;
+    }
+
+    return QQObject_to_PyObject(res);
+}
+
+
+static PyObject * QQObject_to_qfloat(QQObject * self, PyObject *Py_UNUSED(ignored)){
+    QuadObject q;
+
+    // hi is already hi + lo rounded to quad precision
+    q.value = self->value.hi;
+    return QuadObject_to_PyObject(q);
+}
+
+
+//Pickling
+static PyObject *QQObject_unpickle = NULL;
+
+// Module level _from_bytes, so a pickle names it once and then holds only the
+// raw bytes of each qqfloat
+static PyObject *
+QQObject__from_bytes(PyObject *module, PyObject *arg) {
+    (void)module;
+    return QQObject_from_bytes(QQType, arg);
+}
+
+static PyObject *
+QQObject___reduce__(QQObject *self, PyObject *Py_UNUSED(ignored)) {
+    PyObject *bytes_obj = QQObject_to_bytes(self, NULL);
+
+    if (bytes_obj == NULL) {
+        return NULL;
+    }
+    return Py_BuildValue("O(N)", QQObject_unpickle, bytes_obj);
+}
+
+
+static Py_hash_t QQObject_hash(QQObject *self){
+    // Values that are exactly a double hash like that float, so that
+    // qqfloat(1.5) == 1.5 keeps hash(qqfloat(1.5)) == hash(1.5)
+    PyObject *obj;
+    Py_hash_t h;
+    double d = (double) self->value.hi;
+
+    if (self->value.lo == 0 && (__float128) d == self->value.hi) {
+        obj = PyFloat_FromDouble(d);
+    } else {
+        obj = QQObject_to_bytes(self, NULL);
+    }
+    if (obj == NULL) {
+        return -1;
+    }
+
+    h = PyObject_Hash(obj);
+    Py_DECREF(obj);
+    return h;
+}
+
+
+static PyObject* QQObject_get_hi(PyObject * self, void * y){
+    QuadObject q;
+
+    q.value = ((QQObject *) self)->value.hi;
+    return QuadObject_to_PyObject(q);
+}
+
+static PyObject* QQObject_get_lo(PyObject * self, void * y){
+    QuadObject q;
+
+    q.value = ((QQObject *) self)->value.lo;
+    return QuadObject_to_PyObject(q);
+}
+
+
+static PyMethodDef QQ_methods[] = {
+    {"to_bytes", (PyCFunction) QQObject_to_bytes, METH_NOARGS, "to_bytes"},
+    {"from_bytes", (PyCFunction) QQObject_from_bytes, METH_CLASS|METH_O, "from_bytes"},
+    {"to_qfloat", (PyCFunction) QQObject_to_qfloat, METH_NOARGS, "Convert to a qfloat, rounding to quad precision."},
+    {"__reduce__", (PyCFunction) QQObject___reduce__, METH_NOARGS, "Pickle a qqfloat as its raw bytes" },
+    {NULL}  /* Sentinel */
+};
+
+// Properties
+static PyGetSetDef QQ_cgetset[] = {
+    {"hi", QQObject_get_hi, NULL, "Leading quad" },
+    {"lo", QQObject_get_lo, NULL, "Trailing quad" },
+    {NULL}  /* Sentinel */
+};
+
+static int
+QQ_init(QQObject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject * obj;
+    PyObject * lo_obj = NULL;
+    qq_t lo;
+    (void)kwds;
+
+    if (!PyArg_ParseTuple(args, "O|O:", &obj, &lo_obj)){
+        return -1;
+    }
+
+    if(!PyObject_to_QQObject(obj, &self->value)){
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_TypeError, "Can not convert value to quad-double precision.");
+        }
+        return -1;
+    }
+
+    if (lo_obj != NULL) {
+        // qqfloat(hi, lo) builds the (renormalised) sum hi + lo
+        if(!PyObject_to_QQObject(lo_obj, &lo)){
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_TypeError, "Can not convert value to quad-double precision.");
+            }
+            return -1;
+        }
+        self->value = qq_ieee_add(self->value, lo);
+    }
+
+    return 0;
+}
+
+
+static PyType_Slot QQType_slots[] = {
+    {Py_tp_doc, (void *)PyDoc_STR("A single quad-double precision variable")},
+    {Py_tp_new, (void *)PyType_GenericNew},
+    {Py_tp_repr, (void *)QQObject_repr},
+    {Py_tp_str, (void *)QQObject_str},
+    {Py_tp_methods, (void *)QQ_methods},
+    {Py_tp_init, (void *)QQ_init},
+    {Py_tp_getset, (void *)QQ_cgetset},
+    {Py_tp_richcompare, (void *)QQType_RichCompare},
+    {Py_tp_hash, (void *)QQObject_hash},
+
+    {Py_nb_add, (void *)QQObject_add},
+    {Py_nb_subtract, (void *)QQObject_subtract},
+    {Py_nb_multiply, (void *)QQObject_mult},
+    {Py_nb_negative, (void *)QQObject_neg},
+    {Py_nb_positive, (void *)QQObject_pos},
+    {Py_nb_absolute, (void *)QQObject_abs},
+    {Py_nb_bool, (void *)QQObject_bool},
+    {Py_nb_int, (void *)QQObject_int},
+    {Py_nb_float, (void *)QQObject_float},
+    {Py_nb_true_divide, (void *)QQObject_true_divide},
+    {0, NULL}
+};
+
+static PyType_Spec QQType_spec = {
+    .name = "pyquadp.qmqqfloat.qqfloat",
+    .basicsize = sizeof(QQObject),
+    .itemsize = 0,
+    .flags = Py_TPFLAGS_DEFAULT,
+    .slots = QQType_slots,
+};
+
+static PyMethodDef QQModule_methods[] = {
+    {"_from_bytes", (PyCFunction) QQObject__from_bytes, METH_O, "Un-pickle a qqfloat from its raw bytes"},
+    {NULL}  /* Sentinel */
+};
+
+static PyModuleDef QQModule = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "qmqqfloat",
+    .m_doc = PyDoc_STR("Quad-double precision module for scalar qqfloat's."),
+    .m_size = -1,
+    .m_methods = QQModule_methods,
+};
+
+static PyObject*
+QQObject_to_PyObject(qq_t value) {
+    QQObject* ret;
+
+    if (QQType == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "qqfloat type not initialized");
+        return NULL;
+    }
+
+    ret = (QQObject*) PyType_GenericAlloc(QQType, 0);
+
+    if (ret != NULL) {
+        ret->value = value;
+    }
+
+    return (PyObject*) ret;
+}
+
+
+static bool
+PyUnicode_to_QQ(PyObject * in, qq_t * out)
+{
+    const char *s;
+    QuadObject q;
+
+    s = PyUnicode_AsUTF8AndSize(in, NULL);
+    if (s == NULL) {
+        return false;
+    }
+    if (qq_from_string(s, out)) {
+        return true;
+    }
+
+    // Hex floats, inf and nan go through the quad parser
+    if(!PyObject_to_QuadObject(in, &q, true)){
+        return false;
+    }
+    *out = qq_from_quad(q.value);
+    return true;
+}
+
+
+static bool
+PyLong_to_QQ(PyObject * in, qq_t * out)
+{
+    long long v;
+    int overflow;
+    PyObject *str;
+    bool ret;
+
+    v = PyLong_AsLongLongAndOverflow(in, &overflow);
+    if (v == -1 && PyErr_Occurred()) {
+        return false;
+    }
+    if (!overflow) {
+        *out = qq_from_quad((__float128) v);
+        return true;
+    }
+
+    // The decimal parser is exact for integers up to ~2^226
+    str = PyObject_Str(in);
+    if (str == NULL) {
+        return false;
+    }
+    ret = PyUnicode_to_QQ(str, out);
+    Py_DECREF(str);
+    return ret;
+}
+
+
+static bool
+PyObject_to_QQObject(PyObject * in, qq_t * out)
+{
+    QuadObject q;
+
+    if(QQObject_Check(in)){
+        *out = ((QQObject *) in)->value;
+        return true;
+    }
+
+    if(QuadObject_Check(in)){
+        if(!PyObject_to_QuadObject(in, &q, true)){
+            return false;
+        }
+        *out = qq_from_quad(q.value);
+        return true;
+    }
+
+    if(PyFloat_Check(in)){
+        *out = qq_from_quad(PyFloat_AsDouble(in));
+        return true;
+    }
+
+    if(PyLong_Check(in)){
+        return PyLong_to_QQ(in, out);
+    }
+
+    if(PyUnicode_Check(in)){
+        return PyUnicode_to_QQ(in, out);
+    }
+
+    return false;
+}
+
+static bool QQObject_Check(PyObject * obj){
+    if(QQType != NULL && PyObject_TypeCheck(obj, QQType))
+        return true;
+    return false;
+}
+
+
+PyMODINIT_FUNC
+PyInit_qmqqfloat(void)
+{
+    PyObject *m;
+    static void *PyQQfloat_API[PyQQfloat_API_pointers];
+    PyObject *c_api_object;
+    PyObject *qq_type_obj;
+    PyObject *module_name_obj;
+
+    if (import_qmfloat() < 0)
+        return NULL;
+
+    m = PyModule_Create(&QQModule);
+    if (m == NULL)
+        return NULL;
+
+    QQObject_unpickle = PyObject_GetAttrString(m, "_from_bytes");
+    if (QQObject_unpickle == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    qq_type_obj = PyType_FromSpec(&QQType_spec);
+    if (qq_type_obj == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+    module_name_obj = PyUnicode_FromString("pyquadp.qmqqfloat");
+    if (module_name_obj == NULL) {
+        Py_DECREF(qq_type_obj);
+        Py_DECREF(m);
+        return NULL;
+    }
+    if (PyObject_SetAttrString(qq_type_obj, "__module__", module_name_obj) < 0) {
+        Py_DECREF(module_name_obj);
+        Py_DECREF(qq_type_obj);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_DECREF(module_name_obj);
+
+    QQType = (PyTypeObject *)qq_type_obj;
+
+    /* Initialize the C API pointer array */
+    PyQQfloat_API[PyQQfloat_qq2py_NUM] = (void *)QQObject_to_PyObject;
+    PyQQfloat_API[PyQQfloat_py2qq_NUM] = (void *)PyObject_to_QQObject;
+    PyQQfloat_API[PyQQfloat_check_NUM] = (void *)QQObject_Check;
+    PyQQfloat_API[PyQQfloat_type_NUM] = (void *)QQType;
+
+    if (PyModule_AddObjectRef(m, "qqfloat", qq_type_obj) < 0) {
+        Py_DECREF(qq_type_obj);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_DECREF(qq_type_obj);
+
+
+    /* Create a Capsule containing the API pointer array's address */
+    c_api_object = PyCapsule_New((void *)PyQQfloat_API, "pyquadp.qmqqfloat._C_API", NULL);
+    if (c_api_object == NULL) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    if (PyModule_AddObjectRef(m, "_C_API", c_api_object) < 0) {
+        Py_DECREF(c_api_object);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_DECREF(c_api_object);
+
+    if (PyDict_SetItemString(PyImport_GetModuleDict(), "qmqqfloat", m) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+
+    return m;
+}
@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+#include "pyquadp.h"
+
+#include "qqmath.h"
+
+#ifndef Py_QQFLOAT_H
+#define Py_QQFLOAT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* C API functions */
+#define PyQQfloat_qq2py_NUM 0
+#define PyQQfloat_py2qq_NUM 1
+#define PyQQfloat_check_NUM 2
+#define PyQQfloat_type_NUM 3
+
+/* Total number of C API pointers */
+#define PyQQfloat_API_pointers 4
+
+#define QQ_BUF 160
+// Significant digits shown by repr and str
+#define QQ_REPR_DIGITS 65
+
+// exported
+typedef struct {
+    PyObject_HEAD
+    union{
+    qq_t value;
+    char bytes[sizeof(qq_t)];
+    };
+} QQObject;
+
+#ifdef QQFLOAT_MODULE
+
+static PyObject* QQObject_to_PyObject(qq_t value);
+static bool PyObject_to_QQObject(PyObject * in, qq_t * out);
+static bool QQObject_Check(PyObject * obj);
+
+#else
+
+static void **PyQQfloat_API;
+
+#define QQObject_to_PyObject \
+ (*(PyObject * (*)(qq_t)) PyQQfloat_API[PyQQfloat_qq2py_NUM])
+
+#define PyObject_to_QQObject \
+ (*(bool (*)(PyObject *, qq_t *)) PyQQfloat_API[PyQQfloat_py2qq_NUM])
+
+#define QQObject_Check \
+(*(bool (*)(PyObject *)) PyQQfloat_API[PyQQfloat_check_NUM])
+
+#define QQType \
+(*(PyTypeObject *) PyQQfloat_API[PyQQfloat_type_NUM])
+
+/* Return -1 on error, 0 on success.
+ * PyCapsule_Import will set an exception if there's an error.
+ */
+static int
+import_qmqqfloat(void)
+{
+    PyQQfloat_API = (void **)PyCapsule_Import("pyquadp.qmqqfloat._C_API", 0);
+    return (PyQQfloat_API != NULL) ? 0 : -1;
+}
+
+#endif
+
+// end exported
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
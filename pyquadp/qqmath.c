@@ -0,0 +1,418 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#include "qqmath.h"
+
+// exp: x = k ln2 + r, expm1(r) from a Taylor series on r/2^10 followed by
+// ten doublings, the same scheme as qdd_exp. Terms from s^10 on are below
+// 2^-113 of the result and only need quad precision.
+#define QQ_EXP_SQUARINGS 10
+#define QQ_EXP_TERMS 16
+#define QQ_EXP_QQ_TERMS 9
+#define QQ_EXP_MAX 11356.6Q
+#define QQ_EXP_MIN -11433.5Q
+
+// Largest power of ten (and its negation) handled in one step by qq_scale10
+#define QQ_POW10_STEP 4900
+
+// Decimal digits beyond this have no effect on a parsed quad-double
+#define QQ_PARSE_DIGITS 90
+// Digits gathered into an integer before being folded in, 10^30 < 2^113
+#define QQ_PARSE_CHUNK 30
+#define QQ_PARSE_MAX_EXP 100000
+
+// ln2 = C0 + C1 + C2, C0 has 98 significant bits so that k * C0 is exact for
+// every k that gives a finite result
+static const double qq_inv_ln2 = 0x1.71547652b82fep+0;
+static const __float128 qq_ln2_c0 = 0x1.62e42fefa39ef35793c767300000p-1Q;
+static const __float128 qq_ln2_c1 = 0x1.f97b57a079a193394c5b16c5068cp-103Q;
+static const __float128 qq_ln2_c2 = -0x1.48e8aa0ba8308f13bf2428a6cf55p-217Q;
+
+// 1/n! for n = 2..16
+static const qq_t qq_inv_fact[] = {
+    {0x1.0000000000000000000000000000p-1Q, 0x0.0p+0Q},
+    {0x1.5555555555555555555555555555p-3Q, 0x1.5555555555555555555555555555p-117Q},
+    {0x1.5555555555555555555555555555p-5Q, 0x1.5555555555555555555555555555p-119Q},
+    {0x1.1111111111111111111111111111p-7Q, 0x1.1111111111111111111111111111p-123Q},
+    {0x1.6c16c16c16c16c16c16c16c16c17p-10Q, -0x1.f49f49f49f49f49f49f49f49f49fp-125Q},
+    {0x1.a01a01a01a01a01a01a01a01a01ap-13Q, 0x1.a01a01a01a01a01a01a01a01a01ap-133Q},
+    {0x1.a01a01a01a01a01a01a01a01a01ap-16Q, 0x1.a01a01a01a01a01a01a01a01a01ap-136Q},
+    {0x1.71de3a556c7338faac1c88e50017p-19Q, 0x1.de3a556c7338faac1c88e500171ep-135Q},
+    {0x1.27e4fb7789f5c72ef016d3ea6679p-22Q, -0x1.b49e220fa3d26aa982c5af3320b5p-138Q},
+    {0x1.ae64567f544e38fe747e4b837dc7p-26Q, 0x1.e202b72f11b6aaac590f0129fef9p-142Q},
+    {0x1.1eed8eff8d897b544da987acfe85p-29Q, -0x1.04ff8c22d2618e389bd2d523aad7p-143Q},
+    {0x1.6124613a86d097ca38331d23af68p-33Q, 0x1.34ecdd5efd11c71cca1034c068d1p-147Q},
+    {0x1.93974a8c07c9d20badf145dfa3e5p-37Q, -0x1.5732e772568a28a0f69157fe20d9p-153Q},
+    {0x1.ae7f3e733b81f11d8656b0ee8cb0p-41Q, -0x1.6e142a138f824d787e78e664674ep-157Q},
+    {0x1.ae7f3e733b81f11d8656b0ee8cb0p-45Q, -0x1.6e142a138f824d787e78e664674ep-161Q},
+};
+
+#define QQ_INV_FACT(n) qq_inv_fact[(n) - 2]
+
+static qq_t
+qq_expm1_reduced(qq_t r)
+{
+    // expm1(r) for |r| <= ~ln2/2, accurate relative to the result
+    qq_t s, p;
+    __float128 q;
+    int n;
+
+    s = qq_mul_pow2(r, 0x1p-10Q);
+
+    q = QQ_INV_FACT(QQ_EXP_TERMS).hi;
+    for (n = QQ_EXP_TERMS - 1; n > QQ_EXP_QQ_TERMS; --n) {
+        q = qq_ffma(q, s.hi, QQ_INV_FACT(n).hi);
+    }
+    p = qq_from_quad(q);
+    for (; n >= 2; --n) {
+        p = qq_add(qq_mul(p, s), QQ_INV_FACT(n));
+    }
+    p = qq_add_q(qq_mul(p, s), 1);
+    p = qq_mul(p, s);
+
+    // 2p and p^2 never cancel as |p| < 1
+    for (n = 0; n < QQ_EXP_SQUARINGS; ++n) {
+        p = qq_add(qq_mul_pow2(p, 2), qq_sqr(p));
+    }
+    return p;
+}
+
+static qq_t
+qq_ldexp(qq_t a, int e)
+{
+    // a * 2^e, in two steps when 2^e itself is outside the normal range
+    if (e >= 1 - QDD_QUAD_BIAS && e <= QDD_QUAD_BIAS) {
+        return qq_mul_pow2(a, qdd_quad_pow2(e));
+    }
+    a = qq_mul_pow2(a, qdd_quad_pow2(e / 2));
+    return qq_mul_pow2(a, qdd_quad_pow2(e - e / 2));
+}
+
+static qq_t
+qq_sub_ln2(qq_t a, __float128 k)
+{
+    // a - k ln2 for integer k with |k| < 2^15. k C0 is exact and cancels
+    // exactly against a, so the small result keeps its full precision.
+    qq_t r;
+
+    if (k == 0) {
+        return a;
+    }
+    r = qq_add_q(a, -qq_fmul(k, qq_ln2_c0));
+    r = qq_sub(r, qq_mul_q(qq_from_quad(k), qq_ln2_c1));
+    return qq_add_q(r, -qq_fmul(k, qq_ln2_c2));
+}
+
+static qq_t
+qq_mul_ln2(__float128 k)
+{
+    qq_t r;
+
+    if (k == 0) {
+        return qq_from_quad(0);
+    }
+    r = qq_add(qq_from_quad(qq_fmul(k, qq_ln2_c0)), qq_from_quad(qq_fmul(k, qq_ln2_c2)));
+    return qq_add(r, qq_mul_q(qq_from_quad(k), qq_ln2_c1));
+}
+
+qq_t
+qq_exp(qq_t a)
+{
+    qq_t r, p;
+    double k;
+
+    if (!finiteq(a.hi)) {
+        return qq_special(expq(a.hi));
+    }
+    if (a.hi > QQ_EXP_MAX) {
+        return qq_special(HUGE_VALQ);
+    }
+    if (a.hi < QQ_EXP_MIN) {
+        return qq_special(0);
+    }
+
+    // k only has to be close to x/ln2, so a double is good enough
+    k = nearbyint((double)a.hi * qq_inv_ln2);
+    r = qq_sub_ln2(a, k);
+    p = qq_add_q(qq_expm1_reduced(r), 1);
+    p = qq_ldexp(p, (int)k);
+    return finiteq(p.hi) ? p : qq_special(HUGE_VALQ);
+}
+
+qq_t
+qq_log(qq_t a)
+{
+    qq_t m, x, corr;
+    __float128 x0;
+    int e;
+
+    if (!(a.hi > 0) || !finiteq(a.hi)) {
+        return qq_special(logq(a.hi));
+    }
+
+    // a = 2^e m with m in [sqrt(1/2), sqrt(2))
+    frexpq(a.hi, &e);
+    m = qq_ldexp(a, -e);
+    if (m.hi < M_SQRT1_2q) {
+        m = qq_mul_pow2(m, 2);
+        e -= 1;
+    }
+
+    // One Newton step x = x0 + m expm1(-x0) + (m - 1) from the quad log, as
+    // in qdd_log
+    x0 = logq(m.hi) + m.lo / m.hi;
+    corr = qq_add(qq_mul(m, qq_expm1_reduced(qq_from_quad(-x0))), qq_add_q(m, -1));
+    x = qq_add_q(corr, x0);
+
+    return qq_add(x, qq_mul_ln2(e));
+}
+
+qq_t
+qq_pow10(int n)
+{
+    // Binary powering; powers up to 10^48 are exact quads
+    qq_t r, b;
+    unsigned int u;
+
+    u = n < 0 ? -(unsigned int)n : (unsigned int)n;
+    r = qq_from_quad(1);
+    b = qq_from_quad(10);
+    while (u) {
+        if (u & 1) {
+            r = qq_mul(r, b);
+        }
+        u >>= 1;
+        if (u) {
+            b = qq_sqr(b);
+        }
+    }
+    if (n < 0) {
+        return qq_div(qq_from_quad(1), r);
+    }
+    return r;
+}
+
+static qq_t
+qq_scale10(qq_t a, int n)
+{
+    // a * 10^n, split in two so that 10^|n| itself stays finite
+    if (n > QQ_POW10_STEP) {
+        a = qq_mul(a, qq_pow10(QQ_POW10_STEP));
+        n -= QQ_POW10_STEP;
+    } else if (n < -QQ_POW10_STEP) {
+        a = qq_div(a, qq_pow10(QQ_POW10_STEP));
+        n += QQ_POW10_STEP;
+    }
+    if (n >= 0) {
+        return qq_ieee_mul(a, qq_pow10(n));
+    }
+    return qq_ieee_div(a, qq_pow10(-n));
+}
+
+bool
+qq_from_string(const char *s, qq_t *out)
+{
+    qq_t m;
+    __uint128_t chunk;
+    int chunk_len, ndigits, exp10, nexp;
+    bool neg, seen_digit, seen_point;
+
+    while (isspace((unsigned char)*s)) {
+        ++s;
+    }
+    neg = *s == '-';
+    if (*s == '-' || *s == '+') {
+        ++s;
+    }
+
+    // m holds the significant digits as an integer, exp10 the power of ten
+    // it is to be scaled by
+    m = qq_from_quad(0);
+    chunk = 0;
+    chunk_len = 0;
+    ndigits = 0;
+    exp10 = 0;
+    seen_digit = false;
+    seen_point = false;
+    for (;; ++s) {
+        if (*s == '.' && !seen_point) {
+            seen_point = true;
+            continue;
+        }
+        if (!isdigit((unsigned char)*s)) {
+            break;
+        }
+        seen_digit = true;
+        if (ndigits == 0 && *s == '0') {
+            if (seen_point) {
+                exp10 -= 1;
+            }
+            continue;
+        }
+        if (ndigits >= QQ_PARSE_DIGITS) {
+            if (!seen_point) {
+                exp10 += 1;
+            }
+            continue;
+        }
+        chunk = chunk * 10 + (unsigned int)(*s - '0');
+        chunk_len += 1;
+        ndigits += 1;
+        if (seen_point) {
+            exp10 -= 1;
+        }
+        if (chunk_len == QQ_PARSE_CHUNK) {
+            m = qq_add_q(qq_mul_q(m, qq_pow10(QQ_PARSE_CHUNK).hi), (__float128)chunk);
+            chunk = 0;
+            chunk_len = 0;
+        }
+    }
+    if (!seen_digit) {
+        return false;
+    }
+    if (chunk_len) {
+        m = qq_add_q(qq_mul_q(m, qq_pow10(chunk_len).hi), (__float128)chunk);
+    }
+
+    if (*s == 'e' || *s == 'E') {
+        bool eneg;
+
+        ++s;
+        eneg = *s == '-';
+        if (*s == '-' || *s == '+') {
+            ++s;
+        }
+        if (!isdigit((unsigned char)*s)) {
+            return false;
+        }
+        nexp = 0;
+        for (; isdigit((unsigned char)*s); ++s) {
+            if (nexp < QQ_PARSE_MAX_EXP) {
+                nexp = nexp * 10 + (*s - '0');
+            }
+        }
+        exp10 += eneg ? -nexp : nexp;
+    }
+
+    while (isspace((unsigned char)*s)) {
+        ++s;
+    }
+    if (*s != '\0') {
+        return false;
+    }
+
+    if (m.hi != 0) {
+        // Anything this far out is Inf or 0 whatever the digits
+        if (exp10 > QQ_PARSE_MAX_EXP / 2) {
+            exp10 = QQ_PARSE_MAX_EXP / 2;
+        } else if (exp10 < -QQ_PARSE_MAX_EXP / 2) {
+            exp10 = -QQ_PARSE_MAX_EXP / 2;
+        }
+        if (exp10 > 2 * QQ_POW10_STEP) {
+            m = qq_special(HUGE_VALQ);
+        } else if (exp10 < -2 * QQ_POW10_STEP) {
+            m = qq_from_quad(0);
+        } else {
+            m = qq_scale10(m, exp10);
+        }
+    }
+    *out = neg ? qq_neg(m) : m;
+    return true;
+}
+
+int
+qq_to_string(char *buf, size_t size, qq_t a, int ndigits)
+{
+    // Digits come from repeatedly taking the integer part of r in [1, 10)
+    // and multiplying the rest by 10, with one guard digit for rounding.
+    // The truncated digits can be off by one where hi is an integer and lo
+    // is negative, that is fixed up when propagating the carries.
+    char digits[QQ_PARSE_DIGITS + 3];
+    char out[QQ_PARSE_DIGITS + 16];
+    qq_t r;
+    int i, e, d, pos;
+    bool neg;
+
+    if (ndigits < 1) {
+        ndigits = 1;
+    } else if (ndigits > QQ_PARSE_DIGITS) {
+        ndigits = QQ_PARSE_DIGITS;
+    }
+
+    neg = signbitq(a.hi) != 0;
+    if (isnanq(a.hi)) {
+        return snprintf(buf, size, "nan");
+    }
+    if (isinfq(a.hi)) {
+        return snprintf(buf, size, neg ? "-inf" : "inf");
+    }
+
+    r = neg ? qq_neg(a) : a;
+    if (r.hi == 0) {
+        e = 0;
+        memset(digits, 0, sizeof(digits));
+    } else {
+        e = (int)floorq(log10q(r.hi));
+        r = qq_scale10(r, -e);
+        if (r.hi >= 10) {
+            r = qq_div(r, qq_from_quad(10));
+            e += 1;
+        } else if (r.hi < 1) {
+            r = qq_mul_q(r, 10);
+            e -= 1;
+        }
+
+        for (i = 0; i <= ndigits + 1; ++i) {
+            d = (int)r.hi;
+            digits[i] = (char)d;
+            r = qq_mul_q(qq_add_q(r, -(__float128)d), 10);
+        }
+
+        for (i = ndigits + 1; i > 0; --i) {
+            if (digits[i] < 0) {
+                digits[i] += 10;
+                digits[i - 1] -= 1;
+            } else if (digits[i] > 9) {
+                digits[i] -= 10;
+                digits[i - 1] += 1;
+            }
+        }
+        if (digits[0] == 0) {
+            // Leading digit lost to the fix up, shift everything up one
+            memmove(digits, digits + 1, (size_t)ndigits + 1);
+            e -= 1;
+        }
+
+        // Round on the guard digit
+        if (digits[ndigits] >= 5) {
+            for (i = ndigits - 1; i >= 0; --i) {
+                digits[i] += 1;
+                if (digits[i] < 10 || i == 0) {
+                    break;
+                }
+                digits[i] = 0;
+            }
+        }
+        if (digits[0] > 9) {
+            digits[0] = 1;
+            e += 1;
+        }
+    }
+
+    pos = 0;
+    if (neg) {
+        out[pos++] = '-';
+    }
+    out[pos++] = (char)('0' + digits[0]);
+    if (ndigits > 1) {
+        out[pos++] = '.';
+        for (i = 1; i < ndigits; ++i) {
+            out[pos++] = (char)('0' + digits[i]);
+        }
+    }
+    out[pos] = '\0';
+    return snprintf(buf, size, "%se%c%02d", out, e < 0 ? '-' : '+', e < 0 ? -e : e);
+}
@@ -0,0 +1,530 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+#include "pyquadp.h"
+
+#include "qsoftquad.h"
+
+// Quad-double primitives: the unevaluated sum hi + lo of two __float128 with
+// |lo| <= ulp(hi)/2, giving ~226 bits (~68 decimal digits) of precision.
+//
+// The error-free transformations below need every quad operation to be
+// correctly rounded, so they go through the inline qsq_* kernels and fall
+// back to the C operators and fmaq for zeros, subnormals and non-finite
+// values, both of which round identically.
+
+typedef struct {
+    __float128 hi;
+    __float128 lo;
+} qq_t;
+
+// Correctly rounded quad operations
+
+static inline __float128
+qq_fadd(__float128 a, __float128 b)
+{
+    __float128 r;
+
+    if (!qsq_add(a, b, &r)) {
+        r = a + b;
+    }
+    return r;
+}
+
+static inline __float128
+qq_fsub(__float128 a, __float128 b)
+{
+    __float128 r;
+
+    if (!qsq_sub(a, b, &r)) {
+        r = a - b;
+    }
+    return r;
+}
+
+static inline __float128
+qq_fmul(__float128 a, __float128 b)
+{
+    __float128 r;
+
+    if (!qsq_mul(a, b, &r)) {
+        r = a * b;
+    }
+    return r;
+}
+
+static inline __float128
+qq_ffma(__float128 a, __float128 b, __float128 c)
+{
+    __float128 r;
+
+    if (!qsq_fma(a, b, c, &r)) {
+        r = fmaq(a, b, c);
+    }
+    return r;
+}
+
+// Error-free transformations
+
+static inline qq_t
+qq_two_sum(__float128 a, __float128 b)
+{
+    qq_t r;
+    __float128 bb;
+
+    r.hi = qq_fadd(a, b);
+    bb = qq_fsub(r.hi, a);
+    r.lo = qq_fadd(qq_fsub(a, qq_fsub(r.hi, bb)), qq_fsub(b, bb));
+    return r;
+}
+
+static inline qq_t
+qq_fast_two_sum(__float128 a, __float128 b)
+{
+    // Requires |a| >= |b| (or a == 0). A zero b leaves a as is, which keeps
+    // the sign of a -0 leading part.
+    qq_t r;
+
+    r.hi = b == 0 ? a : qq_fadd(a, b);
+    r.lo = qq_fsub(b, qq_fsub(r.hi, a));
+    return r;
+}
+
+static inline qq_t
+qq_two_prod(__float128 a, __float128 b)
+{
+    qq_t r;
+
+    r.hi = qq_fmul(a, b);
+    r.lo = qq_ffma(a, b, -r.hi);
+    return r;
+}
+
+// Fixed-point window accumulator
+//
+// The fast paths below sum quads and exact quad products into a 256-bit
+// two's complement integer, then round once to a normalised pair. That is
+// one pass of integer work in place of the dozen dependent quad operations
+// of the error-free transformations, which stay as the fallback for zeros,
+// subnormals, non-finite values and deep cancellation.
+
+typedef struct {
+    qsq_u256 s;
+    int scale;      // biased exponent of bit 0
+    bool inexact;   // bits fell below bit 0
+} qq_acc;
+
+static inline void
+qq_acc_init(qq_acc *acc, int top)
+{
+    // top is the biased exponent of the largest term, which lands on bit
+    // 252 and leaves headroom for the carries of a few more
+    acc->s.hi = 0;
+    acc->s.lo = 0;
+    acc->scale = top - 252;
+    acc->inexact = false;
+}
+
+static inline qsq_u256
+qq_acc_shift(qq_acc *acc, qsq_u256 t, int k)
+{
+    // Scale t by 2^k, truncating (and noting it) when k is negative
+    qsq_u256 lost;
+
+    if (k >= 0) {
+        return qsq_u256_shl(t, k);
+    }
+    k = -k;
+    if (k >= 256) {
+        acc->inexact = true;
+        t.hi = 0;
+        t.lo = 0;
+        return t;
+    }
+    lost = qsq_u256_shl(t, 256 - k);
+    acc->inexact |= (lost.hi | lost.lo) != 0;
+    if (k >= 128) {
+        t.lo = k == 128 ? t.hi : t.hi >> (k - 128);
+        t.hi = 0;
+    } else {
+        t.lo = (t.lo >> k) | (t.hi << (128 - k));
+        t.hi >>= k;
+    }
+    return t;
+}
+
+static inline void
+qq_acc_put(qq_acc *acc, qsq_u256 t, bool negative)
+{
+    acc->s = negative ? qsq_u256_sub(acc->s, t) : qsq_u256_add(acc->s, t);
+}
+
+static inline bool
+qq_acc_add(qq_acc *acc, __float128 x, bool negate)
+{
+    qdd_quad_bits b = {.f = x};
+    qsq_u256 t = {0, 0};
+    int e, k;
+
+    if ((b.u << 1) == 0) {
+        return true;
+    }
+    if (!qsq_unpack(b.u, &e, &t.lo)) {
+        return false;
+    }
+    k = e - QSQ_MANT_BITS - acc->scale;
+    if (k > 140) {
+        return false;
+    }
+    qq_acc_put(acc, qq_acc_shift(acc, t, k), (bool)(b.u >> 127) != negate);
+    return true;
+}
+
+static inline bool
+qq_acc_add_prod(qq_acc *acc, __float128 x, __float128 y, bool negate)
+{
+    // Adds the exact product x*y
+    qdd_quad_bits bx = {.f = x}, by = {.f = y};
+    __uint128_t mx, my;
+    int ex, ey, k;
+
+    if ((bx.u << 1) == 0 || (by.u << 1) == 0) {
+        return true;
+    }
+    if (!qsq_unpack(bx.u, &ex, &mx) || !qsq_unpack(by.u, &ey, &my)) {
+        return false;
+    }
+    k = ex + ey - QDD_QUAD_BIAS - 2 * QSQ_MANT_BITS - acc->scale;
+    if (k > 27) {
+        return false;
+    }
+    qq_acc_put(acc, qq_acc_shift(acc, qsq_mul_113(mx, my), k),
+               (bool)((bx.u ^ by.u) >> 127) != negate);
+    return true;
+}
+
+static inline bool
+qq_acc_round(qq_acc *acc, int need, __float128 *hi, __float128 *lo)
+{
+    // Round the sum to hi + lo. When bits were dropped the sum must still
+    // carry need significant bits above bit 0 for the pair to be accurate.
+    const __uint128_t low15 = ((__uint128_t)1 << 15) - 1;
+    qdd_quad_bits r;
+    qsq_u256 s = acc->s, rem;
+    __uint128_t sign = 0, h, m;
+    unsigned int up;
+    int lz, eh, pos;
+
+    if (s.hi >> 127) {
+        s = qsq_u256_sub((qsq_u256){0, 0}, s);
+        sign = (__uint128_t)1 << 127;
+    }
+    if ((s.hi | s.lo) == 0) {
+        if (acc->inexact) {
+            return false;
+        }
+        *hi = 0;
+        *lo = 0;
+        return true;
+    }
+    lz = qsq_u256_clz(s);
+    if (acc->inexact && 255 - lz < need) {
+        return false;
+    }
+    s = qsq_u256_shl(s, lz);
+
+    // Top 113 bits to hi, round to nearest even on the 143 bits below
+    h = s.hi >> 15;
+    rem.hi = s.hi & low15;
+    rem.lo = s.lo;
+    up = (unsigned int)(rem.hi >> 14) & (unsigned int)((rem.hi & (low15 >> 1)) != 0 || rem.lo != 0 || (h & 1));
+    h += up;
+    eh = acc->scale - lz + 143 + QSQ_MANT_BITS;
+    if (h >> (QSQ_MANT_BITS + 1)) {
+        h >>= 1;
+        eh++;
+    }
+    if (eh <= 0 || eh >= QSQ_EXP_MASK) {
+        return false;
+    }
+    r.u = sign | ((__uint128_t)eh << QSQ_MANT_BITS) | (h & QSQ_MANT_MASK);
+    *hi = r.f;
+
+    // The remainder, negated when hi was rounded up, is exactly representable
+    // bar the bits below the 113 we keep
+    if (up) {
+        rem = qsq_u256_sub((qsq_u256){(__uint128_t)1 << 15, 0}, rem);
+        sign ^= (__uint128_t)1 << 127;
+    }
+    if ((rem.hi | rem.lo) == 0) {
+        *lo = 0;
+        return true;
+    }
+    pos = 255 - qsq_u256_clz(rem);
+    eh = acc->scale - lz + pos;
+    if (pos > QSQ_MANT_BITS) {
+        // At most 31 bits to drop, all of them in rem.lo
+        int d = pos - QSQ_MANT_BITS;
+
+        m = (rem.lo >> d) | (rem.hi << (128 - d));
+        return qsq_round_pack(sign, eh, m, (unsigned int)(rem.lo >> (d - 1)) & 1,
+                              (rem.lo & ((((__uint128_t)1) << (d - 1)) - 1)) != 0, lo);
+    }
+    m = rem.lo << (QSQ_MANT_BITS - pos);
+    return qsq_round_pack(sign, eh, m, 0, false, lo);
+}
+
+// Quad-double arithmetic
+//
+// Each operation tries the accumulator first and falls back to the
+// error-free transformations, which handle every finite input.
+
+static inline int
+qq_exponent(__float128 x)
+{
+    qdd_quad_bits b = {.f = x};
+
+    return (int)((b.u >> QSQ_MANT_BITS) & QSQ_EXP_MASK);
+}
+
+static inline qq_t
+qq_from_quad(__float128 a)
+{
+    qq_t r = {a, 0};
+    return r;
+}
+
+static inline qq_t
+qq_add_eft(qq_t a, qq_t b)
+{
+    qq_t s, t;
+
+    s = qq_two_sum(a.hi, b.hi);
+    t = qq_two_sum(a.lo, b.lo);
+    s.lo = qq_fadd(s.lo, t.hi);
+    s = qq_fast_two_sum(s.hi, s.lo);
+    s.lo = qq_fadd(s.lo, t.lo);
+    return qq_fast_two_sum(s.hi, s.lo);
+}
+
+static inline qq_t
+qq_add(qq_t a, qq_t b)
+{
+    qq_acc acc;
+    qq_t r;
+    int ea = qq_exponent(a.hi), eb = qq_exponent(b.hi);
+
+    if (ea | eb) {
+        qq_acc_init(&acc, ea > eb ? ea : eb);
+        if (qq_acc_add(&acc, a.hi, false) && qq_acc_add(&acc, b.hi, false) &&
+            qq_acc_add(&acc, a.lo, false) && qq_acc_add(&acc, b.lo, false) &&
+            qq_acc_round(&acc, 232, &r.hi, &r.lo)) {
+            return r;
+        }
+    }
+    return qq_add_eft(a, b);
+}
+
+static inline qq_t
+qq_add_q(qq_t a, __float128 b)
+{
+    return qq_add(a, qq_from_quad(b));
+}
+
+static inline qq_t
+qq_neg(qq_t a)
+{
+    qq_t r = {-a.hi, -a.lo};
+    return r;
+}
+
+static inline qq_t
+qq_sub(qq_t a, qq_t b)
+{
+    return qq_add(a, qq_neg(b));
+}
+
+static inline qq_t
+qq_mul_eft(qq_t a, qq_t b)
+{
+    qq_t p;
+
+    p = qq_two_prod(a.hi, b.hi);
+    p.lo = qq_ffma(a.hi, b.lo, p.lo);
+    p.lo = qq_ffma(a.lo, b.hi, p.lo);
+    return qq_fast_two_sum(p.hi, p.lo);
+}
+
+static inline qq_t
+qq_mul(qq_t a, qq_t b)
+{
+    // a.lo*b.lo sits below the last bit kept and is dropped, as in qdd_mul
+    qq_acc acc;
+    qq_t r;
+    int ea = qq_exponent(a.hi), eb = qq_exponent(b.hi);
+
+    if (ea && eb) {
+        qq_acc_init(&acc, ea + eb - QDD_QUAD_BIAS + 1);
+        if (qq_acc_add_prod(&acc, a.hi, b.hi, false) &&
+            qq_acc_add_prod(&acc, a.hi, b.lo, false) &&
+            qq_acc_add_prod(&acc, a.lo, b.hi, false) &&
+            qq_acc_round(&acc, 232, &r.hi, &r.lo)) {
+            return r;
+        }
+    }
+    return qq_mul_eft(a, b);
+}
+
+static inline qq_t
+qq_mul_q(qq_t a, __float128 b)
+{
+    return qq_mul(a, qq_from_quad(b));
+}
+
+static inline qq_t
+qq_sqr(qq_t a)
+{
+    return qq_mul(a, a);
+}
+
+static inline qq_t
+qq_div_eft(qq_t a, qq_t b)
+{
+    // Quotient digit from the quads, then one correction from the exact
+    // remainder, as in qdd_div
+    qq_t p;
+    __float128 q, e;
+
+    q = a.hi / b.hi;
+    p = qq_two_prod(q, b.hi);
+    e = qq_fsub(qq_fadd(qq_fsub(qq_fsub(a.hi, p.hi), p.lo), a.lo), qq_fmul(q, b.lo));
+    return qq_fast_two_sum(q, e / b.hi);
+}
+
+static inline qq_t
+qq_div(qq_t a, qq_t b)
+{
+    // The remainder a - q*b only needs rounding to a quad for the correction
+    qq_acc acc;
+    qq_t r;
+    __float128 q = a.hi / b.hi;
+    int ea = qq_exponent(a.hi), eq = qq_exponent(q);
+
+    if (ea && eq) {
+        qq_acc_init(&acc, ea + 1);
+        if (qq_acc_add(&acc, a.hi, false) && qq_acc_add(&acc, a.lo, false) &&
+            qq_acc_add_prod(&acc, q, b.hi, true) &&
+            qq_acc_add_prod(&acc, q, b.lo, true) &&
+            qq_acc_round(&acc, 120, &r.hi, &r.lo)) {
+            return qq_add(qq_from_quad(q), qq_from_quad(r.hi / b.hi));
+        }
+    }
+    return qq_div_eft(a, b);
+}
+
+static inline qq_t
+qq_sqrt(qq_t a)
+{
+    // One Newton step from the correctly rounded quad square root
+    qq_acc acc;
+    qq_t r;
+    __float128 s;
+
+    if (a.hi <= 0) {
+        r.hi = a.hi == 0 ? a.hi : nanq("");
+        r.lo = 0;
+        return r;
+    }
+    s = sqrtq(a.hi);
+    qq_acc_init(&acc, qq_exponent(a.hi) + 1);
+    if (!(qq_acc_add(&acc, a.hi, false) && qq_acc_add(&acc, a.lo, false) &&
+          qq_acc_add_prod(&acc, s, s, true) &&
+          qq_acc_round(&acc, 120, &r.hi, &r.lo))) {
+        r = qq_add_eft(a, qq_neg(qq_two_prod(s, s)));
+    }
+    return qq_add(qq_from_quad(s), qq_from_quad(r.hi / qq_fadd(s, s)));
+}
+
+static inline qq_t
+qq_mul_pow2(qq_t a, __float128 p)
+{
+    // Exact scaling by a power of two p, barring overflow and underflow
+    qq_t r = {qq_fmul(a.hi, p), qq_fmul(a.lo, p)};
+    return r;
+}
+
+static inline qq_t
+qq_special(__float128 hi)
+{
+    // The quad-double form of a non-finite result
+    qq_t r = {hi, 0};
+    return r;
+}
+
+static inline bool
+qq_lt(qq_t a, qq_t b)
+{
+    // Normalised pairs order on hi first and then on lo
+    return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+// Elementary functions, accurate to a few units in the last place of a
+// quad-double (~2^-222 relative). NaN, Inf and overflow/underflow follow
+// libquadmath.
+
+qq_t qq_exp(qq_t a);
+qq_t qq_log(qq_t a);
+
+// 10^n to quad-double precision
+qq_t qq_pow10(int n);
+
+// Parse a decimal or "inf"/"nan" string; returns false on a syntax error
+bool qq_from_string(const char *s, qq_t *out);
+
+// Write a in scientific notation with ndigits significant digits, returns
+// the length as snprintf does
+int qq_to_string(char *buf, size_t size, qq_t a, int ndigits);
+
+// Arithmetic with IEEE behaviour for non-finite results, the quad-double
+// counterparts of qdd_ieee_*
+
+static inline qq_t
+qq_ieee_add(qq_t a, qq_t b)
+{
+    qq_t r = qq_add(a, b);
+    return finiteq(r.hi) ? r : qq_special(a.hi + b.hi);
+}
+
+static inline qq_t
+qq_ieee_sub(qq_t a, qq_t b)
+{
+    qq_t r = qq_sub(a, b);
+    return finiteq(r.hi) ? r : qq_special(a.hi - b.hi);
+}
+
+static inline qq_t
+qq_ieee_mul(qq_t a, qq_t b)
+{
+    qq_t r = qq_mul(a, b);
+    return finiteq(r.hi) ? r : qq_special(a.hi * b.hi);
+}
+
+static inline qq_t
+qq_ieee_div(qq_t a, qq_t b)
+{
+    qq_t r;
+
+    if (!finiteq(a.hi) || !finiteq(b.hi) || b.hi == 0) {
+        return qq_special(a.hi / b.hi);
+    }
+    r = qq_div(a, b);
+    return finiteq(r.hi) ? r : qq_special(a.hi / b.hi);
+}
+
+static inline qq_t
+qq_ieee_sqrt(qq_t a)
+{
+    if (!finiteq(a.hi)) {
+        return qq_special(sqrtq(a.hi));
+    }
+    return qq_sqrt(a);
+}
@@ -0,0 +1,758 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+// Trims the Windows headers to what the thread pool needs
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "qreduce.h"
+#include "qsoftquad.h"
+
+typedef struct {
+    void (*task)(void *, size_t);
+    void *ctx;
+    size_t ntasks;
+    size_t first;
+    size_t stride;
+} qreduce_worker;
+
+int
+qreduce_cpu_count(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors < 1 ? 1 : (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return n < 1 ? 1 : (int)n;
+#endif
+}
+
+static void *
+qreduce_worker_main(void *arg)
+{
+    qreduce_worker *w = (qreduce_worker *)arg;
+    size_t i;
+
+    for (i = w->first; i < w->ntasks; i += w->stride) {
+        w->task(w->ctx, i);
+    }
+    return NULL;
+}
+
+// Native threads on Windows, so MinGW builds need no pthread library
+
+#ifdef _WIN32
+typedef HANDLE qreduce_thread;
+
+static DWORD WINAPI
+qreduce_worker_thread(LPVOID arg)
+{
+    qreduce_worker_main(arg);
+    return 0;
+}
+
+static bool
+qreduce_thread_start(qreduce_thread *id, qreduce_worker *w)
+{
+    *id = CreateThread(NULL, 0, qreduce_worker_thread, w, 0, NULL);
+    return *id != NULL;
+}
+
+static void
+qreduce_thread_join(qreduce_thread id)
+{
+    WaitForSingleObject(id, INFINITE);
+    CloseHandle(id);
+}
+#else
+typedef pthread_t qreduce_thread;
+
+static bool
+qreduce_thread_start(qreduce_thread *id, qreduce_worker *w)
+{
+    return pthread_create(id, NULL, qreduce_worker_main, w) == 0;
+}
+
+static void
+qreduce_thread_join(qreduce_thread id)
+{
+    pthread_join(id, NULL);
+}
+#endif
+
+void
+qreduce_parallel_for(size_t ntasks, int threads, void (*task)(void *, size_t), void *ctx)
+{
+    qreduce_worker *workers;
+    qreduce_thread *ids;
+    bool *started;
+    size_t nthreads, t;
+
+    nthreads = threads < 1 ? 1 : (size_t)threads;
+    if (nthreads > ntasks) {
+        nthreads = ntasks;
+    }
+    if (nthreads <= 1) {
+        for (t = 0; t < ntasks; ++t) {
+            task(ctx, t);
+        }
+        return;
+    }
+
+    workers = malloc(nthreads * sizeof(*workers));
+    ids = malloc(nthreads * sizeof(*ids));
+    started = calloc(nthreads, sizeof(*started));
+    if (workers == NULL || ids == NULL || started == NULL) {
+        free(workers);
+        free(ids);
+        free(started);
+        for (t = 0; t < ntasks; ++t) {
+            task(ctx, t);
+        }
+        return;
+    }
+
+    for (t = 0; t < nthreads; ++t) {
+        workers[t].task = task;
+        workers[t].ctx = ctx;
+        workers[t].ntasks = ntasks;
+        workers[t].first = t;
+        workers[t].stride = nthreads;
+    }
+    for (t = 1; t < nthreads; ++t) {
+        started[t] = qreduce_thread_start(&ids[t], &workers[t]);
+    }
+
+    // The calling thread takes the first share and any that failed to start
+    qreduce_worker_main(&workers[0]);
+    for (t = 1; t < nthreads; ++t) {
+        if (started[t]) {
+            qreduce_thread_join(ids[t]);
+        } else {
+            qreduce_worker_main(&workers[t]);
+        }
+    }
+
+    free(workers);
+    free(ids);
+    free(started);
+}
+
+
+static inline __float128
+qreduce_add(__float128 a, __float128 b)
+{
+    __float128 r;
+
+    if (!qsq_add(a, b, &r)) {
+        r = a + b;
+    }
+    return r;
+}
+
+static inline __float128
+qreduce_mul(__float128 a, __float128 b)
+{
+    __float128 r;
+
+    if (!qsq_mul(a, b, &r)) {
+        r = a * b;
+    }
+    return r;
+}
+
+static inline __float128
+qreduce_mul_double(double a, double b)
+{
+    // The 106 bit product of two doubles fits in binary128, so for normal
+    // inputs the significands are multiplied and packed without rounding
+    qdd_double_bits x, y;
+    qdd_quad_bits r;
+    uint64_t ea, eb;
+    __uint128_t p;
+    int lead;
+
+    x.f = a;
+    y.f = b;
+    ea = (x.u >> 52) & 0x7ff;
+    eb = (y.u >> 52) & 0x7ff;
+    if (ea == 0 || ea == 0x7ff || eb == 0 || eb == 0x7ff) {
+        return (__float128)a * (__float128)b;
+    }
+    p = (__uint128_t)((x.u & 0xfffffffffffffULL) | (1ULL << 52)) * ((y.u & 0xfffffffffffffULL) | (1ULL << 52));
+    lead = 104 + (int)(p >> 105);
+    r.u = ((__uint128_t)((x.u ^ y.u) >> 63) << 127)
+        | ((__uint128_t)(ea + eb - 2 * QDD_DOUBLE_BIAS + (uint64_t)(lead - 104) + QDD_QUAD_BIAS) << 112)
+        | ((p << (112 - lead)) & QSQ_MANT_MASK);
+    return r.f;
+}
+
+static inline __float128
+qreduce_load(const char *p, qreduce_kind kind, size_t i)
+{
+    if (kind == QREDUCE_FLOAT64) {
+        return qdd_double_to_quad(((const double *)p)[i]);
+    }
+    return ((const __float128 *)p)[i];
+}
+
+static inline void
+qreduce_store(void *out, qreduce_kind kind, size_t i, __float128 v)
+{
+    if (kind == QREDUCE_FLOAT64) {
+        ((double *)out)[i] = qdd_quad_to_double(v);
+    } else {
+        ((__float128 *)out)[i] = v;
+    }
+}
+
+// Quad accumulation, used whenever an operand is not float64. y == NULL
+// sums x. Four independent accumulators hide the latency of each addition.
+
+typedef struct {
+    const char *x;
+    const char *y;
+    qreduce_kind xkind;
+    qreduce_kind ykind;
+    size_t n;
+    __float128 *partial;
+} qreduce_quad_job;
+
+static __float128
+qreduce_quad_range(const char *x, qreduce_kind xkind, const char *y, qreduce_kind ykind, size_t begin, size_t end)
+{
+    __float128 acc[4] = {0, 0, 0, 0};
+    size_t i, j;
+
+    for (i = begin; i + 4 <= end; i += 4) {
+        for (j = 0; j < 4; ++j) {
+            __float128 term = qreduce_load(x, xkind, i + j);
+
+            if (y != NULL) {
+                term = qreduce_mul(term, qreduce_load(y, ykind, i + j));
+            }
+            acc[j] = qreduce_add(acc[j], term);
+        }
+    }
+    for (; i < end; ++i) {
+        __float128 term = qreduce_load(x, xkind, i);
+
+        if (y != NULL) {
+            term = qreduce_mul(term, qreduce_load(y, ykind, i));
+        }
+        acc[0] = qreduce_add(acc[0], term);
+    }
+    return qreduce_add(qreduce_add(acc[0], acc[1]), qreduce_add(acc[2], acc[3]));
+}
+
+static void
+qreduce_quad_task(void *ctx, size_t chunk)
+{
+    qreduce_quad_job *job = (qreduce_quad_job *)ctx;
+    size_t begin = chunk * QREDUCE_CHUNK;
+    size_t end = begin + QREDUCE_CHUNK < job->n ? begin + QREDUCE_CHUNK : job->n;
+
+    job->partial[chunk] = qreduce_quad_range(job->x, job->xkind, job->y, job->ykind, begin, end);
+}
+
+static int
+qreduce_quad(const char *x, qreduce_kind xkind, const char *y, qreduce_kind ykind, size_t n, int threads,
+             __float128 *out)
+{
+    // Chunks are always combined in order, threaded or not
+    qreduce_quad_job job = {.x = x, .y = y, .xkind = xkind, .ykind = ykind, .n = n};
+    size_t nchunks = (n + QREDUCE_CHUNK - 1) / QREDUCE_CHUNK;
+    __float128 total;
+    size_t i;
+
+    if (nchunks == 0) {
+        *out = 0;
+        return 0;
+    }
+    if (threads <= 1 || nchunks == 1) {
+        total = qreduce_quad_range(x, xkind, y, ykind, 0, n < QREDUCE_CHUNK ? n : QREDUCE_CHUNK);
+        for (i = 1; i < nchunks; ++i) {
+            total = qreduce_add(total, qreduce_quad_range(x, xkind, y, ykind, i * QREDUCE_CHUNK,
+                                                          (i + 1) * QREDUCE_CHUNK < n ? (i + 1) * QREDUCE_CHUNK : n));
+        }
+        *out = total;
+        return 0;
+    }
+
+    job.partial = malloc(nchunks * sizeof(__float128));
+    if (job.partial == NULL) {
+        return -1;
+    }
+    qreduce_parallel_for(nchunks, threads, qreduce_quad_task, &job);
+
+    total = job.partial[0];
+    for (i = 1; i < nchunks; ++i) {
+        total = qreduce_add(total, job.partial[i]);
+    }
+    free(job.partial);
+    *out = total;
+    return 0;
+}
+
+// float64 data is summed exactly instead. Every finite term is an integer
+// times 2^(k - QREDUCE_EXACT_OFFSET), and is added to a 128 bit bin for its
+// k, so the bins hold the exact sum whatever the order and no bin can
+// overflow before 2^74 terms. Products of two float64 values are 106 bit
+// integers and go into two bins, 53 bits apart. Inf and NaN terms are kept
+// to one side in ordinary quad arithmetic.
+#define QREDUCE_EXACT_OFFSET 2150
+#define QREDUCE_EXACT_BINS 4160
+#define QREDUCE_EXACT_LIMBS ((QREDUCE_EXACT_BINS + 128) / 64 + 2)
+#define QREDUCE_DOUBLE_MANT ((1ULL << 52) - 1)
+
+typedef struct {
+    __int128 bin[QREDUCE_EXACT_BINS];
+    __float128 special;
+    // Bins outside [lo, hi] are zero
+    int lo;
+    int hi;
+} qreduce_exact;
+
+static qreduce_exact *
+qreduce_exact_new(void)
+{
+    qreduce_exact *acc = calloc(1, sizeof(qreduce_exact));
+
+    if (acc != NULL) {
+        acc->lo = QREDUCE_EXACT_BINS;
+        acc->hi = -1;
+    }
+    return acc;
+}
+
+static void
+qreduce_exact_reset(qreduce_exact *acc)
+{
+    if (acc->lo <= acc->hi) {
+        memset(&acc->bin[acc->lo], 0, (size_t)(acc->hi - acc->lo + 1) * sizeof(acc->bin[0]));
+    }
+    acc->special = 0;
+    acc->lo = QREDUCE_EXACT_BINS;
+    acc->hi = -1;
+}
+
+static inline bool
+qreduce_decode(double d, uint64_t *m, int *e, int64_t *sign)
+{
+    // d = m * 2^(e - 1075) for finite d, sign is 0 or -1
+    qdd_double_bits b = {.f = d};
+
+    *e = (int)((b.u >> 52) & 0x7ff);
+    *m = b.u & QREDUCE_DOUBLE_MANT;
+    *sign = -(int64_t)(b.u >> 63);
+    if (*e == 0x7ff) {
+        return false;
+    }
+    if (*e == 0) {
+        *e = 1;
+    } else {
+        *m |= 1ULL << 52;
+    }
+    return true;
+}
+
+static void
+qreduce_exact_add(qreduce_exact *acc, const double *x, const double *y, size_t begin, size_t end)
+{
+    // y == NULL sums x
+    int lo = acc->lo;
+    int hi = acc->hi;
+    size_t i;
+    uint64_t ma, mb;
+    int64_t sa, sb, sign;
+    int ea, eb, k;
+    __uint128_t p;
+
+    if (y == NULL) {
+        for (i = begin; i < end; ++i) {
+            if (!qreduce_decode(x[i], &ma, &ea, &sa)) {
+                acc->special += (__float128)x[i];
+                continue;
+            }
+            k = ea + 1075;
+            acc->bin[k] += (__int128)(((int64_t)ma ^ sa) - sa);
+            lo = k < lo ? k : lo;
+            hi = k > hi ? k : hi;
+        }
+    } else {
+        for (i = begin; i < end; ++i) {
+            if (!qreduce_decode(x[i], &ma, &ea, &sa) || !qreduce_decode(y[i], &mb, &eb, &sb)) {
+                acc->special += (__float128)x[i] * (__float128)y[i];
+                continue;
+            }
+            p = (__uint128_t)ma * mb;
+            sign = sa ^ sb;
+            k = ea + eb;
+            acc->bin[k] += (__int128)((((int64_t)p & (int64_t)((1ULL << 53) - 1)) ^ sign) - sign);
+            acc->bin[k + 53] += (__int128)(((int64_t)(p >> 53) ^ sign) - sign);
+            lo = k < lo ? k : lo;
+            hi = k + 53 > hi ? k + 53 : hi;
+        }
+    }
+    acc->lo = lo;
+    acc->hi = hi;
+}
+
+static void
+qreduce_exact_merge(qreduce_exact *dst, const qreduce_exact *src)
+{
+    int k;
+
+    for (k = src->lo; k <= src->hi; ++k) {
+        dst->bin[k] += src->bin[k];
+    }
+    dst->lo = src->lo < dst->lo ? src->lo : dst->lo;
+    dst->hi = src->hi > dst->hi ? src->hi : dst->hi;
+    dst->special += src->special;
+}
+
+static void
+qreduce_limbs_add(uint64_t *limbs, __uint128_t v, int bit)
+{
+    // limbs += v * 2^bit
+    int w = bit / 64;
+    int off = bit % 64;
+    uint64_t parts[3];
+    __uint128_t carry = 0;
+    int i;
+
+    parts[0] = (uint64_t)v << off;
+    parts[1] = (uint64_t)(off ? v >> (64 - off) : v >> 64);
+    parts[2] = off ? (uint64_t)(v >> (128 - off)) : 0;
+    for (i = 0; w + i < QREDUCE_EXACT_LIMBS; ++i) {
+        carry += (__uint128_t)limbs[w + i] + (i < 3 ? parts[i] : 0);
+        limbs[w + i] = (uint64_t)carry;
+        carry >>= 64;
+        if (i >= 2 && carry == 0) {
+            break;
+        }
+    }
+}
+
+static inline int
+qreduce_limbs_bit(const uint64_t *limbs, int bit)
+{
+    return bit < 0 ? 0 : (int)((limbs[bit / 64] >> (bit % 64)) & 1);
+}
+
+static __float128
+qreduce_exact_round(const qreduce_exact *acc, bool odd)
+{
+    // Collect positive and negative bins as two big integers, subtract and
+    // round the difference once to binary128. Rounding to odd instead keeps
+    // a later rounding to float64 correct.
+    uint64_t pos[QREDUCE_EXACT_LIMBS] = {0};
+    uint64_t neg[QREDUCE_EXACT_LIMBS] = {0};
+    uint64_t *big, *sub;
+    qdd_quad_bits r;
+    __uint128_t sig, borrow;
+    bool negative, sticky;
+    int k, h, i, guard;
+
+    for (k = acc->lo; k <= acc->hi; ++k) {
+        if (acc->bin[k] > 0) {
+            qreduce_limbs_add(pos, (__uint128_t)acc->bin[k], k);
+        } else if (acc->bin[k] < 0) {
+            qreduce_limbs_add(neg, -(__uint128_t)acc->bin[k], k);
+        }
+    }
+
+    negative = false;
+    for (i = QREDUCE_EXACT_LIMBS - 1; i >= 0; --i) {
+        if (pos[i] != neg[i]) {
+            negative = neg[i] > pos[i];
+            break;
+        }
+    }
+    if (i < 0) {
+        return acc->special;
+    }
+    big = negative ? neg : pos;
+    sub = negative ? pos : neg;
+    borrow = 0;
+    for (i = 0; i < QREDUCE_EXACT_LIMBS; ++i) {
+        __uint128_t d = (__uint128_t)big[i] - sub[i] - borrow;
+        big[i] = (uint64_t)d;
+        borrow = (d >> 64) & 1;
+    }
+
+    for (i = QREDUCE_EXACT_LIMBS - 1; big[i] == 0; --i) {
+    }
+    h = 64 * i + 63 - __builtin_clzll(big[i]);
+
+    sig = 0;
+    for (k = h; k > h - 113; --k) {
+        sig = (sig << 1) | (__uint128_t)qreduce_limbs_bit(big, k);
+    }
+    guard = qreduce_limbs_bit(big, h - 113);
+    sticky = false;
+    for (k = h - 114; k >= 0 && !sticky; --k) {
+        if (k % 64 == 63 && big[k / 64] == 0) {
+            k -= 63;
+            continue;
+        }
+        sticky = qreduce_limbs_bit(big, k);
+    }
+
+    if (odd) {
+        sig |= (__uint128_t)(guard | (int)sticky);
+    } else {
+        sig += (__uint128_t)(guard & (sticky | (int)(sig & 1)));
+        if (sig >> 113) {
+            sig >>= 1;
+            h += 1;
+        }
+    }
+    r.u = ((__uint128_t)negative << 127)
+        | ((__uint128_t)(h - QREDUCE_EXACT_OFFSET + QDD_QUAD_BIAS) << 112)
+        | (sig & QSQ_MANT_MASK);
+    return acc->special + r.f;
+}
+
+typedef struct {
+    const double *x;
+    const double *y;
+    size_t n;
+    size_t ntasks;
+    qreduce_exact **acc;
+} qreduce_exact_job;
+
+static void
+qreduce_exact_task(void *ctx, size_t t)
+{
+    qreduce_exact_job *job = (qreduce_exact_job *)ctx;
+
+    qreduce_exact_add(job->acc[t], job->x, job->y, job->n * t / job->ntasks, job->n * (t + 1) / job->ntasks);
+}
+
+static size_t
+qreduce_num_tasks(size_t work, int threads)
+{
+    // A thread is only worth starting for at least QREDUCE_CHUNK elements
+    size_t ntasks = threads < 1 ? 1 : (size_t)threads;
+
+    if (ntasks > work / QREDUCE_CHUNK) {
+        ntasks = work / QREDUCE_CHUNK > 0 ? work / QREDUCE_CHUNK : 1;
+    }
+    return ntasks;
+}
+
+static int
+qreduce_exact_run(const double *x, const double *y, size_t n, int threads, bool odd, __float128 *out)
+{
+    // Each thread gets one contiguous range and its own bins
+    qreduce_exact_job job = {.x = x, .y = y, .n = n};
+    size_t t;
+    int rc = 0;
+
+    job.ntasks = qreduce_num_tasks(n, threads);
+    job.acc = calloc(job.ntasks, sizeof(*job.acc));
+    if (job.acc == NULL) {
+        return -1;
+    }
+    for (t = 0; t < job.ntasks; ++t) {
+        job.acc[t] = qreduce_exact_new();
+        if (job.acc[t] == NULL) {
+            rc = -1;
+            goto done;
+        }
+    }
+
+    qreduce_parallel_for(job.ntasks, (int)job.ntasks, qreduce_exact_task, &job);
+
+    for (t = 1; t < job.ntasks; ++t) {
+        qreduce_exact_merge(job.acc[0], job.acc[t]);
+    }
+    *out = qreduce_exact_round(job.acc[0], odd);
+
+done:
+    for (t = 0; t < job.ntasks; ++t) {
+        free(job.acc[t]);
+    }
+    free(job.acc);
+    return rc;
+}
+
+int
+qreduce_sum(const void *x, qreduce_kind kind, size_t n, int threads, qreduce_kind out_kind, void *out)
+{
+    return qreduce_dot(x, kind, NULL, kind, n, threads, out_kind, out);
+}
+
+int
+qreduce_dot(const void *x, qreduce_kind xkind, const void *y, qreduce_kind ykind, size_t n, int threads,
+            qreduce_kind out_kind, void *out)
+{
+    __float128 r;
+    int rc;
+
+    if (xkind == QREDUCE_FLOAT64 && (y == NULL || ykind == QREDUCE_FLOAT64)) {
+        rc = qreduce_exact_run((const double *)x, (const double *)y, n, threads, out_kind == QREDUCE_FLOAT64, &r);
+    } else {
+        rc = qreduce_quad((const char *)x, xkind, (const char *)y, ykind, n, threads, &r);
+    }
+    if (rc == 0) {
+        qreduce_store(out, out_kind, 0, r);
+    }
+    return rc;
+}
+
+typedef struct {
+    const char *a;
+    const char *x;
+    qreduce_kind akind;
+    qreduce_kind xkind;
+    size_t m;
+    size_t n;
+    size_t ntasks;
+    qreduce_kind out_kind;
+    void *out;
+    int failed;
+} qreduce_gemv_job;
+
+static void
+qreduce_gemv_task(void *ctx, size_t t)
+{
+    // One block of rows, each row reduced on its own by this thread
+    qreduce_gemv_job *job = (qreduce_gemv_job *)ctx;
+    size_t begin = job->m * t / job->ntasks;
+    size_t end = job->m * (t + 1) / job->ntasks;
+    size_t asize = job->akind == QREDUCE_FLOAT64 ? sizeof(double) : sizeof(__float128);
+    qreduce_exact *acc = NULL;
+    __float128 r;
+    size_t i;
+
+    if (job->akind == QREDUCE_FLOAT64 && job->xkind == QREDUCE_FLOAT64) {
+        acc = qreduce_exact_new();
+        if (acc == NULL) {
+            job->failed = 1;
+            return;
+        }
+    }
+
+    for (i = begin; i < end; ++i) {
+        const char *row = job->a + i * job->n * asize;
+
+        if (acc != NULL) {
+            qreduce_exact_reset(acc);
+            qreduce_exact_add(acc, (const double *)row, (const double *)job->x, 0, job->n);
+            r = qreduce_exact_round(acc, job->out_kind == QREDUCE_FLOAT64);
+        } else {
+            qreduce_quad(row, job->akind, job->x, job->xkind, job->n, 1, &r);
+        }
+        qreduce_store(job->out, job->out_kind, i, r);
+    }
+    free(acc);
+}
+
+int
+qreduce_gemv(const void *a, qreduce_kind akind, const void *x, qreduce_kind xkind, size_t m, size_t n, int threads,
+             qreduce_kind out_kind, void *out)
+{
+    qreduce_gemv_job job = {
+        .a = (const char *)a,
+        .x = (const char *)x,
+        .akind = akind,
+        .xkind = xkind,
+        .m = m,
+        .n = n,
+        .out_kind = out_kind,
+        .out = out,
+    };
+
+    job.ntasks = qreduce_num_tasks(m * n, threads);
+    if (job.ntasks > m) {
+        job.ntasks = m > 0 ? m : 1;
+    }
+    qreduce_parallel_for(job.ntasks, (int)job.ntasks, qreduce_gemv_task, &job);
+    return job.failed ? -1 : 0;
+}
+
+typedef struct {
+    __float128 alpha;
+    const char *x;
+    const char *y;
+    qreduce_kind xkind;
+    qreduce_kind ykind;
+    size_t n;
+    qreduce_kind out_kind;
+    void *out;
+} qreduce_axpy_job;
+
+static void
+qreduce_axpy_task(void *ctx, size_t chunk)
+{
+    qreduce_axpy_job *job = (qreduce_axpy_job *)ctx;
+    size_t begin = chunk * QREDUCE_CHUNK;
+    size_t end = begin + QREDUCE_CHUNK < job->n ? begin + QREDUCE_CHUNK : job->n;
+    double alpha_d = (double)job->alpha;
+    __float128 r, xi, yi;
+    size_t i;
+
+    if (job->xkind == QREDUCE_FLOAT64 && job->ykind == QREDUCE_FLOAT64 && (__float128)alpha_d == job->alpha) {
+        const double *x = (const double *)job->x;
+        const double *y = (const double *)job->y;
+
+        if (job->out_kind == QREDUCE_FLOAT64) {
+            // Every input is a double, so one double fma is already
+            // correctly rounded
+            double *out = (double *)job->out;
+
+            for (i = begin; i < end; ++i) {
+                out[i] = fma(alpha_d, x[i], y[i]);
+            }
+        } else {
+            // The product is exact in quad, leaving one rounding in the add
+            __float128 *out = (__float128 *)job->out;
+
+            for (i = begin; i < end; ++i) {
+                out[i] = qreduce_add(qreduce_mul_double(alpha_d, x[i]), qdd_double_to_quad(y[i]));
+            }
+        }
+        return;
+    }
+
+    for (i = begin; i < end; ++i) {
+        xi = qreduce_load(job->x, job->xkind, i);
+        yi = qreduce_load(job->y, job->ykind, i);
+        if (!qsq_fma(job->alpha, xi, yi, &r)) {
+            r = fmaq(job->alpha, xi, yi);
+        }
+        qreduce_store(job->out, job->out_kind, i, r);
+    }
+}
+
+void
+qreduce_axpy(__float128 alpha, const void *x, qreduce_kind xkind, const void *y, qreduce_kind ykind, size_t n,
+             int threads, qreduce_kind out_kind, void *out)
+{
+    qreduce_axpy_job job = {
+        .alpha = alpha,
+        .x = (const char *)x,
+        .y = (const char *)y,
+        .xkind = xkind,
+        .ykind = ykind,
+        .n = n,
+        .out_kind = out_kind,
+        .out = out,
+    };
+
+    qreduce_parallel_for((n + QREDUCE_CHUNK - 1) / QREDUCE_CHUNK, threads, qreduce_axpy_task, &job);
+}
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+
+// Quad precision reductions and level 1/2 BLAS that read float64 or
+// binary128 buffers directly.
+//
+// Results are bit-for-bit the same whatever the number of threads: float64
+// data is summed exactly, anything else in fixed size chunks whose partial
+// results are combined in chunk order.
+
+#include <stddef.h>
+
+typedef enum {
+    QREDUCE_FLOAT64,
+    QREDUCE_QUAD,
+} qreduce_kind;
+
+#define QREDUCE_CHUNK 16384
+
+// Number of online CPUs, at least 1
+int qreduce_cpu_count(void);
+
+// Call task(ctx, i) for every i in [0, ntasks) using up to threads threads.
+// Falls back to the calling thread if no more threads can be started.
+void qreduce_parallel_for(size_t ntasks, int threads, void (*task)(void *, size_t), void *ctx);
+
+// The routines below read operands of either kind and write their result
+// as out_kind. float64 results are correctly rounded whenever every operand
+// is float64. They return -1 if out of memory.
+
+// Sum of n elements of x
+int qreduce_sum(const void *x, qreduce_kind kind, size_t n, int threads, qreduce_kind out_kind, void *out);
+
+// Sum of the n products x[i] * y[i]. The product of two float64 values is
+// formed exactly.
+int qreduce_dot(const void *x, qreduce_kind xkind, const void *y, qreduce_kind ykind, size_t n, int threads,
+                qreduce_kind out_kind, void *out);
+
+// out = a @ x for a C-contiguous m by n matrix a, split over rows
+int qreduce_gemv(const void *a, qreduce_kind akind, const void *x, qreduce_kind xkind, size_t m, size_t n, int threads,
+                 qreduce_kind out_kind, void *out);
+
+// out = alpha * x + y with a single rounding per element, for float64
+// output only if alpha is a double too
+void qreduce_axpy(__float128 alpha, const void *x, qreduce_kind xkind, const void *y, qreduce_kind ykind, size_t n,
+                  int threads, qreduce_kind out_kind, void *out);
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "qsoftquad.h"
+
+// The batched kernels are compiled once per ISA level and the best one the
+// CPU supports is picked by qsoft_init(). The inline qsq_* kernels take on the
+// target of the function they are inlined into, so the v3 build gets mulx,
+// lzcnt and friends without any source changes.
+
+#define QSOFT_DEFINE_KERNELS(suffix, attr)                                                            \
+    static attr void qsoft_add_n_##suffix(const __float128 *a, const __float128 *b, __float128 *out,  \
+                                          size_t n)                                                   \
+    {                                                                                                 \
+        size_t i;                                                                                     \
+        __float128 r;                                                                                 \
+                                                                                                      \
+        for (i = 0; i < n; ++i) {                                                                     \
+            if (!qsq_add(a[i], b[i], &r)) {                                                           \
+                r = a[i] + b[i];                                                                      \
+            }                                                                                         \
+            out[i] = r;                                                                               \
+        }                                                                                             \
+    }                                                                                                 \
+                                                                                                      \
+    static attr void qsoft_sub_n_##suffix(const __float128 *a, const __float128 *b, __float128 *out,  \
+                                          size_t n)                                                   \
+    {                                                                                                 \
+        size_t i;                                                                                     \
+        __float128 r;                                                                                 \
+                                                                                                      \
+        for (i = 0; i < n; ++i) {                                                                     \
+            if (!qsq_sub(a[i], b[i], &r)) {                                                           \
+                r = a[i] - b[i];                                                                      \
+            }                                                                                         \
+            out[i] = r;                                                                               \
+        }                                                                                             \
+    }                                                                                                 \
+                                                                                                      \
+    static attr void qsoft_mul_n_##suffix(const __float128 *a, const __float128 *b, __float128 *out,  \
+                                          size_t n)                                                   \
+    {                                                                                                 \
+        size_t i;                                                                                     \
+        __float128 r;                                                                                 \
+                                                                                                      \
+        for (i = 0; i < n; ++i) {                                                                     \
+            if (!qsq_mul(a[i], b[i], &r)) {                                                           \
+                r = a[i] * b[i];                                                                      \
+            }                                                                                         \
+            out[i] = r;                                                                               \
+        }                                                                                             \
+    }                                                                                                 \
+                                                                                                      \
+    static attr void qsoft_fma_n_##suffix(const __float128 *a, const __float128 *b,                   \
+                                          const __float128 *c, __float128 *out, size_t n)             \
+    {                                                                                                 \
+        size_t i;                                                                                     \
+        __float128 r;                                                                                 \
+                                                                                                      \
+        for (i = 0; i < n; ++i) {                                                                     \
+            if (!qsq_fma(a[i], b[i], c[i], &r)) {                                                     \
+                r = fmaq(a[i], b[i], c[i]);                                                           \
+            }                                                                                         \
+            out[i] = r;                                                                               \
+        }                                                                                             \
+    }
+
+typedef struct {
+    const char *name;
+    void (*add_n)(const __float128 *, const __float128 *, __float128 *, size_t);
+    void (*sub_n)(const __float128 *, const __float128 *, __float128 *, size_t);
+    void (*mul_n)(const __float128 *, const __float128 *, __float128 *, size_t);
+    void (*fma_n)(const __float128 *, const __float128 *, const __float128 *, __float128 *, size_t);
+} qsoft_kernels;
+
+#define QSOFT_KERNELS(suffix, name) \
+    { name, qsoft_add_n_##suffix, qsoft_sub_n_##suffix, qsoft_mul_n_##suffix, qsoft_fma_n_##suffix }
+
+QSOFT_DEFINE_KERNELS(baseline, )
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define QSOFT_X86_64_V2 "popcnt,sse3,ssse3,sse4.1,sse4.2"
+#define QSOFT_X86_64_V3 QSOFT_X86_64_V2 ",avx,avx2,bmi,bmi2,f16c,fma,lzcnt,movbe"
+#define QSOFT_X86_64_V4 QSOFT_X86_64_V3 ",avx512f,avx512bw,avx512cd,avx512dq,avx512vl"
+
+QSOFT_DEFINE_KERNELS(v2, __attribute__((target(QSOFT_X86_64_V2))))
+QSOFT_DEFINE_KERNELS(v3, __attribute__((target(QSOFT_X86_64_V3))))
+QSOFT_DEFINE_KERNELS(v4, __attribute__((target(QSOFT_X86_64_V4))))
+
+// Ordered from least to most capable
+static const qsoft_kernels QSoftLevels[] = {
+    QSOFT_KERNELS(baseline, "x86-64"),
+    QSOFT_KERNELS(v2, "x86-64-v2"),
+    QSOFT_KERNELS(v3, "x86-64-v3"),
+    QSOFT_KERNELS(v4, "x86-64-v4"),
+};
+
+// Every feature in the target string of a level must be checked, a CPU with
+// only some of them would fault in code compiled for the level
+static int
+qsoft_cpu_level(void)
+{
+    __builtin_cpu_init();
+    if (!(__builtin_cpu_supports("popcnt") && __builtin_cpu_supports("sse3") && __builtin_cpu_supports("ssse3")
+          && __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("sse4.2"))) {
+        return 0;
+    }
+    if (!(__builtin_cpu_supports("avx") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi")
+          && __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("f16c") && __builtin_cpu_supports("fma")
+          && __builtin_cpu_supports("lzcnt") && __builtin_cpu_supports("movbe"))) {
+        return 1;
+    }
+    if (!(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+          && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512dq")
+          && __builtin_cpu_supports("avx512vl"))) {
+        return 2;
+    }
+    return 3;
+}
+#else
+#if defined(__aarch64__)
+#define QSOFT_BASELINE_NAME "aarch64"
+#else
+#define QSOFT_BASELINE_NAME "baseline"
+#endif
+
+static const qsoft_kernels QSoftLevels[] = {
+    QSOFT_KERNELS(baseline, QSOFT_BASELINE_NAME),
+};
+
+static int
+qsoft_cpu_level(void)
+{
+    return 0;
+}
+#endif
+
+#define QSOFT_NUM_LEVELS ((int)(sizeof(QSoftLevels) / sizeof(QSoftLevels[0])))
+
+static int QSoftCPULevel = 0;
+static int QSoftLevel = 0;
+
+int
+qsoft_init(void)
+{
+    const char *env;
+    int i;
+
+    QSoftCPULevel = qsoft_cpu_level();
+    QSoftLevel = QSoftCPULevel;
+
+    env = getenv(QSOFT_LEVEL_ENV);
+    if (env == NULL || env[0] == '\0') {
+        return 0;
+    }
+    if (strcmp(env, "baseline") == 0) {
+        QSoftLevel = 0;
+        return 0;
+    }
+    for (i = 0; i < QSOFT_NUM_LEVELS; ++i) {
+        if (strcmp(env, QSoftLevels[i].name) == 0) {
+            // Never select code the CPU cannot run
+            QSoftLevel = i < QSoftCPULevel ? i : QSoftCPULevel;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *
+qsoft_level_name(void)
+{
+    return QSoftLevels[QSoftLevel].name;
+}
+
+const char *
+qsoft_cpu_level_name(void)
+{
+    return QSoftLevels[QSoftCPULevel].name;
+}
+
+int
+qsoft_num_levels(void)
+{
+    return QSOFT_NUM_LEVELS;
+}
+
+const char *
+qsoft_level_name_at(int level)
+{
+    return QSoftLevels[level].name;
+}
+
+void
+qsoft_add_n(const __float128 *a, const __float128 *b, __float128 *out, size_t n)
+{
+    QSoftLevels[QSoftLevel].add_n(a, b, out, n);
+}
+
+void
+qsoft_sub_n(const __float128 *a, const __float128 *b, __float128 *out, size_t n)
+{
+    QSoftLevels[QSoftLevel].sub_n(a, b, out, n);
+}
+
+void
+qsoft_mul_n(const __float128 *a, const __float128 *b, __float128 *out, size_t n)
+{
+    QSoftLevels[QSoftLevel].mul_n(a, b, out, n);
+}
+
+void
+qsoft_fma_n(const __float128 *a, const __float128 *b, const __float128 *c, __float128 *out, size_t n)
+{
+    QSoftLevels[QSoftLevel].fma_n(a, b, c, out, n);
+}
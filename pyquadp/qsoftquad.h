@@ -0,0 +1,557 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+
+// Software binary128 arithmetic on integer limbs.
+//
+// The inline kernels below implement round-to-nearest-even add, multiply and
+// fused multiply-add for the common case where every operand is a finite,
+// non-zero, normal number and so is the result. They return false for
+// anything else (zeros, subnormals, Inf, NaN, overflow, underflow) so the
+// caller can hand that element to libgcc/libquadmath, which keeps results and
+// floating point exception flags bit-for-bit identical to the plain C
+// operators.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "qdd.h"
+
+#define QSQ_EXP_MASK 0x7fff
+#define QSQ_MANT_BITS 112
+#define QSQ_IMPLICIT (((__uint128_t)1) << QSQ_MANT_BITS)
+#define QSQ_MANT_MASK (QSQ_IMPLICIT - 1)
+
+typedef struct {
+    __uint128_t hi;
+    __uint128_t lo;
+} qsq_u256;
+
+static inline bool
+qsq_unpack(__uint128_t bits, int *e, __uint128_t *m)
+{
+    // Finite non-zero normal numbers only
+    *e = (int)((bits >> QSQ_MANT_BITS) & QSQ_EXP_MASK);
+    if (*e == 0 || *e == QSQ_EXP_MASK) {
+        return false;
+    }
+    *m = (bits & QSQ_MANT_MASK) | QSQ_IMPLICIT;
+    return true;
+}
+
+static inline bool
+qsq_round_pack(__uint128_t sign, int e, __uint128_t m, unsigned int guard, bool sticky,
+               __float128 *out)
+{
+    // m holds 113 bits with the leading bit at bit 112, guard is the next bit
+    // below and sticky the OR of everything under it. Written without data
+    // dependent branches as the rounding direction is close to random.
+    qdd_quad_bits r;
+    unsigned int carry;
+
+    m += guard & ((unsigned int)sticky | (unsigned int)(m & 1));
+    carry = (unsigned int)(m >> (QSQ_MANT_BITS + 1));
+    m >>= carry;
+    e += (int)carry;
+    if (e <= 0 || e >= QSQ_EXP_MASK) {
+        return false;
+    }
+    r.u = sign | ((__uint128_t)e << QSQ_MANT_BITS) | (m & QSQ_MANT_MASK);
+    *out = r.f;
+    return true;
+}
+
+static inline bool
+qsq_add(__float128 a, __float128 b, __float128 *out)
+{
+    qdd_quad_bits x, y;
+    __uint128_t ma, mb, sign, m, swap, diff, sticky;
+    int ea, eb, d, shift;
+    unsigned int carry;
+
+    x.f = a;
+    y.f = b;
+    // Order by magnitude so that |x| >= |y|, without a branch
+    swap = -(__uint128_t)((x.u << 1) < (y.u << 1));
+    m = (x.u ^ y.u) & swap;
+    x.u ^= m;
+    y.u ^= m;
+    if (!qsq_unpack(x.u, &ea, &ma) || !qsq_unpack(y.u, &eb, &mb)) {
+        return false;
+    }
+    sign = x.u & ((__uint128_t)1 << 127);
+
+    // Three extra bits: guard, round and sticky
+    ma <<= 3;
+    mb <<= 3;
+    d = ea - eb;
+    if (d >= 120) {
+        mb = 1;
+    } else {
+        sticky = (mb & ((((__uint128_t)1) << d) - 1)) != 0;
+        mb = (mb >> d) | sticky;
+    }
+
+    // Effective subtraction adds the two's complement
+    diff = -(__uint128_t)((x.u ^ y.u) >> 127);
+    m = ma + ((mb ^ diff) - diff);
+    if (m == 0) {
+        *out = 0;
+        return true;
+    }
+
+    // Renormalise the leading bit to bit 115
+    carry = (unsigned int)(m >> (QSQ_MANT_BITS + 4));
+    m = (m >> carry) | (m & carry);
+    ea += (int)carry;
+    shift = qdd_clz128(m) - (127 - QSQ_MANT_BITS - 3);
+    m <<= shift;
+    ea -= shift;
+
+    return qsq_round_pack(sign, ea, m >> 3, (unsigned int)(m >> 2) & 1, (m & 3) != 0, out);
+}
+
+static inline bool
+qsq_sub(__float128 a, __float128 b, __float128 *out)
+{
+    return qsq_add(a, -b, out);
+}
+
+static inline qsq_u256
+qsq_mul_113(__uint128_t a, __uint128_t b)
+{
+    // Full product of two 113-bit significands
+    uint64_t a0 = (uint64_t)a, a1 = (uint64_t)(a >> 64);
+    uint64_t b0 = (uint64_t)b, b1 = (uint64_t)(b >> 64);
+    __uint128_t p00 = (__uint128_t)a0 * b0;
+    __uint128_t p01 = (__uint128_t)a0 * b1;
+    __uint128_t p10 = (__uint128_t)a1 * b0;
+    __uint128_t mid = (p00 >> 64) + (uint64_t)p01 + (uint64_t)p10;
+    qsq_u256 r;
+
+    r.lo = (mid << 64) | (uint64_t)p00;
+    r.hi = (__uint128_t)a1 * b1 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+    return r;
+}
+
+static inline bool
+qsq_mul(__float128 a, __float128 b, __float128 *out)
+{
+    qdd_quad_bits x, y;
+    __uint128_t ma, mb, m, rem;
+    qsq_u256 p;
+    int ea, eb, shift;
+
+    x.f = a;
+    y.f = b;
+    if (!qsq_unpack(x.u, &ea, &ma) || !qsq_unpack(y.u, &eb, &mb)) {
+        return false;
+    }
+
+    // The product is in [2^224, 2^226), keep its leading 113 bits
+    p = qsq_mul_113(ma, mb);
+    shift = 112 + (int)(p.hi >> 97);
+    m = (p.hi << (128 - shift)) | (p.lo >> shift);
+    rem = p.lo & ((((__uint128_t)1) << shift) - 1);
+
+    return qsq_round_pack((x.u ^ y.u) & ((__uint128_t)1 << 127),
+                          ea + eb - 16383 + (shift - 112), m,
+                          (unsigned int)(rem >> (shift - 1)) & 1,
+                          (rem & ((((__uint128_t)1) << (shift - 1)) - 1)) != 0, out);
+}
+
+// 256-bit helpers for the fused multiply-add
+
+static inline qsq_u256
+qsq_u256_shr_sticky(qsq_u256 a, int n)
+{
+    // Shift right by n, OR-ing everything shifted out into bit 0
+    qsq_u256 r;
+    bool sticky;
+
+    if (n <= 0) {
+        return a;
+    }
+    if (n >= 256) {
+        r.hi = 0;
+        r.lo = (a.hi | a.lo) != 0;
+        return r;
+    }
+    if (n >= 128) {
+        sticky = a.lo != 0 || (n > 128 && (a.hi & ((((__uint128_t)1) << (n - 128)) - 1)) != 0);
+        r.lo = n == 128 ? a.hi : a.hi >> (n - 128);
+        r.hi = 0;
+    } else {
+        sticky = (a.lo & ((((__uint128_t)1) << n) - 1)) != 0;
+        r.lo = (a.lo >> n) | (a.hi << (128 - n));
+        r.hi = a.hi >> n;
+    }
+    r.lo |= sticky;
+    return r;
+}
+
+static inline qsq_u256
+qsq_u256_shl(qsq_u256 a, int n)
+{
+    qsq_u256 r;
+
+    if (n <= 0) {
+        return a;
+    }
+    if (n >= 128) {
+        r.hi = a.lo << (n - 128);
+        r.lo = 0;
+    } else {
+        r.hi = (a.hi << n) | (a.lo >> (128 - n));
+        r.lo = a.lo << n;
+    }
+    return r;
+}
+
+static inline bool
+qsq_u256_less(qsq_u256 a, qsq_u256 b)
+{
+    return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+static inline qsq_u256
+qsq_u256_add(qsq_u256 a, qsq_u256 b)
+{
+    qsq_u256 r;
+
+    r.lo = a.lo + b.lo;
+    r.hi = a.hi + b.hi + (r.lo < a.lo);
+    return r;
+}
+
+static inline qsq_u256
+qsq_u256_sub(qsq_u256 a, qsq_u256 b)
+{
+    // a >= b
+    qsq_u256 r;
+
+    r.lo = a.lo - b.lo;
+    r.hi = a.hi - b.hi - (a.lo < b.lo);
+    return r;
+}
+
+static inline int
+qsq_u256_clz(qsq_u256 a)
+{
+    if (a.hi) {
+        return qdd_clz128(a.hi);
+    }
+    return 128 + qdd_clz128(a.lo);
+}
+
+static inline bool
+qsq_fma(__float128 a, __float128 b, __float128 c, __float128 *out)
+{
+    qdd_quad_bits x, y, z;
+    __uint128_t ma, mb, mc, psign, csign;
+    qsq_u256 p, q, s, t;
+    int ea, eb, ec, pe, lead;
+
+    x.f = a;
+    y.f = b;
+    z.f = c;
+    if (!qsq_unpack(x.u, &ea, &ma) || !qsq_unpack(y.u, &eb, &mb) || !qsq_unpack(z.u, &ec, &mc)) {
+        return false;
+    }
+    psign = (x.u ^ y.u) & ((__uint128_t)1 << 127);
+    csign = z.u & ((__uint128_t)1 << 127);
+
+    // Move the leading bit of both the exact product and c to bit 227, which
+    // leaves room for a carry. pe and ec are then the biased exponents of
+    // that bit.
+    p = qsq_mul_113(ma, mb);
+    pe = ea + eb - 16383;
+    if (p.hi >> 97) {
+        pe += 1;
+        p = qsq_u256_shl(p, 2);
+    } else {
+        p = qsq_u256_shl(p, 3);
+    }
+    q.hi = 0;
+    q.lo = mc;
+    q = qsq_u256_shl(q, 227 - QSQ_MANT_BITS);
+
+    // Align the smaller term to the larger one
+    if (pe < ec || (pe == ec && qsq_u256_less(p, q))) {
+        t = p;
+        p = q;
+        q = t;
+        t.hi = psign;
+        psign = csign;
+        csign = t.hi;
+        lead = pe;
+        pe = ec;
+        ec = lead;
+    }
+    q = qsq_u256_shr_sticky(q, pe - ec);
+
+    if (psign == csign) {
+        s = qsq_u256_add(p, q);
+    } else {
+        s = qsq_u256_sub(p, q);
+        if ((s.hi | s.lo) == 0) {
+            *out = 0;
+            return true;
+        }
+    }
+
+    // Renormalise so that bits 114..2 are the significand, bit 1 the guard
+    // bit and bit 0 sticky
+    lead = 255 - qsq_u256_clz(s);
+    pe += lead - 227;
+    if (lead > 114) {
+        s = qsq_u256_shr_sticky(s, lead - 114);
+    } else {
+        s = qsq_u256_shl(s, 114 - lead);
+    }
+
+    return qsq_round_pack(psign, pe, s.lo >> 2, (unsigned int)(s.lo >> 1) & 1, (s.lo & 1) != 0, out);
+}
+
+static inline bool
+qsq_to_int128(__float128 x, __int128 *out)
+{
+    // Truncates toward zero like a C cast. Returns false for NaN and for
+    // values outside the signed 128-bit range.
+    qdd_quad_bits b = {.f = x};
+    int e = (int)((b.u >> QSQ_MANT_BITS) & QSQ_EXP_MASK) - QDD_QUAD_BIAS;
+    __uint128_t m = (b.u & QSQ_MANT_MASK) | QSQ_IMPLICIT;
+    bool negative = (bool)(b.u >> 127);
+
+    if (e < 0) {
+        *out = 0;
+        return true;
+    }
+    if (e >= 127) {
+        // Only -2^127 itself fits
+        *out = (__int128)((__uint128_t)1 << 127);
+        return negative && e == 127 && (b.u & QSQ_MANT_MASK) == 0;
+    }
+    m = e >= QSQ_MANT_BITS ? m << (e - QSQ_MANT_BITS) : m >> (QSQ_MANT_BITS - e);
+    *out = negative ? -(__int128)m : (__int128)m;
+    return true;
+}
+
+typedef enum {
+    QSQ_ROUND_TRUNC,
+    QSQ_ROUND_FLOOR,
+    QSQ_ROUND_CEIL,
+    QSQ_ROUND_RINT,
+} qsq_round_mode;
+
+static inline __float128
+qsq_round_integral(__float128 x, qsq_round_mode mode)
+{
+    // Round to an integral value by masking the fraction bits and adding one
+    // unit in the last integer place when rounding away from zero; a carry
+    // moves into the exponent by itself. Signed zeros are kept and Inf and
+    // NaN, payload included, come back unchanged. For rint the integer
+    // part's lowest bit is the bit above the mask, which for 1 <= |x| < 2
+    // is the (odd) lowest bit of the exponent field.
+    qdd_quad_bits b = {.f = x};
+    __uint128_t sign = b.u >> 127;
+    int e = (int)((b.u >> QSQ_MANT_BITS) & QSQ_EXP_MASK) - QDD_QUAD_BIAS;
+    __uint128_t mask, frac;
+    bool nonzero, up = false;
+    int fb;
+
+    if (e >= QSQ_MANT_BITS) {
+        return x;
+    }
+    if (e < 0) {
+        nonzero = (b.u << 1) != 0;
+        switch (mode) {
+        case QSQ_ROUND_TRUNC:
+            break;
+        case QSQ_ROUND_FLOOR:
+            up = sign && nonzero;
+            break;
+        case QSQ_ROUND_CEIL:
+            up = !sign && nonzero;
+            break;
+        case QSQ_ROUND_RINT:
+            // Above one half, as exactly one half goes to even zero
+            up = e == -1 && (b.u & QSQ_MANT_MASK) != 0;
+            break;
+        }
+        b.u = (sign << 127) | ((__uint128_t)up * ((__uint128_t)QDD_QUAD_BIAS << QSQ_MANT_BITS));
+        return b.f;
+    }
+
+    fb = QSQ_MANT_BITS - e;
+    mask = (((__uint128_t)1) << fb) - 1;
+    frac = b.u & mask;
+    b.u &= ~mask;
+    switch (mode) {
+    case QSQ_ROUND_TRUNC:
+        break;
+    case QSQ_ROUND_FLOOR:
+        up = sign && frac;
+        break;
+    case QSQ_ROUND_CEIL:
+        up = !sign && frac;
+        break;
+    case QSQ_ROUND_RINT:
+        up = frac > (mask >> 1) + 1 || (frac == (mask >> 1) + 1 && ((b.u >> fb) & 1));
+        break;
+    }
+    b.u += (__uint128_t)up << fb;
+    return b.f;
+}
+
+static inline __float128
+qsq_frexp(__float128 x, int32_t *e)
+{
+    // x == m * 2^e with 0.5 <= |m| < 1, subnormals included. Zeros, Inf and
+    // NaN come back unchanged with e = 0.
+    qdd_quad_bits b = {.f = x};
+    int exp = (int)((b.u >> QSQ_MANT_BITS) & QSQ_EXP_MASK);
+    __uint128_t mant = b.u & QSQ_MANT_MASK;
+    int shift;
+
+    *e = 0;
+    if (exp == QSQ_EXP_MASK || (b.u << 1) == 0) {
+        return x;
+    }
+    if (exp == 0) {
+        shift = qdd_clz128(mant) - (127 - QSQ_MANT_BITS);
+        mant = (mant << shift) & QSQ_MANT_MASK;
+        exp = 1 - shift;
+    }
+    *e = exp - (QDD_QUAD_BIAS - 1);
+    b.u = (b.u & ((__uint128_t)1 << 127)) | ((__uint128_t)(QDD_QUAD_BIAS - 1) << QSQ_MANT_BITS) | mant;
+    return b.f;
+}
+
+static inline bool
+qsq_ldexp(__float128 x, int64_t n, __float128 *out)
+{
+    // x * 2^n by moving the exponent field, for normal x and results only
+    qdd_quad_bits b = {.f = x};
+    int64_t exp = (int64_t)((b.u >> QSQ_MANT_BITS) & QSQ_EXP_MASK);
+
+    if (exp == 0 || exp == QSQ_EXP_MASK || n <= -exp || n >= QSQ_EXP_MASK - exp) {
+        return false;
+    }
+    b.u += (__uint128_t)(__int128)n << QSQ_MANT_BITS;
+    *out = b.f;
+    return true;
+}
+
+static inline bool
+qsq_decompose(__float128 x, __int128 *m, int32_t *e)
+{
+    // x == m * 2^e exactly with m odd, or m = e = 0 for zeros. Returns false
+    // (with m = e = 0) for Inf and NaN.
+    qdd_quad_bits b = {.f = x};
+    int exp = (int)((b.u >> QSQ_MANT_BITS) & QSQ_EXP_MASK);
+    __uint128_t mant = b.u & QSQ_MANT_MASK;
+    int tz;
+
+    *m = 0;
+    *e = 0;
+    if (exp == QSQ_EXP_MASK) {
+        return false;
+    }
+    if (exp == 0) {
+        if (mant == 0) {
+            return true;
+        }
+        exp = 1;
+    } else {
+        mant |= QSQ_IMPLICIT;
+    }
+    tz = (uint64_t)mant ? __builtin_ctzll((uint64_t)mant) : 64 + __builtin_ctzll((uint64_t)(mant >> 64));
+    mant >>= tz;
+    *m = (b.u >> 127) ? -(__int128)mant : (__int128)mant;
+    *e = exp - QDD_QUAD_BIAS - QSQ_MANT_BITS + tz;
+    return true;
+}
+
+typedef enum {
+    QSQ_COMPOSE_EXACT,
+    QSQ_COMPOSE_INEXACT,
+    QSQ_COMPOSE_UNDERFLOW,
+    QSQ_COMPOSE_OVERFLOW,
+} qsq_compose_status;
+
+static inline qsq_compose_status
+qsq_compose(__int128 m, int64_t e, __float128 *out)
+{
+    // m * 2^e rounded once to nearest even, subnormal results included.
+    // Underflow means an inexact result below the normal range and overflow
+    // a result rounded to Inf.
+    qdd_quad_bits r;
+    __uint128_t sign = (__uint128_t)(m < 0) << 127;
+    __uint128_t a = m < 0 ? -(__uint128_t)m : (__uint128_t)m;
+    __uint128_t q, rem, half;
+    int64_t top, lsb, shift;
+    bool tiny;
+
+    if (a == 0) {
+        *out = 0;
+        return QSQ_COMPOSE_EXACT;
+    }
+    // Beyond this range the result is Inf or zero either way
+    e = e < -(1 << 20) ? -(1 << 20) : (e > (1 << 20) ? (1 << 20) : e);
+    top = 127 - qdd_clz128(a) + e;
+    if (top > QDD_QUAD_BIAS) {
+        r.u = sign | ((__uint128_t)QSQ_EXP_MASK << QSQ_MANT_BITS);
+        *out = r.f;
+        return QSQ_COMPOSE_OVERFLOW;
+    }
+    // Exponent of the last significand bit kept, fixed for subnormals
+    tiny = top < 1 - QDD_QUAD_BIAS;
+    lsb = tiny ? 1 - QDD_QUAD_BIAS - QSQ_MANT_BITS : top - QSQ_MANT_BITS;
+    shift = lsb - e;
+    rem = 0;
+    if (shift <= 0) {
+        q = a << -shift;
+    } else if (shift >= 128) {
+        q = 0;
+        rem = a;
+    } else {
+        q = a >> shift;
+        rem = a & ((((__uint128_t)1) << shift) - 1);
+        half = ((__uint128_t)1) << (shift - 1);
+        q += rem > half || (rem == half && (q & 1));
+    }
+    // The biased exponent field follows from lsb whether or not q carried
+    // into the next binade, and a subnormal q is its own encoding
+    r.u = ((__uint128_t)(lsb - (1 - QDD_QUAD_BIAS - QSQ_MANT_BITS)) << QSQ_MANT_BITS) + q;
+    if ((r.u >> QSQ_MANT_BITS) >= QSQ_EXP_MASK) {
+        r.u = sign | ((__uint128_t)QSQ_EXP_MASK << QSQ_MANT_BITS);
+        *out = r.f;
+        return QSQ_COMPOSE_OVERFLOW;
+    }
+    r.u |= sign;
+    *out = r.f;
+    if (rem == 0) {
+        return QSQ_COMPOSE_EXACT;
+    }
+    return tiny ? QSQ_COMPOSE_UNDERFLOW : QSQ_COMPOSE_INEXACT;
+}
+
+// Environment variable that pins the ISA level of the batched kernels, e.g.
+// PYQUADP_CPU_LEVEL=x86-64-v2. Levels above what the CPU supports are
+// lowered to the best supported one.
+#define QSOFT_LEVEL_ENV "PYQUADP_CPU_LEVEL"
+
+// Pick the kernels for this CPU, returns -1 if QSOFT_LEVEL_ENV names an
+// unknown level
+int qsoft_init(void);
+const char *qsoft_level_name(void);
+const char *qsoft_cpu_level_name(void);
+int qsoft_num_levels(void);
+const char *qsoft_level_name_at(int level);
+
+// Batched kernels over contiguous arrays, out may alias the inputs
+void qsoft_add_n(const __float128 *a, const __float128 *b, __float128 *out, size_t n);
+void qsoft_sub_n(const __float128 *a, const __float128 *b, __float128 *out, size_t n);
+void qsoft_mul_n(const __float128 *a, const __float128 *b, __float128 *out, size_t n);
+void qsoft_fma_n(const __float128 *a, const __float128 *b, const __float128 *c, __float128 *out, size_t n);
@@ -0,0 +1,938 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
+#include "qreduce.h"
+#include "qtable.h"
+
+// File bytes per loadtxt chunk, and elements per savetxt block
+#define QTABLE_CHUNK_BYTES (1 << 20)
+#define QTABLE_BLOCK_ITEMS 16384
+// savetxt blocks formatted per thread before they are written out
+#define QTABLE_BLOCKS_PER_THREAD 4
+
+typedef struct {
+    // An empty delimiter splits on runs of whitespace
+    const char *delimiter;
+    size_t delimiter_len;
+    // Empty for no comments
+    const char *comments;
+    size_t comments_len;
+} qtable_syntax;
+
+typedef struct {
+    const char *begin;
+    const char *end;
+    // Lines and data rows in the chunk, from the count pass
+    size_t lines;
+    size_t rows;
+    const char *first_row;
+    const char *first_row_end;
+    // First error of the parse pass. error_line counts from 1 within the
+    // chunk, error_column is 0 when the number of columns is wrong.
+    size_t error_line;
+    size_t error_column;
+    size_t error_count;
+    const char *error_text;
+    size_t error_len;
+    bool no_memory;
+} qtable_chunk;
+
+typedef struct {
+    const qtable_kind *kind;
+    qtable_syntax syntax;
+    qtable_chunk *chunks;
+    // First row of each chunk
+    size_t *row_offset;
+    // Rows kept after max_rows
+    size_t nrows;
+    size_t ncols;
+    // Column read into each output column
+    const size_t *usecols;
+    size_t nout;
+    char *out;
+} qtable_load_job;
+
+static bool
+qtable_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static const char *
+qtable_find(const char *p, const char *end, const char *s, size_t len)
+{
+    // First s in [p, end), or end
+    while ((size_t)(end - p) >= len) {
+        const char *hit = memchr(p, s[0], (size_t)(end - p) - len + 1);
+
+        if (hit == NULL) {
+            break;
+        }
+        if (memcmp(hit, s, len) == 0) {
+            return hit;
+        }
+        p = hit + 1;
+    }
+    return end;
+}
+
+static const char *
+qtable_line_end(const char *p, const char *end)
+{
+    const char *nl = memchr(p, '\n', (size_t)(end - p));
+
+    return nl == NULL ? end : nl;
+}
+
+static bool
+qtable_data_row(const char *line, const char *nl, const qtable_syntax *syntax, const char **row_end)
+{
+    // Cuts any comment off a line; rows left blank are skipped
+    const char *p;
+
+    if (syntax->comments_len > 0) {
+        nl = qtable_find(line, nl, syntax->comments, syntax->comments_len);
+    }
+    *row_end = nl;
+    for (p = line; p < nl; p++) {
+        if (!qtable_space(*p)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t
+qtable_split(const char *p, const char *end, const qtable_syntax *syntax, const char **start, size_t *len, size_t max)
+{
+    // Splits a row into fields, storing the first max of them, and returns
+    // how many there are
+    size_t n = 0;
+
+    if (syntax->delimiter_len == 0) {
+        for (;;) {
+            const char *field;
+
+            while (p < end && qtable_space(*p)) {
+                p++;
+            }
+            if (p == end) {
+                return n;
+            }
+            field = p;
+            while (p < end && !qtable_space(*p)) {
+                p++;
+            }
+            if (n < max) {
+                start[n] = field;
+                len[n] = (size_t)(p - field);
+            }
+            n++;
+        }
+    }
+
+    for (;;) {
+        const char *d = qtable_find(p, end, syntax->delimiter, syntax->delimiter_len);
+
+        if (n < max) {
+            start[n] = p;
+            len[n] = (size_t)(d - p);
+        }
+        n++;
+        if (d == end) {
+            return n;
+        }
+        p = d + syntax->delimiter_len;
+    }
+}
+
+static void
+qtable_count_task(void *ctx, size_t task)
+{
+    qtable_load_job *job = (qtable_load_job *)ctx;
+    qtable_chunk *chunk = &job->chunks[task];
+    const char *p = chunk->begin;
+
+    while (p < chunk->end) {
+        const char *nl = qtable_line_end(p, chunk->end);
+        const char *row_end;
+
+        if (qtable_data_row(p, nl, &job->syntax, &row_end)) {
+            if (chunk->rows == 0) {
+                chunk->first_row = p;
+                chunk->first_row_end = row_end;
+            }
+            chunk->rows++;
+        }
+        chunk->lines++;
+        p = nl < chunk->end ? nl + 1 : nl;
+    }
+}
+
+static void
+qtable_parse_task(void *ctx, size_t task)
+{
+    qtable_load_job *job = (qtable_load_job *)ctx;
+    qtable_chunk *chunk = &job->chunks[task];
+    const qtable_kind *kind = job->kind;
+    size_t row = job->row_offset[task];
+    size_t line = 0;
+    const char *p = chunk->begin;
+    const char **start;
+    size_t *len;
+
+    if (row >= job->nrows) {
+        return;
+    }
+    start = malloc(job->ncols * sizeof(*start));
+    len = malloc(job->ncols * sizeof(*len));
+    if (start == NULL || len == NULL) {
+        free(start);
+        free(len);
+        chunk->no_memory = true;
+        return;
+    }
+
+    while (p < chunk->end && row < job->nrows) {
+        const char *nl = qtable_line_end(p, chunk->end);
+        const char *row_end;
+
+        line++;
+        if (qtable_data_row(p, nl, &job->syntax, &row_end)) {
+            char *out = job->out + row * job->nout * kind->itemsize;
+            size_t n = qtable_split(p, row_end, &job->syntax, start, len, job->ncols);
+            size_t j;
+
+            if (n != job->ncols) {
+                chunk->error_line = line;
+                chunk->error_count = n;
+                break;
+            }
+            for (j = 0; j < job->nout; j++) {
+                size_t col = job->usecols == NULL ? j : job->usecols[j];
+
+                if (!kind->parse(start[col], len[col], out + j * kind->itemsize)) {
+                    chunk->error_line = line;
+                    chunk->error_column = col + 1;
+                    chunk->error_text = start[col];
+                    chunk->error_len = len[col];
+                    break;
+                }
+            }
+            if (chunk->error_line != 0) {
+                break;
+            }
+            row++;
+        }
+        p = nl < chunk->end ? nl + 1 : nl;
+    }
+
+    free(start);
+    free(len);
+}
+
+static int
+qtable_threads(int threads)
+{
+    if (threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "threads must be non-negative");
+        return -1;
+    }
+    return threads == 0 ? qreduce_cpu_count() : threads;
+}
+
+static void
+qtable_os_error(int err, PyObject *path)
+{
+    // OSError naming the file as given, not as encoded bytes
+    PyObject *name = PyUnicode_DecodeFSDefault(PyBytes_AsString(path));
+
+    errno = err;
+    PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, name);
+    Py_XDECREF(name);
+}
+
+// Map a whole file read-only. Returns 0 or an errno value; an empty file
+// gives a NULL map. Runs without the GIL.
+static int
+qtable_map_file(const char *filename, const char **map, size_t *size)
+{
+#ifdef _WIN32
+    // filename is UTF-8, as os.fsencode gives on Windows
+    wchar_t *wname;
+    struct _stat64 st;
+    HANDLE mapping;
+    int n, fd, err = 0;
+
+    *map = NULL;
+    *size = 0;
+    n = MultiByteToWideChar(CP_UTF8, 0, filename, -1, NULL, 0);
+    wname = n > 0 ? malloc((size_t)n * sizeof(*wname)) : NULL;
+    if (wname == NULL) {
+        return n > 0 ? ENOMEM : EINVAL;
+    }
+    MultiByteToWideChar(CP_UTF8, 0, filename, -1, wname, n);
+    fd = _wopen(wname, _O_RDONLY | _O_BINARY | _O_NOINHERIT);
+    free(wname);
+    if (fd < 0 || _fstat64(fd, &st) < 0) {
+        err = errno;
+    } else if (st.st_size > 0) {
+        mapping = CreateFileMappingW((HANDLE)_get_osfhandle(fd), NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) {
+            *map = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            // The view keeps the mapping alive
+            CloseHandle(mapping);
+        }
+        if (*map == NULL) {
+            err = GetLastError() == ERROR_NOT_ENOUGH_MEMORY ? ENOMEM : EIO;
+        } else {
+            *size = (size_t)st.st_size;
+        }
+    }
+    if (fd >= 0) {
+        _close(fd);
+    }
+    return err;
+#else
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    void *p;
+    int err = 0;
+
+    *map = NULL;
+    *size = 0;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        err = errno;
+    } else if (st.st_size > 0) {
+        p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            err = errno;
+        } else {
+            *map = p;
+            *size = (size_t)st.st_size;
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return err;
+#endif
+}
+
+static void
+qtable_unmap_file(const char *map, size_t size)
+{
+    if (map == NULL) {
+        return;
+    }
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(map);
+#else
+    munmap((void *)map, size);
+#endif
+}
+
+static int
+qtable_text(PyObject *obj, const char *what, const char **text, size_t *len)
+{
+    // None or a str, as UTF-8; None gives an empty string
+    Py_ssize_t n = 0;
+
+    *text = "";
+    *len = 0;
+    if (obj == NULL || obj == Py_None) {
+        return 0;
+    }
+    if (!PyUnicode_Check(obj)) {
+        PyErr_Format(PyExc_TypeError, "%s must be a str or None", what);
+        return -1;
+    }
+    *text = PyUnicode_AsUTF8AndSize(obj, &n);
+    if (*text == NULL) {
+        return -1;
+    }
+    *len = (size_t)n;
+    return 0;
+}
+
+static Py_ssize_t *
+qtable_usecols(PyObject *obj, size_t *n)
+{
+    // An int or a sequence of ints, possibly negative
+    PyObject *seq;
+    Py_ssize_t *cols;
+    Py_ssize_t i;
+
+    if (PyLong_Check(obj)) {
+        cols = malloc(sizeof(*cols));
+        if (cols == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        cols[0] = PyNumber_AsSsize_t(obj, PyExc_IndexError);
+        if (cols[0] == -1 && PyErr_Occurred()) {
+            free(cols);
+            return NULL;
+        }
+        *n = 1;
+        return cols;
+    }
+
+    seq = PySequence_Fast(obj, "usecols must be an int or a sequence of ints");
+    if (seq == NULL) {
+        return NULL;
+    }
+    *n = (size_t)PySequence_Size(seq);
+    cols = malloc((*n + 1) * sizeof(*cols));
+    if (cols == NULL) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (i = 0; i < (Py_ssize_t)*n; i++) {
+        PyObject *item = PySequence_GetItem(seq, i);
+
+        cols[i] = item == NULL ? -1 : PyNumber_AsSsize_t(item, PyExc_IndexError);
+        Py_XDECREF(item);
+        if (cols[i] == -1 && PyErr_Occurred()) {
+            free(cols);
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+    return cols;
+}
+
+static void
+qtable_chunks(qtable_load_job *job, size_t nchunks, const char *begin, const char *end)
+{
+    // Roughly equal chunks, each ending just after a newline
+    size_t size = (size_t)(end - begin);
+    const char *p = begin;
+    size_t c;
+
+    for (c = 0; c < nchunks; c++) {
+        const char *stop = begin + (size_t)((unsigned __int128)size * (c + 1) / nchunks);
+
+        if (stop < p) {
+            stop = p;
+        }
+        if (stop < end) {
+            stop = qtable_line_end(stop, end);
+            stop = stop < end ? stop + 1 : stop;
+        }
+        job->chunks[c].begin = p;
+        job->chunks[c].end = stop;
+        p = stop;
+    }
+}
+
+static void
+qtable_load_error(const qtable_load_job *job, size_t nchunks, size_t skiprows)
+{
+    // Reports the error nearest the start of the file
+    size_t line = skiprows;
+    size_t c;
+
+    for (c = 0; c < nchunks; c++) {
+        const qtable_chunk *chunk = &job->chunks[c];
+        PyObject *text;
+
+        if (chunk->no_memory) {
+            PyErr_NoMemory();
+            return;
+        }
+        if (chunk->error_line == 0) {
+            line += chunk->lines;
+            continue;
+        }
+        line += chunk->error_line;
+        if (chunk->error_column == 0) {
+            PyErr_Format(PyExc_ValueError, "the number of columns changed from %zu to %zu at line %zu", job->ncols,
+                         chunk->error_count, line);
+            return;
+        }
+        text = PyUnicode_DecodeUTF8(chunk->error_text, (Py_ssize_t)chunk->error_len, "replace");
+        if (text != NULL) {
+            PyErr_Format(PyExc_ValueError, "could not convert string %R to %s at line %zu, column %zu", text,
+                         job->kind->name, line, chunk->error_column);
+            Py_DECREF(text);
+        }
+        return;
+    }
+}
+
+PyObject *
+qtable_loadtxt(const qtable_kind *kind, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"fname", "delimiter", "comments", "skiprows", "usecols", "max_rows", "ndmin", "threads",
+                             NULL};
+    PyObject *path = NULL;
+    PyObject *delimiter_obj = NULL;
+    PyObject *comments_obj = NULL;
+    PyObject *usecols_obj = NULL;
+    PyObject *max_rows_obj = NULL;
+    PyObject *result = NULL;
+    Py_ssize_t skiprows = 0;
+    Py_ssize_t max_rows = -1;
+    Py_ssize_t *usecols = NULL;
+    size_t *columns = NULL;
+    Py_ssize_t dims[2];
+    qtable_load_job job;
+    const char *map = NULL;
+    const char *begin;
+    const char *end;
+    const char *filename;
+    size_t size = 0;
+    size_t skipped = 0;
+    size_t nchunks = 0;
+    size_t total;
+    size_t c;
+    int ndmin = 0;
+    int threads = 1;
+    int nd;
+    int err = 0;
+    bool comments_default;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|$OOnOOii", kwlist, PyUnicode_FSConverter, &path,
+                                     &delimiter_obj, &comments_obj, &skiprows, &usecols_obj, &max_rows_obj, &ndmin,
+                                     &threads)) {
+        return NULL;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.kind = kind;
+    threads = qtable_threads(threads);
+    if (threads < 0) {
+        goto done;
+    }
+    if (qtable_text(delimiter_obj, "delimiter", &job.syntax.delimiter, &job.syntax.delimiter_len) < 0) {
+        goto done;
+    }
+    if (delimiter_obj != NULL && delimiter_obj != Py_None && job.syntax.delimiter_len == 0) {
+        PyErr_SetString(PyExc_ValueError, "delimiter must not be empty");
+        goto done;
+    }
+    comments_default = comments_obj == NULL;
+    if (qtable_text(comments_obj, "comments", &job.syntax.comments, &job.syntax.comments_len) < 0) {
+        goto done;
+    }
+    if (comments_default) {
+        job.syntax.comments = "#";
+        job.syntax.comments_len = 1;
+    }
+    if (skiprows < 0) {
+        PyErr_SetString(PyExc_ValueError, "skiprows must be non-negative");
+        goto done;
+    }
+    if (max_rows_obj != NULL && max_rows_obj != Py_None) {
+        max_rows = PyNumber_AsSsize_t(max_rows_obj, PyExc_OverflowError);
+        if (max_rows == -1 && PyErr_Occurred()) {
+            goto done;
+        }
+        if (max_rows < 0) {
+            PyErr_SetString(PyExc_ValueError, "max_rows must be non-negative");
+            goto done;
+        }
+    }
+    if (ndmin < 0 || ndmin > 2) {
+        PyErr_Format(PyExc_ValueError, "Illegal value of ndmin keyword: %d", ndmin);
+        goto done;
+    }
+    if (usecols_obj != NULL && usecols_obj != Py_None) {
+        usecols = qtable_usecols(usecols_obj, &job.nout);
+        if (usecols == NULL) {
+            goto done;
+        }
+        columns = malloc((job.nout + 1) * sizeof(*columns));
+        if (columns == NULL) {
+            PyErr_NoMemory();
+            goto done;
+        }
+    }
+
+    filename = PyBytes_AsString(path);
+    Py_BEGIN_ALLOW_THREADS
+    err = qtable_map_file(filename, &map, &size);
+    Py_END_ALLOW_THREADS
+    if (err != 0) {
+        qtable_os_error(err, path);
+        goto done;
+    }
+
+    begin = map;
+    end = map + size;
+    nchunks = size / QTABLE_CHUNK_BYTES + 1;
+    job.chunks = calloc(nchunks, sizeof(*job.chunks));
+    job.row_offset = calloc(nchunks, sizeof(*job.row_offset));
+    if (job.chunks == NULL || job.row_offset == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (; skipped < (size_t)skiprows && begin < end; skipped++) {
+        begin = qtable_line_end(begin, end);
+        begin = begin < end ? begin + 1 : begin;
+    }
+    qtable_chunks(&job, nchunks, begin, end);
+    qreduce_parallel_for(nchunks, threads, qtable_count_task, &job);
+    Py_END_ALLOW_THREADS
+
+    total = 0;
+    for (c = 0; c < nchunks; c++) {
+        job.row_offset[c] = total;
+        total += job.chunks[c].rows;
+        if (job.chunks[c].rows > 0 && job.ncols == 0) {
+            job.ncols = qtable_split(job.chunks[c].first_row, job.chunks[c].first_row_end, &job.syntax, NULL, NULL, 0);
+        }
+    }
+    job.nrows = max_rows >= 0 && (size_t)max_rows < total ? (size_t)max_rows : total;
+
+    if (usecols != NULL) {
+        for (c = 0; c < job.nout; c++) {
+            Py_ssize_t col = usecols[c] < 0 ? usecols[c] + (Py_ssize_t)job.ncols : usecols[c];
+
+            if (job.nrows > 0 && (col < 0 || (size_t)col >= job.ncols)) {
+                PyErr_Format(PyExc_ValueError, "invalid column index %zd at row 1 with %zu columns", usecols[c],
+                             job.ncols);
+                goto done;
+            }
+            columns[c] = (size_t)col;
+        }
+        job.usecols = columns;
+    } else {
+        job.nout = job.ncols;
+    }
+
+    // Squeezed as np.loadtxt does, then padded back out to ndmin
+    nd = 0;
+    if (ndmin == 2) {
+        dims[nd++] = (Py_ssize_t)job.nrows;
+        dims[nd++] = (Py_ssize_t)job.nout;
+    } else if (job.nrows == 0) {
+        dims[nd++] = 0;
+    } else {
+        if (job.nrows != 1) {
+            dims[nd++] = (Py_ssize_t)job.nrows;
+        }
+        if (job.nout != 1) {
+            dims[nd++] = (Py_ssize_t)job.nout;
+        }
+        if (nd < ndmin) {
+            dims[nd++] = (Py_ssize_t)(job.nrows * job.nout);
+        }
+    }
+    result = kind->new_array(nd, dims, &job.out);
+    if (result == NULL) {
+        goto done;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    qreduce_parallel_for(nchunks, threads, qtable_parse_task, &job);
+    Py_END_ALLOW_THREADS
+
+    for (c = 0; c < nchunks; c++) {
+        if (job.chunks[c].error_line != 0 || job.chunks[c].no_memory) {
+            qtable_load_error(&job, nchunks, skipped);
+            Py_CLEAR(result);
+            break;
+        }
+    }
+
+done:
+    qtable_unmap_file(map, size);
+    free(job.chunks);
+    free(job.row_offset);
+    free(usecols);
+    free(columns);
+    Py_XDECREF(path);
+    return result;
+}
+
+typedef struct {
+    const qtable_kind *kind;
+    const qformat_spec *spec;
+    const char *data;
+    size_t nrows;
+    size_t ncols;
+    size_t block_rows;
+    size_t first_block;
+    const char *delimiter;
+    size_t delimiter_len;
+    const char *newline;
+    size_t newline_len;
+    char **text;
+    size_t *len;
+    bool failed;
+} qtable_save_job;
+
+static bool
+qtable_append(char **text, size_t *cap, size_t used, const char *s, size_t len)
+{
+    if (used + len > *cap) {
+        size_t grown_cap = 2 * *cap + len;
+        char *grown = realloc(*text, grown_cap);
+
+        if (grown == NULL) {
+            return false;
+        }
+        *text = grown;
+        *cap = grown_cap;
+    }
+    memcpy(*text + used, s, len);
+    return true;
+}
+
+static void
+qtable_format_task(void *ctx, size_t task)
+{
+    // Formats one block of rows into one buffer
+    qtable_save_job *job = (qtable_save_job *)ctx;
+    const qtable_kind *kind = job->kind;
+    size_t block = job->first_block + task;
+    size_t start = block * job->block_rows;
+    size_t stop = start + job->block_rows < job->nrows ? start + job->block_rows : job->nrows;
+    size_t cap = (stop - start) * (job->ncols * (24 + job->delimiter_len) + job->newline_len) + 64;
+    size_t used = 0;
+    size_t i;
+    size_t j;
+    char *text = malloc(cap);
+
+    if (text == NULL) {
+        job->failed = true;
+        return;
+    }
+    for (i = start; i < stop; i++) {
+        for (j = 0; j < job->ncols; j++) {
+            const char *item = job->data + (i * job->ncols + j) * kind->itemsize;
+            int len;
+
+            if (j > 0 && !qtable_append(&text, &cap, used, job->delimiter, job->delimiter_len)) {
+                goto fail;
+            }
+            used += j > 0 ? job->delimiter_len : 0;
+            len = kind->format(item, job->spec, text + used, cap - used);
+            if (len >= 0 && (size_t)len >= cap - used) {
+                char *grown;
+
+                cap = 2 * cap + (size_t)len + 1;
+                grown = realloc(text, cap);
+                if (grown == NULL) {
+                    goto fail;
+                }
+                text = grown;
+                len = kind->format(item, job->spec, text + used, cap - used);
+            }
+            if (len < 0) {
+                goto fail;
+            }
+            used += (size_t)len;
+        }
+        if (!qtable_append(&text, &cap, used, job->newline, job->newline_len)) {
+            goto fail;
+        }
+        used += job->newline_len;
+    }
+    job->text[task] = text;
+    job->len[task] = used;
+    return;
+
+fail:
+    free(text);
+    job->failed = true;
+}
+
+static bool
+qtable_write_comment(FILE *fp, const char *text, size_t len, const char *comments, size_t comments_len,
+                     const char *newline, size_t newline_len)
+{
+    // Every line of a header or footer starts with the comment string
+    const char *end = text + len;
+    bool ok = fwrite(comments, 1, comments_len, fp) == comments_len;
+
+    while (ok && text < end) {
+        const char *nl = qtable_line_end(text, end);
+
+        ok = fwrite(text, 1, (size_t)(nl - text), fp) == (size_t)(nl - text);
+        if (ok && nl < end) {
+            ok = fputc('\n', fp) != EOF && fwrite(comments, 1, comments_len, fp) == comments_len;
+            nl++;
+        }
+        text = nl;
+    }
+    return ok && fwrite(newline, 1, newline_len, fp) == newline_len;
+}
+
+PyObject *
+qtable_savetxt(const qtable_kind *kind, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = {"fname", "X", "fmt", "delimiter", "newline", "header", "footer", "comments", "threads",
+                             NULL};
+    PyObject *path = NULL;
+    PyObject *obj;
+    PyObject *arr = NULL;
+    PyObject *fmt_obj = NULL;
+    PyObject *delimiter_obj = NULL;
+    PyObject *newline_obj = NULL;
+    PyObject *header_obj = NULL;
+    PyObject *footer_obj = NULL;
+    PyObject *comments_obj = NULL;
+    PyObject *result = NULL;
+    const char *filename;
+    const char *fmt;
+    const char *header;
+    const char *footer;
+    const char *comments;
+    size_t fmt_len;
+    size_t header_len;
+    size_t footer_len;
+    size_t comments_len;
+    qformat_spec spec;
+    qtable_save_job job;
+    Py_ssize_t dims[2];
+    size_t nblocks;
+    size_t batch;
+    FILE *fp;
+    int nd;
+    int threads = 1;
+    int err = 0;
+    bool failed = false;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O|OOOOOO$i", kwlist, PyUnicode_FSConverter, &path, &obj,
+                                     &fmt_obj, &delimiter_obj, &newline_obj, &header_obj, &footer_obj, &comments_obj,
+                                     &threads)) {
+        return NULL;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.kind = kind;
+    threads = qtable_threads(threads);
+    if (threads < 0 || qtable_text(fmt_obj, "fmt", &fmt, &fmt_len) < 0
+        || qtable_text(delimiter_obj, "delimiter", &job.delimiter, &job.delimiter_len) < 0
+        || qtable_text(newline_obj, "newline", &job.newline, &job.newline_len) < 0
+        || qtable_text(header_obj, "header", &header, &header_len) < 0
+        || qtable_text(footer_obj, "footer", &footer, &footer_len) < 0
+        || qtable_text(comments_obj, "comments", &comments, &comments_len) < 0) {
+        goto done;
+    }
+    if (delimiter_obj == NULL) {
+        job.delimiter = " ";
+        job.delimiter_len = 1;
+    }
+    if (newline_obj == NULL) {
+        job.newline = "\n";
+        job.newline_len = 1;
+    }
+    if (comments_obj == NULL) {
+        comments = "# ";
+        comments_len = 2;
+    }
+    if (fmt_len > 0) {
+        if (!kind->format_spec) {
+            PyErr_Format(PyExc_ValueError, "fmt is not supported for %s", kind->name);
+            goto done;
+        }
+        if (!qformat_parse_spec(fmt, fmt_len, &spec)) {
+            PyErr_Format(PyExc_ValueError, "Invalid format specifier '%s' for object of type '%s'", fmt, kind->name);
+            goto done;
+        }
+        job.spec = &spec;
+    }
+
+    arr = kind->as_array(obj, &nd, dims, &job.data);
+    if (arr == NULL) {
+        goto done;
+    }
+    if (nd < 1 || nd > 2) {
+        PyErr_Format(PyExc_ValueError, "Expected 1D or 2D array, got %dD array instead", nd);
+        goto done;
+    }
+    // A 1D array is written one element per line
+    job.nrows = (size_t)dims[0];
+    job.ncols = nd == 2 ? (size_t)dims[1] : 1;
+    job.block_rows = job.ncols > 0 && job.ncols < QTABLE_BLOCK_ITEMS ? QTABLE_BLOCK_ITEMS / job.ncols : 1;
+    nblocks = (job.nrows + job.block_rows - 1) / job.block_rows;
+    batch = (size_t)threads * QTABLE_BLOCKS_PER_THREAD;
+    job.text = calloc(batch, sizeof(*job.text));
+    job.len = calloc(batch, sizeof(*job.len));
+    if (job.text == NULL || job.len == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    filename = PyBytes_AsString(path);
+    Py_BEGIN_ALLOW_THREADS
+    fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        err = errno;
+    } else {
+        if (header_len > 0) {
+            failed = !qtable_write_comment(fp, header, header_len, comments, comments_len, job.newline,
+                                           job.newline_len);
+        }
+        for (job.first_block = 0; !failed && job.first_block < nblocks; job.first_block += batch) {
+            size_t n = nblocks - job.first_block < batch ? nblocks - job.first_block : batch;
+            size_t b;
+
+            qreduce_parallel_for(n, threads, qtable_format_task, &job);
+            for (b = 0; b < n; b++) {
+                if (!job.failed && !failed) {
+                    failed = fwrite(job.text[b], 1, job.len[b], fp) != job.len[b];
+                }
+                free(job.text[b]);
+                job.text[b] = NULL;
+            }
+            failed = failed || job.failed;
+        }
+        if (!failed && footer_len > 0) {
+            failed = !qtable_write_comment(fp, footer, footer_len, comments, comments_len, job.newline,
+                                           job.newline_len);
+        }
+        if (failed && !job.failed) {
+            err = errno != 0 ? errno : EIO;
+        }
+        if (fclose(fp) != 0 && !failed) {
+            failed = true;
+            err = errno;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if (job.failed) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    if (err != 0) {
+        qtable_os_error(err, path);
+        goto done;
+    }
+    result = Py_NewRef(Py_None);
+
+done:
+    free(job.text);
+    free(job.len);
+    Py_XDECREF(arr);
+    Py_XDECREF(path);
+    return result;
+}
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+
+// Text tables, loadtxt and savetxt for the quad array modules.
+//
+// loadtxt maps the file and cuts it into line aligned chunks. A first pass
+// counts the rows of every chunk in parallel, the array is allocated once,
+// and a second pass parses each chunk straight into its rows. savetxt
+// formats blocks of rows in parallel and writes them out in order. The GIL
+// is released for all file access, parsing and formatting.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "qformat.h"
+#include "qtext.h"
+
+typedef struct {
+    // Scalar type name for error messages, "qfloat"
+    const char *name;
+    size_t itemsize;
+    qtext_parser parse;
+    // Text of one element as snprintf would write it; spec is NULL for the
+    // default repr. Returns the full length or -1 if out of memory.
+    int (*format)(const void *item, const qformat_spec *spec, char *buf, size_t size);
+    // Whether savetxt accepts a fmt spec
+    bool format_spec;
+    // New C-contiguous array of the module's dtype and its data
+    PyObject *(*new_array)(int nd, const Py_ssize_t *dims, char **data);
+    // obj as a C-contiguous array of the module's dtype, a new reference
+    PyObject *(*as_array)(PyObject *obj, int *nd, Py_ssize_t *dims, const char **data);
+} qtable_kind;
+
+// loadtxt(fname, *, delimiter=None, comments="#", skiprows=0, usecols=None,
+//         max_rows=None, ndmin=0, threads=1)
+PyObject *qtable_loadtxt(const qtable_kind *kind, PyObject *args, PyObject *kwargs);
+
+// savetxt(fname, X, fmt="", delimiter=" ", newline="\n", header="",
+//         footer="", comments="# ", *, threads=1)
+PyObject *qtable_savetxt(const qtable_kind *kind, PyObject *args, PyObject *kwargs);
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-2.0+
+#include "pyquadp.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "qtext.h"
+
+bool
+qtext_parse(const char *item, size_t itemsize, bool ucs4, bool swap, qtext_parser parse, void *out)
+{
+    char stack_buf[QTEXT_BUFFER];
+    char *buf;
+    size_t len;
+    size_t i;
+    bool ok;
+
+    if (!ucs4) {
+        len = itemsize;
+        while (len > 0 && item[len - 1] == '\0') {
+            len--;
+        }
+        return parse(item, len, out);
+    }
+
+    len = itemsize / 4;
+    for (; len > 0; len--) {
+        uint32_t c;
+
+        memcpy(&c, item + 4 * (len - 1), sizeof(c));
+        if (c != 0) {
+            break;
+        }
+    }
+    buf = len <= QTEXT_BUFFER ? stack_buf : malloc(len);
+    if (buf == NULL) {
+        return false;
+    }
+
+    ok = true;
+    for (i = 0; i < len; i++) {
+        uint32_t c;
+
+        memcpy(&c, item + 4 * i, sizeof(c));
+        if (swap) {
+            c = __builtin_bswap32(c);
+        }
+        if (c >= 0x80) {
+            ok = false;
+            break;
+        }
+        buf[i] = (char)c;
+    }
+    ok = ok && parse(buf, len, out);
+
+    if (buf != stack_buf) {
+        free(buf);
+    }
+    return ok;
+}
+
+bool
+qtext_store(const char *text, size_t len, char *item, size_t itemsize, bool ucs4, bool swap)
+{
+    size_t i;
+
+    if (!ucs4) {
+        if (len > itemsize) {
+            return false;
+        }
+        memcpy(item, text, len);
+        memset(item + len, 0, itemsize - len);
+        return true;
+    }
+
+    if (len > itemsize / 4) {
+        return false;
+    }
+    for (i = 0; i < len; i++) {
+        uint32_t c = (unsigned char)text[i];
+
+        if (swap) {
+            c = __builtin_bswap32(c);
+        }
+        memcpy(item + 4 * i, &c, sizeof(c));
+    }
+    memset(item + 4 * len, 0, itemsize - 4 * len);
+    return true;
+}
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-2.0+
+#pragma once
+
+// Text held in NumPy S (bytes) and U (UCS4) array elements.
+//
+// Elements are fixed width and padded with trailing NULs. U text is only
+// ever numbers here, so anything outside ASCII is rejected rather than
+// decoded.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Longest U element converted on the stack, anything longer is copied to the heap
+#define QTEXT_BUFFER 256
+
+// Parses len bytes of ASCII text into *out
+typedef bool (*qtext_parser)(const char *s, size_t len, void *out);
+
+// Run parse over the text of one element of itemsize bytes. ucs4 selects U
+// over S, swap a U element in non-native byte order. Returns false if the
+// text is not ASCII, does not parse or memory runs out.
+bool qtext_parse(const char *item, size_t itemsize, bool ucs4, bool swap, qtext_parser parse, void *out);
+
+// Store len bytes of ASCII text into an element, NUL padded. Returns false,
+// leaving the element untouched, if the text does not fit.
+bool qtext_store(const char *text, size_t len, char *item, size_t itemsize, bool ucs4, bool swap);
@@ -5,25 +5,37 @@ from setuptools import Extension, setup
 extensions = [
     Extension(
         name="pyquadp.qmathc",
-        sources=["pyquadp/qfloat.c", "pyquadp/qmathc.c"],
+        sources=["pyquadp/qfloat.c", "pyquadp/qparse.c", "pyquadp/qformat.c", "pyquadp/qmathc.c"],
         libraries=["quadmath"],
         py_limited_api=True,
     ),
     Extension(
         name="pyquadp.qcmathc",
-        sources=["pyquadp/qfloat.c", "pyquadp/qcmplx.c", "pyquadp/qcmathc.c"],
+        sources=["pyquadp/qfloat.c", "pyquadp/qparse.c", "pyquadp/qformat.c", "pyquadp/qcmplx.c", "pyquadp/qcmathc.c"],
         libraries=["quadmath"],
         py_limited_api=True,
     ),
     Extension(
         name="pyquadp.qmfloat",
-        sources=["pyquadp/qfloat.c"],
+        sources=["pyquadp/qfloat.c", "pyquadp/qparse.c", "pyquadp/qformat.c"],
         libraries=["quadmath"],
         py_limited_api=True,
     ),
     Extension(
         name="pyquadp.qmcmplx",
-        sources=["pyquadp/qfloat.c", "pyquadp/qcmplx.c"],
+        sources=["pyquadp/qfloat.c", "pyquadp/qparse.c", "pyquadp/qformat.c", "pyquadp/qcmplx.c"],
+        libraries=["quadmath"],
+        py_limited_api=True,
+    ),
+    Extension(
+        name="pyquadp.qmddfloat",
+        sources=["pyquadp/ddfloat.c"],
+        libraries=["quadmath"],
+        py_limited_api=True,
+    ),
+    Extension(
+        name="pyquadp.qmqqfloat",
+        sources=["pyquadp/qqfloat.c", "pyquadp/qqmath.c"],
         libraries=["quadmath"],
         py_limited_api=True,
     ),
@@ -43,21 +55,66 @@ if __name__ == "__main__":
         [
             Extension(
                 name="pyquadp.qarray",
-                sources=["pyquadp/qfloatarray.c"],
+                sources=[
+                    "pyquadp/qfloatarray.c",
+                    "pyquadp/qfastmath.c",
+                    "pyquadp/qsoftquad.c",
+                    "pyquadp/qreduce.c",
+                    "pyquadp/qparse.c",
+                    "pyquadp/qformat.c",
+                    "pyquadp/qtext.c",
+                    "pyquadp/qtable.c",
+                    "pyquadp/qdlpack.c",
+                    "pyquadp/qarrow.c",
+                ],
                 include_dirs=["pyquadp", np.get_include()],
                 libraries=["quadmath"],
                 py_limited_api=True,
             ),
             Extension(
                 name="pyquadp.qcarray",
-                sources=["pyquadp/qcarray.c"],
+                sources=[
+                    "pyquadp/qcarray.c",
+                    "pyquadp/qsoftquad.c",
+                    "pyquadp/qreduce.c",
+                    "pyquadp/qparse.c",
+                    "pyquadp/qformat.c",
+                    "pyquadp/qtext.c",
+                    "pyquadp/qtable.c",
+                    "pyquadp/qdlpack.c",
+                    "pyquadp/qarrow.c",
+                ],
                 include_dirs=["pyquadp", np.get_include()],
                 libraries=["quadmath"],
                 py_limited_api=True,
             ),
             Extension(
                 name="pyquadp.qiarray",
-                sources=["pyquadp/qiarray.c"],
+                sources=[
+                    "pyquadp/qiarray.c",
+                    "pyquadp/qsoftquad.c",
+                    "pyquadp/qreduce.c",
+                    "pyquadp/qparse.c",
+                    "pyquadp/qformat.c",
+                    "pyquadp/qtext.c",
+                    "pyquadp/qtable.c",
+                    "pyquadp/qdlpack.c",
+                    "pyquadp/qarrow.c",
+                ],
+                include_dirs=["pyquadp", np.get_include()],
+                libraries=["quadmath"],
+                py_limited_api=True,
+            ),
+            Extension(
+                name="pyquadp.ddarray",
+                sources=["pyquadp/ddarray.c", "pyquadp/qddmath.c"],
+                include_dirs=["pyquadp", np.get_include()],
+                libraries=["quadmath"],
+                py_limited_api=True,
+            ),
+            Extension(
+                name="pyquadp.qqarray",
+                sources=["pyquadp/qqarray.c", "pyquadp/qqmath.c"],
                 include_dirs=["pyquadp", np.get_include()],
                 libraries=["quadmath"],
                 py_limited_api=True,
@@ -0,0 +1,338 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+import math
+import operator
+
+import numpy as np
+import pytest
+
+import pyquadp as pq
+import pyquadp.ddarray as ddarray
+import pyquadp.qarray as qarray
+
+# Double-double results are good to a few units of 2^-106
+DD_RTOL = 2.0**-100
+
+
+def _dd_spread(size, seed):
+    # Values with a non-zero trailing part, built as quad divisions. Returns
+    # the ddarray and its exact qarray copy.
+    rng = np.random.default_rng(seed)
+    num = rng.integers(1, 2**40, size=size).astype(np.float64)
+    den = rng.integers(1, 2**20, size=size).astype(np.float64)
+    dd = np.divide(num.astype(qarray.dtype), den).astype(ddarray.dtype)
+    return dd, dd.astype(qarray.dtype)
+
+
+def _max_rel_err(dd, ref):
+    diff = dd.astype(qarray.dtype) - ref
+    return max(
+        abs(float(d / r)) if r != 0 else abs(float(d)) for d, r in zip(diff, ref)
+    )
+
+
+@pytest.mark.ddarray
+class TestDDArrayImport:
+    def test_ddarray_module_imports(self):
+
+        assert ddarray is not None
+        assert pq.ddarray is ddarray
+
+    def test_ddarray_type_exported(self):
+
+        assert ddarray.ddarray is pq.ddfloat
+        assert ddarray.dtype.itemsize == 16
+
+
+@pytest.mark.ddarray
+class TestDDArrayConstructors:
+    def test_zeros_ones_full(self):
+
+        arr = ddarray.zeros((2, 3))
+        assert arr.shape == (2, 3)
+        assert arr.dtype == ddarray.dtype
+        assert np.all(arr.astype(np.float64) == 0)
+
+        arr = ddarray.ones(3)
+        assert np.all(arr.astype(np.float64) == 1)
+
+        arr = ddarray.full(2, "0.1")
+        assert arr[0] == pq.ddfloat("0.1")
+        assert arr[1].lo != 0
+
+        assert ddarray.empty(4).shape == (4,)
+
+    def test_from_list(self):
+
+        arr = ddarray.from_list([1, 2.5, "3.141592653589793238", pq.qfloat(1) / 3])
+        assert arr.dtype == ddarray.dtype
+        assert arr[0] == 1
+        assert arr[1] == 2.5
+        assert arr[2] == pq.ddfloat("3.141592653589793238")
+        assert arr[3] == pq.ddfloat(pq.qfloat(1) / 3)
+
+        with pytest.raises(TypeError):
+            ddarray.from_list(["abc"])
+
+    def test_like(self):
+
+        base = np.zeros((2, 2))
+        assert ddarray.empty_like(base).shape == (2, 2)
+        assert np.all(ddarray.zeros_like(base).astype(np.float64) == 0)
+        assert np.all(ddarray.ones_like(base).astype(np.float64) == 1)
+        assert ddarray.full_like(base, 3)[1, 1] == 3
+
+    def test_asarray(self):
+
+        arr = ddarray.from_list([1, 2])
+        assert ddarray.asarray(arr) is arr
+        assert ddarray.asarray(arr, copy=True) is not arr
+        assert ddarray.from_array(np.array([1.5, 2.5]))[1] == 2.5
+
+
+@pytest.mark.ddarray
+class TestDDArrayCasts:
+    def test_float64_roundtrip(self):
+
+        x = np.random.default_rng(1).random(100)
+        dd = x.astype(ddarray.dtype)
+        assert np.all(dd.astype(np.float64) == x)
+        assert np.all(np.asarray(x, dtype=ddarray.dtype).astype(np.float64) == x)
+
+    def test_float32(self):
+
+        x = np.array([0.5, 1.25, -3.0], dtype=np.float32)
+        dd = x.astype(ddarray.dtype)
+        np.testing.assert_array_equal(dd.astype(np.float32), x)
+
+    def test_safe_casts(self):
+
+        # Widening into ddarray and on to qarray is safe, narrowing is not
+        dd = ddarray.dtype
+        assert np.can_cast(np.float64, dd, "safe")
+        assert np.can_cast(dd, qarray.dtype, "safe")
+        assert not np.can_cast(dd, np.float64, "safe")
+        assert not np.can_cast(dd, np.float32, "safe")
+        assert np.result_type(dd, np.float32) == dd
+        assert np.result_type(dd, np.float64) == dd
+
+        x = np.divide(ddarray.from_list([1]), 3)
+        assert (x * np.float32(0.5)).dtype == dd
+        assert np.all(x * np.float32(0.5) == np.divide(x, 2.0))
+        assert x[0] > x.astype(np.float64)[0] and x[0] != x.astype(np.float64)[0]
+        assert np.less([x[0]], x).tolist() == [False]
+
+    def test_qarray_roundtrip(self):
+
+        q = np.divide(qarray.from_list(range(1, 201)), 7)
+        dd = q.astype(ddarray.dtype)
+        # qarray -> ddarray rounds, ddarray -> qarray is exact
+        assert _max_rel_err(dd, q) < DD_RTOL
+        assert np.all(dd.astype(qarray.dtype).astype(ddarray.dtype) == dd)
+
+    def test_qarray_range(self):
+
+        q = qarray.from_list(["1e400", "-1e400", "1e-400", "nan"])
+        with np.errstate(all="ignore"):
+            dd = q.astype(ddarray.dtype)
+        assert dd[0].hi == math.inf
+        assert dd[1].hi == -math.inf
+        assert dd[2].hi == 0
+        assert math.isnan(dd[3].hi)
+
+
+@pytest.mark.ddarray
+class TestDDArrayUfuncs:
+    @pytest.mark.parametrize(
+        "ufunc", [np.add, np.subtract, np.multiply, np.divide]
+    )
+    def test_binary(self, ufunc):
+
+        a, qa = _dd_spread(500, 3)
+        b, qb = _dd_spread(500, 4)
+        out = ufunc(a, b)
+        assert out.dtype == ddarray.dtype
+        assert _max_rel_err(out, ufunc(qa, qb)) < DD_RTOL
+
+        # Strided operands take the generic loop
+        out = ufunc(a[::2], b[1::2])
+        assert _max_rel_err(out, ufunc(qa[::2], qb[1::2])) < DD_RTOL
+
+    @pytest.mark.parametrize(
+        "ufunc", [np.add, np.subtract, np.multiply, np.divide]
+    )
+    def test_binary_float64(self, ufunc):
+
+        a, qa = _dd_spread(100, 5)
+        d = np.random.default_rng(6).random(100) + 0.5
+
+        out = ufunc(a, d)
+        assert out.dtype == ddarray.dtype
+        assert _max_rel_err(out, ufunc(qa, d)) < DD_RTOL
+
+        out = ufunc(d, a)
+        assert out.dtype == ddarray.dtype
+        assert _max_rel_err(out, ufunc(d, qa)) < DD_RTOL
+
+    @pytest.mark.parametrize(
+        "ufunc", [np.add, np.subtract, np.multiply, np.divide]
+    )
+    def test_binary_qarray(self, ufunc):
+
+        a, qa = _dd_spread(50, 7)
+        q = qarray.from_list([pq.qfloat(1) / 7] * 50)
+
+        # Mixing with qarray is done in quad precision
+        out = ufunc(a, q)
+        assert out.dtype == qarray.dtype
+        assert np.all(out == ufunc(a.astype(qarray.dtype), q))
+
+        out = ufunc(q, a)
+        assert out.dtype == qarray.dtype
+        assert np.all(out == ufunc(q, a.astype(qarray.dtype)))
+
+    @pytest.mark.parametrize(
+        "ufunc, op",
+        [
+            (np.equal, operator.eq),
+            (np.not_equal, operator.ne),
+            (np.less, operator.lt),
+            (np.less_equal, operator.le),
+            (np.greater, operator.gt),
+            (np.greater_equal, operator.ge),
+        ],
+    )
+    def test_compare_mixed(self, ufunc, op):
+
+        a = ddarray.from_list(
+            [1, 2, 3, pq.ddfloat(2.0, 2.0**-70), pq.ddfloat(2.0, -(2.0**-70)), "nan"]
+        )
+        qa = [x.to_qfloat() for x in a]
+
+        # Ordered compares with the NaN flag invalid as the other loops do
+        with np.errstate(invalid="ignore"):
+            # Python and NumPy numbers compare against the full pair
+            for b in [2, np.int32(2), 2.0]:
+                assert ufunc(a, b).tolist() == [op(x, pq.qfloat(float(b))) for x in qa]
+                assert ufunc(b, a).tolist() == [op(pq.qfloat(float(b)), x) for x in qa]
+
+            # and qarray in quad precision, not through float64
+            q = pq.qfloat("2.0000000000000000000000000001")
+            qarr = qarray.from_list([q] * len(a))
+            assert ufunc(a, qarr).tolist() == [op(x, q) for x in qa]
+            assert ufunc(qarr, a).tolist() == [op(q, x) for x in qa]
+
+    @pytest.mark.parametrize(
+        "ufunc", [np.negative, np.positive, np.absolute, np.square, np.sqrt]
+    )
+    def test_unary(self, ufunc):
+
+        a, qa = _dd_spread(200, 8)
+        out = ufunc(a)
+        assert out.dtype == ddarray.dtype
+        assert _max_rel_err(out, ufunc(qa)) < DD_RTOL
+
+    @pytest.mark.parametrize(
+        "ufunc, lo, hi",
+        [
+            (np.exp, -700.0, 700.0),
+            (np.log, 1e-300, 1e300),
+            (np.sin, -100.0, 100.0),
+            (np.cos, -100.0, 100.0),
+        ],
+    )
+    def test_math(self, ufunc, lo, hi):
+
+        rng = np.random.default_rng(9)
+        if ufunc is np.log:
+            x = np.exp(rng.uniform(np.log(lo), np.log(hi), 500))
+        else:
+            x = rng.uniform(lo, hi, 500)
+        q = np.divide(x.astype(qarray.dtype), 3)
+        dd = q.astype(ddarray.dtype)
+        ref = ufunc(dd.astype(qarray.dtype))
+        assert _max_rel_err(ufunc(dd), ref) < DD_RTOL
+
+    def test_math_near_one(self):
+
+        x = ddarray.from_list([1, pq.ddfloat(1.0, 2.0**-70), pq.ddfloat(1.0, -(2.0**-60))])
+        ref = np.log(x.astype(qarray.dtype))
+        out = np.log(x)
+        assert out[0] == 0
+        assert _max_rel_err(out[1:], ref[1:]) < DD_RTOL
+
+    def test_special(self):
+
+        x = ddarray.from_list(["inf", "-inf", "nan", 0, -1, 1000, -1000])
+        with np.errstate(all="ignore"):
+            e = np.exp(x)
+            s = np.sqrt(x)
+            lg = np.log(x)
+            sn = np.sin(x)
+        assert e[0].hi == math.inf
+        assert e[1].hi == 0
+        assert math.isnan(e[2].hi)
+        assert e[5].hi == math.inf
+        assert e[6].hi == 0
+        assert s[0].hi == math.inf
+        assert s[3].hi == 0
+        assert math.isnan(s[4].hi)
+        assert lg[3].hi == -math.inf
+        assert math.isnan(lg[4].hi)
+        assert math.isnan(sn[0].hi)
+
+        with np.errstate(all="ignore"):
+            y = np.divide(ddarray.from_list([1, -1, 0]), ddarray.zeros(3))
+        assert y[0].hi == math.inf
+        assert y[1].hi == -math.inf
+        assert math.isnan(y[2].hi)
+
+    def test_near_dbl_max(self):
+        # Splitting the operands for the exact product must not overflow
+        x = ddarray.from_list([pq.ddfloat(1.7e308, 1.7e283)])
+        ref = x.astype(qarray.dtype)
+        with np.errstate(all="raise"):
+            for out, exact in [(x * 0.5, ref * 0.5), (x / 2.0, ref / 2), (x * 1e-300, ref * 1e-300)]:
+                assert _max_rel_err(out, exact) < DD_RTOL
+
+    def test_signed_zero(self):
+        z = ddarray.from_list([-0.0])
+        for r in (np.add(z, z), np.multiply(z, 1.0), np.subtract(z, 0.0), z / 2.0):
+            assert math.copysign(1, r[0].hi) == -1
+        assert str(z.astype(qarray.dtype)[0]) == "-0.0"
+        assert math.copysign(1, np.add(z, -z)[0].hi) == 1
+        assert math.copysign(1, (z * z)[0].hi) == 1
+
+
+@pytest.mark.ddarray
+class TestDDArrayHardening:
+    def test_sort_argmax(self):
+
+        arr = ddarray.from_list([pq.ddfloat(1.0, 2.0**-80), 3, 1, -2])
+        np.testing.assert_array_equal(np.argsort(arr), [3, 2, 0, 1])
+        assert np.argmax(arr) == 1
+        assert np.argmin(arr) == 3
+
+        arr = ddarray.from_list([1, "nan", 2])
+        assert np.argmax(arr) == 1
+        assert np.argmin(arr) == 1
+
+    def test_nonzero(self):
+
+        arr = ddarray.from_list([0, -0.0, 1, "nan"])
+        np.testing.assert_array_equal(np.nonzero(arr)[0], [2, 3])
+
+    def test_byteswap(self):
+
+        dd, _ = _dd_spread(10, 10)
+        swapped = dd.byteswap()
+        raw = swapped.view(np.uint8).reshape(10, 2, 8)
+        ref = dd.view(np.uint8).reshape(10, 2, 8)[:, :, ::-1]
+        np.testing.assert_array_equal(raw, ref)
+        assert np.all(swapped.byteswap() == dd)
+
+    def test_fill(self):
+
+        arr = ddarray.empty(3)
+        arr.fill(pq.ddfloat(1) / 3)
+        assert np.all(arr == pq.ddfloat(1) / 3)
@@ -0,0 +1,171 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+import math
+import pickle
+
+import pytest
+
+import pyquadp as pq
+
+# Double-double results are good to a few units of 2^-106
+DD_RTOL = 2.0**-100
+
+
+def _rel_err(dd, q):
+    return abs(float((dd.to_qfloat() - q) / q))
+
+
+class TestDDFloat:
+    def test_make(self):
+        d = pq.ddfloat(1)
+        assert d.hi == 1.0
+        assert d.lo == 0.0
+        assert repr(d) == "ddfloat('1.00000000000000000000000000000000e+00')"
+        assert str(d) == "1.00000000000000000000000000000000e+00"
+
+        d = pq.ddfloat(0.1)
+        assert d.hi == 0.1
+        assert d.lo == 0.0
+
+        d = pq.ddfloat("0.1")
+        assert d.hi == 0.1
+        assert d.lo != 0.0
+        assert _rel_err(d, pq.qfloat("0.1")) < DD_RTOL
+
+        with pytest.raises(TypeError):
+            pq.ddfloat("abc")
+
+        with pytest.raises(TypeError):
+            pq.ddfloat([1])
+
+    def test_hi_lo(self):
+        d = pq.ddfloat(1.0, 2.0**-80)
+        assert d.hi == 1.0
+        assert d.lo == 2.0**-80
+
+        # Renormalised so that hi is the rounded sum
+        d = pq.ddfloat(1.0, 1.0)
+        assert d.hi == 2.0
+        assert d.lo == 0.0
+
+    def test_large_int(self):
+        d = pq.ddfloat(2**80 + 1)
+        assert d.hi == 2.0**80
+        assert d.lo == 1.0
+        assert int(d) == 2**80 + 1
+
+        assert int(pq.ddfloat(2**62 + 1)) == 2**62 + 1
+        assert int(pq.ddfloat(-(2**70) - 3)) == -(2**70) - 3
+
+    def test_int_float(self):
+        assert int(pq.ddfloat("2.75")) == 2
+        assert int(pq.ddfloat("-2.75")) == -2
+        # hi rounds up to an integer and lo is a small negative correction
+        assert int(pq.ddfloat(2.0**60, -0.5)) == 2**60 - 1
+        assert int(pq.ddfloat(-(2.0**60), 0.5)) == -(2**60) + 1
+        assert float(pq.ddfloat(1) / 3) == 1 / 3
+
+        with pytest.raises(OverflowError):
+            int(pq.ddfloat(math.inf))
+
+    def test_arithmetic(self):
+        a = pq.ddfloat("1.2345678901234567890123456789")
+        b = pq.ddfloat("9.8765432109876543210987654321")
+        qa = a.to_qfloat()
+        qb = b.to_qfloat()
+
+        assert _rel_err(a + b, qa + qb) < DD_RTOL
+        assert _rel_err(a - b, qa - qb) < DD_RTOL
+        assert _rel_err(a * b, qa * qb) < DD_RTOL
+        assert _rel_err(a / b, qa / qb) < DD_RTOL
+        assert -a == pq.ddfloat(0) - a
+        assert abs(-a) == a
+        assert +a == a
+
+    def test_mixed(self):
+        d = pq.ddfloat(1) / 3
+
+        assert isinstance(d + 1, pq.ddfloat)
+        assert isinstance(1.5 * d, pq.ddfloat)
+        assert isinstance(d - "1", pq.ddfloat)
+
+        # Mixing with qfloat promotes to qfloat
+        assert isinstance(d + pq.qfloat(1), pq.qfloat)
+        assert isinstance(pq.qfloat(1) / d, pq.qfloat)
+        assert d.to_qfloat() == d
+        assert pq.qfloat(2) > d
+
+    def test_special(self):
+        inf = pq.ddfloat(math.inf)
+        assert (inf + 1).hi == math.inf
+        assert (inf * 2).hi == math.inf
+        assert math.isnan((inf - inf).hi)
+        assert (pq.ddfloat(1) / 0).hi == math.inf
+        assert (pq.ddfloat(-1) / 0).hi == -math.inf
+        assert (pq.ddfloat(1) / inf).hi == 0
+        assert (pq.ddfloat(1e308) * 10).hi == math.inf
+
+        nan = pq.ddfloat("nan")
+        assert nan != nan
+        assert not (nan == nan)
+        assert not (nan < 1)
+
+    def test_signed_zero(self):
+        z = pq.ddfloat(-0.0)
+        assert repr(z).startswith("ddfloat('-0.")
+        assert str(z.to_qfloat()) == "-0.0"
+        assert math.copysign(1, (z + z).hi) == -1
+        assert math.copysign(1, (z * pq.ddfloat(1.0)).hi) == -1
+        assert math.copysign(1, (z + pq.ddfloat(0.0)).hi) == 1
+
+    def test_compare(self):
+        a = pq.ddfloat(1.0, 2.0**-80)
+        b = pq.ddfloat(1.0)
+
+        assert a > b
+        assert b < a
+        assert a >= b
+        assert b <= a
+        assert a != b
+        assert b == 1
+        assert b == 1.0
+
+    def test_bool(self):
+        assert not pq.ddfloat(0)
+        assert not pq.ddfloat(-0.0)
+        assert pq.ddfloat(2.0**-1000)
+
+    def test_hash(self):
+        assert hash(pq.ddfloat(1.5)) == hash(1.5)
+        assert hash(pq.ddfloat(2)) == hash(2)
+        assert hash(pq.ddfloat(1) / 3) == hash(pq.ddfloat(1) / 3)
+        assert len({pq.ddfloat(1), pq.ddfloat(1.0), 1}) == 1
+
+    def test_bytes(self):
+        d = pq.ddfloat(1) / 3
+        b = d.to_bytes()
+        assert len(b) == 16
+        assert pq.ddfloat.from_bytes(b) == d
+
+        with pytest.raises(ValueError):
+            pq.ddfloat.from_bytes(b"123")
+
+    def test_pickle(self, tmp_path):
+        d = pq.ddfloat(1) / 3
+        path = tmp_path / "dd.pickle"
+
+        with open(path, "wb") as f:
+            pickle.dump(d, f)
+
+        with open(path, "rb") as f:
+            d2 = pickle.load(f)
+
+        assert d == d2
+        assert d.lo == d2.lo
+
+    def test_pickle_compact(self):
+        values = [pq.ddfloat(1) / 3 + i for i in range(1000)]
+        # One memoized reference to _from_bytes, then the raw bytes of each
+        size = len(values[0].to_bytes())
+        assert len(pickle.dumps(values)) < 1000 * (size + 10)
+        assert [v.to_bytes() for v in pickle.loads(pickle.dumps(values))] == [v.to_bytes() for v in values]
@@ -0,0 +1,127 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+import ctypes
+import io
+import platform
+
+import numpy as np
+import pytest
+
+import pyquadp.qarray as qarray
+import pyquadp.qcarray as qcarray
+from pyquadp import fortranio
+from pyquadp.fortranio import FortranFile, FortranFormattingError
+
+
+def lib_ext():
+    os = platform.system()
+    if os == "Darwin":
+        return "dylib"
+    elif os == "Windows":
+        return "dll"
+    else:
+        return "so"
+
+
+libname = f"./tests/quad.{lib_ext()}"
+mod_name = "__testq_MOD_"
+lib = ctypes.CDLL(libname)
+
+
+def _call(name, path, n, x, c):
+    # Fortran passes the length of a character(len=*) argument last
+    func = getattr(lib, f"{mod_name}{name}")
+    func.restype = None
+    filename = str(path).encode()
+    func(
+        filename,
+        ctypes.byref(ctypes.c_int(n)),
+        x.ctypes.data_as(ctypes.c_void_p),
+        c.ctypes.data_as(ctypes.c_void_p),
+        ctypes.c_size_t(len(filename)),
+    )
+
+
+class TestFortranFile:
+    def test_read_gfortran_records(self, tmp_path):
+
+        path = tmp_path / "a.dat"
+        x = qarray.from_array(np.arange(1.0, 9.0)) / 3
+        c = qcarray.from_list([complex(i, -i) for i in range(8)]) / 7
+        _call("write_records", path, 8, x, c)
+
+        with FortranFile(path) as f:
+            out = f.read_record(qarray.dtype)
+            assert not out.flags.owndata
+            assert out.tobytes() == x.tobytes()
+            assert f.read_record(qcarray.dtype).tobytes() == c.tobytes()
+            n, first, block = f.read_record((np.int32, ()), (qarray.dtype, 1), (qarray.dtype, (3, 2)))
+            assert int(n) == 8
+            assert first[0] == x[0]
+            assert block.shape == (3, 2)
+            assert block[2, 1] == x[5]
+            with pytest.raises(EOFError):
+                f.read_record(qarray.dtype)
+
+    def test_write_for_gfortran(self, tmp_path):
+
+        path = tmp_path / "a.dat"
+        x = qarray.from_array(np.linspace(0, 1, 5)) / 3
+        c = qcarray.from_list([1j, 2, 3 - 1j, 4, 0.5j])
+        with FortranFile(path, "w") as f:
+            f.write_record(x[::-1][::-1])
+            f.write_record(c)
+
+        x_out = qarray.from_array(np.zeros(5))
+        c_out = qcarray.from_list([0j] * 5)
+        _call("read_records", path, 5, x_out, c_out)
+        assert x_out.tobytes() == x.tobytes()
+        assert c_out.tobytes() == c.tobytes()
+
+    def test_options(self, tmp_path):
+
+        x = qarray.from_list([1.5, "0.1", -3])
+        grid = np.asfortranarray(qarray.from_array(np.arange(6.0).reshape(2, 3)))
+        for marker in (4, 8):
+            for byteorder in ("<", ">"):
+                buf = io.BytesIO()
+                f = FortranFile(buf, "w", marker=marker, byteorder=byteorder)
+                f.write_record(np.int32(3), x)
+                f.write_record(grid)
+                raw = buf.getvalue()
+                assert raw[:marker] == (16 * 3 + 4).to_bytes(marker, "little" if byteorder == "<" else "big")
+
+                f = FortranFile(io.BytesIO(raw), marker=marker, byteorder=byteorder)
+                n, out = f.read_record((np.int32, ()), qarray.dtype)
+                assert int(n) == 3
+                assert out.astype(qarray.dtype).tobytes() == x.tobytes()
+                out = f.read_record((qarray.dtype, (2, -1)))
+                assert out.shape == (2, 3)
+                assert out.astype(qarray.dtype).tobytes(order="F") == grid.tobytes(order="F")
+
+        f = FortranFile(io.BytesIO(raw[:-1]), marker=8, byteorder=">")
+        f.skip_record()
+        with pytest.raises(FortranFormattingError):
+            f.read_record(qarray.dtype)
+        with pytest.raises(ValueError):
+            FortranFile(io.BytesIO(raw), marker=8, byteorder=">").read_record((qarray.dtype, 2))
+        with pytest.raises(ValueError):
+            FortranFile(io.BytesIO(raw), marker=2)
+
+    def test_subrecords(self, monkeypatch):
+
+        monkeypatch.setattr(fortranio, "_SUBRECORD", 40)
+        x = qarray.from_array(np.arange(6.0))
+        buf = io.BytesIO()
+        FortranFile(buf, "w").write_record(x)
+        markers = np.frombuffer(buf.getvalue(), dtype=np.uint8)
+
+        # 96 bytes as 40 + 40 + 16, leading markers negative while more follow
+        # and trailing markers negative on continuations
+        heads = [int(markers[p : p + 4].view(np.int32)[0]) for p in (0, 48, 96)]
+        tails = [int(markers[p : p + 4].view(np.int32)[0]) for p in (44, 92, 116)]
+        assert heads == [-40, -40, 16]
+        assert tails == [40, -40, -16]
+
+        out = FortranFile(io.BytesIO(buf.getvalue())).read_record(qarray.dtype)
+        assert out.tobytes() == x.tobytes()
@@ -0,0 +1,184 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+import io
+import pickle
+
+import numpy as np
+import pytest
+
+import pyquadp
+import pyquadp.ddarray as ddarray
+import pyquadp.qarray as qarray
+import pyquadp.qcarray as qcarray
+import pyquadp.qiarray as qiarray
+import pyquadp.qqarray as qqarray
+
+
+class TestNpy:
+    def test_save_load_round_trip(self, tmp_path):
+
+        arrays = [
+            qarray.from_array(np.arange(12.0).reshape(3, 4)) / 3,
+            qcarray.from_list([1 + 2j, -0.5j, complex("nan")]),
+            qiarray.from_list([1, -(2**127), 2**100]),
+            ddarray.from_list([pyquadp.ddfloat(1.0, 2.0**-70), -3]),
+            qqarray.from_list(["0.1", -3]),
+            np.arange(4.0),
+        ]
+        for i, arr in enumerate(arrays):
+            path = tmp_path / f"a{i}.npy"
+            pyquadp.save(path, arr)
+            out = pyquadp.load(path)
+            assert out.dtype == arr.dtype
+            assert out.shape == arr.shape
+            assert out.tobytes() == arr.tobytes()
+
+        buf = io.BytesIO()
+        pyquadp.save(buf, arrays[0])
+        buf.seek(0)
+        assert pyquadp.load(buf).tobytes() == arrays[0].tobytes()
+
+    def test_plain_numpy_reads_tagged_file(self, tmp_path):
+
+        arr = qarray.from_list(["0.1", "-2.5"])
+        pyquadp.save(tmp_path / "a", arr)
+        plain = np.load(tmp_path / "a.npy")
+        assert plain.dtype.names == ("pyquadp.qfloat<",)
+        assert plain.view(qarray.dtype).tobytes() == arr.tobytes()
+
+    def test_mmap(self, tmp_path):
+
+        path = tmp_path / "a.npy"
+        arr = qarray.from_array(np.linspace(0, 1, 1000).reshape(10, 100)) / 7
+        pyquadp.save(path, arr)
+
+        out = pyquadp.load(path, mmap_mode="r")
+        assert isinstance(out, np.memmap)
+        assert out.dtype == qarray.dtype
+        assert out.tobytes() == arr.tobytes()
+        assert not out.flags.writeable
+
+        out = pyquadp.load(path, mmap_mode="r+")
+        out[0, 0] = 5
+        out.flush()
+        del out
+        assert float(pyquadp.load(path)[0, 0]) == 5.0
+
+        fortran = np.asfortranarray(qcarray.from_list([1j, 2, 3 - 1j, 4]).reshape(2, 2))
+        pyquadp.save(path, fortran)
+        out = pyquadp.load(path, mmap_mode="r")
+        assert out.flags.f_contiguous
+        assert [complex(v) for v in out.ravel()] == [complex(v) for v in fortran.ravel()]
+
+        with pytest.raises(ValueError):
+            pyquadp.load(path, mmap_mode="w+")
+
+    def test_npz(self, tmp_path):
+
+        a = qarray.from_list([1, 2.5])
+        c = qcarray.from_list([1j])
+        for save in (pyquadp.savez, pyquadp.savez_compressed):
+            save(tmp_path / "z", a, c=c, d=np.arange(3))
+            with pyquadp.load(tmp_path / "z.npz") as z:
+                assert sorted(z.files) == ["arr_0", "c", "d"]
+                assert z["arr_0"].tobytes() == a.tobytes()
+                assert z["c"].dtype == qcarray.dtype
+                assert z["d"].tolist() == [0, 1, 2]
+
+    def test_non_native_byte_order(self, tmp_path):
+
+        path = tmp_path / "a.npy"
+        arr = qcarray.from_list([1 + 2j, -0.5j])
+        swapped = arr.astype(arr.dtype.newbyteorder("S"))
+        pyquadp.save(path, swapped)
+        assert np.load(path).dtype.names[0][-1] == swapped.dtype.byteorder
+
+        out = pyquadp.load(path)
+        assert out.dtype.isnative
+        assert out.tobytes() == arr.tobytes()
+
+        out = pyquadp.load(path, mmap_mode="r")
+        assert out.dtype == swapped.dtype
+        assert out.astype(arr.dtype).tobytes() == arr.tobytes()
+
+
+class TestRaw:
+    def test_tofile_fromfile(self, tmp_path):
+
+        path = tmp_path / "a.bin"
+        arr = qarray.from_array(np.arange(200000.0)) / 3
+        for byteorder in ("=", "<", ">"):
+            pyquadp.tofile(arr, path, byteorder=byteorder)
+            out = pyquadp.fromfile(path, qarray.dtype, byteorder=byteorder)
+            assert out.dtype.isnative
+            assert out.tobytes() == arr.tobytes()
+
+        pyquadp.tofile(arr[::3], path, byteorder=">")
+        out = pyquadp.fromfile(path, qarray.dtype, count=2, offset=16, byteorder=">")
+        assert out.tobytes() == arr[3:9:3].tobytes()
+
+        buf = io.BytesIO()
+        pyquadp.tofile(arr[:4], buf, byteorder=">")
+        assert buf.getvalue() == arr[:4].byteswap().tobytes()
+
+    def test_frombuffer(self):
+
+        arr = qiarray.from_list([1, -2, 2**100])
+        raw = b"".join(int(v).to_bytes(16, "big", signed=True) for v in arr)
+        view = pyquadp.frombuffer(raw, qiarray.dtype, byteorder=">")
+        assert not view.flags.owndata
+        assert [int(v) for v in view] == [1, -2, 2**100]
+        assert pyquadp.frombuffer(arr.tobytes(), qiarray.dtype, count=1, offset=16)[0] == -2
+
+        with pytest.raises(TypeError):
+            pyquadp.frombuffer(raw, np.float64)
+
+        # Swapped views of the multi-part types read and write element-wise
+        for arr in [ddarray.from_list([pyquadp.ddfloat(1.0, 2.0**-70)]), qqarray.from_list(["0.1"])]:
+            buf = io.BytesIO()
+            pyquadp.tofile(arr, buf, byteorder=">")
+            view = pyquadp.frombuffer(buf.getvalue(), arr.dtype, byteorder=">").copy()
+            assert view[0] == arr[0] and view[0].lo == arr[0].lo
+            view[0] = 5
+            assert view.astype(arr.dtype)[0] == 5
+
+
+class QuadPickler(pickle.Pickler):
+    reducer_override = staticmethod(pyquadp.npyio.reducer_override)
+
+
+class TestPickle:
+    def test_arrays(self):
+
+        arrays = [
+            qarray.from_array(np.arange(12.0).reshape(3, 4)) / 3,
+            qcarray.from_list([1 + 2j, -0.5j]),
+            qiarray.from_list([1, -(2**127), 2**100]),
+            ddarray.from_list([pyquadp.ddfloat(1.0, 2.0**-70), -3]),
+            qqarray.from_list(["0.1", -3]),
+        ]
+        for arr in arrays:
+            assert pickle.loads(pickle.dumps(arr.dtype)) == arr.dtype
+            for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+                out = pickle.loads(pickle.dumps(arr, protocol=protocol))
+                assert out.dtype == arr.dtype
+                assert out.tobytes() == arr.tobytes()
+
+    def test_out_of_band(self):
+
+        arr = np.asfortranarray(qarray.from_array(np.arange(20000.0).reshape(100, 200)) / 7)
+        buffers = []
+        fp = io.BytesIO()
+        QuadPickler(fp, protocol=5, buffer_callback=buffers.append).dump({"x": arr, "y": [1.5, np.arange(3)]})
+        assert len(fp.getvalue()) < 1000
+        assert sum(buf.raw().nbytes for buf in buffers) >= arr.nbytes
+
+        out = pickle.loads(fp.getvalue(), buffers=buffers)
+        assert out["x"].flags.f_contiguous
+        assert out["x"].tobytes() == arr.tobytes()
+        assert out["y"][1].tolist() == [0, 1, 2]
+
+        # In band, the data is copied into the pickle as usual
+        fp = io.BytesIO()
+        QuadPickler(fp, protocol=5).dump(arr[::2])
+        assert pickle.loads(fp.getvalue()).tobytes() == arr[::2].tobytes()
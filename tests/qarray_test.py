@@ -1,9 +1,14 @@
 # SPDX-License-Identifier: GPL-2.0+
 
+import ctypes
+import math
+import sys
+
 import numpy as np
 import pytest
 
 import pyquadp.qarray as qarray
+import pyquadp.qiarray as qiarray
 
 
 @pytest.mark.qarray
@@ -228,6 +233,147 @@ class TestQArrayInterop:
         assert float(out[0]) == pytest.approx(0.5)
         assert float(out[1]) == pytest.approx(1.5)
 
+    def test_cast_float64_special_roundtrip(self):
+
+        tiny = np.finfo(np.float64).smallest_subnormal
+        src = np.array(
+            [0.0, -0.0, tiny, -tiny, 2.2250738585072014e-308, 1.7976931348623157e308,
+             np.inf, -np.inf, np.nan, 0.1],
+            dtype=np.float64,
+        )
+
+        out = src.astype(qarray.dtype)
+        assert out[2].as_integer_ratio() == (1, 2**1074)
+        with np.errstate(invalid="ignore", over="ignore"):
+            back = out.astype(np.float64)
+            src32 = src.astype(np.float32)
+            back32 = src32.astype(qarray.dtype).astype(np.float32)
+        np.testing.assert_array_equal(back, src)
+        assert np.signbit(back[1])
+        np.testing.assert_array_equal(back32, src32)
+
+    def test_cast_qarray_to_float_rounds_once(self):
+
+        # 1 + 2**-24 + 2**-60 rounds up in float32 but would tie to 1.0
+        # if it went through float64 first
+        arr = qarray.from_list([1.0]) + 2.0**-24 + 2.0**-60
+        assert arr.astype(np.float32)[0] == np.float32(1 + 2.0**-23)
+
+        # ties to even, subnormal results and overflow
+        arr = qarray.from_list([1.0]) + 2.0**-53
+        assert arr.astype(np.float64)[0] == 1.0
+        arr = qarray.from_list([2.0**-1074, 3 * 2.0**-1074]) * 0.5
+        np.testing.assert_array_equal(arr.astype(np.float64), [0.0, 2 * 2.0**-1074])
+        arr = qarray.from_list([2.0**-1074]) * 0.75
+        assert arr.astype(np.float64)[0] == 2.0**-1074
+        arr = qarray.from_list([1.7976931348623157e308]) * 2
+        assert arr.astype(np.float64)[0] == np.inf
+        assert arr.astype(np.float32)[0] == np.inf
+
+    def test_cast_longdouble_roundtrip(self):
+
+        src = np.array([1, 2, -7], dtype=np.longdouble) / 3
+
+        out = src.astype(qarray.dtype)
+        assert out.dtype == qarray.dtype
+        for x, y in zip(src, out):
+            assert x.as_integer_ratio() == y.as_integer_ratio()
+        np.testing.assert_array_equal(out.astype(np.longdouble), src)
+
+        assert np.can_cast(np.longdouble, qarray.dtype)
+        assert not np.can_cast(qarray.dtype, np.longdouble)
+        assert (src + out).dtype == qarray.dtype
+
+    def test_byte_order_variants(self):
+
+        arr = qarray.from_list([1.5, -2, "0.1", "-0.0"])
+        big = arr.astype(qarray.dtype.newbyteorder(">"))
+        assert big.tobytes()[:16] == arr.tobytes()[15::-1]
+        assert [float(v) for v in big] == [1.5, -2.0, 0.1, -0.0]
+        assert big.astype(qarray.dtype).tobytes() == arr.tobytes()
+        assert (big + big).tobytes() == (arr + arr).tobytes()
+        assert np.count_nonzero(big) == 3
+
+        big[0] = 3
+        assert float(big[0]) == 3.0
+        assert big.tobytes()[:2] == b"\x40\x00"
+
+        swapped = arr.copy()
+        swapped.byteswap(inplace=True)
+        assert swapped.tobytes() == arr.astype(big.dtype).tobytes()
+        assert arr[::2].byteswap().byteswap().tobytes() == arr[::2].tobytes()
+
+    @pytest.mark.skipif(
+        np.finfo(np.longdouble).nmant != 63, reason="needs x87 extended long double"
+    )
+    def test_cast_qarray_to_longdouble_rounds(self):
+
+        arr = qarray.from_list([1.0]) + qarray.from_list([2.0**-64, 2.0**-64 + 2.0**-100])
+        out = arr.astype(np.longdouble)
+        one = np.longdouble(1)
+        np.testing.assert_array_equal(out, [one, one + np.longdouble(2.0**-63)])
+
+    @pytest.mark.parametrize(
+        "dtype",
+        [np.int8, np.int16, np.int32, np.int64, np.uint8, np.uint16, np.uint32, np.uint64],
+    )
+    def test_cast_integer_dtype_roundtrip(self, dtype):
+
+        info = np.iinfo(dtype)
+        src = np.array([info.min, 0, 1, info.max], dtype=dtype)
+
+        out = src.astype(qarray.dtype)
+        assert out.dtype == qarray.dtype
+        # 64-bit extremes are exact in quad precision
+        assert out[3].as_integer_ratio() == (int(info.max), 1)
+        np.testing.assert_array_equal(out.astype(dtype), src)
+
+        assert np.can_cast(dtype, qarray.dtype)
+        assert not np.can_cast(qarray.dtype, dtype)
+        assert np.result_type(dtype, qarray.dtype) == qarray.dtype
+
+    def test_cast_bool(self):
+
+        src = np.array([True, False])
+        out = src.astype(qarray.dtype)
+        np.testing.assert_array_equal(out.astype(np.float64), [1.0, 0.0])
+
+        arr = qarray.from_list([0.0, -0.0, 0.5, "nan"])
+        np.testing.assert_array_equal(arr.astype(np.bool_), [False, False, True, True])
+
+    def test_cast_qarray_to_integer_truncates(self):
+
+        arr = qarray.from_list(["2.75", "-2.75", "9007199254740993"])
+        np.testing.assert_array_equal(
+            arr.astype(np.int64), np.array([2, -2, 2**53 + 1], dtype=np.int64)
+        )
+
+        with pytest.warns(RuntimeWarning, match="invalid value"):
+            out = qarray.from_list(["nan", "1e30"]).astype(np.int64)
+        np.testing.assert_array_equal(out, [np.iinfo(np.int64).min] * 2)
+
+    @pytest.mark.parametrize("dtype", [np.int8, np.int16, np.int32])
+    def test_cast_qarray_to_narrow_integer_matches_float64(self, dtype):
+
+        # Narrow signed casts go through int32, as NumPy's float64 casts do
+        values = [2.0**40, 3e9, -3e9, 2.0**31 - 1, -(2.0**31), 70000.0, -2.75, 1e30]
+        with np.errstate(invalid="ignore"):
+            expected = np.array(values).astype(dtype)
+        with pytest.warns(RuntimeWarning, match="invalid value"):
+            out = qarray.from_list(values).astype(dtype)
+        np.testing.assert_array_equal(out, expected)
+
+        with pytest.warns(RuntimeWarning, match="invalid value"):
+            out = qarray.from_list(["nan"]).astype(dtype)
+        assert out[0] == np.array(np.iinfo(np.int32).min).astype(dtype)
+
+    def test_mixed_int64_keeps_precision(self):
+
+        big = np.array([2**60 + 1], dtype=np.int64)
+        out = qarray.zeros(1) + big
+        assert out.dtype == qarray.dtype
+        assert int(out[0]) == 2**60 + 1
+
     def test_numpy_sum_and_prod_reduce_qarray(self):
 
         values = np.array([[1.25, -3.0], [0.25, 5.5]], dtype=np.float64)
@@ -426,8 +572,150 @@ class TestQArrayUfuncs:
         assert np.allclose(np.asarray(pow_dq, dtype=np.float64), np.power(d, qf))
 
 
+    @pytest.mark.parametrize("dtype", [np.float32, np.int32, np.int64, np.float64])
+    @pytest.mark.parametrize(
+        "ufunc", [np.add, np.subtract, np.multiply, np.divide, np.power]
+    )
+    def test_mixed_loops_match_casting_first(self, dtype, ufunc):
+
+        # Longer than one conversion block, with strided and in-place cases
+        q = qarray.from_array(np.linspace(0.5, 40.0, 700))
+        other = np.arange(-350, 350).astype(dtype)
+        other[::2] += 3
+        other_q = other.astype(qarray.dtype)
+
+        def bits(arr):
+            return np.ascontiguousarray(arr).view(np.uint64)
+
+        with np.errstate(all="ignore"):
+            for x, y, xq, yq in [
+                (q, other, q, other_q),
+                (other, q, other_q, q),
+                (q[::3], other[::3], q[::3], other_q[::3]),
+            ]:
+                out = ufunc(x, y)
+                assert out.dtype == qarray.dtype
+                np.testing.assert_array_equal(bits(out), bits(ufunc(xq, yq)))
+
+            strided = qarray.zeros(1400)[::2]
+            ufunc(q, other, out=strided)
+            np.testing.assert_array_equal(bits(strided), bits(ufunc(q, other_q)))
+
+            inplace = q.copy()
+            ufunc(inplace, other, out=inplace)
+            np.testing.assert_array_equal(bits(inplace), bits(ufunc(q, other_q)))
+
+    def test_mixed_loops_reduce(self):
+
+        # Reductions hand the mixed loops a stride 0 accumulator
+        x = np.arange(1000.0)
+        assert np.sum(np.arange(1, 11.0), dtype=qarray.dtype) == 55
+        assert np.add.reduce(x, dtype=qarray.dtype) == 499500
+        assert np.sum(x.astype(np.int32), dtype=qarray.dtype) == 499500
+        assert np.multiply.reduce(np.arange(1.0, 30.0), dtype=qarray.dtype).as_integer_ratio() == (
+            math.factorial(29),
+            1,
+        )
+
+        grid = x.reshape(10, 100)
+        np.testing.assert_array_equal(
+            np.add.reduce(grid, axis=0, dtype=qarray.dtype).astype(np.float64), grid.sum(axis=0)
+        )
+        np.testing.assert_array_equal(
+            np.add.reduce(grid, axis=1, dtype=qarray.dtype).astype(np.float64), grid.sum(axis=1)
+        )
+
+
 @pytest.mark.qarray
 class TestQArrayHardening:
+    def test_rounding_ufuncs_match_libquadmath(self):
+
+        from pyquadp import qmath
+
+        halves = np.multiply(qarray.from_array(np.arange(-20.0, 21.0)), qarray.from_list(["0.5"]))
+        x = np.concatenate([_qarray_spread(500, 31), halves, qarray.from_list(_QARRAY_EDGE_VALUES)])
+
+        for ufunc, ref in (
+            (np.floor, qmath.floorq),
+            (np.ceil, qmath.ceilq),
+            (np.trunc, qmath.truncq),
+            (np.rint, qmath.rintq),
+        ):
+            out = ufunc(x)
+            assert out.dtype == qarray.dtype
+            assert out.tobytes() == qarray.from_list([ref(v) for v in x]).tobytes()
+
+        # NaN payloads and signed zeros come through untouched
+        nan = np.frombuffer((2**127 - 5).to_bytes(16, "little"), dtype=qarray.dtype)
+        assert np.floor(nan).tobytes() == nan.tobytes()
+        assert np.signbit(np.ceil(qarray.from_list(["-0.5"])).astype(np.float64))[0]
+
+        assert np.round(qarray.from_list(["2.5", "3.5", "-0.5"])).tolist() == [2, 4, 0]
+        assert qarray.from_list(["1.25"]).round(1)[0] == qarray.from_list(["1.2"])[0]
+
+    def test_modf_frexp_ldexp(self):
+
+        from pyquadp import qmath
+
+        x = np.concatenate([_qarray_spread(300, 32), qarray.from_list(["1e-4950", "-2", "0", "-0.0", "-inf"])])
+
+        frac, whole = np.modf(x)
+        for v, f, w in zip(x, frac, whole):
+            rf, rw = qmath.modfq(v)
+            assert (f.as_integer_ratio(), w) == (rf.as_integer_ratio(), rw)
+            assert np.signbit(float(f)) == np.signbit(float(v))
+
+        m, e = np.frexp(x)
+        assert e.dtype == np.int32
+        for v, mm, ee in zip(x, m, e):
+            assert (mm, int(ee)) == qmath.frexpq(v)
+        assert np.ldexp(m, e).tobytes() == x.tobytes()
+        assert np.ldexp(m, e.astype(np.int64)).tobytes() == x.tobytes()
+
+        one = qarray.from_list(["1.5"])
+        assert np.ldexp(one, 3)[0] == 12
+        with np.errstate(all="ignore"):
+            assert np.ldexp(one, [-16500, 20000, 2**40]).tolist() == [0, float("inf"), float("inf")]
+
+    def test_classification_ufuncs_match_libquadmath(self):
+
+        from pyquadp import qmath
+
+        nan = np.frombuffer((2**128 - 5).to_bytes(16, "little"), dtype=qarray.dtype)
+        edges = qarray.from_list(["1e400", "-1e4000", "1e-4950", "-0.0", "0"] + _QARRAY_EDGE_VALUES)
+        x = np.concatenate([_qarray_spread(200, 33), edges, nan])
+
+        for ufunc, ref in (
+            (np.isnan, qmath.isnanq),
+            (np.isinf, qmath.isinfq),
+            (np.isfinite, qmath.finiteq),
+            (np.signbit, qmath.signbitq),
+        ):
+            for view in (x, x[::3]):
+                out = ufunc(view)
+                assert out.dtype == np.bool_
+                assert out.tolist() == [bool(ref(v)) for v in view]
+
+        # Values beyond the float64 range are finite, the sign of a NaN is kept
+        assert not np.isinf(edges[:2]).any()
+        assert np.signbit(nan)[0]
+
+    def test_nonzero_and_logical_ufuncs(self):
+
+        x = qarray.from_list(["-0.0", "0", "1e-4950", "nan", "-inf", "2"])
+        truth = [False, False, True, True, True, True]
+
+        assert x.astype(bool).tolist() == truth
+        assert np.count_nonzero(x) == 4
+        assert np.nonzero(x)[0].tolist() == [2, 3, 4, 5]
+        assert np.logical_not(x).tolist() == [not t for t in truth]
+
+        y = x[::-1]
+        other = truth[::-1]
+        assert np.logical_and(x, y).tolist() == [a and b for a, b in zip(truth, other)]
+        assert np.logical_or(x, y).tolist() == [a or b for a, b in zip(truth, other)]
+        assert np.logical_xor(x, y).tolist() == [a != b for a, b in zip(truth, other)]
+
     def test_nan_propagates_through_add(self):
 
         a = qarray.from_list([1.0, float("nan"), 3.0])
@@ -563,3 +851,968 @@ class TestQArrayHardening:
         assert np.isnan(float(arr[0]))
         assert np.isposinf(float(arr[1]))
         assert np.isneginf(float(arr[2]))
+
+
+def _qarray_ordered_bits(arr):
+    # Map quad bit patterns to integers ordered like the values they encode
+    words = np.frombuffer(np.ascontiguousarray(arr).tobytes(), dtype="<u8").reshape(-1, 2)
+    out = []
+    for lo, hi in words:
+        value = (int(hi) << 64) | int(lo)
+        if value >> 127:
+            value = -(value & ((1 << 127) - 1))
+        out.append(value)
+    return out
+
+
+def _qarray_ulp_diff(a, b):
+    return max(abs(x - y) for x, y in zip(_qarray_ordered_bits(a), _qarray_ordered_bits(b)))
+
+
+def _qarray_random(lo, hi, size=2000):
+    rng = np.random.default_rng(1234)
+    coarse = qarray.from_array(rng.uniform(lo, hi, size))
+    fine = qarray.from_array(rng.uniform(-1.0, 1.0, size) * 2.0**-60)
+    return np.add(coarse, np.multiply(coarse, fine))
+
+
+@pytest.mark.qarray
+class TestQArrayFastMath:
+    def test_fast_math_disabled_by_default(self):
+
+        assert qarray.get_fast_math() is False
+
+    def test_set_fast_math_returns_previous(self):
+
+        assert qarray.set_fast_math(True) is False
+        assert qarray.get_fast_math() is True
+        assert qarray.set_fast_math(False) is True
+        assert qarray.get_fast_math() is False
+
+    def test_fast_math_context_manager_restores(self):
+
+        import pyquadp
+
+        with pyquadp.fast_math():
+            assert qarray.get_fast_math() is True
+            with pyquadp.fast_math(False):
+                assert qarray.get_fast_math() is False
+            assert qarray.get_fast_math() is True
+        assert qarray.get_fast_math() is False
+
+    def test_fast_math_is_per_thread(self):
+
+        import threading
+
+        import pyquadp
+
+        seen = []
+        with pyquadp.fast_math():
+            thread = threading.Thread(target=lambda: seen.append(qarray.get_fast_math()))
+            thread.start()
+            thread.join()
+        assert seen == [False]
+
+    @pytest.mark.parametrize(
+        "ufunc,lo,hi",
+        [
+            (np.exp, -20.0, 20.0),
+            (np.exp, -11000.0, 11000.0),
+            (np.log, 1e-300, 1e300),
+            (np.log, 0.5, 2.0),
+            (np.sin, -10.0, 10.0),
+            (np.sin, -30000.0, 30000.0),
+            (np.cos, -10.0, 10.0),
+            (np.cos, -30000.0, 30000.0),
+        ],
+    )
+    def test_fast_math_within_ulps_of_libquadmath(self, ufunc, lo, hi):
+
+        import pyquadp
+
+        if ufunc is np.log:
+            x = np.exp(_qarray_random(np.log(lo), np.log(hi)))
+        else:
+            x = _qarray_random(lo, hi)
+        ref = ufunc(x)
+        with pyquadp.fast_math():
+            out = ufunc(x)
+
+        assert out.dtype == qarray.dtype
+        assert _qarray_ulp_diff(out, ref) <= 4
+
+    def test_fast_math_near_one_and_multiples_of_pi(self):
+
+        import pyquadp
+
+        eps = qarray.from_array(np.array([1e-30, -1e-20, 1e-12, -1e-6, 1e-3]))
+        one = np.add(qarray.ones(5), eps)
+        pi = qarray.from_list(["3.141592653589793238462643383279502884"] * 5)
+        pi_eps = np.add(np.multiply(pi, qarray.from_array(np.array([1.0, 2.0, -3.0, 7.0, 100.0]))), eps)
+
+        with pyquadp.fast_math():
+            log_out = np.log(one)
+            sin_out = np.sin(pi_eps)
+            cos_out = np.cos(np.add(pi_eps, np.divide(pi, qarray.full(5, 2))))
+
+        assert _qarray_ulp_diff(log_out, np.log(one)) <= 4
+        assert _qarray_ulp_diff(sin_out, np.sin(pi_eps)) <= 4
+        assert _qarray_ulp_diff(cos_out, np.cos(np.add(pi_eps, np.divide(pi, qarray.full(5, 2))))) <= 4
+
+    def test_fast_math_special_values_match(self):
+
+        import pyquadp
+
+        x = qarray.from_list([0.0, -0.0, float("inf"), float("-inf"), 20000.0, -20000.0, "1e-4000", 1e-30])
+
+        with np.errstate(all="ignore"):
+            refs = [np.exp(x), np.sin(x), np.cos(x)]
+            with pyquadp.fast_math():
+                outs = [np.exp(x), np.sin(x), np.cos(x)]
+
+        for out, ref in zip(outs, refs):
+            assert out.tobytes() == ref.tobytes()
+
+    def test_fast_math_log_special_values(self):
+
+        import pyquadp
+
+        x = qarray.from_list([0.0, 1.0, float("inf"), -1.0, float("nan")])
+
+        with np.errstate(all="ignore"):
+            with pyquadp.fast_math():
+                out = np.asarray(np.log(x), dtype=np.float64)
+
+        assert np.isneginf(out[0])
+        assert out[1] == 0.0
+        assert np.isposinf(out[2])
+        assert np.isnan(out[3])
+        assert np.isnan(out[4])
+
+
+def _qarray_spread(size, seed):
+    # Random signs, significands and a wide spread of exponents so the
+    # operands of a binary op overlap partially, fully or not at all
+    rng = np.random.default_rng(seed)
+    mant = np.add(
+        qarray.from_array(rng.uniform(1.0, 2.0, size)),
+        qarray.from_array(rng.uniform(0.0, 1.0, size) * 2.0**-60),
+    )
+    scale = qarray.from_array(np.ldexp(rng.choice([-1.0, 1.0], size), rng.integers(-130, 130, size)))
+    return np.multiply(mant, scale)
+
+
+_QARRAY_EDGE_VALUES = [
+    0.0,
+    -0.0,
+    1.0,
+    -1.0,
+    float("inf"),
+    float("-inf"),
+    float("nan"),
+    "1e-4940",
+    "3.3621031431120935062626778173217526e-4932",
+    "1.1897314953572317650857593266280070e+4932",
+    "-1.1897314953572317650857593266280070e+4932",
+    "1.0000000000000000000000000000000002",
+]
+
+
+@pytest.mark.qarray
+class TestQArraySoftQuad:
+    @pytest.mark.parametrize(
+        "ufunc,op",
+        [
+            (np.add, lambda x, y: x + y),
+            (np.subtract, lambda x, y: x - y),
+            (np.multiply, lambda x, y: x * y),
+        ],
+    )
+    def test_binary_matches_scalar_ops(self, ufunc, op):
+
+        x = _qarray_spread(1000, 1)
+        y = _qarray_spread(1000, 2)
+        # Exact and near cancellation
+        y[:100] = np.negative(x[:100])
+        y[100:200] = np.negative(np.multiply(x[100:200], qarray.full(100, "1.0000000000000000000000000000000002")))
+
+        out = ufunc(x, y)
+        ref = qarray.from_list([op(a, b) for a, b in zip(x, y)])
+
+        assert out.tobytes() == ref.tobytes()
+
+    @pytest.mark.parametrize("ufunc", [np.add, np.subtract, np.multiply])
+    def test_binary_contiguous_matches_strided(self, ufunc):
+
+        x = _qarray_spread(2000, 3)
+        y = _qarray_spread(2000, 4)
+
+        assert ufunc(x[::2], y[::2]).tobytes() == ufunc(x, y)[::2].tobytes()
+        assert ufunc(x, y[:1]).tobytes() == ufunc(x, qarray.full(2000, y[0])).tobytes()
+
+    @pytest.mark.parametrize(
+        "ufunc,op",
+        [
+            (np.add, lambda x, y: x + y),
+            (np.subtract, lambda x, y: x - y),
+            (np.multiply, lambda x, y: x * y),
+        ],
+    )
+    def test_binary_edge_values(self, ufunc, op):
+
+        vals = _QARRAY_EDGE_VALUES
+        x = qarray.from_list([a for a in vals for _ in vals])
+        y = qarray.from_list([b for _ in vals for b in vals])
+
+        with np.errstate(all="ignore"):
+            out = ufunc(x, y)
+            ref = qarray.from_list([op(a, b) for a, b in zip(x, y)])
+
+        assert _qarray_ordered_bits(out) == _qarray_ordered_bits(ref)
+
+    def test_fma_matches_fmaq(self):
+
+        from pyquadp.qmath import fmaq
+
+        x = _qarray_spread(500, 5)
+        y = _qarray_spread(500, 6)
+        z = np.negative(np.multiply(x, y))
+        z[250:] = _qarray_spread(250, 7)
+
+        out = qarray.fma(x, y, z)
+        ref = qarray.from_list([fmaq(a, b, c) for a, b, c in zip(x, y, z)])
+
+        assert out.dtype == qarray.dtype
+        assert out.tobytes() == ref.tobytes()
+        assert qarray.fma(x[::2], y[::2], z[::2]).tobytes() == out[::2].tobytes()
+
+    def test_fma_edge_values(self):
+
+        from pyquadp.qmath import fmaq
+
+        vals = _QARRAY_EDGE_VALUES
+        x = qarray.from_list([a for a in vals for _ in vals])
+        y = qarray.from_list([b for _ in vals for b in vals])
+        z = qarray.from_list(list(reversed(vals)) * len(vals))
+
+        with np.errstate(all="ignore"):
+            out = qarray.fma(x, y, z)
+        ref = qarray.from_list([fmaq(a, b, c) for a, b, c in zip(x, y, z)])
+
+        assert _qarray_ordered_bits(out) == _qarray_ordered_bits(ref)
+
+
+
+@pytest.mark.qarray
+class TestQArrayErrorFree:
+    def test_two_sum_two_prod_exact(self):
+
+        from fractions import Fraction
+
+        x = _qarray_spread(500, 21)
+        y = _qarray_spread(500, 22)
+
+        for func, op in ((qarray.two_sum, np.add), (qarray.two_prod, np.multiply)):
+            r, e = func(x, y)
+            assert r.tobytes() == op(x, y).tobytes()
+            for a, b, rr, ee in zip(x, y, r, e):
+                exact = op(Fraction(*a.as_integer_ratio()), Fraction(*b.as_integer_ratio()))
+                assert Fraction(*rr.as_integer_ratio()) + Fraction(*ee.as_integer_ratio()) == exact
+
+        s, e = qarray.two_sum(x[::3], y[::3])
+        assert e.tobytes() == qarray.two_sum(x, y)[1][::3].tobytes()
+
+    def test_two_sum_two_prod_float64(self):
+
+        from fractions import Fraction
+
+        rng = np.random.default_rng(23)
+        x = rng.standard_normal(500) * np.ldexp(1.0, rng.integers(-60, 60, 500))
+        y = rng.standard_normal(500)
+
+        s, e = qarray.two_sum(x, y)
+        p, f = qarray.two_prod(x, y)
+        assert s.dtype == np.float64
+        np.testing.assert_array_equal(s, x + y)
+        np.testing.assert_array_equal(p, x * y)
+        for a, b, ss, ee, pp, ff in zip(x, y, s, e, p, f):
+            assert Fraction(ss) + Fraction(ee) == Fraction(a) + Fraction(b)
+            assert Fraction(pp) + Fraction(ff) == Fraction(a) * Fraction(b)
+
+        with np.errstate(all="ignore"):
+            s, e = qarray.two_sum([np.inf, 1e308], [1.0, 1e308])
+            p, f = qarray.two_prod([np.nan, 1e300], [1.0, 1e300])
+        np.testing.assert_array_equal(s, [np.inf, np.inf])
+        np.testing.assert_array_equal(e, [0.0, 0.0])
+        np.testing.assert_array_equal(f, [0.0, 0.0])
+
+    def test_split_join(self):
+
+        from fractions import Fraction
+
+        x = _qarray_spread(500, 24)
+        hi, lo = qarray.split(x)
+        assert hi.dtype == np.float64
+        assert lo.dtype == np.float64
+        np.testing.assert_array_equal(hi, x.astype(np.float64))
+        for q, h, l in zip(x, hi, lo):
+            assert Fraction(h) + Fraction(l) == _round_to_dd(Fraction(*q.as_integer_ratio()), h)
+
+        # 106 bits survive the round trip
+        back = qarray.join(hi, lo)
+        assert back.tobytes() == np.add(hi.astype(qarray.dtype), lo.astype(qarray.dtype)).tobytes()
+        short = np.add(qarray.from_array(hi), qarray.from_array(lo))
+        assert qarray.join(*qarray.split(short)).tobytes() == short.tobytes()
+
+    def test_split_join_edge_values(self):
+
+        x = qarray.from_list(_QARRAY_EDGE_VALUES)
+        with np.errstate(all="ignore"):
+            hi, lo = qarray.split(x)
+            ref = x.astype(np.float64)
+            back = qarray.join(hi, lo).astype(np.float64)
+        np.testing.assert_array_equal(hi, ref)
+        np.testing.assert_array_equal(lo[~np.isfinite(hi)], 0.0)
+        np.testing.assert_array_equal(np.signbit(back), np.signbit(ref))
+
+
+_QARRAY_LEVEL_SCRIPT = """
+import hashlib
+import numpy as np
+import pyquadp
+from pyquadp import qarray
+
+rng = np.random.default_rng(0)
+x = np.multiply(qarray.from_array(rng.uniform(-10, 10, 500)), qarray.from_array(np.ldexp(1.0, rng.integers(-80, 80, 500))))
+y = qarray.from_array(rng.uniform(-10, 10, 500))
+h = hashlib.sha256()
+for out in (np.add(x, y), np.subtract(x, y), np.multiply(x, y), qarray.fma(x, y, x)):
+    h.update(out.tobytes())
+print(qarray.runtime_info()["selected_level"], h.hexdigest())
+"""
+
+
+def _qarray_run_level(level):
+    import os
+    import subprocess
+    import sys
+
+    import pyquadp
+
+    env = dict(os.environ)
+    env["PYQUADP_CPU_LEVEL"] = level
+    env["PYTHONPATH"] = os.path.dirname(os.path.dirname(pyquadp.__file__))
+    return subprocess.run(
+        [sys.executable, "-c", _QARRAY_LEVEL_SCRIPT], env=env, capture_output=True, text=True
+    )
+
+
+@pytest.mark.qarray
+class TestQArrayRuntime:
+    def test_runtime_info(self):
+
+        info = qarray.runtime_info()
+
+        assert info["selected_level"] in info["available_levels"]
+        assert info["cpu_level"] in info["available_levels"]
+        assert info["env_var"] == "PYQUADP_CPU_LEVEL"
+        assert info["fast_math"] is qarray.get_fast_math()
+
+    def test_show_runtime(self, capsys):
+
+        import pyquadp
+
+        pyquadp.show_runtime()
+
+        out = capsys.readouterr().out
+        assert qarray.runtime_info()["selected_level"] in out
+        assert "PYQUADP_CPU_LEVEL" in out
+
+    def test_levels_give_identical_results(self):
+
+        results = set()
+        for level in qarray.runtime_info()["available_levels"]:
+            proc = _qarray_run_level(level)
+            assert proc.returncode == 0, proc.stderr
+            selected, digest = proc.stdout.split()
+            assert selected in qarray.runtime_info()["available_levels"]
+            results.add(digest)
+
+        assert len(results) == 1
+
+    def test_unknown_level_fails_import(self):
+
+        proc = _qarray_run_level("not-a-level")
+
+        assert proc.returncode != 0
+        assert "PYQUADP_CPU_LEVEL" in proc.stderr
+
+
+def _round_to_dd(value, hi):
+    # hi + value - hi rounded to double, the nearest double-double to value
+    from fractions import Fraction
+
+    return Fraction(hi) + Fraction(float(value - Fraction(hi)))
+
+
+def _round_to_quad(value):
+    # Round a Fraction to the nearest binary128 value, ties to even
+    from fractions import Fraction
+
+    if value == 0:
+        return Fraction(0)
+    sign = -1 if value < 0 else 1
+    value = abs(value)
+    exp = value.numerator.bit_length() - value.denominator.bit_length()
+    if Fraction(2) ** exp > value:
+        exp -= 1
+    # Subnormals keep the spacing of the smallest normal binade
+    exp = max(exp, -16382)
+    scale = Fraction(2) ** (112 - exp)
+    whole, rem = divmod(value.numerator * scale.numerator, value.denominator * scale.denominator)
+    half = value.denominator * scale.denominator
+    if 2 * rem > half or (2 * rem == half and whole & 1):
+        whole += 1
+    return sign * Fraction(whole) / scale
+
+
+@pytest.mark.qarray
+class TestQArrayReductions:
+    def test_qsum_qdot_correctly_rounded(self):
+
+        from fractions import Fraction
+
+        rng = np.random.default_rng(5)
+        x = rng.standard_normal(40000) * np.ldexp(1.0, rng.integers(-60, 60, 40000))
+        y = rng.standard_normal(40000) * np.ldexp(1.0, rng.integers(-60, 60, 40000))
+
+        total = sum(map(Fraction, x))
+        dot = sum(Fraction(a) * Fraction(b) for a, b in zip(x, y))
+        assert Fraction(*qarray.qsum(x).as_integer_ratio()) == _round_to_quad(total)
+        assert Fraction(*qarray.qdot(x, y).as_integer_ratio()) == _round_to_quad(dot)
+
+    def test_qsum_qdot_independent_of_threads(self):
+
+        rng = np.random.default_rng(6)
+        x = rng.standard_normal(100003)
+        y = rng.standard_normal(100003)
+
+        sums = {qarray.qsum(x, threads=t).as_integer_ratio() for t in (1, 2, 3, 8, 0)}
+        dots = {qarray.qdot(x, y, threads=t).as_integer_ratio() for t in (1, 2, 3, 8, 0)}
+        assert len(sums) == 1
+        assert len(dots) == 1
+
+    def test_qsum_special_values(self):
+
+        assert qarray.qsum([1e308, 1.0, -1e308]) == 1
+        assert qarray.qsum([5e-324] * 3).as_integer_ratio() == (3, 2**1074)
+        assert qarray.qsum([]) == 0
+        assert qarray.qsum(np.ones((3, 4))) == 12
+        assert qarray.qsum([np.inf, 1.0]) == np.inf
+        assert np.isnan(float(qarray.qsum([np.inf, -np.inf])))
+        assert np.isnan(float(qarray.qsum([1.0, np.nan])))
+        assert np.isnan(float(qarray.qdot([np.inf], [0.0])))
+        assert qarray.qdot([1e300, 1e-300], [1e300, 1e300]) > qarray.from_list(["1e599"])[0]
+
+    def test_qsum_qdot_non_float64_inputs(self):
+
+        # int64 and qarray data are read as quad, never through float64
+        big = np.array([2**62 + 1, 1], dtype=np.int64)
+        assert qarray.qsum(big).as_integer_ratio() == (2**62 + 2, 1)
+
+        tenth = qarray.from_list(["0.1"])
+        assert qarray.qdot(tenth, [3.0]) == tenth[0] * 3
+        assert qarray.qsum(np.arange(10, dtype=np.float32)) == 45
+
+        with pytest.raises(ValueError):
+            qarray.qdot([1.0, 2.0], [1.0])
+        with pytest.raises(ValueError):
+            qarray.qsum([1.0], threads=-1)
+
+    def test_float64_results_correctly_rounded(self):
+
+        from fractions import Fraction
+
+        rng = np.random.default_rng(7)
+        x = rng.standard_normal(20000) * np.ldexp(1.0, rng.integers(-40, 40, 20000))
+        y = rng.standard_normal(20000)
+
+        total = sum(map(Fraction, x))
+        dot = sum(Fraction(a) * Fraction(b) for a, b in zip(x, y))
+        assert qarray.qsum(x, dtype=np.float64) == float(total)
+        assert qarray.qdot(x, y, dtype=np.float64) == float(dot)
+        assert type(qarray.qsum(x, dtype=np.float64)) is np.float64
+        assert type(qarray.qsum(x, dtype=qarray.dtype)) is qfloat
+
+        with pytest.raises(ValueError):
+            qarray.qsum(x, dtype=np.float32)
+
+    def test_qgemv(self):
+
+        from fractions import Fraction
+
+        rng = np.random.default_rng(8)
+        a = rng.standard_normal((37, 500))
+        x = rng.standard_normal(500)
+
+        exact = [sum(Fraction(u) * Fraction(v) for u, v in zip(row, x)) for row in a]
+        quad = qarray.qgemv(a, x)
+        assert quad.dtype == qarray.dtype
+        assert [Fraction(*q.as_integer_ratio()) for q in quad] == [_round_to_quad(e) for e in exact]
+        np.testing.assert_array_equal(qarray.qgemv(a, x, dtype=np.float64), [float(e) for e in exact])
+
+        for t in (2, 5, 0):
+            np.testing.assert_array_equal(qarray.qgemv(a, x, threads=t), quad)
+
+        np.testing.assert_array_equal(qarray.qgemv(a.astype(qarray.dtype), x), quad)
+
+        with pytest.raises(ValueError):
+            qarray.qgemv(a, x[:-1])
+        with pytest.raises(ValueError):
+            qarray.qgemv(x, x)
+
+    def test_qnrm2_qaxpy(self):
+
+        from fractions import Fraction
+
+        assert qarray.qnrm2([3.0, 4.0]) == 5
+        assert qarray.qnrm2([1e200, 1e200], dtype=np.float64) == math.hypot(1e200, 1e200)
+
+        rng = np.random.default_rng(9)
+        x = rng.standard_normal(1000)
+        y = rng.standard_normal(1000)
+        alpha = 0.1
+
+        exact = [Fraction(alpha) * Fraction(u) + Fraction(v) for u, v in zip(x, y)]
+        np.testing.assert_array_equal(qarray.qaxpy(alpha, x, y, dtype=np.float64), [float(e) for e in exact])
+        quad = qarray.qaxpy(alpha, x, y)
+        assert [Fraction(*q.as_integer_ratio()) for q in quad] == [_round_to_quad(e) for e in exact]
+
+        with pytest.raises(ValueError):
+            qarray.qaxpy(alpha, x, y[:-1])
+
+
+def _exact_decimal(value):
+    # Exact decimal string of a Fraction whose denominator is a power of two
+    k = value.denominator.bit_length() - 1
+    return f"{value.numerator * 5**k}e-{k}"
+
+
+@pytest.mark.qarray
+class TestQArrayParse:
+    def test_from_strings_correctly_rounded(self):
+
+        import random
+        import sys
+        from fractions import Fraction
+
+        limit = sys.get_int_max_str_digits() if hasattr(sys, "get_int_max_str_digits") else 0
+        if hasattr(sys, "set_int_max_str_digits"):
+            sys.set_int_max_str_digits(0)
+        try:
+            rng = random.Random(41)
+            values = []
+            for _ in range(1500):
+                digits = "".join(rng.choice("0123456789") for _ in range(rng.randint(1, 50)))
+                k = rng.randint(0, len(digits))
+                values.append(f"{rng.choice(['', '-', '+'])}{digits[:k]}.{digits[k:]}e{rng.randint(-5000, 4880)}")
+
+            # Exact halfway points between neighbouring quads, including
+            # subnormals, and a value just above each
+            for _ in range(500):
+                m = rng.getrandbits(112) | (1 << 112)
+                half = Fraction(2 * m + 1) * Fraction(2) ** rng.randint(-16600, -120)
+                values.append(_exact_decimal(half))
+                values.append(_exact_decimal(half).replace("e", "0" * 30 + "1e", 1))
+            values += ["10384593717069655257060992658440193", "10384593717069655257060992658440195"]
+
+            exact = [Fraction(v) for v in values]
+        finally:
+            if hasattr(sys, "set_int_max_str_digits"):
+                sys.set_int_max_str_digits(limit)
+
+        expected = [_round_to_quad(e) for e in exact]
+        for parsed in (qarray.from_strings(values), qarray.from_strings(np.array(values)), qarray.from_list(values)):
+            assert [Fraction(*q.as_integer_ratio()) for q in parsed] == expected
+
+    def test_from_strings_special_values(self):
+
+        from fractions import Fraction
+
+        values = [" 1.5 ", "-0", "0x1.8p1", "inf", "-Infinity", "1e5000", "-1e-5000", "5.", ".5", "1" + "0" * 60]
+        out = qarray.from_strings(values)
+
+        assert out.tolist()[:3] == [1.5, 0, 3]
+        assert np.signbit(out[1:2].astype(np.float64))[0]
+        assert np.isnan(qarray.from_strings(["nan"]))[0]
+        assert np.isinf(out[3:6]).all() and np.signbit(out[3:6]).tolist() == [False, True, False]
+        assert out[6] == 0 and np.signbit(out[6:7])[0]
+        assert out[7:9].tolist() == [5, 0.5]
+        assert Fraction(*out[9].as_integer_ratio()) == _round_to_quad(Fraction(10**60))
+
+        with pytest.raises(ValueError, match="could not convert"):
+            qarray.from_strings(["1", "1.2.3"])
+        with pytest.raises(ValueError, match="could not convert"):
+            qarray.from_strings(["1\x00"])
+        with pytest.raises(ValueError, match="could not convert"):
+            qarray.from_strings(np.array(["1", "\u00bd"]))
+        with pytest.raises(TypeError):
+            qarray.from_strings([1.5])
+
+    def test_from_strings_arrays_keep_shape(self):
+
+        text = np.array([["1.25", "-2e-3"], ["3.14", "1e4000"]])
+        expected = qarray.from_list(text.ravel().tolist()).reshape(2, 2)
+
+        for values in (text, text.astype("S"), text.astype(">U6"), text.T.copy().T, text[:, ::-1][:, ::-1]):
+            out = qarray.from_strings(values)
+            assert out.shape == (2, 2)
+            assert out.tobytes() == expected.tobytes()
+
+        big = np.array([str(v) for v in qarray.from_array(np.linspace(-1, 1, 50000))])
+        assert qarray.from_strings(big, threads=0).tobytes() == qarray.from_strings(big.tolist()).tobytes()
+        with pytest.raises(ValueError, match="1e"):
+            qarray.from_strings(np.concatenate([big, ["1e"]]), threads=3)
+
+    def test_to_strings(self):
+
+        values = qarray.from_strings(["3.14", "1e16", "-0.0", "nan", "1e-4950", "0.1"])
+        out = qarray.to_strings(values)
+        assert out.dtype == np.dtype("<U7")
+        assert out.tolist() == ["3.14", "1e+16", "-0.0", "nan", "1e-4950", "0.1"]
+        assert qarray.to_strings(values, ".2e").tolist() == [format(v, ".2e") for v in values]
+        assert qarray.to_strings(values.reshape(2, 3), "\u00e9>8").tolist() == [
+            ["\u00e9\u00e9\u00e9\u00e93.14", "\u00e9\u00e9\u00e91e+16", "\u00e9\u00e9\u00e9\u00e9-0.0"],
+            ["\u00e9\u00e9\u00e9\u00e9\u00e9nan", "\u00e91e-4950", "\u00e9\u00e9\u00e9\u00e9\u00e90.1"],
+        ]
+        assert qarray.to_strings([1, 2.5]).tolist() == ["1.0", "2.5"]
+        assert qarray.to_strings(qarray.zeros(0)).shape == (0,)
+
+        big = qarray.from_array(np.linspace(-1, 1, 50001)) / 3
+        text = qarray.to_strings(big, threads=0)
+        assert text.tolist() == [str(v) for v in big]
+        assert qarray.from_strings(text).tobytes() == big.tobytes()
+        assert qarray.to_strings(big, ".50f", threads=3).tolist() == [format(v, ".50f") for v in big]
+
+        with pytest.raises(ValueError):
+            qarray.to_strings(values, "d")
+
+    def test_string_casts(self):
+
+        values = qarray.from_strings(["3.14", "1e16", "-0.0", "nan", "0.1"])
+        assert values.astype("U8").tolist() == ["3.14", "1e+16", "-0.0", "nan", "0.1"]
+        assert values.astype("S8").tolist() == [b"3.14", b"1e+16", b"-0.0", b"nan", b"0.1"]
+
+        for dtype in ("<U", ">U", "S"):
+            text = np.array(["0.1", " -2.5e-3 ", "inf"], dtype=dtype)
+            out = text.astype(qarray.dtype)
+            assert out.tobytes() == qarray.from_strings(["0.1", "-2.5e-3", "inf"]).tobytes()
+
+        big = qarray.from_array(np.linspace(-1, 1, 1001)) / 3
+        assert big.astype("U48").astype(qarray.dtype).tobytes() == big.tobytes()
+
+        # Too short an element is an error rather than a truncated number
+        with pytest.raises(ValueError, match="does not fit"):
+            values.astype(str)
+        with pytest.raises(ValueError, match="could not convert string to qfloat: '1x'"):
+            np.array(["1", "1x"]).astype(qarray.dtype)
+
+    def test_string_dtype(self):
+
+        text = np.array(["3.14", "-1e-4950", "nan"], dtype=np.dtypes.StringDType())
+        values = qarray.from_strings(text)
+        assert values.tobytes() == qarray.from_strings(["3.14", "-1e-4950", "nan"]).tobytes()
+
+        out = qarray.to_strings(values, dtype=np.dtypes.StringDType())
+        assert out.dtype == np.dtypes.StringDType()
+        assert out.tolist() == ["3.14", "-1e-4950", "nan"]
+        assert qarray.to_strings(values, dtype="S").tolist() == [b"3.14", b"-1e-4950", b"nan"]
+
+        with pytest.raises(ValueError):
+            qarray.from_strings(np.array(["1", None], dtype=np.dtypes.StringDType(na_object=None)))
+        with pytest.raises(TypeError):
+            qarray.to_strings(values, dtype=np.float64)
+
+
+@pytest.mark.qarray
+class TestQArrayText:
+    def test_loadtxt(self, tmp_path):
+
+        path = tmp_path / "table.txt"
+        path.write_text("# x y z\n1 2 3\n\n4 5 6  # note\n0.1\t-2e-3 nan\n")
+
+        out = qarray.loadtxt(path)
+        assert out.dtype == qarray.dtype
+        assert out.shape == (3, 3)
+        assert out.tobytes() == qarray.from_strings(["1", "2", "3", "4", "5", "6", "0.1", "-2e-3", "nan"]).tobytes()
+
+        assert qarray.loadtxt(path, usecols=(0, -1)).shape == (3, 2)
+        assert [float(v) for v in qarray.loadtxt(path, usecols=1)] == [2.0, 5.0, -0.002]
+        assert qarray.loadtxt(path, max_rows=1).shape == (3,)
+        assert qarray.loadtxt(path, max_rows=1, ndmin=2).shape == (1, 3)
+        assert qarray.loadtxt(path, skiprows=2).shape == (2, 3)
+
+        path.write_text("a;b\n1;2\n3; 4\n")
+        out = qarray.loadtxt(str(path), delimiter=";", skiprows=1, comments=None)
+        assert [[float(v) for v in row] for row in out] == [[1.0, 2.0], [3.0, 4.0]]
+
+        path.write_text("")
+        assert qarray.loadtxt(path).shape == (0,)
+
+    def test_loadtxt_errors(self, tmp_path):
+
+        path = tmp_path / "table.txt"
+        path.write_text("1 2\n3\n")
+        with pytest.raises(ValueError, match="number of columns changed from 2 to 1 at line 2"):
+            qarray.loadtxt(path)
+        path.write_text("# c\n1 2\n3 x\n")
+        with pytest.raises(ValueError, match="could not convert string 'x' to qfloat at line 3, column 2"):
+            qarray.loadtxt(path)
+        with pytest.raises(ValueError, match="invalid column index"):
+            qarray.loadtxt(path, usecols=[2])
+        with pytest.raises(FileNotFoundError):
+            qarray.loadtxt(tmp_path / "missing.txt")
+
+    def test_savetxt_round_trip(self, tmp_path):
+
+        path = tmp_path / "table.txt"
+        values = qarray.from_array(np.linspace(-1, 1, 60000).reshape(20000, 3)) / 3
+        qarray.savetxt(path, values, header="x y z\nsecond", footer="end", threads=0)
+        lines = path.read_text().splitlines()
+        assert lines[:2] == ["# x y z", "# second"]
+        assert lines[-1] == "# end"
+        assert lines[2] == " ".join(str(v) for v in values[0])
+
+        out = qarray.loadtxt(path, threads=3)
+        assert out.tobytes() == values.tobytes()
+
+        qarray.savetxt(path, values[:2], fmt=".3e", delimiter=",", newline="\r\n")
+        assert path.read_bytes() == b"".join(
+            ",".join(format(v, ".3e") for v in row).encode() + b"\r\n" for row in values[:2]
+        )
+
+        qarray.savetxt(path, [1, 2.5])
+        assert path.read_text() == "1.0\n2.5\n"
+
+        with pytest.raises(ValueError, match="Expected 1D or 2D array"):
+            qarray.savetxt(path, values.reshape(2, 3, -1))
+        with pytest.raises(ValueError):
+            qarray.savetxt(path, values, fmt="d")
+
+
+
+class _DLTensor(ctypes.Structure):
+    _fields_ = [
+        ("data", ctypes.c_void_p),
+        ("device_type", ctypes.c_int32),
+        ("device_id", ctypes.c_int32),
+        ("ndim", ctypes.c_int32),
+        ("code", ctypes.c_uint8),
+        ("bits", ctypes.c_uint8),
+        ("lanes", ctypes.c_uint16),
+        ("shape", ctypes.POINTER(ctypes.c_int64)),
+        ("strides", ctypes.POINTER(ctypes.c_int64)),
+        ("byte_offset", ctypes.c_uint64),
+    ]
+
+
+def _dltensor(capsule, name=b"dltensor"):
+    # What a C consumer sees in the capsule; DLManagedTensor starts with it
+    get = ctypes.pythonapi.PyCapsule_GetPointer
+    get.restype = ctypes.c_void_p
+    get.argtypes = [ctypes.py_object, ctypes.c_char_p]
+    return _DLTensor.from_address(get(capsule, name))
+
+
+class TestQArrayDLPack:
+    def test_round_trip(self):
+
+        from pyquadp.dlpack import DLPackArray
+
+        arr = qarray.from_array(np.arange(12.0).reshape(3, 4)) / 3
+        out = qarray.from_dlpack(qarray.to_dlpack(arr))
+        assert np.shares_memory(out, arr)
+        assert out.tobytes() == arr.tobytes()
+
+        view = qarray.from_dlpack(DLPackArray(arr[:, ::2]))
+        assert view.strides == arr[:, ::2].strides
+        view[0, 1] = 7
+        assert arr[0, 2] == 7
+
+        copied = qarray.from_dlpack(DLPackArray(arr), copy=True)
+        assert not np.shares_memory(copied, arr)
+        assert copied.tobytes() == arr.tobytes()
+
+    def test_capsule_layout(self):
+
+        arr = qarray.from_array(np.arange(6.0).reshape(2, 3))[:, ::2]
+        capsule = qarray.to_dlpack(arr)
+        tensor = _dltensor(capsule)
+        assert tensor.data == arr.ctypes.data
+        assert (tensor.device_type, tensor.code, tensor.bits, tensor.lanes) == (1, 2, 128, 1)
+        assert [tensor.shape[i] for i in range(2)] == [2, 2]
+        assert [tensor.strides[i] for i in range(2)] == [3, 2]
+
+        # Consumed capsules are renamed and cannot be used twice
+        qarray.from_dlpack(capsule)
+        with pytest.raises(TypeError):
+            qarray.from_dlpack(capsule)
+
+    def test_lifetime_and_flags(self):
+
+        arr = qarray.from_array(np.arange(4.0))
+        refs = sys.getrefcount(arr)
+        capsule = qarray.to_dlpack(arr)
+        out = qarray.from_dlpack(capsule)
+        del capsule
+        assert sys.getrefcount(arr) == refs + 1
+        del out
+        assert sys.getrefcount(arr) == refs
+
+        arr.flags.writeable = False
+        with pytest.raises(BufferError):
+            qarray.to_dlpack(arr)
+        capsule = qarray.to_dlpack(arr, max_version=(1, 0))
+        assert _dltensor(capsule, b"dltensor_versioned") is not None
+        assert not qarray.from_dlpack(capsule).flags.writeable
+
+        swapped = arr.astype(arr.dtype.newbyteorder("S"))
+        with pytest.raises(BufferError):
+            qarray.to_dlpack(swapped, copy=False)
+        assert qarray.from_dlpack(qarray.to_dlpack(swapped)).tobytes() == arr.tobytes()
+
+        with pytest.raises(TypeError):
+            qarray.from_dlpack(np.arange(3.0))
+
+
+class _ArrowSchema(ctypes.Structure):
+    _fields_ = [
+        ("format", ctypes.c_char_p),
+        ("name", ctypes.c_char_p),
+        ("metadata", ctypes.c_void_p),
+        ("flags", ctypes.c_int64),
+        ("n_children", ctypes.c_int64),
+        ("children", ctypes.c_void_p),
+        ("dictionary", ctypes.c_void_p),
+        ("release", ctypes.c_void_p),
+        ("private_data", ctypes.c_void_p),
+    ]
+
+
+class _ArrowArray(ctypes.Structure):
+    _fields_ = [
+        ("length", ctypes.c_int64),
+        ("null_count", ctypes.c_int64),
+        ("offset", ctypes.c_int64),
+        ("n_buffers", ctypes.c_int64),
+        ("n_children", ctypes.c_int64),
+        ("buffers", ctypes.POINTER(ctypes.c_void_p)),
+        ("children", ctypes.c_void_p),
+        ("dictionary", ctypes.c_void_p),
+        ("release", ctypes.c_void_p),
+        ("private_data", ctypes.c_void_p),
+    ]
+
+
+def _arrow_structs(pair):
+    # What a C consumer sees in the capsules
+    get = ctypes.pythonapi.PyCapsule_GetPointer
+    get.restype = ctypes.c_void_p
+    get.argtypes = [ctypes.py_object, ctypes.c_char_p]
+    return (
+        _ArrowSchema.from_address(get(pair[0], b"arrow_schema")),
+        _ArrowArray.from_address(get(pair[1], b"arrow_array")),
+    )
+
+
+def _arrow_metadata(address):
+    # Arrow metadata is an int32 count then length prefixed keys and values
+    def int32(pos):
+        return ctypes.c_int32.from_address(address + pos).value
+
+    pos = 4
+    result = {}
+    for _ in range(int32(0)):
+        key = ctypes.string_at(address + pos + 4, int32(pos))
+        pos += 4 + len(key)
+        value = ctypes.string_at(address + pos + 4, int32(pos))
+        pos += 4 + len(value)
+        result[key] = value
+    return result
+
+
+class TestQArrayArrow:
+    def test_round_trip(self):
+
+        from pyquadp.arrow import ArrowArray
+
+        arr = qarray.from_array(np.arange(6.0)) / 3
+        out = qarray.from_arrow(qarray.to_arrow(arr))
+        assert np.shares_memory(out, arr)
+        assert not out.flags.writeable
+        assert out.tobytes() == arr.tobytes()
+
+        strided = ArrowArray(arr[::2])
+        assert len(strided) == 3
+        assert qarray.from_arrow(strided).tobytes() == arr[::2].tobytes()
+
+        copied = qarray.from_arrow(ArrowArray(arr), copy=True)
+        assert copied.flags.writeable
+        assert not np.shares_memory(copied, arr)
+        assert len(qarray.from_arrow(ArrowArray(arr[:0]))) == 0
+
+    def test_struct_layout(self):
+
+        arr = qarray.from_array(np.arange(4.0))
+        pair = qarray.to_arrow(arr)
+        schema, array = _arrow_structs(pair)
+        assert schema.format == b"w:16"
+        assert schema.n_children == 0 and schema.flags == 0
+        assert _arrow_metadata(schema.metadata) == {
+            b"ARROW:extension:name": b"pyquadp.qfloat",
+            b"ARROW:extension:metadata": b"",
+        }
+        assert (array.length, array.null_count, array.offset, array.n_buffers) == (4, 0, 0, 2)
+        assert array.buffers[0] is None
+        assert array.buffers[1] == arr.ctypes.data
+
+        # Offsets are honoured and plain fixed_size_binary is accepted
+        array.offset = 1
+        array.length = 2
+        schema.metadata = None
+        out = qarray.from_arrow(pair)
+        assert [float(v) for v in out] == [1.0, 2.0]
+
+        # The array was moved out of its capsule
+        with pytest.raises(ValueError):
+            qarray.from_arrow(pair)
+
+    def test_lifetime_and_errors(self):
+
+        arr = qarray.from_array(np.arange(4.0))
+        refs = sys.getrefcount(arr)
+        pair = qarray.to_arrow(arr)
+        out = qarray.from_arrow(pair)
+        del pair
+        assert sys.getrefcount(arr) == refs + 1
+        del out
+        assert sys.getrefcount(arr) == refs
+
+        # Unreleased capsules release their data when they go
+        qarray.to_arrow(arr)
+        assert sys.getrefcount(arr) == refs
+
+        pair = qarray.to_arrow(arr)
+        bitmap = ctypes.c_uint8(0b1101)
+        _, array = _arrow_structs(pair)
+        array.buffers[0] = ctypes.addressof(bitmap)
+        array.null_count = -1
+        with pytest.raises(ValueError, match="nulls"):
+            qarray.from_arrow(pair)
+
+        with pytest.raises(ValueError):
+            qarray.to_arrow(arr.reshape(2, 2))
+        with pytest.raises(TypeError):
+            qarray.from_arrow(np.arange(3.0))
+        with pytest.raises(TypeError, match="pyquadp.qint"):
+            qarray.from_arrow(qiarray.to_arrow(qiarray.from_list([1])))
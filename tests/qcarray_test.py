@@ -3,7 +3,9 @@
 import numpy as np
 import pytest
 
+import pyquadp.qarray as qarray
 import pyquadp.qcarray as qcarray
+import pyquadp.qiarray as qiarray
 
 
 @pytest.mark.qcarray
@@ -245,6 +247,113 @@ class TestQCArrayInterop:
         roundtrip = np.asarray(out, dtype=np.complex128)
         assert np.allclose(roundtrip, src)
 
+    def test_cast_qarray_qcarray(self):
+
+        import pyquadp.qarray as qarray
+
+        arr = qarray.from_list(["0.1", -2])
+        out = arr.astype(qcarray.dtype)
+        assert out.dtype == qcarray.dtype
+        assert out[0].real == arr[0]
+        assert out[0].imag == 0
+
+        # The way back keeps the real part
+        back = qcarray.from_list([1.5 + 2j, -3 - 1j]).astype(qarray.dtype)
+        assert back.dtype == qarray.dtype
+        np.testing.assert_array_equal(back.astype(np.float64), [1.5, -3.0])
+
+        assert np.can_cast(qarray.dtype, qcarray.dtype)
+        assert not np.can_cast(qcarray.dtype, qarray.dtype)
+        assert np.result_type(qarray.dtype, qcarray.dtype) == qcarray.dtype
+        assert (qcarray.from_list([1j]) + arr[:1]).dtype == qcarray.dtype
+
+    def test_cast_clongdouble_roundtrip(self):
+
+        part = np.array([1, -2], dtype=np.longdouble) / 3
+        src = part + 1j * part[::-1]
+
+        out = src.astype(qcarray.dtype)
+        assert out.dtype == qcarray.dtype
+        assert out[0].real.as_integer_ratio() == part[0].as_integer_ratio()
+        assert out[0].imag.as_integer_ratio() == part[1].as_integer_ratio()
+        np.testing.assert_array_equal(out.astype(np.clongdouble), src)
+
+        assert np.can_cast(np.clongdouble, qcarray.dtype)
+        assert not np.can_cast(qcarray.dtype, np.clongdouble)
+
+    def test_byte_order_variants(self):
+
+        arr = qcarray.from_list([1 + 2j, -3j, 0.5])
+        big = arr.astype(qcarray.dtype.newbyteorder(">"))
+        # Each part is swapped on its own, the real part stays first
+        raw = arr.tobytes()
+        assert big.tobytes()[:32] == raw[15::-1] + raw[31:15:-1]
+        assert [complex(v) for v in big] == [1 + 2j, -3j, 0.5]
+        assert big.astype(qcarray.dtype).tobytes() == raw
+        assert (big * big).tobytes() == (arr * arr).tobytes()
+
+        big[2] = 4j
+        assert complex(big[2]) == 4j
+        swapped = arr.copy()
+        swapped.byteswap(inplace=True)
+        assert swapped.tobytes() == arr.astype(big.dtype).tobytes()
+
+    def test_cast_strings(self):
+
+        text = np.array(["(1+2j)", "-j", " 4 ", "1e3-2.5e-2j", "nan+infj"])
+        arr = text.astype(qcarray.dtype)
+        assert arr.dtype == qcarray.dtype
+        assert arr.astype("U20").tolist() == ["(1+2j)", "-1j", "(4+0j)", "(1000-0.025j)", "(nan+infj)"]
+        assert arr.astype("S20")[0] == b"(1+2j)"
+        assert text.astype(">U12").astype(qcarray.dtype).tobytes() == arr.tobytes()
+
+        with pytest.raises(ValueError, match="does not fit"):
+            arr.astype(str)
+        with pytest.raises(ValueError, match="could not convert string to qcmplx"):
+            np.array(["1+"]).astype(qcarray.dtype)
+
+    def test_dlpack(self):
+
+        from pyquadp.dlpack import DLPackArray
+
+        arr = qcarray.from_list([1 + 2j, -3j, 0.5])
+        out = qcarray.from_dlpack(DLPackArray(arr))
+        assert np.shares_memory(out, arr)
+        assert out.tobytes() == arr.tobytes()
+
+        # No 256 bit type in DLPack, the parts are a last dimension of floats
+        parts = qarray.from_dlpack(DLPackArray(arr))
+        assert parts.shape == (3, 2)
+        assert float(parts[0, 1]) == 2.0
+        with pytest.raises(TypeError):
+            qiarray.from_dlpack(DLPackArray(arr))
+
+    def test_arrow(self):
+
+        from pyquadp.arrow import ArrowArray
+
+        arr = qcarray.from_list([1 + 2j, -3j, 0.5])
+        out = qcarray.from_arrow(ArrowArray(arr))
+        assert np.shares_memory(out, arr)
+        assert out.tobytes() == arr.tobytes()
+        # fixed_size_binary(32) does not fit a 16 byte dtype
+        with pytest.raises(TypeError, match="w:16"):
+            qarray.from_arrow(ArrowArray(arr))
+
+    def test_loadtxt_savetxt(self, tmp_path):
+
+        path = tmp_path / "table.txt"
+        arr = qcarray.from_list([1 + 2j, -3j, 0.5, complex("nan")]).reshape(2, 2)
+        qcarray.savetxt(path, arr, delimiter=",")
+        assert path.read_text() == "(1+2j),(-0-3j)\n(0.5+0j),(nan+0j)\n"
+
+        out = qcarray.loadtxt(path, delimiter=",")
+        assert out.dtype == qcarray.dtype
+        assert out.tobytes() == arr.tobytes()
+
+        with pytest.raises(ValueError, match="fmt is not supported for qcmplx"):
+            qcarray.savetxt(path, arr, fmt=".3e")
+
     def test_numpy_sum_and_prod_reduce_qcarray(self):
 
         values = np.array(
@@ -867,3 +976,30 @@ class TestQCArrayHardening:
         np.testing.assert_array_equal(
             np.argsort(mixed, axis=1), np.argsort(expected, axis=1)
         )
+
+    def test_classification_and_logical_ufuncs(self):
+
+        values = [
+            0j,
+            complex(-0.0, -0.0),
+            complex(0.0, 1e-300),
+            complex(float("nan"), 0.0),
+            complex(1.0, float("-inf")),
+            complex(float("inf"), float("nan")),
+            1 - 2j,
+        ]
+        q = qcarray.from_list(values)
+        ref = np.array(values, dtype=np.complex128)
+
+        for ufunc in (np.isnan, np.isinf, np.isfinite, np.logical_not):
+            np.testing.assert_array_equal(ufunc(q), ufunc(ref))
+            np.testing.assert_array_equal(ufunc(q[::2]), ufunc(ref[::2]))
+
+        for ufunc in (np.logical_and, np.logical_or, np.logical_xor):
+            np.testing.assert_array_equal(ufunc(q, q[::-1]), ufunc(ref, ref[::-1]))
+
+        assert np.count_nonzero(q) == np.count_nonzero(ref)
+        np.testing.assert_array_equal(np.nonzero(q)[0], np.nonzero(ref)[0])
+
+        big = qcarray.from_list(["1e400+0j"])
+        assert np.isfinite(big)[0] and not np.isinf(big)[0]
@@ -14,16 +14,16 @@ import pyquadp as pq
 class TestQFloat:
     def test_make(self):
         q = pq.qfloat(1)
-        assert str(q) == "1.000000000000000000000000000000000000e+00"
+        assert str(q) == "1.0"
 
         q = pq.qfloat(1.0)
-        assert str(q) == "1.000000000000000000000000000000000000e+00"
+        assert str(q) == "1.0"
 
         q = pq.qfloat("1")
-        assert str(q) == "1.000000000000000000000000000000000000e+00"
+        assert str(q) == "1.0"
 
         q2 = pq.qfloat(q)
-        assert str(q) == "1.000000000000000000000000000000000000e+00"
+        assert str(q) == "1.0"
 
         with pytest.raises(TypeError) as cm:
             q = pq.qfloat("abc")
@@ -245,6 +245,22 @@ class TestQFloat:
 
         assert result == q1
 
+    def test_pickle_compact(self):
+        values = [pq.qfloat("1.234567890")] * 1000
+        values = [v + 0 for v in values]  # distinct objects, not memoized
+        # One memoized reference to _from_bytes, then the raw bytes of each
+        size = len(values[0].to_bytes())
+        assert len(pickle.dumps(values)) < 1000 * (size + 10)
+        assert pickle.loads(pickle.dumps(values)) == values
+
+        # The dict state of older versions still loads
+        q1 = values[0]
+        old = (
+            b"\x80\x04\x8c\x0fpyquadp.qmfloat\x94\x8c\x06qfloat\x94\x93\x94)\x81\x94}\x94("
+            b"\x8c\x0f_pickle_version\x94K\x01\x8c\x05bytes\x94C" + bytes([size]) + q1.to_bytes() + b"\x94ub."
+        )
+        assert pickle.loads(old) == q1
+
     def test_hash(self):
         q1 = pq.qfloat("1.234567890")
         q2 = pq.qfloat("1.234567899999")
@@ -312,3 +328,73 @@ class TestQFloat:
 
         with pytest.raises(ValueError):
             pq.qfloat("nan").as_integer_ratio()
+
+    def test_repr_shortest(self):
+        cases = {
+            "3.14": "3.14",
+            "1e16": "1e+16",
+            "123.0": "123.0",
+            "0.0001": "0.0001",
+            "0.00001": "1e-05",
+            "-0": "-0.0",
+            "inf": "inf",
+            "-inf": "-inf",
+            "nan": "nan",
+            "1e-4950": "1e-4950",
+            "0.1": "0.1",
+        }
+        for text, expected in cases.items():
+            assert str(pq.qfloat(text)) == expected
+            assert repr(pq.qfloat(text)) == f"qfloat('{expected}')"
+
+        assert str(pq.qfloat(0.1)) == "0.1000000000000000055511151231257827"
+        assert str(pq.qfloat(1) / 3) == "0.3333333333333333333333333333333333"
+
+    def test_repr_round_trips(self):
+        import random
+        from decimal import Decimal
+        from fractions import Fraction
+
+        rng = random.Random(42)
+        for i in range(3000):
+            bits = rng.getrandbits(127)
+            if i % 3 == 0:
+                bits &= (1 << 112) - 1
+            elif i % 3 == 1:
+                bits = (bits & ((1 << 112) - 1)) | (rng.randint(16383 - 300, 16383 + 300) << 112)
+            if bits >> 112 == 0x7FFF:
+                continue
+            q = pq.qfloat.from_bytes(bits.to_bytes(16, "little"))
+            text = str(q)
+            assert pq.qfloat(text).to_bytes() == q.to_bytes()
+
+            # Neither neighbour with one digit fewer reads back
+            if i % 10 == 0 and q != 0:
+                scale = Decimal(text).normalize().as_tuple().exponent + 1
+                lower = Fraction(*q.as_integer_ratio()) / Fraction(10) ** scale
+                for m in (lower.numerator // lower.denominator, lower.numerator // lower.denominator + 1):
+                    assert pq.qfloat(f"{m}e{scale}").to_bytes() != q.to_bytes()
+
+    def test_format(self):
+        q = pq.qfloat("3.14")
+        assert format(q, "") == "3.14"
+        assert format(q, ".3e") == "3.140e+00"
+        assert format(q, ".36e") == "3.140000000000000000000000000000000108e+00"
+        assert format(q, ">10.3f") == "     3.140"
+        assert format(q, "*^10") == "***3.14***"
+        assert format(q, "+.1%") == "+314.0%"
+        assert format(pq.qfloat("1234567.5"), ",.2f") == "1,234,567.50"
+        assert format(pq.qfloat("-0.0001"), "z.2f") == "0.00"
+        assert format(pq.qfloat("2"), "#g") == "2.00000"
+        assert format(pq.qfloat("1e40"), ".3") == "1e+40"
+        assert f"{pq.qfloat('-2.5'):=+08.2f}" == "-0002.50"
+        assert format(pq.qfloat("9.5"), "012,.1f") == "00,000,009.5"
+        assert format(pq.qfloat("123"), ".3") == "1.23e+02"
+        assert format(pq.qfloat("2.5"), "#.0") == "2.e+00"
+        assert format(pq.qfloat("1e16"), "#") == "1.e+16"
+        assert format(pq.qfloat("1") / 3, ".40f") == "0.3333333333333333333333333333333333172839"
+
+        with pytest.raises(ValueError):
+            format(q, "d")
+        with pytest.raises(ValueError):
+            format(q, ".3.4f")
@@ -3,6 +3,7 @@
 import numpy as np
 import pytest
 
+import pyquadp.qarray as qarray
 import pyquadp.qiarray as qiarray
 
 FIXED_WIDTH_DTYPES = [
@@ -272,6 +273,138 @@ class TestQIArrayInterop:
             out.astype(np.int64), np.array([0, 1, 7], dtype=np.int64)
         )
 
+    def test_cast_qiarray_to_qarray(self):
+
+        import pyquadp.qarray as qarray
+
+        arr = qiarray.from_list([2**112 + 1, -5, 0])
+        out = arr.astype(qarray.dtype)
+        assert out.dtype == qarray.dtype
+        assert [v.as_integer_ratio()[0] for v in out] == [2**112 + 1, -5, 0]
+
+        # Beyond the 113-bit significand the value is rounded
+        out = qiarray.from_list([2**120 + 1]).astype(qarray.dtype)
+        assert out[0].as_integer_ratio() == (2**120, 1)
+
+        assert np.result_type(qiarray.dtype, qarray.dtype) == qarray.dtype
+
+    def test_cast_qarray_to_qiarray_truncates(self):
+
+        import pyquadp.qarray as qarray
+
+        arr = qarray.from_list(["2.75", "-2.75", "1e30", "-0.5"])
+        out = arr.astype(qiarray.dtype)
+        assert out.dtype == qiarray.dtype
+        assert [int(v) for v in out] == [2, -2, 10**30, 0]
+
+        with pytest.warns(RuntimeWarning, match="invalid value"):
+            out = qarray.from_list(["nan", "1e40"]).astype(qiarray.dtype)
+        assert [int(v) for v in out] == [-(2**127)] * 2
+
+    def test_cast_strings(self):
+
+        text = np.array(["1", " -5 ", str(2**127 - 1), str(-(2**127))])
+        arr = text.astype(qiarray.dtype)
+        assert [int(v) for v in arr] == [1, -5, 2**127 - 1, -(2**127)]
+        assert arr.astype("U40").tolist() == ["1", "-5", str(2**127 - 1), str(-(2**127))]
+        assert arr.astype("S40")[1] == b"-5"
+        assert text.astype(">U40").astype(qiarray.dtype).tobytes() == arr.tobytes()
+
+        with pytest.raises(ValueError, match="does not fit"):
+            arr.astype(str)
+        for bad in ["1.5", "x", str(2**127)]:
+            with pytest.raises(ValueError, match="could not convert string to qint"):
+                np.array([bad]).astype(qiarray.dtype)
+
+    def test_byte_order_variants(self):
+
+        arr = qiarray.from_list([1, -2, 2**100])
+        big = arr.astype(qiarray.dtype.newbyteorder(">"))
+        assert big.tobytes()[:16] == (1).to_bytes(16, "big")
+        assert [int(v) for v in big] == [1, -2, 2**100]
+        assert big.astype(qiarray.dtype).tobytes() == arr.tobytes()
+        assert [int(v) for v in big + big] == [2, -4, 2**101]
+
+        big[0] = -(2**127)
+        assert big.tobytes()[:16] == (-(2**127)).to_bytes(16, "big", signed=True)
+
+    def test_dlpack(self):
+
+        from pyquadp.dlpack import DLPackArray
+
+        arr = qiarray.from_list([1, -(2**127), 2**100])
+        out = qiarray.from_dlpack(DLPackArray(arr[::2]))
+        assert np.shares_memory(out, arr)
+        assert [int(v) for v in out] == [1, 2**100]
+        with pytest.raises(TypeError):
+            qiarray.from_dlpack(qarray.to_dlpack(qarray.from_list([1.5])))
+
+    def test_arrow(self):
+
+        from pyquadp.arrow import ArrowArray
+
+        arr = qiarray.from_list([1, -(2**127), 2**100])
+        out = qiarray.from_arrow(ArrowArray(arr[::2]))
+        assert [int(v) for v in out] == [1, 2**100]
+        assert qiarray.from_arrow(qiarray.to_arrow(arr)).tobytes() == arr.tobytes()
+        with pytest.raises(TypeError, match="pyquadp.qfloat"):
+            qiarray.from_arrow(qarray.to_arrow(qarray.from_list([1.5])))
+
+    def test_loadtxt_savetxt(self, tmp_path):
+
+        path = tmp_path / "table.txt"
+        arr = qiarray.from_list([1, -(2**127), 2**100, 0])
+        qiarray.savetxt(path, arr)
+        assert path.read_text().split() == ["1", str(-(2**127)), str(2**100), "0"]
+
+        out = qiarray.loadtxt(path)
+        assert out.dtype == qiarray.dtype
+        assert out.tobytes() == arr.tobytes()
+
+        path.write_text("1 2.5\n")
+        with pytest.raises(ValueError, match="could not convert string '2.5' to qint at line 1, column 2"):
+            qiarray.loadtxt(path)
+
+    @pytest.mark.parametrize("ufunc", [np.add, np.subtract, np.multiply])
+    def test_mixed_qarray_promotes(self, ufunc):
+
+        import pyquadp.qarray as qarray
+
+        i = qiarray.from_list([7, -5])
+        f = qarray.from_list(["2.5", "0.5"])
+
+        for a, b in [(i, f), (f, i)]:
+            out = ufunc(a, b)
+            assert out.dtype == qarray.dtype
+            expected = ufunc(a.astype(qarray.dtype), b.astype(qarray.dtype))
+            assert np.all(out == expected)
+
+    @pytest.mark.parametrize(
+        "ufunc",
+        [
+            np.floor_divide,
+            np.remainder,
+            np.left_shift,
+            np.right_shift,
+            np.bitwise_and,
+            np.bitwise_or,
+            np.bitwise_xor,
+        ],
+    )
+    def test_mixed_qarray_integer_only_raises(self, ufunc):
+
+        import pyquadp.qarray as qarray
+
+        i = qiarray.from_list([7, -5])
+        f = qarray.from_list(["3.5", "2"])
+
+        # The qarray operand must not be truncated to fit the qiarray loop
+        for a, b in [(i, f), (f, i)]:
+            with pytest.raises(TypeError, match="qiarray and a qarray"):
+                ufunc(a, b)
+        out = ufunc(i, f.astype(qiarray.dtype))
+        assert [int(v) for v in out] == [int(v) for v in ufunc(i, qiarray.from_list([3, 2]))]
+
     def test_numpy_sum_and_prod_reduce_qiarray(self):
 
         values = np.array([[2, -3], [4, 5]], dtype=np.int64)
@@ -528,3 +661,78 @@ class TestQIArrayUfuncs:
         np.testing.assert_array_equal(
             np.asarray(bit_or, dtype=np.int64), np.bitwise_or(avals, bvals)
         )
+
+
+def _compose_reference(m, e):
+    # m * 2**e rounded to nearest even binary128 as (numerator, denominator)
+    from fractions import Fraction
+
+    if m == 0:
+        return (0, 1)
+    sign = -1 if m < 0 else 1
+    a = abs(m)
+    top = a.bit_length() - 1 + e
+    if top > 16383:
+        return None
+    lsb = max(top - 112, -16494)
+    shift = lsb - e
+    if shift <= 0:
+        q = a << -shift
+    else:
+        q, rem = divmod(a, 1 << shift)
+        half = 1 << (shift - 1)
+        if rem > half or (rem == half and q & 1):
+            q += 1
+    if q.bit_length() + lsb - 1 > 16383:
+        return None
+    value = sign * Fraction(q) * Fraction(2) ** lsb
+    return value.as_integer_ratio()
+
+
+@pytest.mark.qiarray
+class TestQIArrayDecompose:
+    def test_decompose_is_exact(self):
+
+        from fractions import Fraction
+
+        import pyquadp.qarray as qarray
+
+        x = qarray.from_list(["1", "0.1", "-3", "0", "1e-4950", "6e-4966", "1.1e4932", "-2.5e300"])
+        m, e = qiarray.decompose(x)
+        assert m.dtype == qiarray.dtype
+        assert e.dtype == np.int32
+        for v, mm, ee in zip(x, m, e):
+            assert int(mm) == 0 or int(mm) % 2 == 1
+            assert Fraction(int(mm)) * Fraction(2) ** int(ee) == Fraction(*v.as_integer_ratio())
+
+        assert qiarray.compose(m, e).tobytes() == x.tobytes()
+
+        with pytest.warns(RuntimeWarning, match="invalid value"):
+            m, e = qiarray.decompose(qarray.from_list(["inf", "nan"]))
+        assert [int(v) for v in m] == [0, 0]
+
+    def test_compose_rounds_once(self):
+
+        import random
+
+        random.seed(3)
+        ms = [random.getrandbits(random.randint(1, 127)) * random.choice([-1, 1]) for _ in range(2000)]
+        es = [random.randint(-16650, 16300) for _ in ms]
+        ms[:4] = [2**113 + 1, 2**113 + 3, 3, -(2**127)]
+        es[:4] = [0, 0, -16496, -16494 - 126]
+
+        with np.errstate(all="ignore"):
+            out = qiarray.compose(qiarray.from_list(ms), np.array(es, dtype=np.int32))
+        for v, m, e in zip(out, ms, es):
+            ref = _compose_reference(m, e)
+            if ref is None:
+                assert abs(float(v)) == np.inf
+            else:
+                assert v.as_integer_ratio() == ref
+
+        # int64 exponents take their own loop
+        assert qiarray.compose(qiarray.from_list([3]), [-1])[0] == 1.5
+
+        with np.errstate(over="raise"):
+            with pytest.raises(FloatingPointError):
+                qiarray.compose(qiarray.from_list([1]), [16384])
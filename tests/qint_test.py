@@ -233,6 +233,22 @@ class Testqint:
 
         assert result == q1
 
+    def test_pickle_compact(self):
+        values = [pq.qint("1234567890")] * 1000
+        values = [v + 0 for v in values]  # distinct objects, not memoized
+        # One memoized reference to _from_bytes, then the raw bytes of each
+        size = len(values[0].to_bytes())
+        assert len(pickle.dumps(values)) < 1000 * (size + 10)
+        assert pickle.loads(pickle.dumps(values)) == values
+
+        # The dict state of older versions still loads
+        q1 = values[0]
+        old = (
+            b"\x80\x04\x8c\x0dpyquadp.qmint\x94\x8c\x04qint\x94\x93\x94)\x81\x94}\x94("
+            b"\x8c\x0f_pickle_version\x94K\x01\x8c\x05bytes\x94C" + bytes([size]) + q1.to_bytes() + b"\x94ub."
+        )
+        assert pickle.loads(old) == q1
+
     def test_hash(self):
         q1 = pq.qint("1234567890")
         q2 = pq.qint("1234567899999")
@@ -0,0 +1,315 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+import decimal
+import math
+from fractions import Fraction
+
+import numpy as np
+import pytest
+
+import pyquadp as pq
+import pyquadp.qarray as qarray
+import pyquadp.qqarray as qqarray
+
+# Quad-double results are good to a few units of 2^-226
+QQ_RTOL = 2.0**-220
+
+# Enough digits that the reference itself is not the limit
+CTX = decimal.Context(prec=250)
+
+
+def _exact(x):
+    return Fraction(*x.hi.as_integer_ratio()) + Fraction(*x.lo.as_integer_ratio())
+
+
+def _dec(x):
+    f = _exact(x)
+    return CTX.divide(decimal.Decimal(f.numerator), decimal.Decimal(f.denominator))
+
+
+def _qq_spread(size, seed, scale=20):
+    # Values with a full-width trailing part, built as quad-double divisions
+    rng = np.random.default_rng(seed)
+    num = rng.integers(1, 2**60, size=size) * rng.choice([-1, 1], size=size)
+    den = rng.integers(1, 2**30, size=size)
+    exp = rng.integers(-scale, scale + 1, size=size)
+    return np.divide(
+        qqarray.from_list([pq.qqfloat(int(n)) for n in num]),
+        qqarray.from_list([pq.qqfloat(int(d)) * pq.qqfloat(10.0**int(e)) for d, e in zip(den, exp)]),
+    )
+
+
+def _max_rel_err(out, ref):
+    # ref holds Decimals
+    worst = 0
+    for got, r in zip(out, ref):
+        err = abs(CTX.subtract(_dec(got), r))
+        if r != 0:
+            err = CTX.divide(err, abs(r))
+        worst = max(worst, float(err))
+    return worst
+
+
+@pytest.mark.qqarray
+class TestQQArrayImport:
+    def test_qqarray_module_imports(self):
+
+        assert qqarray is not None
+        assert pq.qqarray is qqarray
+
+    def test_qqarray_type_exported(self):
+
+        assert qqarray.qqarray is pq.qqfloat
+        assert qqarray.dtype.itemsize == 32
+
+
+@pytest.mark.qqarray
+class TestQQArrayConstructors:
+    def test_zeros_ones_full(self):
+
+        arr = qqarray.zeros((2, 3))
+        assert arr.shape == (2, 3)
+        assert arr.dtype == qqarray.dtype
+        assert np.all(arr.astype(np.float64) == 0)
+
+        assert np.all(qqarray.ones(3).astype(np.float64) == 1)
+
+        arr = qqarray.full(2, "0.1")
+        assert arr[0] == pq.qqfloat("0.1")
+        assert arr[1].lo != 0
+
+        assert qqarray.empty(4).shape == (4,)
+
+    def test_from_list(self):
+
+        arr = qqarray.from_list([1, 2.5, "3.141592653589793238", pq.qfloat(1) / 3])
+        assert arr.dtype == qqarray.dtype
+        assert arr[0] == 1
+        assert arr[1] == 2.5
+        assert arr[2] == pq.qqfloat("3.141592653589793238")
+        assert arr[3] == pq.qqfloat(pq.qfloat(1) / 3)
+
+        with pytest.raises(TypeError):
+            qqarray.from_list(["abc"])
+
+    def test_like(self):
+
+        base = np.zeros((2, 2))
+        assert qqarray.empty_like(base).shape == (2, 2)
+        assert np.all(qqarray.zeros_like(base).astype(np.float64) == 0)
+        assert np.all(qqarray.ones_like(base).astype(np.float64) == 1)
+        assert qqarray.full_like(base, 3)[1, 1] == 3
+
+
+@pytest.mark.qqarray
+class TestQQArrayCasts:
+    def test_float64_roundtrip(self):
+
+        x = np.random.default_rng(1).random(100)
+        qq = x.astype(qqarray.dtype)
+        assert np.all(qq.astype(np.float64) == x)
+
+    def test_float32(self):
+
+        x = np.array([0.5, 1.25, -3.0], dtype=np.float32)
+        np.testing.assert_array_equal(x.astype(qqarray.dtype).astype(np.float32), x)
+
+    def test_qarray_roundtrip(self):
+
+        q = np.divide(qarray.from_list(range(1, 201)), 7)
+        qq = q.astype(qqarray.dtype)
+        # qarray -> qqarray is exact, qqarray -> qarray keeps hi
+        assert np.all(qq.astype(qarray.dtype) == q)
+        assert all(x.lo == 0 for x in qq)
+
+        third = qqarray.from_list([pq.qqfloat(1) / 3])
+        assert third.astype(qarray.dtype)[0] == pq.qfloat(1) / 3
+
+
+@pytest.mark.qqarray
+class TestQQArrayUfuncs:
+    @pytest.mark.parametrize(
+        "ufunc, op",
+        [
+            (np.add, CTX.add),
+            (np.subtract, CTX.subtract),
+            (np.multiply, CTX.multiply),
+            (np.divide, CTX.divide),
+        ],
+    )
+    def test_binary(self, ufunc, op):
+
+        a = _qq_spread(200, 3)
+        b = _qq_spread(200, 4)
+        out = ufunc(a, b)
+        assert out.dtype == qqarray.dtype
+        ref = [op(_dec(x), _dec(y)) for x, y in zip(a, b)]
+        assert _max_rel_err(out, ref) < QQ_RTOL
+
+        # Strided operands take the generic loop
+        out = ufunc(a[::2], b[1::2])
+        assert _max_rel_err(out, [op(_dec(x), _dec(y)) for x, y in zip(a[::2], b[1::2])]) < QQ_RTOL
+
+    def test_cancellation(self):
+
+        # Deep cancellation takes the error-free transformation fallback
+        a = qqarray.from_list([pq.qqfloat(pq.qfloat(1), pq.qfloat(2) ** -150)])
+        b = qqarray.from_list([pq.qqfloat(pq.qfloat(1), pq.qfloat(2) ** -200)])
+        out = a - b
+        assert _exact(out[0]) == Fraction(1, 2**150) - Fraction(1, 2**200)
+        assert (a - a)[0] == 0
+
+    @pytest.mark.parametrize("ufunc", [np.add, np.subtract, np.multiply, np.divide])
+    def test_binary_mixed(self, ufunc):
+
+        a = _qq_spread(50, 5)
+        d = np.random.default_rng(6).random(50) + 0.5
+        q = np.divide(qarray.from_list(range(1, 51)), 7)
+
+        for other in (d, q):
+            exact = other.astype(qqarray.dtype)
+            out = ufunc(a, other)
+            assert out.dtype == qqarray.dtype
+            assert np.all(out == ufunc(a, exact))
+
+            out = ufunc(other, a)
+            assert out.dtype == qqarray.dtype
+            assert np.all(out == ufunc(exact, a))
+
+    @pytest.mark.parametrize(
+        "ufunc", [np.equal, np.not_equal, np.less, np.less_equal, np.greater, np.greater_equal]
+    )
+    def test_compare_mixed(self, ufunc):
+
+        tiny = pq.qfloat(2) ** -150
+        a = qqarray.from_list(
+            [1, 2, 3, pq.qqfloat(pq.qfloat(2), tiny), pq.qqfloat(pq.qfloat(2), -tiny), "nan"]
+        )
+
+        # Python and NumPy numbers and qarray compare against the full pair
+        exact = qqarray.from_list([2] * 6)
+        for other in (2, np.int32(2), 2.0, qarray.from_list([2] * 6)):
+            np.testing.assert_array_equal(ufunc(a, other), ufunc(a, exact))
+            np.testing.assert_array_equal(ufunc(other, a), ufunc(exact, a))
+        assert ufunc(a, 2).tolist()[3:5] == [ufunc(1, 0), ufunc(0, 1)]
+
+    @pytest.mark.parametrize(
+        "ufunc, op",
+        [
+            (np.negative, CTX.minus),
+            (np.absolute, CTX.abs),
+            (np.square, lambda x: CTX.multiply(x, x)),
+            (np.sqrt, CTX.sqrt),
+        ],
+    )
+    def test_unary(self, ufunc, op):
+
+        a = _qq_spread(100, 8)
+        if ufunc is np.sqrt:
+            a = np.absolute(a)
+        out = ufunc(a)
+        assert out.dtype == qqarray.dtype
+        assert _max_rel_err(out, [op(_dec(x)) for x in a]) < QQ_RTOL
+
+    def test_exp_log(self):
+
+        x = np.divide(_qq_spread(60, 9, scale=0), 2**40) * 3000
+        out = np.exp(x)
+        assert _max_rel_err(out, [CTX.exp(_dec(v)) for v in x]) < QQ_RTOL
+
+        y = np.absolute(_qq_spread(60, 10))
+        out = np.log(y)
+        assert _max_rel_err(out, [CTX.ln(_dec(v)) for v in y]) < QQ_RTOL
+
+    def test_log_near_one(self):
+
+        one = pq.qqfloat(1)
+        x = qqarray.from_list([one, one + pq.qqfloat(2.0**-150), one - pq.qqfloat(2.0**-60) / 3])
+        out = np.log(x)
+        assert out[0] == 0
+        assert _max_rel_err(out[1:], [CTX.ln(_dec(v)) for v in x[1:]]) < QQ_RTOL
+
+    def test_special(self):
+
+        x = qqarray.from_list(["inf", "-inf", "nan", 0, -1, 12000, -12000])
+        with np.errstate(all="ignore"):
+            e = np.exp(x)
+            s = np.sqrt(x)
+            lg = np.log(x)
+        assert e[0].hi == math.inf
+        assert e[1].hi == 0
+        assert math.isnan(e[2].hi)
+        assert e[5].hi == math.inf
+        assert e[6].hi == 0
+        assert s[0].hi == math.inf
+        assert s[3].hi == 0
+        assert math.isnan(s[4].hi)
+        assert lg[3].hi == -math.inf
+        assert math.isnan(lg[4].hi)
+
+        with np.errstate(all="ignore"):
+            y = np.divide(qqarray.from_list([1, -1, 0]), qqarray.zeros(3))
+        assert y[0].hi == math.inf
+        assert y[1].hi == -math.inf
+        assert math.isnan(y[2].hi)
+
+        # Results past the quad range overflow
+        big = qqarray.from_list(["1e4900"])
+        with np.errstate(all="ignore"):
+            assert (big * big)[0].hi == math.inf
+
+    def test_signed_zero(self):
+        z = qqarray.from_list([-0.0])
+        for r in (np.add(z, z), np.multiply(z, 1.0), np.subtract(z, 0.0), z / 2.0):
+            assert math.copysign(1, float(r[0].hi)) == -1
+        assert str(z.astype(qarray.dtype)[0]) == "-0.0"
+        assert math.copysign(1, float(np.add(z, -z)[0].hi)) == 1
+        assert math.copysign(1, float((z * z)[0].hi)) == 1
+
+
+@pytest.mark.qqarray
+class TestQQArrayHardening:
+    def test_sort_argmax(self):
+
+        tiny = pq.qqfloat(pq.qfloat(1), pq.qfloat(2) ** -150)
+        arr = qqarray.from_list([tiny, 3, 1, -2])
+        np.testing.assert_array_equal(np.argsort(arr), [3, 2, 0, 1])
+        assert np.argmax(arr) == 1
+        assert np.argmin(arr) == 3
+
+        arr = qqarray.from_list([1, "nan", 2])
+        assert np.argmax(arr) == 1
+        assert np.argmin(arr) == 1
+
+    def test_nonzero(self):
+
+        arr = qqarray.from_list([0, -0.0, 1, "nan"])
+        np.testing.assert_array_equal(np.nonzero(arr)[0], [2, 3])
+
+    def test_byteswap(self):
+
+        qq = _qq_spread(10, 11)
+        swapped = qq.byteswap()
+        raw = swapped.view(np.uint8).reshape(10, 2, 16)
+        ref = qq.view(np.uint8).reshape(10, 2, 16)[:, :, ::-1]
+        np.testing.assert_array_equal(raw, ref)
+        assert np.all(swapped.byteswap() == qq)
+
+    def test_compare(self):
+
+        tiny = pq.qqfloat(pq.qfloat(1), pq.qfloat(2) ** -150)
+        a = qqarray.from_list([tiny, 1, 2, "nan"])
+        b = qqarray.from_list([1, tiny, 2, "nan"])
+        np.testing.assert_array_equal(a == b, [False, False, True, False])
+        np.testing.assert_array_equal(a != b, [True, True, False, True])
+        np.testing.assert_array_equal(a < b, [False, True, False, False])
+        np.testing.assert_array_equal(a <= b, [False, True, True, False])
+        np.testing.assert_array_equal(a > b, [True, False, False, False])
+        np.testing.assert_array_equal(a >= b, [True, False, True, False])
+        np.testing.assert_array_equal(a == 1.0, [False, True, False, False])
+
+    def test_fill(self):
+
+        arr = qqarray.empty(3)
+        arr.fill(pq.qqfloat(1) / 3)
+        assert np.all(arr == pq.qqfloat(1) / 3)
@@ -0,0 +1,146 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+import math
+import pickle
+from fractions import Fraction
+
+import pytest
+
+import pyquadp as pq
+
+# Quad-double results are good to a few units of 2^-226
+QQ_RTOL = Fraction(1, 2**220)
+
+
+def _exact(x):
+    return Fraction(*x.hi.as_integer_ratio()) + Fraction(*x.lo.as_integer_ratio())
+
+
+def _rel_err(x, ref):
+    return abs((_exact(x) - ref) / ref)
+
+
+class TestQQFloat:
+    def test_make(self):
+        q = pq.qqfloat(1)
+        assert q.hi == 1
+        assert q.lo == 0
+        assert repr(q) == "qqfloat('1." + "0" * 64 + "e+00')"
+        assert str(q) == "1." + "0" * 64 + "e+00"
+
+        q = pq.qqfloat(0.1)
+        assert _exact(q) == Fraction(0.1)
+
+        q = pq.qqfloat("0.1")
+        assert q.lo != 0
+        assert _rel_err(q, Fraction(1, 10)) < QQ_RTOL
+
+        q = pq.qqfloat(pq.qfloat("0.1"))
+        assert q.hi == pq.qfloat("0.1")
+        assert q.lo == 0
+
+        with pytest.raises(TypeError):
+            pq.qqfloat("abc")
+
+        with pytest.raises(TypeError):
+            pq.qqfloat([1])
+
+    def test_hi_lo(self):
+        q = pq.qqfloat(pq.qfloat(1), pq.qfloat(2) ** -150)
+        assert q.hi == 1
+        assert q.lo == pq.qfloat(2) ** -150
+
+        # Renormalised so that hi is the rounded sum
+        q = pq.qqfloat(1, 1)
+        assert q.hi == 2
+        assert q.lo == 0
+
+    def test_int_float(self):
+        assert int(pq.qqfloat(2**200 + 1)) == 2**200 + 1
+        assert int(pq.qqfloat(-(2**150) - 3)) == -(2**150) - 3
+        assert int(pq.qqfloat("2.75")) == 2
+        assert int(pq.qqfloat("-2.75")) == -2
+        assert float(pq.qqfloat(1) / 3) == 1 / 3
+
+        with pytest.raises(OverflowError):
+            int(pq.qqfloat(math.inf))
+
+    def test_arithmetic(self):
+        a = pq.qqfloat("1.234567890123456789012345678901234567890123456789012345678901234")
+        b = pq.qqfloat("9.876543210987654321098765432109876543210987654321098765432109876")
+        fa = _exact(a)
+        fb = _exact(b)
+
+        assert _rel_err(a + b, fa + fb) < QQ_RTOL
+        assert _rel_err(a - b, fa - fb) < QQ_RTOL
+        assert _rel_err(a * b, fa * fb) < QQ_RTOL
+        assert _rel_err(a / b, fa / fb) < QQ_RTOL
+        assert -a == pq.qqfloat(0) - a
+        assert abs(-a) == a
+        assert +a == a
+
+    def test_mixed(self):
+        q = pq.qqfloat(1) / 3
+
+        assert isinstance(q + 1, pq.qqfloat)
+        assert isinstance(1.5 * q, pq.qqfloat)
+        assert isinstance(q - "1", pq.qqfloat)
+
+        # qfloat operands are exact in a qqfloat
+        assert isinstance(q + pq.qfloat(1), pq.qqfloat)
+        assert isinstance(pq.qfloat(1) / q, pq.qqfloat)
+        assert q.to_qfloat() == pq.qfloat(1) / 3
+
+    def test_special(self):
+        inf = pq.qqfloat(math.inf)
+        assert (inf + 1).hi == math.inf
+        assert math.isnan((inf - inf).hi)
+        assert (pq.qqfloat(1) / 0).hi == math.inf
+        assert (pq.qqfloat(-1) / 0).hi == -math.inf
+        assert (pq.qqfloat(1) / inf).hi == 0
+        assert (pq.qqfloat("1e4900") * pq.qqfloat("1e4900")).hi == math.inf
+
+        nan = pq.qqfloat("nan")
+        assert nan != nan
+        assert not (nan < 1)
+
+    def test_signed_zero(self):
+        z = pq.qqfloat(-0.0)
+        assert math.copysign(1, float((z + z).hi)) == -1
+        assert math.copysign(1, float((z * pq.qqfloat(1)).hi)) == -1
+        assert math.copysign(1, float((z + pq.qqfloat(0)).hi)) == 1
+
+    def test_compare_hash(self):
+        a = pq.qqfloat(pq.qfloat(1), pq.qfloat(2) ** -150)
+        b = pq.qqfloat(1)
+
+        assert a > b
+        assert b < a
+        assert a != b
+        assert b == 1
+        assert not pq.qqfloat(0)
+        assert a
+
+        assert hash(pq.qqfloat(1.5)) == hash(1.5)
+        assert hash(pq.qqfloat(2)) == hash(2)
+        assert hash(a) == hash(pq.qqfloat(pq.qfloat(1), pq.qfloat(2) ** -150))
+
+    def test_bytes_pickle(self):
+        q = pq.qqfloat(1) / 3
+        b = q.to_bytes()
+        assert len(b) == 32
+        assert pq.qqfloat.from_bytes(b) == q
+
+        with pytest.raises(ValueError):
+            pq.qqfloat.from_bytes(b"123")
+
+        q2 = pickle.loads(pickle.dumps(q))
+        assert q == q2
+        assert q.lo == q2.lo
+
+    def test_pickle_compact(self):
+        values = [pq.qqfloat(1) / 3 + i for i in range(1000)]
+        # One memoized reference to _from_bytes, then the raw bytes of each
+        size = len(values[0].to_bytes())
+        assert len(pickle.dumps(values)) < 1000 * (size + 10)
+        assert [v.to_bytes() for v in pickle.loads(pickle.dumps(values))] == [v.to_bytes() for v in values]
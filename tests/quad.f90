@@ -27,4 +27,33 @@ module testq
 
     end subroutine single_quadc
 
+    subroutine write_records(filename, n, x, c)
+        character(len=*), intent(in) :: filename
+        integer, intent(in) :: n
+        real(qp), intent(in) :: x(n)
+        complex(qp), intent(in) :: c(n)
+        integer :: u
+
+        open(newunit=u, file=filename, form='unformatted', access='sequential', status='replace')
+        write(u) x
+        write(u) c
+        write(u) n, x(1), reshape(x(1:6), [3, 2])
+        close(u)
+
+    end subroutine write_records
+
+    subroutine read_records(filename, n, x, c)
+        character(len=*), intent(in) :: filename
+        integer, intent(in) :: n
+        real(qp), intent(out) :: x(n)
+        complex(qp), intent(out) :: c(n)
+        integer :: u
+
+        open(newunit=u, file=filename, form='unformatted', access='sequential', status='old')
+        read(u) x
+        read(u) c
+        close(u)
+
+    end subroutine read_records
+
 end module testq
\ No newline at end of file